@@ -9,133 +9,51 @@
  */
 
 #include "aecm.h"
+#include "../SPL/signal_processing_library.h"
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdint.h>
 
-static __inline int32_t WebRtcSpl_AddSatW32(int32_t a, int32_t b) {
-    // Do the addition in unsigned numbers, since signed overflow is undefined
-    // behavior.
-    const int32_t sum = (int32_t) ((uint32_t) a + (uint32_t) b);
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
 
-    // a + b can't overflow if a and b have different signs. If they have the
-    // same sign, a + b also has the same sign iff it didn't overflow.
-    if ((a < 0) == (b < 0) && (a < 0) != (sum < 0)) {
-        // The direction of the overflow is obvious from the sign of a + b.
-        return sum < 0 ? INT32_MAX : INT32_MIN;
-    }
-    return sum;
-}
-
-static __inline uint32_t __clz_uint32(uint32_t v) {
-// Never used with input 0
-    assert(v > 0);
-#if defined(__INTEL_COMPILER)
-    return _bit_scan_reverse(v) ^ 31U;
-#elif defined(__GNUC__) && (__GNUC__ >= 4 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
-// This will translate either to (bsr ^ 31U), clz , ctlz, cntlz, lzcnt depending on
-// -march= setting or to a software routine in exotic machines.
-    return __builtin_clz(v);
-#elif defined(_MSC_VER)
-    // for _BitScanReverse
-#include <intrin.h>
-    {
-        uint32_t idx;
-        _BitScanReverse(&idx, v);
-        return idx ^ 31U;
-    }
-#else
-// Will never be emitted for MSVC, GCC, Intel compilers
-    static const uint8_t byte_to_unary_table[] = {
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    };
-    return word > 0xffffff ? byte_to_unary_table[v >> 24] :
-        word > 0xffff ? byte_to_unary_table[v >> 16] + 8 :
-        word > 0xff ? byte_to_unary_table[v >> 8] + 16 :
-        byte_to_unary_table[v] + 24;
-#endif
-}
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t WebRtcSpl_NormW16(int16_t a) {
-    const int32_t a32 = a;
-    return a == 0 ? 0 : __clz_uint32(a < 0 ? ~a32 : a32) - 17;
-}
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormU32(uint32_t a) {
-
-    if (a == 0) return 0;
-    return (int16_t) __clz_uint32(a);
-}
+# include <windows.h>
 
+typedef INIT_ONCE AecmOnce;
+# define AECM_ONCE_INIT INIT_ONCE_STATIC_INIT
 
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormW32(int32_t a) {
+#else
 
-    if (a == 0) return 0;
-    uint32_t v = (uint32_t) (a < 0 ? ~a : a);
-    // Returns the number of leading zero bits in the argument.
-    return (int16_t) (__clz_uint32(v) - 1);
-}
+# include <pthread.h>
 
-static __inline int16_t WebRtcSpl_SatW32ToW16(int32_t value32) {
-    int16_t out16 = (int16_t) value32;
+typedef pthread_once_t AecmOnce;
+# define AECM_ONCE_INIT PTHREAD_ONCE_INIT
 
-    if (value32 > 32767)
-        out16 = 32767;
-    else if (value32 < -32768)
-        out16 = -32768;
+#endif
 
-    return out16;
-}
+#ifdef AEC_DEBUG
+FILE *dfile;
+FILE *testfile;
+#endif
 
-static __inline int16_t WebRtcSpl_AddSatW16(int16_t a, int16_t b) {
-    return WebRtcSpl_SatW32ToW16((int32_t) a + (int32_t) b);
+// Runs |init| exactly once for |lock|, the function pointers of the kernels
+// are shared by all instances and only selected the first time.
+#if defined(_WIN32)
+static BOOL CALLBACK InitOnce(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void) once;
+    (void) context;
+    ((void (*)(void)) param)();
+    return TRUE;
 }
 
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t WebRtcSpl_NormW32(int32_t a) {
-
-    if (a == 0) return 0;
-    uint32_t v = (uint32_t) (a < 0 ? ~a : a);
-    // Returns the number of leading zero bits in the argument.
-    return (int16_t) (__clz_uint32(v) - 1);
+static void once(AecmOnce *lock, void (*init)(void)) {
+    InitOnceExecuteOnce(lock, InitOnce, (PVOID) init, NULL);
 }
-
-int32_t WebRtcSpl_DivW32W16(int32_t num, int16_t den) {
-    // Guard against division with 0
-    if (den != 0) {
-        return (int32_t) (num / den);
-    } else {
-        return (int32_t) 0x7FFFFFFF;
-    }
+#else
+static void once(AecmOnce *lock, void (*init)(void)) {
+    pthread_once(lock, init);
 }
-
-#ifdef AEC_DEBUG
-FILE *dfile;
-FILE *testfile;
 #endif
 
 const int16_t WebRtcAecm_kCosTable[] = {
@@ -317,10 +235,13 @@ const uint16_t *WebRtcAecm_AlignedFarend(AecmCore *self,
 CalcLinearEnergies WebRtcAecm_CalcLinearEnergies;
 StoreAdaptiveChannel WebRtcAecm_StoreAdaptiveChannel;
 ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
+CalcChannelError WebRtcAecm_CalcChannelError;
 
 AecmCore *WebRtcAecm_CreateCore() {
     AecmCore *aecm = (AecmCore *) (malloc(sizeof(AecmCore)));
 
+    WebRtcSpl_Init();
+
     aecm->farFrameBuf = WebRtc_CreateBuffer(FRAME_LEN + PART_LEN,
                                             sizeof(int16_t));
     if (!aecm->farFrameBuf) {
@@ -463,6 +384,84 @@ static void ResetAdaptiveChannelC(AecmCore *aecm) {
     aecm->channelAdapt32[i] = (int32_t) aecm->channelStored[i] << 16;
 }
 
+void WebRtcAecm_CalcChannelErrorBin(AecmCore *aecm,
+                                    const uint16_t *far_spectrum,
+                                    const int16_t far_q,
+                                    const uint16_t *dfa,
+                                    int i,
+                                    int32_t *error,
+                                    int32_t *zeros_far,
+                                    int32_t *shift_ch_far,
+                                    int32_t *xfa_q) {
+    uint32_t tmpU32no1, tmpU32no2;
+    int16_t zerosFar, zerosNum, zerosCh, zerosDfa;
+    int16_t shiftChFar;
+    int16_t tmp16no1;
+    int16_t xfaQ, dfaQ;
+
+    // Determine norm of channel and farend to make sure we don't get overflow in
+    // multiplication
+    zerosCh = WebRtcSpl_NormU32(aecm->channelAdapt32[i]);
+    zerosFar = WebRtcSpl_NormU32((uint32_t) far_spectrum[i]);
+    if (zerosCh + zerosFar > 31) {
+        // Multiplication is safe
+        tmpU32no1 = WEBRTC_SPL_UMUL_32_16(aecm->channelAdapt32[i],
+                                          far_spectrum[i]);
+        shiftChFar = 0;
+    } else {
+        // We need to shift down before multiplication
+        shiftChFar = 32 - zerosCh - zerosFar;
+        // If zerosCh == zerosFar == 0, shiftChFar is 32. A
+        // right shift of 32 is undefined. To avoid that, we
+        // do this check.
+        tmpU32no1 = (uint32_t) (
+                shiftChFar >= 32
+                ? 0
+                : aecm->channelAdapt32[i] >> shiftChFar) *
+                    far_spectrum[i];
+    }
+    // Determine Q-domain of numerator
+    zerosNum = WebRtcSpl_NormU32(tmpU32no1);
+    if (dfa[i]) {
+        zerosDfa = WebRtcSpl_NormU32((uint32_t) dfa[i]);
+    } else {
+        zerosDfa = 32;
+    }
+    tmp16no1 = zerosDfa - 2 + aecm->dfaNoisyQDomain -
+               RESOLUTION_CHANNEL32 - far_q + shiftChFar;
+    if (zerosNum > tmp16no1 + 1) {
+        xfaQ = tmp16no1;
+        dfaQ = zerosDfa - 2;
+    } else {
+        xfaQ = zerosNum - 2;
+        dfaQ = RESOLUTION_CHANNEL32 + far_q - aecm->dfaNoisyQDomain -
+               shiftChFar + xfaQ;
+    }
+    // Add in the same Q-domain
+    tmpU32no1 = WEBRTC_SPL_SHIFT_W32(tmpU32no1, xfaQ);
+    tmpU32no2 = WEBRTC_SPL_SHIFT_W32((uint32_t) dfa[i], dfaQ);
+    error[i] = (int32_t) tmpU32no2 - (int32_t) tmpU32no1;
+    zeros_far[i] = zerosFar;
+    shift_ch_far[i] = shiftChFar;
+    xfa_q[i] = xfaQ;
+}
+
+static void CalcChannelErrorC(AecmCore *aecm,
+                              const uint16_t *far_spectrum,
+                              const int16_t far_q,
+                              const uint16_t *dfa,
+                              int32_t *error,
+                              int32_t *zeros_far,
+                              int32_t *shift_ch_far,
+                              int32_t *xfa_q) {
+    int i;
+
+    for (i = 0; i < PART_LEN1; i++) {
+        WebRtcAecm_CalcChannelErrorBin(aecm, far_spectrum, far_q, dfa, i,
+                                       error, zeros_far, shift_ch_far, xfa_q);
+    }
+}
+
 // Initialize function pointers for ARM Neon platform.
 #if defined(WEBRTC_HAS_NEON)
 static void WebRtcAecm_InitNeon(void)
@@ -473,6 +472,26 @@ static void WebRtcAecm_InitNeon(void)
 }
 #endif
 
+// Initialize function pointers for x86 platforms. There is no SSE2 version of
+// WebRtcAecm_CalcChannelError(), it needs per-lane variable shifts.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcAecm_InitX86(void)
+{
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuAVX2) {
+        WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelAVX2;
+        WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelAVX2;
+        WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesAVX2;
+        WebRtcAecm_CalcChannelError = WebRtcAecm_CalcChannelErrorAVX2;
+    } else if (features & kSplCpuSSE2) {
+        WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelSSE2;
+        WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelSSE2;
+        WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesSSE2;
+    }
+}
+#endif
+
 // Initialize function pointers for MIPS platform.
 #if defined(MIPS32_LE)
 static void WebRtcAecm_InitMips(void)
@@ -485,6 +504,27 @@ static void WebRtcAecm_InitMips(void)
 }
 #endif
 
+// Initialize function pointers, the C versions first and then the fastest
+// version the platform supports. Only called once, through once().
+static void InitCoreFunctions(void) {
+    WebRtcAecm_CalcLinearEnergies = CalcLinearEnergiesC;
+    WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelC;
+    WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelC;
+    WebRtcAecm_CalcChannelError = CalcChannelErrorC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    WebRtcAecm_InitX86();
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+    WebRtcAecm_InitNeon();
+#endif
+
+#if defined(MIPS32_LE)
+    WebRtcAecm_InitMips();
+#endif
+}
+
 // WebRtcAecm_InitCore(...)
 //
 // This function initializes the AECM instant created with WebRtcAecm_CreateCore(...)
@@ -550,6 +590,7 @@ int WebRtcAecm_InitCore(AecmCore *const aecm, int samplingFreq) {
     aecm->farLogEnergy = 0;
     memset(aecm->echoAdaptLogEnergy, 0, sizeof(aecm->echoAdaptLogEnergy));
     memset(aecm->echoStoredLogEnergy, 0, sizeof(aecm->echoStoredLogEnergy));
+    aecm->logEnergyPos = 0;
 
     // Initialize the echo channels with a stored shape.
     if (samplingFreq == 8000) {
@@ -598,19 +639,12 @@ int WebRtcAecm_InitCore(AecmCore *const aecm, int samplingFreq) {
     // Assert a preprocessor definition at compile-time. It's an assumption
     // used in assembly code, so check the assembly files before any change.
     static_assert(PART_LEN % 16 == 0, "PART_LEN is not a multiple of 16");
+    static_assert((MAX_BUF_LEN & (MAX_BUF_LEN - 1)) == 0,
+                  "MAX_BUF_LEN is not a power of 2");
 
     // Initialize function pointers.
-    WebRtcAecm_CalcLinearEnergies = CalcLinearEnergiesC;
-    WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelC;
-    WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelC;
-
-#if defined(WEBRTC_HAS_NEON)
-    WebRtcAecm_InitNeon();
-#endif
-
-#if defined(MIPS32_LE)
-    WebRtcAecm_InitMips();
-#endif
+    static AecmOnce lock = AECM_ONCE_INIT;
+    once(&lock, InitCoreFunctions);
     return 0;
 }
 
@@ -770,7 +804,7 @@ static int16_t LogOfEnergyInQ8(uint32_t energy, int q_domain) {
     static const int16_t kLogLowValue = PART_LEN_SHIFT << 7;
     int16_t log_energy_q8 = kLogLowValue;
     if (energy > 0) {
-        int zeros = NormU32(energy);
+        int zeros = WebRtcSpl_NormU32(energy);
         int16_t frac = ExtractFractionPart(energy, zeros);
         // log2 of |energy| in Q8.
         log_energy_q8 += ((31 - zeros) << 8) + frac - (q_domain << 8);
@@ -802,6 +836,7 @@ void WebRtcAecm_CalcEnergies(AecmCore *aecm,
     uint32_t tmpFar = 0;
 
     int i;
+    int newest;
 
     int16_t tmp16;
     int16_t increase_max_shifts = 4;
@@ -811,30 +846,24 @@ void WebRtcAecm_CalcEnergies(AecmCore *aecm,
 
     // Get log of near end energy and store in buffer
 
-    // Shift buffer
-    memmove(aecm->nearLogEnergy + 1, aecm->nearLogEnergy,
-            sizeof(int16_t) * (MAX_BUF_LEN - 1));
+    // Step back in the ring buffers, the oldest value is overwritten
+    aecm->logEnergyPos = (aecm->logEnergyPos - 1) & (MAX_BUF_LEN - 1);
+    newest = aecm->logEnergyPos;
 
     // Logarithm of integrated magnitude spectrum (nearEner)
-    aecm->nearLogEnergy[0] = LogOfEnergyInQ8(nearEner, aecm->dfaNoisyQDomain);
+    aecm->nearLogEnergy[newest] = LogOfEnergyInQ8(nearEner, aecm->dfaNoisyQDomain);
 
     WebRtcAecm_CalcLinearEnergies(aecm, far_spectrum, echoEst, &tmpFar, &tmpAdapt, &tmpStored);
 
-    // Shift buffers
-    memmove(aecm->echoAdaptLogEnergy + 1, aecm->echoAdaptLogEnergy,
-            sizeof(int16_t) * (MAX_BUF_LEN - 1));
-    memmove(aecm->echoStoredLogEnergy + 1, aecm->echoStoredLogEnergy,
-            sizeof(int16_t) * (MAX_BUF_LEN - 1));
-
     // Logarithm of delayed far end energy
     aecm->farLogEnergy = LogOfEnergyInQ8(tmpFar, far_q);
 
     // Logarithm of estimated echo energy through adapted channel
-    aecm->echoAdaptLogEnergy[0] = LogOfEnergyInQ8(tmpAdapt,
-                                                  RESOLUTION_CHANNEL16 + far_q);
+    aecm->echoAdaptLogEnergy[newest] = LogOfEnergyInQ8(tmpAdapt,
+                                                       RESOLUTION_CHANNEL16 + far_q);
 
     // Logarithm of estimated echo energy through stored channel
-    aecm->echoStoredLogEnergy[0] =
+    aecm->echoStoredLogEnergy[newest] =
             LogOfEnergyInQ8(tmpStored, RESOLUTION_CHANNEL16 + far_q);
 
     // Update farend energy levels (min, max, vad, mse)
@@ -887,7 +916,7 @@ void WebRtcAecm_CalcEnergies(AecmCore *aecm,
     }
     if ((aecm->currentVADValue) && (aecm->firstVAD)) {
         aecm->firstVAD = 0;
-        if (aecm->echoAdaptLogEnergy[0] > aecm->nearLogEnergy[0]) {
+        if (aecm->echoAdaptLogEnergy[newest] > aecm->nearLogEnergy[newest]) {
             // The estimated echo has higher energy than the near end signal.
             // This means that the initialization was too aggressive. Scale
             // down by a factor 8
@@ -895,7 +924,7 @@ void WebRtcAecm_CalcEnergies(AecmCore *aecm,
                 aecm->channelAdapt16[i] >>= 3;
             }
             // Compensate the adapted echo energy level accordingly.
-            aecm->echoAdaptLogEnergy[0] -= (3 << 8);
+            aecm->echoAdaptLogEnergy[newest] -= (3 << 8);
             aecm->firstVAD = 1;
         }
     }
@@ -957,66 +986,35 @@ void WebRtcAecm_UpdateChannel(AecmCore *aecm,
                               const uint16_t *const dfa,
                               const int16_t mu,
                               int32_t *echoEst) {
-    uint32_t tmpU32no1, tmpU32no2;
     int32_t tmp32no1, tmp32no2;
     int32_t mseStored;
     int32_t mseAdapt;
 
     int i;
 
-    int16_t zerosFar, zerosNum, zerosCh, zerosDfa;
+    int16_t zerosFar, zerosNum;
     int16_t shiftChFar, shiftNum, shift2ResChan;
-    int16_t tmp16no1;
-    int16_t xfaQ, dfaQ;
+    int16_t xfaQ;
+
+    int32_t error[PART_LEN1];
+    int32_t zeros_far[PART_LEN1];
+    int32_t shift_ch_far[PART_LEN1];
+    int32_t xfa_q[PART_LEN1];
 
     // This is the channel estimation algorithm. It is base on NLMS but has a variable step
     // length, which was calculated above.
     if (mu) {
+        // The errors of all bins are independent of the update, compute them
+        // up front.
+        WebRtcAecm_CalcChannelError(aecm, far_spectrum, far_q, dfa,
+                                    error, zeros_far, shift_ch_far, xfa_q);
         for (i = 0; i < PART_LEN1; i++) {
-            // Determine norm of channel and farend to make sure we don't get overflow in
-            // multiplication
-            zerosCh = NormU32(aecm->channelAdapt32[i]);
-            zerosFar = NormU32((uint32_t) far_spectrum[i]);
-            if (zerosCh + zerosFar > 31) {
-                // Multiplication is safe
-                tmpU32no1 = WEBRTC_SPL_UMUL_32_16(aecm->channelAdapt32[i],
-                                                  far_spectrum[i]);
-                shiftChFar = 0;
-            } else {
-                // We need to shift down before multiplication
-                shiftChFar = 32 - zerosCh - zerosFar;
-                // If zerosCh == zerosFar == 0, shiftChFar is 32. A
-                // right shift of 32 is undefined. To avoid that, we
-                // do this check.
-                tmpU32no1 = (uint32_t) (
-                        shiftChFar >= 32
-                        ? 0
-                        : aecm->channelAdapt32[i] >> shiftChFar) *
-                            far_spectrum[i];
-            }
-            // Determine Q-domain of numerator
-            zerosNum = NormU32(tmpU32no1);
-            if (dfa[i]) {
-                zerosDfa = NormU32((uint32_t) dfa[i]);
-            } else {
-                zerosDfa = 32;
-            }
-            tmp16no1 = zerosDfa - 2 + aecm->dfaNoisyQDomain -
-                       RESOLUTION_CHANNEL32 - far_q + shiftChFar;
-            if (zerosNum > tmp16no1 + 1) {
-                xfaQ = tmp16no1;
-                dfaQ = zerosDfa - 2;
-            } else {
-                xfaQ = zerosNum - 2;
-                dfaQ = RESOLUTION_CHANNEL32 + far_q - aecm->dfaNoisyQDomain -
-                       shiftChFar + xfaQ;
-            }
-            // Add in the same Q-domain
-            tmpU32no1 = WEBRTC_SPL_SHIFT_W32(tmpU32no1, xfaQ);
-            tmpU32no2 = WEBRTC_SPL_SHIFT_W32((uint32_t) dfa[i], dfaQ);
-            tmp32no1 = (int32_t) tmpU32no2 - (int32_t) tmpU32no1;
-            zerosNum = NormW32(tmp32no1);
+            tmp32no1 = error[i];
             if ((tmp32no1) && (far_spectrum[i] > (CHANNEL_VAD << far_q))) {
+                zerosFar = (int16_t) zeros_far[i];
+                shiftChFar = (int16_t) shift_ch_far[i];
+                xfaQ = (int16_t) xfa_q[i];
+                zerosNum = WebRtcSpl_NormW32(tmp32no1);
                 //
                 // Update is needed
                 //
@@ -1050,7 +1048,7 @@ void WebRtcAecm_UpdateChannel(AecmCore *aecm,
                 tmp32no2 = WebRtcSpl_DivW32W16(tmp32no2, i + 1);
                 // Make sure we are in the right Q-domain
                 shift2ResChan = shiftNum + shiftChFar - xfaQ - mu - ((30 - zerosFar) << 1);
-                if (NormW32(tmp32no2) < shift2ResChan) {
+                if (WebRtcSpl_NormW32(tmp32no2) < shift2ResChan) {
                     tmp32no2 = (int32_t) 0x7fffffff;
                 } else {
                     tmp32no2 = WEBRTC_SPL_SHIFT_W32(tmp32no2, shift2ResChan);
@@ -1087,13 +1085,14 @@ void WebRtcAecm_UpdateChannel(AecmCore *aecm,
             mseStored = 0;
             mseAdapt = 0;
             for (i = 0; i < MIN_MSE_COUNT; i++) {
-                tmp32no1 = ((int32_t) aecm->echoStoredLogEnergy[i]
-                            - (int32_t) aecm->nearLogEnergy[i]);
+                const int k = (aecm->logEnergyPos + i) & (MAX_BUF_LEN - 1);
+                tmp32no1 = ((int32_t) aecm->echoStoredLogEnergy[k]
+                            - (int32_t) aecm->nearLogEnergy[k]);
                 tmp32no2 = WEBRTC_SPL_ABS_W32(tmp32no1);
                 mseStored += tmp32no2;
 
-                tmp32no1 = ((int32_t) aecm->echoAdaptLogEnergy[i]
-                            - (int32_t) aecm->nearLogEnergy[i]);
+                tmp32no1 = ((int32_t) aecm->echoAdaptLogEnergy[k]
+                            - (int32_t) aecm->nearLogEnergy[k]);
                 tmp32no2 = WEBRTC_SPL_ABS_W32(tmp32no1);
                 mseAdapt += tmp32no2;
             }
@@ -1159,7 +1158,8 @@ int16_t WebRtcAecm_CalcSuppressionGain(AecmCore *const aecm) {
     } else {
         // Adjust for possible double talk. If we have large variations in estimation error we
         // likely have double talk (or poor channel).
-        tmp16no1 = (aecm->nearLogEnergy[0] - aecm->echoStoredLogEnergy[0] - ENERGY_DEV_OFFSET);
+        tmp16no1 = (aecm->nearLogEnergy[aecm->logEnergyPos] -
+                    aecm->echoStoredLogEnergy[aecm->logEnergyPos] - ENERGY_DEV_OFFSET);
         dE = WEBRTC_SPL_ABS_W16(tmp16no1);
 
         if (dE < ENERGY_DEV_TOL) {
@@ -1322,27 +1322,6 @@ int32_t WebRtcSpl_SqrtFloor(int32_t value) {
     return root >> 1;
 }
 
-int16_t WebRtcSpl_MaxAbsValueW16(const int16_t *vector, size_t length) {
-    size_t i = 0;
-    int absolute = 0, maximum = 0;
-
-    for (i = 0; i < length; i++) {
-        absolute = abs((int) vector[i]);
-
-        if (absolute > maximum) {
-            maximum = absolute;
-        }
-    }
-
-    // Guard the case for abs(-32768).
-    if (maximum > 32767) {
-        maximum = 32767;
-    }
-
-    return (int16_t) maximum;
-}
-
-
 // Square root of Hanning window in Q14.
 static const ALIGN8_BEG int16_t WebRtcAecm_kSqrtHanning[] ALIGN8_END = {
         0, 399, 798, 1196, 1594, 1990, 2386, 2780, 3172,
@@ -1917,8 +1896,7 @@ static void ComfortNoise(AecmCore *aecm,
     int32_t tmp32;
 
     int16_t randW16[PART_LEN];
-    int16_t uReal[PART_LEN1];
-    int16_t uImag[PART_LEN1];
+    ComplexInt16 u[PART_LEN1];
     int32_t outLShift32;
     int16_t noiseRShift16[PART_LEN1];
 
@@ -2001,24 +1979,23 @@ static void ComfortNoise(AecmCore *aecm,
     WebRtcSpl_RandUArray(randW16, PART_LEN, &aecm->seed);
 
     // Generate noise according to estimated energy.
-    uReal[0] = 0; // Reject LF noise.
-    uImag[0] = 0;
+    u[0].real = 0; // Reject LF noise.
+    u[0].imag = 0;
     for (i = 1; i < PART_LEN1; i++) {
         // Get a random index for the cos and sin tables over [0 359].
         tmp16 = (int16_t) ((359 * randW16[i - 1]) >> 15);
 
         // Tables are in Q13.
-        uReal[i] = (int16_t) ((noiseRShift16[i] * WebRtcAecm_kCosTable[tmp16]) >>
-                                                                               13);
-        uImag[i] = (int16_t) ((-noiseRShift16[i] * WebRtcAecm_kSinTable[tmp16]) >>
+        u[i].real = (int16_t) ((noiseRShift16[i] * WebRtcAecm_kCosTable[tmp16]) >>
                                                                                 13);
+        u[i].imag = (int16_t) ((-noiseRShift16[i] * WebRtcAecm_kSinTable[tmp16]) >>
+                                                                                 13);
     }
-    uImag[PART_LEN] = 0;
+    u[PART_LEN].imag = 0;
 
-    for (i = 0; i < PART_LEN1; i++) {
-        out[i].real = WebRtcSpl_AddSatW16(out[i].real, uReal[i]);
-        out[i].imag = WebRtcSpl_AddSatW16(out[i].imag, uImag[i]);
-    }
+    // Real and imaginary parts are interleaved in both, add them as one vector.
+    WebRtcSpl_AddSatVectorW16((const int16_t *) out, (const int16_t *) u,
+                              (int16_t *) out, 2 * PART_LEN1);
 }
 
 #include <stddef.h>  // size_t
@@ -2300,23 +2277,10 @@ static int BitCount(uint32_t u32) {
     return ((int) tmp);
 }
 
-// Compares the |binary_vector| with all rows of the |binary_matrix| and counts
-// per row the number of times they have the same value.
-//
-// Inputs:
-//      - binary_vector     : binary "vector" stored in a long
-//      - binary_matrix     : binary "matrix" stored as a vector of long
-//      - matrix_size       : size of binary "matrix"
-//
-// Output:
-//      - bit_counts        : "Vector" stored as a long, containing for each
-//                            row the number of times the matrix row and the
-//                            input vector have the same value
-//
-static void BitCountComparison(uint32_t binary_vector,
-                               const uint32_t *binary_matrix,
-                               int matrix_size,
-                               int32_t *bit_counts) {
+static void BitCountComparisonC(uint32_t binary_vector,
+                                const uint32_t *binary_matrix,
+                                int matrix_size,
+                                int32_t *bit_counts) {
     int n = 0;
 
     // Compare |binary_vector| with all rows of the |binary_matrix|
@@ -2325,6 +2289,47 @@ static void BitCountComparison(uint32_t binary_vector,
     }
 }
 
+static int FindCandidateDelayC(const int32_t *mean_bit_counts,
+                               int history_size,
+                               int32_t *value_best,
+                               int32_t *value_worst) {
+    int i;
+    int candidate_delay = -1;
+
+    *value_best = kMaxBitCountsQ9;
+    *value_worst = 0;
+    for (i = 0; i < history_size; i++) {
+        if (mean_bit_counts[i] < *value_best) {
+            *value_best = mean_bit_counts[i];
+            candidate_delay = i;
+        }
+        if (mean_bit_counts[i] > *value_worst) {
+            *value_worst = mean_bit_counts[i];
+        }
+    }
+    return candidate_delay;
+}
+
+// Declare function pointers.
+BitCountComparison WebRtc_BitCountComparison = BitCountComparisonC;
+FindCandidateDelay WebRtc_FindCandidateDelay = FindCandidateDelayC;
+
+// Initialize the function pointers of the delay estimator. The popcount of
+// POPCNT and the nibble lookup of AVX2 replace the software BitCount(). Only
+// called once, through once().
+static void InitDelayEstimatorFunctions(void) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuAVX2) {
+        WebRtc_BitCountComparison = WebRtc_BitCountComparisonAVX2;
+        WebRtc_FindCandidateDelay = WebRtc_FindCandidateDelayAVX2;
+    } else if (features & kSplCpuPOPCNT) {
+        WebRtc_BitCountComparison = WebRtc_BitCountComparisonPOPCNT;
+    }
+#endif
+}
+
 // Collects necessary statistics for the HistogramBasedValidation().  This
 // function has to be called prior to calling HistogramBasedValidation().  The
 // statistics updated and used by the HistogramBasedValidation() are:
@@ -2538,6 +2543,7 @@ BinaryDelayEstimatorFarend *WebRtc_CreateBinaryDelayEstimatorFarend(
     }
 
     self->history_size = 0;
+    self->history_pos = 0;
     self->binary_far_history = NULL;
     self->far_bit_counts = NULL;
     if (WebRtc_AllocateFarendBufferMemory(self, history_size) == 0) {
@@ -2549,28 +2555,52 @@ BinaryDelayEstimatorFarend *WebRtc_CreateBinaryDelayEstimatorFarend(
 
 int WebRtc_AllocateFarendBufferMemory(BinaryDelayEstimatorFarend *self,
                                       int history_size) {
+    uint32_t *binary_far_history;
+    int *far_bit_counts;
+    int kept = 0;
+    int first = 0;
+
     assert(self);
-    // (Re-)Allocate memory for history buffers.
-    self->binary_far_history = (uint32_t *) (
-            realloc(self->binary_far_history,
-                    history_size * sizeof(*self->binary_far_history)));
-    self->far_bit_counts = (int *) (
-            realloc(self->far_bit_counts,
-                    history_size * sizeof(*self->far_bit_counts)));
-    if ((self->binary_far_history == NULL) || (self->far_bit_counts == NULL)) {
+    // (Re-)Allocate memory for history buffers. The ring buffers are unrolled
+    // into the new buffers, the newest spectrum first.
+    binary_far_history = (uint32_t *) (
+            malloc(history_size * sizeof(*binary_far_history)));
+    far_bit_counts = (int *) (malloc(history_size * sizeof(*far_bit_counts)));
+    if ((binary_far_history == NULL) || (far_bit_counts == NULL)) {
+        free(binary_far_history);
+        free(far_bit_counts);
+        binary_far_history = NULL;
+        far_bit_counts = NULL;
         history_size = 0;
     }
+    kept = history_size < self->history_size ? history_size : self->history_size;
+    first = self->history_size - self->history_pos;
+    if (first > kept) {
+        first = kept;
+    }
+    if (kept > 0) {
+        memcpy(binary_far_history, &self->binary_far_history[self->history_pos],
+               sizeof(*binary_far_history) * first);
+        memcpy(&binary_far_history[first], self->binary_far_history,
+               sizeof(*binary_far_history) * (kept - first));
+        memcpy(far_bit_counts, &self->far_bit_counts[self->history_pos],
+               sizeof(*far_bit_counts) * first);
+        memcpy(&far_bit_counts[first], self->far_bit_counts,
+               sizeof(*far_bit_counts) * (kept - first));
+    }
     // Fill with zeros if we have expanded the buffers.
-    if (history_size > self->history_size) {
-        int size_diff = history_size - self->history_size;
-        memset(&self->binary_far_history[self->history_size],
-               0,
-               sizeof(*self->binary_far_history) * size_diff);
-        memset(&self->far_bit_counts[self->history_size],
-               0,
-               sizeof(*self->far_bit_counts) * size_diff);
+    if (history_size > kept) {
+        memset(&binary_far_history[kept], 0,
+               sizeof(*binary_far_history) * (history_size - kept));
+        memset(&far_bit_counts[kept], 0,
+               sizeof(*far_bit_counts) * (history_size - kept));
     }
+    free(self->binary_far_history);
+    free(self->far_bit_counts);
+    self->binary_far_history = binary_far_history;
+    self->far_bit_counts = far_bit_counts;
     self->history_size = history_size;
+    self->history_pos = 0;
 
     return self->history_size;
 }
@@ -2579,15 +2609,15 @@ void WebRtc_InitBinaryDelayEstimatorFarend(BinaryDelayEstimatorFarend *self) {
     assert(self);
     memset(self->binary_far_history, 0, sizeof(uint32_t) * self->history_size);
     memset(self->far_bit_counts, 0, sizeof(int) * self->history_size);
+    self->history_pos = 0;
 }
 
 void WebRtc_SoftResetBinaryDelayEstimatorFarend(
         BinaryDelayEstimatorFarend *self, int delay_shift) {
     int abs_shift = abs(delay_shift);
     int shift_size = 0;
-    int dest_index = 0;
-    int src_index = 0;
-    int padding_index = 0;
+    int padding_delay = 0;
+    int i = 0;
 
     assert(self);
     shift_size = self->history_size - abs_shift;
@@ -2595,38 +2625,43 @@ void WebRtc_SoftResetBinaryDelayEstimatorFarend(
     if (delay_shift == 0) {
         return;
     } else if (delay_shift > 0) {
-        dest_index = abs_shift;
+        // Every spectrum moves |abs_shift| delays back, the newest delays are
+        // zero padded.
+        self->history_pos -= abs_shift;
+        if (self->history_pos < 0) {
+            self->history_pos += self->history_size;
+        }
     } else if (delay_shift < 0) {
-        src_index = abs_shift;
-        padding_index = shift_size;
-    }
-
-    // Shift and zero pad buffers.
-    memmove(&self->binary_far_history[dest_index],
-            &self->binary_far_history[src_index],
-            sizeof(*self->binary_far_history) * shift_size);
-    memset(&self->binary_far_history[padding_index], 0,
-           sizeof(*self->binary_far_history) * abs_shift);
-    memmove(&self->far_bit_counts[dest_index],
-            &self->far_bit_counts[src_index],
-            sizeof(*self->far_bit_counts) * shift_size);
-    memset(&self->far_bit_counts[padding_index], 0,
-           sizeof(*self->far_bit_counts) * abs_shift);
+        // Every spectrum moves |abs_shift| delays ahead, the oldest delays are
+        // zero padded.
+        self->history_pos += abs_shift;
+        if (self->history_pos >= self->history_size) {
+            self->history_pos -= self->history_size;
+        }
+        padding_delay = shift_size;
+    }
+
+    // Zero pad the delays that were shifted out.
+    for (i = padding_delay; i < padding_delay + abs_shift; i++) {
+        int index = self->history_pos + i;
+        if (index >= self->history_size) {
+            index -= self->history_size;
+        }
+        self->binary_far_history[index] = 0;
+        self->far_bit_counts[index] = 0;
+    }
 }
 
 void WebRtc_AddBinaryFarSpectrum(BinaryDelayEstimatorFarend *handle,
                                  uint32_t binary_far_spectrum) {
     assert(handle);
-    // Shift binary spectrum history and insert current |binary_far_spectrum|.
-    memmove(&(handle->binary_far_history[1]), &(handle->binary_far_history[0]),
-            (handle->history_size - 1) * sizeof(uint32_t));
-    handle->binary_far_history[0] = binary_far_spectrum;
-
-    // Shift history of far-end binary spectrum bit counts and insert bit count
-    // of current |binary_far_spectrum|.
-    memmove(&(handle->far_bit_counts[1]), &(handle->far_bit_counts[0]),
-            (handle->history_size - 1) * sizeof(int));
-    handle->far_bit_counts[0] = BitCount(binary_far_spectrum);
+    // Step back in the binary spectrum history, overwriting the oldest, and
+    // insert current |binary_far_spectrum| and its bit count.
+    if (--handle->history_pos < 0) {
+        handle->history_pos = handle->history_size - 1;
+    }
+    handle->binary_far_history[handle->history_pos] = binary_far_spectrum;
+    handle->far_bit_counts[handle->history_pos] = BitCount(binary_far_spectrum);
 }
 
 void WebRtc_FreeBinaryDelayEstimator(BinaryDelayEstimator *self) {
@@ -2656,6 +2691,7 @@ void WebRtc_FreeBinaryDelayEstimator(BinaryDelayEstimator *self) {
 
 BinaryDelayEstimator *WebRtc_CreateBinaryDelayEstimator(
         BinaryDelayEstimatorFarend *farend, int max_lookahead) {
+    static AecmOnce lock = AECM_ONCE_INIT;
     BinaryDelayEstimator *self = NULL;
 
     if ((farend != NULL) && (max_lookahead >= 0)) {
@@ -2667,8 +2703,11 @@ BinaryDelayEstimator *WebRtc_CreateBinaryDelayEstimator(
         return NULL;
     }
 
+    once(&lock, InitDelayEstimatorFunctions);
+
     self->farend = farend;
     self->near_history_size = max_lookahead + 1;
+    self->near_history_pos = 0;
     self->history_size = 0;
     self->robust_validation_enabled = 0;  // Disabled by default.
     self->allowed_offset = 0;
@@ -2740,6 +2779,7 @@ void WebRtc_InitBinaryDelayEstimator(BinaryDelayEstimator *self) {
     memset(self->binary_near_history,
            0,
            sizeof(uint32_t) * self->near_history_size);
+    self->near_history_pos = 0;
     for (i = 0; i <= self->history_size; ++i) {
         self->mean_bit_counts[i] = (20 << 9);  // 20 in Q9.
         self->histogram[i] = 0.f;
@@ -2774,6 +2814,8 @@ int WebRtc_SoftResetBinaryDelayEstimator(BinaryDelayEstimator *self,
 int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator *self,
                                  uint32_t binary_near_spectrum) {
     int i = 0;
+    int far_pos = 0;
+    int wrap_delay = 0;
     int candidate_delay = -1;
     int valid_candidate = 0;
 
@@ -2787,46 +2829,54 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator *self,
         return -1;
     }
     if (self->near_history_size > 1) {
-        // If we apply lookahead, shift near-end binary spectrum history. Insert
-        // current |binary_near_spectrum| and pull out the delayed one.
-        memmove(&(self->binary_near_history[1]), &(self->binary_near_history[0]),
-                (self->near_history_size - 1) * sizeof(uint32_t));
-        self->binary_near_history[0] = binary_near_spectrum;
-        binary_near_spectrum = self->binary_near_history[self->lookahead];
+        // If we apply lookahead, step back in the near-end binary spectrum
+        // history. Insert current |binary_near_spectrum| and pull out the
+        // delayed one.
+        int delayed = 0;
+        if (--self->near_history_pos < 0) {
+            self->near_history_pos = self->near_history_size - 1;
+        }
+        self->binary_near_history[self->near_history_pos] = binary_near_spectrum;
+        delayed = self->near_history_pos + self->lookahead;
+        if (delayed >= self->near_history_size) {
+            delayed -= self->near_history_size;
+        }
+        binary_near_spectrum = self->binary_near_history[delayed];
     }
 
     // Compare with delayed spectra and store the |bit_counts| for each delay.
-    BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
-                       self->history_size, self->bit_counts);
+    // The far-end history wraps after |wrap_delay| delays.
+    far_pos = self->farend->history_pos;
+    wrap_delay = self->history_size - far_pos;
+    WebRtc_BitCountComparison(binary_near_spectrum, &self->farend->binary_far_history[far_pos],
+                              wrap_delay, self->bit_counts);
+    WebRtc_BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
+                              far_pos, &self->bit_counts[wrap_delay]);
 
     // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
-    for (i = 0; i < self->history_size; i++) {
+    for (i = 0; i < self->history_size; i++, far_pos++) {
         // |bit_counts| is constrained to [0, 32], meaning we can smooth with a
         // factor up to 2^26. We use Q9.
         int32_t bit_count = (self->bit_counts[i] << 9);  // Q9.
 
+        if (far_pos == self->history_size) {
+            far_pos = 0;
+        }
         // Update |mean_bit_counts| only when far-end signal has something to
         // contribute. If |far_bit_counts| is zero the far-end signal is weak and
         // we likely have a poor echo condition, hence don't update.
-        if (self->farend->far_bit_counts[i] > 0) {
+        if (self->farend->far_bit_counts[far_pos] > 0) {
             // Make number of right shifts piecewise linear w.r.t. |far_bit_counts|.
             int shifts = kShiftsAtZero;
-            shifts -= (kShiftsLinearSlope * self->farend->far_bit_counts[i]) >> 4;
+            shifts -= (kShiftsLinearSlope * self->farend->far_bit_counts[far_pos]) >> 4;
             WebRtc_MeanEstimatorFix(bit_count, shifts, &(self->mean_bit_counts[i]));
         }
     }
 
     // Find |candidate_delay|, |value_best_candidate| and |value_worst_candidate|
     // of |mean_bit_counts|.
-    for (i = 0; i < self->history_size; i++) {
-        if (self->mean_bit_counts[i] < value_best_candidate) {
-            value_best_candidate = self->mean_bit_counts[i];
-            candidate_delay = i;
-        }
-        if (self->mean_bit_counts[i] > value_worst_candidate) {
-            value_worst_candidate = self->mean_bit_counts[i];
-        }
-    }
+    candidate_delay = WebRtc_FindCandidateDelay(self->mean_bit_counts, self->history_size,
+                                                &value_best_candidate, &value_worst_candidate);
     valley_depth = value_worst_candidate - value_best_candidate;
 
     // The |value_best_candidate| is a good indicator on the probability of
@@ -3721,6 +3771,159 @@ static const int16_t kSinTable1024[] = {
         -1607, -1406, -1206, -1005, -804, -603, -402, -201
 };
 
+/* Twiddle factors of the 128-point FFTs, one pair of 16-bit values per complex
+ * factor, the factors of the stage with butterfly span l start at pair l - 1.
+ * They are the values WebRtcSpl_ComplexFFT() and WebRtcSpl_ComplexIFFT() read
+ * from kSinTable1024[] for stages == 7 and mode == 1, arranged for a
+ * multiply-add with the (real, imaginary) pairs of the data.
+ */
+const int16_t WebRtcAecm_kFft128Twiddles[4][2 * (PART_LEN2 - 1)] = {
+        /* Forward, first factor: (cos, sin). */
+        {
+                32767, 0, 32767, 0, 0, 32767, 32767, 0, 23169, 23169, 0, 32767,
+                -23169, 23169, 32767, 0, 30272, 12539, 23169, 23169, 12539,
+                30272, 0, 32767, -12539, 30272, -23169, 23169, -30272, 12539,
+                32767, 0, 32137, 6392, 30272, 12539, 27244, 18204, 23169,
+                23169, 18204, 27244, 12539, 30272, 6392, 32137, 0, 32767,
+                -6392, 32137, -12539, 30272, -18204, 27244, -23169, 23169,
+                -27244, 18204, -30272, 12539, -32137, 6392, 32767, 0, 32609,
+                3211, 32137, 6392, 31356, 9511, 30272, 12539, 28897, 15446,
+                27244, 18204, 25329, 20787, 23169, 23169, 20787, 25329, 18204,
+                27244, 15446, 28897, 12539, 30272, 9511, 31356, 6392, 32137,
+                3211, 32609, 0, 32767, -3211, 32609, -6392, 32137, -9511,
+                31356, -12539, 30272, -15446, 28897, -18204, 27244, -20787,
+                25329, -23169, 23169, -25329, 20787, -27244, 18204, -28897,
+                15446, -30272, 12539, -31356, 9511, -32137, 6392, -32609, 3211,
+                32767, 0, 32727, 1607, 32609, 3211, 32412, 4807, 32137, 6392,
+                31785, 7961, 31356, 9511, 30851, 11038, 30272, 12539, 29621,
+                14009, 28897, 15446, 28105, 16845, 27244, 18204, 26318, 19519,
+                25329, 20787, 24278, 22004, 23169, 23169, 22004, 24278, 20787,
+                25329, 19519, 26318, 18204, 27244, 16845, 28105, 15446, 28897,
+                14009, 29621, 12539, 30272, 11038, 30851, 9511, 31356, 7961,
+                31785, 6392, 32137, 4807, 32412, 3211, 32609, 1607, 32727, 0,
+                32767, -1607, 32727, -3211, 32609, -4807, 32412, -6392, 32137,
+                -7961, 31785, -9511, 31356, -11038, 30851, -12539, 30272,
+                -14009, 29621, -15446, 28897, -16845, 28105, -18204, 27244,
+                -19519, 26318, -20787, 25329, -22004, 24278, -23169, 23169,
+                -24278, 22004, -25329, 20787, -26318, 19519, -27244, 18204,
+                -28105, 16845, -28897, 15446, -29621, 14009, -30272, 12539,
+                -30851, 11038, -31356, 9511, -31785, 7961, -32137, 6392,
+                -32412, 4807, -32609, 3211, -32727, 1607
+        },
+        /* Forward, second factor: (-sin, cos). */
+        {
+                0, 32767, 0, 32767, -32767, 0, 0, 32767, -23169, 23169, -32767,
+                0, -23169, -23169, 0, 32767, -12539, 30272, -23169, 23169,
+                -30272, 12539, -32767, 0, -30272, -12539, -23169, -23169,
+                -12539, -30272, 0, 32767, -6392, 32137, -12539, 30272, -18204,
+                27244, -23169, 23169, -27244, 18204, -30272, 12539, -32137,
+                6392, -32767, 0, -32137, -6392, -30272, -12539, -27244, -18204,
+                -23169, -23169, -18204, -27244, -12539, -30272, -6392, -32137,
+                0, 32767, -3211, 32609, -6392, 32137, -9511, 31356, -12539,
+                30272, -15446, 28897, -18204, 27244, -20787, 25329, -23169,
+                23169, -25329, 20787, -27244, 18204, -28897, 15446, -30272,
+                12539, -31356, 9511, -32137, 6392, -32609, 3211, -32767, 0,
+                -32609, -3211, -32137, -6392, -31356, -9511, -30272, -12539,
+                -28897, -15446, -27244, -18204, -25329, -20787, -23169, -23169,
+                -20787, -25329, -18204, -27244, -15446, -28897, -12539, -30272,
+                -9511, -31356, -6392, -32137, -3211, -32609, 0, 32767, -1607,
+                32727, -3211, 32609, -4807, 32412, -6392, 32137, -7961, 31785,
+                -9511, 31356, -11038, 30851, -12539, 30272, -14009, 29621,
+                -15446, 28897, -16845, 28105, -18204, 27244, -19519, 26318,
+                -20787, 25329, -22004, 24278, -23169, 23169, -24278, 22004,
+                -25329, 20787, -26318, 19519, -27244, 18204, -28105, 16845,
+                -28897, 15446, -29621, 14009, -30272, 12539, -30851, 11038,
+                -31356, 9511, -31785, 7961, -32137, 6392, -32412, 4807, -32609,
+                3211, -32727, 1607, -32767, 0, -32727, -1607, -32609, -3211,
+                -32412, -4807, -32137, -6392, -31785, -7961, -31356, -9511,
+                -30851, -11038, -30272, -12539, -29621, -14009, -28897, -15446,
+                -28105, -16845, -27244, -18204, -26318, -19519, -25329, -20787,
+                -24278, -22004, -23169, -23169, -22004, -24278, -20787, -25329,
+                -19519, -26318, -18204, -27244, -16845, -28105, -15446, -28897,
+                -14009, -29621, -12539, -30272, -11038, -30851, -9511, -31356,
+                -7961, -31785, -6392, -32137, -4807, -32412, -3211, -32609,
+                -1607, -32727
+        },
+        /* Inverse, first factor: (cos, -sin). */
+        {
+                32767, 0, 32767, 0, 0, -32767, 32767, 0, 23169, -23169, 0,
+                -32767, -23169, -23169, 32767, 0, 30272, -12539, 23169, -23169,
+                12539, -30272, 0, -32767, -12539, -30272, -23169, -23169,
+                -30272, -12539, 32767, 0, 32137, -6392, 30272, -12539, 27244,
+                -18204, 23169, -23169, 18204, -27244, 12539, -30272, 6392,
+                -32137, 0, -32767, -6392, -32137, -12539, -30272, -18204,
+                -27244, -23169, -23169, -27244, -18204, -30272, -12539, -32137,
+                -6392, 32767, 0, 32609, -3211, 32137, -6392, 31356, -9511,
+                30272, -12539, 28897, -15446, 27244, -18204, 25329, -20787,
+                23169, -23169, 20787, -25329, 18204, -27244, 15446, -28897,
+                12539, -30272, 9511, -31356, 6392, -32137, 3211, -32609, 0,
+                -32767, -3211, -32609, -6392, -32137, -9511, -31356, -12539,
+                -30272, -15446, -28897, -18204, -27244, -20787, -25329, -23169,
+                -23169, -25329, -20787, -27244, -18204, -28897, -15446, -30272,
+                -12539, -31356, -9511, -32137, -6392, -32609, -3211, 32767, 0,
+                32727, -1607, 32609, -3211, 32412, -4807, 32137, -6392, 31785,
+                -7961, 31356, -9511, 30851, -11038, 30272, -12539, 29621,
+                -14009, 28897, -15446, 28105, -16845, 27244, -18204, 26318,
+                -19519, 25329, -20787, 24278, -22004, 23169, -23169, 22004,
+                -24278, 20787, -25329, 19519, -26318, 18204, -27244, 16845,
+                -28105, 15446, -28897, 14009, -29621, 12539, -30272, 11038,
+                -30851, 9511, -31356, 7961, -31785, 6392, -32137, 4807, -32412,
+                3211, -32609, 1607, -32727, 0, -32767, -1607, -32727, -3211,
+                -32609, -4807, -32412, -6392, -32137, -7961, -31785, -9511,
+                -31356, -11038, -30851, -12539, -30272, -14009, -29621, -15446,
+                -28897, -16845, -28105, -18204, -27244, -19519, -26318, -20787,
+                -25329, -22004, -24278, -23169, -23169, -24278, -22004, -25329,
+                -20787, -26318, -19519, -27244, -18204, -28105, -16845, -28897,
+                -15446, -29621, -14009, -30272, -12539, -30851, -11038, -31356,
+                -9511, -31785, -7961, -32137, -6392, -32412, -4807, -32609,
+                -3211, -32727, -1607
+        },
+        /* Inverse, second factor: (sin, cos). */
+        {
+                0, 32767, 0, 32767, 32767, 0, 0, 32767, 23169, 23169, 32767, 0,
+                23169, -23169, 0, 32767, 12539, 30272, 23169, 23169, 30272,
+                12539, 32767, 0, 30272, -12539, 23169, -23169, 12539, -30272,
+                0, 32767, 6392, 32137, 12539, 30272, 18204, 27244, 23169,
+                23169, 27244, 18204, 30272, 12539, 32137, 6392, 32767, 0,
+                32137, -6392, 30272, -12539, 27244, -18204, 23169, -23169,
+                18204, -27244, 12539, -30272, 6392, -32137, 0, 32767, 3211,
+                32609, 6392, 32137, 9511, 31356, 12539, 30272, 15446, 28897,
+                18204, 27244, 20787, 25329, 23169, 23169, 25329, 20787, 27244,
+                18204, 28897, 15446, 30272, 12539, 31356, 9511, 32137, 6392,
+                32609, 3211, 32767, 0, 32609, -3211, 32137, -6392, 31356,
+                -9511, 30272, -12539, 28897, -15446, 27244, -18204, 25329,
+                -20787, 23169, -23169, 20787, -25329, 18204, -27244, 15446,
+                -28897, 12539, -30272, 9511, -31356, 6392, -32137, 3211,
+                -32609, 0, 32767, 1607, 32727, 3211, 32609, 4807, 32412, 6392,
+                32137, 7961, 31785, 9511, 31356, 11038, 30851, 12539, 30272,
+                14009, 29621, 15446, 28897, 16845, 28105, 18204, 27244, 19519,
+                26318, 20787, 25329, 22004, 24278, 23169, 23169, 24278, 22004,
+                25329, 20787, 26318, 19519, 27244, 18204, 28105, 16845, 28897,
+                15446, 29621, 14009, 30272, 12539, 30851, 11038, 31356, 9511,
+                31785, 7961, 32137, 6392, 32412, 4807, 32609, 3211, 32727,
+                1607, 32767, 0, 32727, -1607, 32609, -3211, 32412, -4807,
+                32137, -6392, 31785, -7961, 31356, -9511, 30851, -11038, 30272,
+                -12539, 29621, -14009, 28897, -15446, 28105, -16845, 27244,
+                -18204, 26318, -19519, 25329, -20787, 24278, -22004, 23169,
+                -23169, 22004, -24278, 20787, -25329, 19519, -26318, 18204,
+                -27244, 16845, -28105, 15446, -28897, 14009, -29621, 12539,
+                -30272, 11038, -30851, 9511, -31356, 7961, -31785, 6392,
+                -32137, 4807, -32412, 3211, -32609, 1607, -32727
+        }
+};
+
+/* Bit reversed indexes for stages == 7. */
+static const uint8_t kBitReverse128[PART_LEN2] = {
+        0, 64, 32, 96, 16, 80, 48, 112, 8, 72, 40, 104, 24, 88, 56, 120, 4, 68,
+        36, 100, 20, 84, 52, 116, 12, 76, 44, 108, 28, 92, 60, 124, 2, 66, 34,
+        98, 18, 82, 50, 114, 10, 74, 42, 106, 26, 90, 58, 122, 6, 70, 38, 102,
+        22, 86, 54, 118, 14, 78, 46, 110, 30, 94, 62, 126, 1, 65, 33, 97, 17,
+        81, 49, 113, 9, 73, 41, 105, 25, 89, 57, 121, 5, 69, 37, 101, 21, 85,
+        53, 117, 13, 77, 45, 109, 29, 93, 61, 125, 3, 67, 35, 99, 19, 83, 51,
+        115, 11, 75, 43, 107, 27, 91, 59, 123, 7, 71, 39, 103, 23, 87, 55, 119,
+        15, 79, 47, 111, 31, 95, 63, 127
+};
+
 int WebRtcSpl_ComplexFFT(int16_t frfi[], int stages, int mode) {
     int i, j, l, k, istep, n, m;
     int16_t wr, wi;
@@ -3841,26 +4044,6 @@ int WebRtcSpl_ComplexFFT(int16_t frfi[], int stages, int mode) {
     return 0;
 }
 
-int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t *vector, size_t length) {
-    size_t i = 0;
-    int absolute = 0, maximum = 0;
-
-    for (i = 0; i < length; i++) {
-        absolute = abs((int) vector[i]);
-
-        if (absolute > maximum) {
-            maximum = absolute;
-        }
-    }
-
-    // Guard the case for abs(-32768).
-    if (maximum > 32767) {
-        maximum = 32767;
-    }
-
-    return (int16_t) maximum;
-}
-
 int WebRtcSpl_ComplexIFFT(int16_t frfi[], int stages, int mode) {
     size_t i, j, l, istep, n, m;
     int k, scale, shift;
@@ -3886,7 +4069,7 @@ int WebRtcSpl_ComplexIFFT(int16_t frfi[], int stages, int mode) {
         shift = 0;
         round2 = 8192;
 
-        tmp32 = WebRtcSpl_MaxAbsValueW16C(frfi, 2 * n);
+        tmp32 = WebRtcSpl_MaxAbsValueW16(frfi, 2 * n);
         if (tmp32 > 13573) {
             shift++;
             scale++;
@@ -3993,17 +4176,48 @@ int WebRtcSpl_ComplexIFFT(int16_t frfi[], int stages, int mode) {
     return scale;
 }
 
+static int ComplexFFT128C(int16_t *frfi) {
+    return WebRtcSpl_ComplexFFT(frfi, PART_LEN_SHIFT, 1);
+}
+
+static int ComplexIFFT128C(int16_t *frfi) {
+    return WebRtcSpl_ComplexIFFT(frfi, PART_LEN_SHIFT, 1);
+}
+
+// Declare function pointers.
+ComplexFFT128 WebRtcAecm_ComplexFFT128 = ComplexFFT128C;
+ComplexFFT128 WebRtcAecm_ComplexIFFT128 = ComplexIFFT128C;
+
+// Initialize the function pointers of the 128-point FFTs. Only called once,
+// through once().
+static void InitRealFFTFunctions(void) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuAVX2) {
+        WebRtcAecm_ComplexFFT128 = WebRtcAecm_ComplexFFT128AVX2;
+        WebRtcAecm_ComplexIFFT128 = WebRtcAecm_ComplexIFFT128AVX2;
+    } else if (features & kSplCpuSSE2) {
+        WebRtcAecm_ComplexFFT128 = WebRtcAecm_ComplexFFT128SSE2;
+        WebRtcAecm_ComplexIFFT128 = WebRtcAecm_ComplexIFFT128SSE2;
+    }
+#endif
+}
+
 struct RealFFT {
     int order;
 };
 
 struct RealFFT *WebRtcSpl_CreateRealFFT(int order) {
+    static AecmOnce lock = AECM_ONCE_INIT;
     struct RealFFT *self = NULL;
 
     if (order > kMaxFFTOrder || order < 0) {
         return NULL;
     }
 
+    once(&lock, InitRealFFTFunctions);
+
     self = malloc(sizeof(struct RealFFT));
     if (self == NULL) {
         return NULL;
@@ -4034,14 +4248,24 @@ int WebRtcSpl_RealForwardFFT(struct RealFFT *self,
     // 16-bit COMPLEX numbers, for both time and frequency data.
     int16_t complex_buffer[2 << kMaxFFTOrder];
 
-    // Insert zeros to the imaginary parts for complex forward FFT input.
-    for (i = 0, j = 0; i < n; i += 1, j += 2) {
-        complex_buffer[j] = real_data_in[i];
-        complex_buffer[j + 1] = 0;
-    };
+    if (self->order == PART_LEN_SHIFT) {
+        // Insert the samples at their bit reversed positions, with zero
+        // imaginary parts.
+        for (i = 0; i < n; i++) {
+            complex_buffer[2 * kBitReverse128[i]] = real_data_in[i];
+            complex_buffer[2 * kBitReverse128[i] + 1] = 0;
+        }
+        result = WebRtcAecm_ComplexFFT128(complex_buffer);
+    } else {
+        // Insert zeros to the imaginary parts for complex forward FFT input.
+        for (i = 0, j = 0; i < n; i += 1, j += 2) {
+            complex_buffer[j] = real_data_in[i];
+            complex_buffer[j + 1] = 0;
+        };
 
-    WebRtcSpl_ComplexBitReverse(complex_buffer, self->order);
-    result = WebRtcSpl_ComplexFFT(complex_buffer, self->order, 1);
+        WebRtcSpl_ComplexBitReverse(complex_buffer, self->order);
+        result = WebRtcSpl_ComplexFFT(complex_buffer, self->order, 1);
+    }
 
     // For real FFT output, use only the first N + 2 elements from
     // complex forward FFT.
@@ -4060,17 +4284,30 @@ int WebRtcSpl_RealInverseFFT(struct RealFFT *self,
     // Create the buffer specific to complex-valued FFT implementation.
     int16_t complex_buffer[2 << kMaxFFTOrder];
 
-    // For n-point FFT, first copy the first n + 2 elements into complex
-    // FFT, then construct the remaining n - 2 elements by real FFT's
-    // conjugate-symmetric properties.
-    memcpy(complex_buffer, complex_data_in, sizeof(int16_t) * (n + 2));
-    for (i = n + 2; i < 2 * n; i += 2) {
-        complex_buffer[i] = complex_data_in[2 * n - i];
-        complex_buffer[i + 1] = -complex_data_in[2 * n - i + 1];
-    }
+    if (self->order == PART_LEN_SHIFT) {
+        // The same, with every element written to its bit reversed position.
+        for (i = 0; i <= n / 2; i++) {
+            complex_buffer[2 * kBitReverse128[i]] = complex_data_in[2 * i];
+            complex_buffer[2 * kBitReverse128[i] + 1] = complex_data_in[2 * i + 1];
+        }
+        for (i = n / 2 + 1; i < n; i++) {
+            complex_buffer[2 * kBitReverse128[i]] = complex_data_in[2 * (n - i)];
+            complex_buffer[2 * kBitReverse128[i] + 1] = -complex_data_in[2 * (n - i) + 1];
+        }
+        result = WebRtcAecm_ComplexIFFT128(complex_buffer);
+    } else {
+        // For n-point FFT, first copy the first n + 2 elements into complex
+        // FFT, then construct the remaining n - 2 elements by real FFT's
+        // conjugate-symmetric properties.
+        memcpy(complex_buffer, complex_data_in, sizeof(int16_t) * (n + 2));
+        for (i = n + 2; i < 2 * n; i += 2) {
+            complex_buffer[i] = complex_data_in[2 * n - i];
+            complex_buffer[i + 1] = -complex_data_in[2 * n - i + 1];
+        }
 
-    WebRtcSpl_ComplexBitReverse(complex_buffer, self->order);
-    result = WebRtcSpl_ComplexIFFT(complex_buffer, self->order, 1);
+        WebRtcSpl_ComplexBitReverse(complex_buffer, self->order);
+        result = WebRtcSpl_ComplexIFFT(complex_buffer, self->order, 1);
+    }
 
     // Strip out the imaginary parts of the complex inverse FFT output.
     for (i = 0, j = 0; i < n; i += 1, j += 2) {
@@ -24,14 +24,20 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>  // size_t
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define WEBRTC_ARCH_X86_FAMILY
+#endif
+
 static const int32_t kMaxBitCountsQ9 = (32 << 9);  // 32 matching bits in Q9.
 
 typedef struct {
     // Pointer to bit counts.
     int *far_bit_counts;
-    // Binary history variables.
+    // Binary history variables. Both histories are ring buffers, delay |d| is
+    // stored at (|history_pos| + |d|) % |history_size|.
     uint32_t *binary_far_history;
     int history_size;
+    int history_pos;
 } BinaryDelayEstimatorFarend;
 
 typedef struct {
@@ -41,9 +47,11 @@ typedef struct {
     // determined at run-time.
     int32_t *bit_counts;
 
-    // Binary history variables.
+    // Binary history variables. A ring buffer, the newest spectrum is at
+    // |near_history_pos|.
     uint32_t *binary_near_history;
     int near_history_size;
+    int near_history_pos;
     int history_size;
 
     // Delay estimation variables.
@@ -256,6 +264,66 @@ void WebRtc_MeanEstimatorFix(int32_t new_value,
                              int factor,
                              int32_t *mean_value);
 
+// Function pointers for the inner loops of WebRtc_ProcessBinarySpectrum(),
+// pointed at the fastest version the CPU supports when a delay estimator is
+// created.
+//
+// Compares the |binary_vector| with all rows of the |binary_matrix| and counts
+// per row the number of bits that differ.
+//
+// Inputs:
+//      - binary_vector     : binary "vector" stored in a long
+//      - binary_matrix     : binary "matrix" stored as a vector of long
+//      - matrix_size       : size of binary "matrix"
+//
+// Output:
+//      - bit_counts        : Number of differing bits for each row
+typedef void (*BitCountComparison)(uint32_t binary_vector,
+                                   const uint32_t *binary_matrix,
+                                   int matrix_size,
+                                   int32_t *bit_counts);
+
+extern BitCountComparison WebRtc_BitCountComparison;
+
+// Finds the best (smallest) and worst (largest) of the |mean_bit_counts|. The
+// best candidate starts at kMaxBitCountsQ9 and the worst at 0, the first of
+// equal minima wins.
+//
+// Inputs:
+//      - mean_bit_counts   : Smoothed bit counts per delay
+//      - history_size      : Number of delays
+//
+// Outputs:
+//      - value_best        : Smallest value, at most kMaxBitCountsQ9
+//      - value_worst       : Largest value, at least 0
+//
+// Return value:
+//      - candidate_delay   : Index of |value_best|, -1 if no value is below
+//                            kMaxBitCountsQ9
+typedef int (*FindCandidateDelay)(const int32_t *mean_bit_counts,
+                                  int history_size,
+                                  int32_t *value_best,
+                                  int32_t *value_worst);
+
+extern FindCandidateDelay WebRtc_FindCandidateDelay;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtc_BitCountComparisonPOPCNT(uint32_t binary_vector,
+                                     const uint32_t *binary_matrix,
+                                     int matrix_size,
+                                     int32_t *bit_counts);
+
+void WebRtc_BitCountComparisonAVX2(uint32_t binary_vector,
+                                   const uint32_t *binary_matrix,
+                                   int matrix_size,
+                                   int32_t *bit_counts);
+
+int WebRtc_FindCandidateDelayAVX2(const int32_t *mean_bit_counts,
+                                  int history_size,
+                                  int32_t *value_best,
+                                  int32_t *value_worst);
+#endif
+
 // Releases the memory allocated by WebRtc_CreateDelayEstimatorFarend(...)
 void WebRtc_FreeDelayEstimatorFarend(void *handle);
 
@@ -559,7 +627,8 @@ size_t WebRtc_available_write(const RingBuffer *handle);
 #define CONV_LEN2       (CONV_LEN << 1) /* Used at startup. */
 
 /* Energy parameters */
-#define MAX_BUF_LEN     64           /* History length of energy signals. */
+#define MAX_BUF_LEN     64           /* History length of energy signals, */
+/* a power of 2. */
 #define FAR_ENERGY_MIN  1025         /* Lowest Far energy level: At least 2 */
 /* in energy. */
 #define FAR_ENERGY_DIFF 929          /* Allowed difference between max */
@@ -702,10 +771,13 @@ typedef struct {
     int16_t dfaNoisyQDomain;
     int16_t dfaNoisyQDomainOld;
 
+    // Ring buffers of the last MAX_BUF_LEN log energies, the newest one is at
+    // |logEnergyPos|.
     int16_t nearLogEnergy[MAX_BUF_LEN];
     int16_t farLogEnergy;
     int16_t echoAdaptLogEnergy[MAX_BUF_LEN];
     int16_t echoStoredLogEnergy[MAX_BUF_LEN];
+    int logEnergyPos;
 
     // The extra 16 or 32 bytes in the following buffers are for alignment based
     // Neon code.
@@ -1010,6 +1082,7 @@ void WebRtcAecm_UpdateChannel(AecmCore *aecm,
 
 extern const int16_t WebRtcAecm_kCosTable[];
 extern const int16_t WebRtcAecm_kSinTable[];
+extern const int16_t WebRtcAecm_kFft128Twiddles[4][2 * (PART_LEN2 - 1)];
 
 ///////////////////////////////////////////////////////////////////////////////
 // Some function pointers, for internal functions shared by ARM NEON and
@@ -1034,6 +1107,53 @@ typedef void (*ResetAdaptiveChannel)(AecmCore *aecm);
 
 extern ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
 
+// Computes, for every bin, the error between the nearend spectrum and the
+// echo estimate of the adaptive channel, together with the norms and Q-domain
+// shifts the NLMS update in WebRtcAecm_UpdateChannel() needs.
+//
+// Input:
+//      - aecm          : Handle of the AECM instance
+//      - far_spectrum  : Absolute value of the farend signal in Q(far_q)
+//      - far_q         : Q-domain of the farend signal
+//      - dfa           : Absolute value of the nearend signal
+//
+// Output:
+//      - error         : Nearend minus echo estimate, in a common Q-domain
+//      - zeros_far     : Norm of the farend spectrum
+//      - shift_ch_far  : Right shift of the channel before multiplication
+//      - xfa_q         : Q-domain shift of the echo estimate
+typedef void (*CalcChannelError)(AecmCore *aecm,
+                                 const uint16_t *far_spectrum,
+                                 int16_t far_q,
+                                 const uint16_t *dfa,
+                                 int32_t *error,
+                                 int32_t *zeros_far,
+                                 int32_t *shift_ch_far,
+                                 int32_t *xfa_q);
+
+extern CalcChannelError WebRtcAecm_CalcChannelError;
+
+// The complex FFT and inverse FFT of the PART_LEN2 point real FFTs, on
+// interleaved (real, imaginary) data in bit reversed order. The same as
+// WebRtcSpl_ComplexFFT() and WebRtcSpl_ComplexIFFT() with stages == 7 and
+// mode == 1, including the return value.
+typedef int (*ComplexFFT128)(int16_t *frfi);
+
+extern ComplexFFT128 WebRtcAecm_ComplexFFT128;
+extern ComplexFFT128 WebRtcAecm_ComplexIFFT128;
+
+// The C version of WebRtcAecm_CalcChannelError() for bin |i| only. Used by the
+// vector versions for the last bin and for bins where a shift is out of range.
+void WebRtcAecm_CalcChannelErrorBin(AecmCore *aecm,
+                                    const uint16_t *far_spectrum,
+                                    int16_t far_q,
+                                    const uint16_t *dfa,
+                                    int i,
+                                    int32_t *error,
+                                    int32_t *zeros_far,
+                                    int32_t *shift_ch_far,
+                                    int32_t *xfa_q);
+
 // For the above function pointers, functions for generic platforms are declared
 // and defined as static in file aecm_core.c, while those for ARM Neon platforms
 // are declared below and defined in file aecm_core_neon.c.
@@ -1052,6 +1172,53 @@ void WebRtcAecm_StoreAdaptiveChannelNeon(AecmCore* aecm,
 void WebRtcAecm_ResetAdaptiveChannelNeon(AecmCore* aecm);
 #endif
 
+// The x86 versions are defined in aecm_core_sse2.c and aecm_core_avx2.c, and
+// selected at run time by WebRtcAecm_InitCore() from the CPU features.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcAecm_CalcLinearEnergiesSSE2(AecmCore *aecm,
+                                       const uint16_t *far_spectrum,
+                                       int32_t *echo_est,
+                                       uint32_t *far_energy,
+                                       uint32_t *echo_energy_adapt,
+                                       uint32_t *echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelSSE2(AecmCore *aecm,
+                                         const uint16_t *far_spectrum,
+                                         int32_t *echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelSSE2(AecmCore *aecm);
+
+int WebRtcAecm_ComplexFFT128SSE2(int16_t *frfi);
+
+int WebRtcAecm_ComplexIFFT128SSE2(int16_t *frfi);
+
+void WebRtcAecm_CalcLinearEnergiesAVX2(AecmCore *aecm,
+                                       const uint16_t *far_spectrum,
+                                       int32_t *echo_est,
+                                       uint32_t *far_energy,
+                                       uint32_t *echo_energy_adapt,
+                                       uint32_t *echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelAVX2(AecmCore *aecm,
+                                         const uint16_t *far_spectrum,
+                                         int32_t *echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelAVX2(AecmCore *aecm);
+
+int WebRtcAecm_ComplexFFT128AVX2(int16_t *frfi);
+
+int WebRtcAecm_ComplexIFFT128AVX2(int16_t *frfi);
+
+void WebRtcAecm_CalcChannelErrorAVX2(AecmCore *aecm,
+                                     const uint16_t *far_spectrum,
+                                     int16_t far_q,
+                                     const uint16_t *dfa,
+                                     int32_t *error,
+                                     int32_t *zeros_far,
+                                     int32_t *shift_ch_far,
+                                     int32_t *xfa_q);
+#endif
+
 #if defined(MIPS32_LE)
 void WebRtcAecm_CalcLinearEnergies_mips(AecmCore* aecm,
                                         const uint16_t* far_spectrum,
@@ -0,0 +1,466 @@
+/*
+ * AVX2 versions of the AECM channel and delay estimator kernels, bit exact
+ * with the C versions in aecm.c.
+ */
+
+#include <immintrin.h>
+
+#include "aecm.h"
+
+// The signed 16-bit |a| times the unsigned 16-bit |b|, 8 lanes, the same as
+// WEBRTC_SPL_MUL_16_U16().
+static __inline __m256i MulS16U16(const int16_t *a, const uint16_t *b) {
+    const __m256i a32 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) a));
+    const __m256i b32 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) b));
+    return _mm256_mullo_epi32(a32, b32);
+}
+
+static __inline uint32_t HorizontalSum(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_srli_si128(s, 8));
+    s = _mm_add_epi32(s, _mm_srli_si128(s, 4));
+    return (uint32_t) _mm_cvtsi128_si32(s);
+}
+
+// Leading zeros of the unsigned 32-bit lanes, 32 for 0. The highest set bit is
+// isolated and its position read from the exponent of its float value.
+static __inline __m256i CountLeadingZeros(__m256i x) {
+    __m256i exponent;
+
+    x = _mm256_or_si256(x, _mm256_srli_epi32(x, 1));
+    x = _mm256_or_si256(x, _mm256_srli_epi32(x, 2));
+    x = _mm256_or_si256(x, _mm256_srli_epi32(x, 4));
+    x = _mm256_or_si256(x, _mm256_srli_epi32(x, 8));
+    x = _mm256_or_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_andnot_si256(_mm256_srli_epi32(x, 1), x);
+    // 0x80000000 converts to -2^31, which has the same exponent as 2^31.
+    exponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(x)), 23);
+    exponent = _mm256_and_si256(exponent, _mm256_set1_epi32(0xFF));
+    // A zero lane has exponent 0 and is clamped to 32.
+    return _mm256_min_epu32(_mm256_sub_epi32(_mm256_set1_epi32(127 + 31), exponent),
+                            _mm256_set1_epi32(32));
+}
+
+// WebRtcSpl_NormU32() of the 32-bit lanes.
+static __inline __m256i NormU32(__m256i x) {
+    const __m256i is_zero = _mm256_cmpeq_epi32(x, _mm256_setzero_si256());
+    return _mm256_andnot_si256(is_zero, CountLeadingZeros(x));
+}
+
+// WEBRTC_SPL_SHIFT_W32() of unsigned lanes, for shifts in [-31, 31].
+static __inline __m256i ShiftW32(__m256i x, __m256i shift) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i left = _mm256_sllv_epi32(x, _mm256_max_epi32(shift, zero));
+    const __m256i right = _mm256_srlv_epi32(x, _mm256_max_epi32(_mm256_sub_epi32(zero, shift), zero));
+    return _mm256_blendv_epi8(right, left, _mm256_cmpgt_epi32(shift, _mm256_set1_epi32(-1)));
+}
+
+void WebRtcAecm_CalcLinearEnergiesAVX2(AecmCore *aecm,
+                                       const uint16_t *far_spectrum,
+                                       int32_t *echo_est,
+                                       uint32_t *far_energy,
+                                       uint32_t *echo_energy_adapt,
+                                       uint32_t *echo_energy_stored) {
+    __m256i far_sum = _mm256_setzero_si256();
+    __m256i adapt_sum = _mm256_setzero_si256();
+    __m256i stored_sum = _mm256_setzero_si256();
+    int i;
+
+    // The sums wrap around like the 32-bit sums of the C version, so the
+    // order of the additions does not matter.
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m256i echo = MulS16U16(&aecm->channelStored[i], &far_spectrum[i]);
+        const __m256i far = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &far_spectrum[i]));
+
+        _mm256_storeu_si256((__m256i *) &echo_est[i], echo);
+        stored_sum = _mm256_add_epi32(stored_sum, echo);
+        adapt_sum = _mm256_add_epi32(adapt_sum, MulS16U16(&aecm->channelAdapt16[i], &far_spectrum[i]));
+        far_sum = _mm256_add_epi32(far_sum, far);
+    }
+    echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], far_spectrum[i]);
+
+    *far_energy += HorizontalSum(far_sum) + far_spectrum[i];
+    *echo_energy_adapt += HorizontalSum(adapt_sum) +
+                          (uint32_t) (aecm->channelAdapt16[i] * far_spectrum[i]);
+    *echo_energy_stored += HorizontalSum(stored_sum) + (uint32_t) echo_est[i];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelAVX2(AecmCore *aecm,
+                                         const uint16_t *far_spectrum,
+                                         int32_t *echo_est) {
+    int i;
+
+    // During startup we store the channel every block.
+    memcpy(aecm->channelStored, aecm->channelAdapt16, sizeof(int16_t) * PART_LEN1);
+    // Recalculate echo estimate
+    for (i = 0; i < PART_LEN; i += 8) {
+        _mm256_storeu_si256((__m256i *) &echo_est[i],
+                            MulS16U16(&aecm->channelStored[i], &far_spectrum[i]));
+    }
+    echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], far_spectrum[i]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelAVX2(AecmCore *aecm) {
+    int i;
+
+    // The stored channel has a significantly lower MSE than the adaptive one for
+    // two consecutive calculations. Reset the adaptive channel.
+    memcpy(aecm->channelAdapt16, aecm->channelStored, sizeof(int16_t) * PART_LEN1);
+    // Restore the W32 channel
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m256i stored = _mm256_cvtepi16_epi32(
+                _mm_loadu_si128((const __m128i *) &aecm->channelStored[i]));
+        _mm256_storeu_si256((__m256i *) &aecm->channelAdapt32[i], _mm256_slli_epi32(stored, 16));
+    }
+    aecm->channelAdapt32[i] = (int32_t) aecm->channelStored[i] << 16;
+}
+
+void WebRtcAecm_CalcChannelErrorAVX2(AecmCore *aecm,
+                                     const uint16_t *far_spectrum,
+                                     const int16_t far_q,
+                                     const uint16_t *dfa,
+                                     int32_t *error,
+                                     int32_t *zeros_far,
+                                     int32_t *shift_ch_far,
+                                     int32_t *xfa_q) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i max_shift = _mm256_set1_epi32(31);
+    // The Q-domain difference of the nearend and the echo estimate, without
+    // the channel shift.
+    const int q_offset = aecm->dfaNoisyQDomain - RESOLUTION_CHANNEL32 - far_q;
+    const __m256i q_offset_minus_2 = _mm256_set1_epi32(q_offset - 2);
+    const __m256i minus_q_offset = _mm256_set1_epi32(-q_offset);
+    int i, k;
+
+    // The C version does the Q-domain arithmetic in 16 bits. Far outside the
+    // Q-domains the AECM uses this could wrap, leave it to the C version.
+    if (q_offset < -1024 || q_offset > 1024) {
+        for (i = 0; i < PART_LEN1; i++) {
+            WebRtcAecm_CalcChannelErrorBin(aecm, far_spectrum, far_q, dfa, i,
+                                           error, zeros_far, shift_ch_far, xfa_q);
+        }
+        return;
+    }
+
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m256i ch = _mm256_loadu_si256((const __m256i *) &aecm->channelAdapt32[i]);
+        const __m256i far = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &far_spectrum[i]));
+        const __m256i near = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) &dfa[i]));
+        __m256i zeros_ch, zeros_far_v, zeros_sum, shift_ch_far_v, product;
+        __m256i zeros_num, zeros_dfa, tmp16no1, use_tmp, xfa_q_v, dfa_q_v, out_of_range;
+
+        // Determine norm of channel and farend to make sure we don't get
+        // overflow in multiplication. A right shift of 32 or more gives 0.
+        zeros_ch = NormU32(ch);
+        zeros_far_v = NormU32(far);
+        zeros_sum = _mm256_add_epi32(zeros_ch, zeros_far_v);
+        shift_ch_far_v = _mm256_andnot_si256(_mm256_cmpgt_epi32(zeros_sum, max_shift),
+                                             _mm256_sub_epi32(_mm256_set1_epi32(32), zeros_sum));
+        product = _mm256_andnot_si256(_mm256_cmpgt_epi32(shift_ch_far_v, max_shift),
+                                      _mm256_srav_epi32(ch, shift_ch_far_v));
+        product = _mm256_mullo_epi32(product, far);
+
+        // Determine Q-domain of numerator
+        zeros_num = NormU32(product);
+        zeros_dfa = CountLeadingZeros(near);
+        tmp16no1 = _mm256_add_epi32(_mm256_add_epi32(zeros_dfa, shift_ch_far_v), q_offset_minus_2);
+        use_tmp = _mm256_cmpgt_epi32(zeros_num, _mm256_add_epi32(tmp16no1, one));
+        xfa_q_v = _mm256_blendv_epi8(_mm256_sub_epi32(zeros_num, two), tmp16no1, use_tmp);
+        dfa_q_v = _mm256_blendv_epi8(
+                _mm256_add_epi32(_mm256_sub_epi32(xfa_q_v, shift_ch_far_v), minus_q_offset),
+                _mm256_sub_epi32(zeros_dfa, two), use_tmp);
+
+        // Shifts of 32 or more are undefined in C, use the C version so the
+        // result stays the same.
+        out_of_range = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_abs_epi32(xfa_q_v), max_shift),
+                                       _mm256_cmpgt_epi32(_mm256_abs_epi32(dfa_q_v), max_shift));
+        if (!_mm256_testz_si256(out_of_range, out_of_range)) {
+            for (k = i; k < i + 8; k++) {
+                WebRtcAecm_CalcChannelErrorBin(aecm, far_spectrum, far_q, dfa, k,
+                                               error, zeros_far, shift_ch_far, xfa_q);
+            }
+            continue;
+        }
+
+        // Add in the same Q-domain
+        _mm256_storeu_si256((__m256i *) &error[i],
+                            _mm256_sub_epi32(ShiftW32(near, dfa_q_v), ShiftW32(product, xfa_q_v)));
+        _mm256_storeu_si256((__m256i *) &zeros_far[i], zeros_far_v);
+        _mm256_storeu_si256((__m256i *) &shift_ch_far[i], shift_ch_far_v);
+        _mm256_storeu_si256((__m256i *) &xfa_q[i], xfa_q_v);
+    }
+    WebRtcAecm_CalcChannelErrorBin(aecm, far_spectrum, far_q, dfa, i,
+                                   error, zeros_far, shift_ch_far, xfa_q);
+}
+
+// Number of set bits of the 32-bit lanes. Each nibble is looked up in a table
+// of bit counts, then the bytes of every lane are added up.
+static __inline __m256i BitCount(__m256i x) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    const __m256i counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(table, _mm256_and_si256(x, low_nibble)),
+            _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibble)));
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(counts, _mm256_set1_epi8(1)),
+                             _mm256_set1_epi16(1));
+}
+
+void WebRtc_BitCountComparisonAVX2(uint32_t binary_vector,
+                                   const uint32_t *binary_matrix,
+                                   int matrix_size,
+                                   int32_t *bit_counts) {
+    const __m256i vector = _mm256_set1_epi32((int32_t) binary_vector);
+    int n = 0;
+
+    // Compare |binary_vector| with 16 rows of the |binary_matrix| at a time
+    for (; n + 16 <= matrix_size; n += 16) {
+        const __m256i rows0 = _mm256_loadu_si256((const __m256i *) &binary_matrix[n]);
+        const __m256i rows1 = _mm256_loadu_si256((const __m256i *) &binary_matrix[n + 8]);
+        _mm256_storeu_si256((__m256i *) &bit_counts[n], BitCount(_mm256_xor_si256(vector, rows0)));
+        _mm256_storeu_si256((__m256i *) &bit_counts[n + 8], BitCount(_mm256_xor_si256(vector, rows1)));
+    }
+    for (; n + 8 <= matrix_size; n += 8) {
+        const __m256i rows = _mm256_loadu_si256((const __m256i *) &binary_matrix[n]);
+        _mm256_storeu_si256((__m256i *) &bit_counts[n], BitCount(_mm256_xor_si256(vector, rows)));
+    }
+    for (; n < matrix_size; n++) {
+        bit_counts[n] = (int32_t) _mm_popcnt_u32(binary_vector ^ binary_matrix[n]);
+    }
+}
+
+static __inline int32_t HorizontalMin(__m256i v) {
+    __m128i s = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_min_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_min_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+static __inline int32_t HorizontalMax(__m256i v) {
+    __m128i s = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_max_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_max_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+int WebRtc_FindCandidateDelayAVX2(const int32_t *mean_bit_counts,
+                                  int history_size,
+                                  int32_t *value_best,
+                                  int32_t *value_worst) {
+    __m256i best = _mm256_set1_epi32(kMaxBitCountsQ9);
+    __m256i worst = _mm256_setzero_si256();
+    int32_t best_value, worst_value;
+    int i = 0;
+    int k;
+
+    // Find the extremes first, then the first position of the minimum.
+    for (; i + 8 <= history_size; i += 8) {
+        const __m256i values = _mm256_loadu_si256((const __m256i *) &mean_bit_counts[i]);
+        best = _mm256_min_epi32(best, values);
+        worst = _mm256_max_epi32(worst, values);
+    }
+    best_value = HorizontalMin(best);
+    worst_value = HorizontalMax(worst);
+    for (; i < history_size; i++) {
+        if (mean_bit_counts[i] < best_value) {
+            best_value = mean_bit_counts[i];
+        }
+        if (mean_bit_counts[i] > worst_value) {
+            worst_value = mean_bit_counts[i];
+        }
+    }
+    *value_best = best_value;
+    *value_worst = worst_value;
+    if (best_value == kMaxBitCountsQ9) {
+        // Nothing below the start value.
+        return -1;
+    }
+
+    best = _mm256_set1_epi32(best_value);
+    for (i = 0; i + 8 <= history_size; i += 8) {
+        const __m256i values = _mm256_loadu_si256((const __m256i *) &mean_bit_counts[i]);
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(values, best)));
+        if (mask) {
+            for (k = 0; !(mask & (1 << k)); k++) {
+            }
+            return i + k;
+        }
+    }
+    for (; mean_bit_counts[i] != best_value; i++) {
+    }
+    return i;
+}
+
+// One radix-2 butterfly on 8 complex values of |x_i| and |x_j| each, the same
+// arithmetic as WebRtcSpl_ComplexFFT() and WebRtcSpl_ComplexIFFT() in mode 1,
+// see aecm_core_sse2.c.
+static __inline void Butterfly(__m256i *x_i, __m256i *x_j, __m256i a, __m256i b,
+                               __m256i round, __m128i shift) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i low_mask = _mm256_set1_epi32(0xFFFF);
+    const __m256i tr = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(*x_j, a), one), 1);
+    const __m256i ti = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(*x_j, b), one), 1);
+    // The real and imaginary parts of |x_i| in Q14.
+    const __m256i qr = _mm256_srai_epi32(_mm256_slli_epi32(*x_i, 16), 2);
+    const __m256i qi = _mm256_srai_epi32(_mm256_andnot_si256(low_mask, *x_i), 2);
+    // Like the C version, the results are truncated to 16 bits.
+    const __m256i jr = _mm256_sra_epi32(_mm256_add_epi32(_mm256_sub_epi32(qr, tr), round), shift);
+    const __m256i ji = _mm256_sra_epi32(_mm256_add_epi32(_mm256_sub_epi32(qi, ti), round), shift);
+    const __m256i ir = _mm256_sra_epi32(_mm256_add_epi32(_mm256_add_epi32(qr, tr), round), shift);
+    const __m256i ii = _mm256_sra_epi32(_mm256_add_epi32(_mm256_add_epi32(qi, ti), round), shift);
+
+    *x_j = _mm256_or_si256(_mm256_and_si256(jr, low_mask), _mm256_slli_epi32(ji, 16));
+    *x_i = _mm256_or_si256(_mm256_and_si256(ir, low_mask), _mm256_slli_epi32(ii, 16));
+}
+
+// Largest absolute value of the 16-bit values seen so far, abs(-32768) is
+// saturated to 32767 like in WebRtcSpl_MaxAbsValueW16().
+static __inline __m256i MaxAbs(__m256i max_abs, __m256i x) {
+    return _mm256_max_epi16(max_abs, _mm256_max_epi16(x, _mm256_subs_epi16(_mm256_setzero_si256(), x)));
+}
+
+static __inline int16_t HorizontalMaxW16(__m256i v) {
+    __m128i s = _mm_max_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_max_epi16(s, _mm_srli_si128(s, 8));
+    s = _mm_max_epi16(s, _mm_srli_si128(s, 4));
+    s = _mm_max_epi16(s, _mm_srli_si128(s, 2));
+    return (int16_t) _mm_cvtsi128_si32(s);
+}
+
+// One FFT stage with butterfly span |l|, over all PART_LEN2 complex values.
+// Returns the largest absolute output value if |track_max| is set.
+static int16_t Stage(int16_t *frfi, int l, const int16_t *table_a, const int16_t *table_b,
+                     __m256i round, __m128i shift, int track_max) {
+    __m256i max_abs = _mm256_setzero_si256();
+    __m256i *data = (__m256i *) frfi;
+    __m256i x_i, x_j;
+    int s, m;
+
+    if (l <= 4) {
+        // Spans shorter than a register, the butterflies pair values of two
+        // registers after a shuffle. The same factors repeat in every group.
+        __m256i a, b;
+        if (l == 1) {
+            a = _mm256_broadcastd_epi32(_mm_loadl_epi64((const __m128i *) table_a));
+            b = _mm256_broadcastd_epi32(_mm_loadl_epi64((const __m128i *) table_b));
+        } else if (l == 2) {
+            a = _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i *) &table_a[2]));
+            b = _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i *) &table_b[2]));
+        } else {
+            a = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) &table_a[6]));
+            b = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) &table_b[6]));
+        }
+        for (s = 0; s < PART_LEN2 / 8; s += 2) {
+            const __m256i lo = _mm256_loadu_si256(&data[s]);
+            const __m256i hi = _mm256_loadu_si256(&data[s + 1]);
+            if (l == 1) {
+                x_i = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi),
+                                                            _MM_SHUFFLE(2, 0, 2, 0)));
+                x_j = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi),
+                                                            _MM_SHUFFLE(3, 1, 3, 1)));
+                Butterfly(&x_i, &x_j, a, b, round, shift);
+                _mm256_storeu_si256(&data[s], _mm256_unpacklo_epi32(x_i, x_j));
+                _mm256_storeu_si256(&data[s + 1], _mm256_unpackhi_epi32(x_i, x_j));
+            } else if (l == 2) {
+                x_i = _mm256_unpacklo_epi64(lo, hi);
+                x_j = _mm256_unpackhi_epi64(lo, hi);
+                Butterfly(&x_i, &x_j, a, b, round, shift);
+                _mm256_storeu_si256(&data[s], _mm256_unpacklo_epi64(x_i, x_j));
+                _mm256_storeu_si256(&data[s + 1], _mm256_unpackhi_epi64(x_i, x_j));
+            } else {
+                x_i = _mm256_permute2x128_si256(lo, hi, 0x20);
+                x_j = _mm256_permute2x128_si256(lo, hi, 0x31);
+                Butterfly(&x_i, &x_j, a, b, round, shift);
+                _mm256_storeu_si256(&data[s], _mm256_permute2x128_si256(x_i, x_j, 0x20));
+                _mm256_storeu_si256(&data[s + 1], _mm256_permute2x128_si256(x_i, x_j, 0x31));
+            }
+            if (track_max) {
+                max_abs = MaxAbs(MaxAbs(max_abs, x_i), x_j);
+            }
+        }
+    } else {
+        for (s = 0; s < PART_LEN2; s += 2 * l) {
+            for (m = 0; m < l; m += 8) {
+                const __m256i a = _mm256_loadu_si256((const __m256i *) &table_a[2 * (l - 1 + m)]);
+                const __m256i b = _mm256_loadu_si256((const __m256i *) &table_b[2 * (l - 1 + m)]);
+                x_i = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m)]);
+                x_j = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m + l)]);
+                Butterfly(&x_i, &x_j, a, b, round, shift);
+                _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m)], x_i);
+                _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m + l)], x_j);
+                if (track_max) {
+                    max_abs = MaxAbs(MaxAbs(max_abs, x_i), x_j);
+                }
+            }
+        }
+    }
+    return HorizontalMaxW16(max_abs);
+}
+
+// The stages with butterfly span |l| and 2 * |l| in one radix-4 pass, forward
+// FFT only, see aecm_core_sse2.c.
+static void FusedStages(int16_t *frfi, int l, const int16_t *table_a, const int16_t *table_b,
+                        __m256i round, __m128i shift) {
+    int s, m;
+
+    for (s = 0; s < PART_LEN2; s += 4 * l) {
+        for (m = 0; m < l; m += 8) {
+            const __m256i a1 = _mm256_loadu_si256((const __m256i *) &table_a[2 * (l - 1 + m)]);
+            const __m256i b1 = _mm256_loadu_si256((const __m256i *) &table_b[2 * (l - 1 + m)]);
+            const __m256i a2 = _mm256_loadu_si256((const __m256i *) &table_a[2 * (2 * l - 1 + m)]);
+            const __m256i b2 = _mm256_loadu_si256((const __m256i *) &table_b[2 * (2 * l - 1 + m)]);
+            const __m256i a3 = _mm256_loadu_si256((const __m256i *) &table_a[2 * (3 * l - 1 + m)]);
+            const __m256i b3 = _mm256_loadu_si256((const __m256i *) &table_b[2 * (3 * l - 1 + m)]);
+            __m256i x0 = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m)]);
+            __m256i x1 = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m + l)]);
+            __m256i x2 = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m + 2 * l)]);
+            __m256i x3 = _mm256_loadu_si256((const __m256i *) &frfi[2 * (s + m + 3 * l)]);
+
+            Butterfly(&x0, &x1, a1, b1, round, shift);
+            Butterfly(&x2, &x3, a1, b1, round, shift);
+            Butterfly(&x0, &x2, a2, b2, round, shift);
+            Butterfly(&x1, &x3, a3, b3, round, shift);
+            _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m)], x0);
+            _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m + l)], x1);
+            _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m + 2 * l)], x2);
+            _mm256_storeu_si256((__m256i *) &frfi[2 * (s + m + 3 * l)], x3);
+        }
+    }
+}
+
+int WebRtcAecm_ComplexFFT128AVX2(int16_t *frfi) {
+    const int16_t *table_a = WebRtcAecm_kFft128Twiddles[0];
+    const int16_t *table_b = WebRtcAecm_kFft128Twiddles[1];
+    const __m256i round = _mm256_set1_epi32(16384);
+    const __m128i shift = _mm_cvtsi32_si128(15);
+
+    Stage(frfi, 1, table_a, table_b, round, shift, 0);
+    Stage(frfi, 2, table_a, table_b, round, shift, 0);
+    Stage(frfi, 4, table_a, table_b, round, shift, 0);
+    FusedStages(frfi, 8, table_a, table_b, round, shift);
+    FusedStages(frfi, 32, table_a, table_b, round, shift);
+    return 0;
+}
+
+int WebRtcAecm_ComplexIFFT128AVX2(int16_t *frfi) {
+    const int16_t *table_a = WebRtcAecm_kFft128Twiddles[2];
+    const int16_t *table_b = WebRtcAecm_kFft128Twiddles[3];
+    __m256i max_abs = _mm256_setzero_si256();
+    int16_t max_value;
+    int scale = 0;
+    int l, i;
+
+    for (i = 0; i < PART_LEN2 * 2; i += 16) {
+        max_abs = MaxAbs(max_abs, _mm256_loadu_si256((const __m256i *) &frfi[i]));
+    }
+    max_value = HorizontalMaxW16(max_abs);
+    for (l = 1; l < PART_LEN2; l <<= 1) {
+        // Variable scaling, depending upon data
+        const int shift = (max_value > 13573) + (max_value > 27146);
+        scale += shift;
+        max_value = Stage(frfi, l, table_a, table_b, _mm256_set1_epi32(8192 << shift),
+                          _mm_cvtsi32_si128(14 + shift), 1);
+    }
+    return scale;
+}
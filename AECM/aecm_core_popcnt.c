@@ -0,0 +1,20 @@
+/*
+ * POPCNT version of the delay estimator bit count comparison, bit exact with
+ * the C version in aecm.c.
+ */
+
+#include <nmmintrin.h>
+
+#include "aecm.h"
+
+void WebRtc_BitCountComparisonPOPCNT(uint32_t binary_vector,
+                                     const uint32_t *binary_matrix,
+                                     int matrix_size,
+                                     int32_t *bit_counts) {
+    int n = 0;
+
+    // Compare |binary_vector| with all rows of the |binary_matrix|
+    for (; n < matrix_size; n++) {
+        bit_counts[n] = (int32_t) _mm_popcnt_u32(binary_vector ^ binary_matrix[n]);
+    }
+}
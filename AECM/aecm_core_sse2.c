@@ -0,0 +1,267 @@
+/*
+ * SSE2 versions of the AECM channel kernels, bit exact with the C versions in
+ * aecm.c.
+ */
+
+#include <emmintrin.h>
+
+#include "aecm.h"
+
+// Multiplies the signed 16-bit |a| with the unsigned 16-bit |b| into two
+// vectors of 32-bit products, the same as WEBRTC_SPL_MUL_16_U16().
+static __inline void MulS16U16(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+    const __m128i low = _mm_mullo_epi16(a, b);
+    // The unsigned high half is off by |b| for negative |a|.
+    const __m128i high = _mm_sub_epi16(_mm_mulhi_epu16(a, b),
+                                       _mm_and_si128(_mm_srai_epi16(a, 15), b));
+    *lo = _mm_unpacklo_epi16(low, high);
+    *hi = _mm_unpackhi_epi16(low, high);
+}
+
+static __inline uint32_t HorizontalSum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+    return (uint32_t) _mm_cvtsi128_si32(v);
+}
+
+void WebRtcAecm_CalcLinearEnergiesSSE2(AecmCore *aecm,
+                                       const uint16_t *far_spectrum,
+                                       int32_t *echo_est,
+                                       uint32_t *far_energy,
+                                       uint32_t *echo_energy_adapt,
+                                       uint32_t *echo_energy_stored) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i far_sum = zero;
+    __m128i adapt_sum = zero;
+    __m128i stored_sum = zero;
+    __m128i lo, hi;
+    int i;
+
+    // The sums wrap around like the 32-bit sums of the C version, so the
+    // order of the additions does not matter.
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m128i far = _mm_loadu_si128((const __m128i *) &far_spectrum[i]);
+        const __m128i stored = _mm_loadu_si128((const __m128i *) &aecm->channelStored[i]);
+        const __m128i adapt = _mm_loadu_si128((const __m128i *) &aecm->channelAdapt16[i]);
+
+        MulS16U16(stored, far, &lo, &hi);
+        _mm_storeu_si128((__m128i *) &echo_est[i], lo);
+        _mm_storeu_si128((__m128i *) &echo_est[i + 4], hi);
+        stored_sum = _mm_add_epi32(stored_sum, _mm_add_epi32(lo, hi));
+
+        MulS16U16(adapt, far, &lo, &hi);
+        adapt_sum = _mm_add_epi32(adapt_sum, _mm_add_epi32(lo, hi));
+
+        far_sum = _mm_add_epi32(far_sum, _mm_add_epi32(_mm_unpacklo_epi16(far, zero),
+                                                       _mm_unpackhi_epi16(far, zero)));
+    }
+    echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], far_spectrum[i]);
+
+    *far_energy += HorizontalSum(far_sum) + far_spectrum[i];
+    *echo_energy_adapt += HorizontalSum(adapt_sum) +
+                          (uint32_t) (aecm->channelAdapt16[i] * far_spectrum[i]);
+    *echo_energy_stored += HorizontalSum(stored_sum) + (uint32_t) echo_est[i];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelSSE2(AecmCore *aecm,
+                                         const uint16_t *far_spectrum,
+                                         int32_t *echo_est) {
+    __m128i lo, hi;
+    int i;
+
+    // During startup we store the channel every block.
+    memcpy(aecm->channelStored, aecm->channelAdapt16, sizeof(int16_t) * PART_LEN1);
+    // Recalculate echo estimate
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m128i far = _mm_loadu_si128((const __m128i *) &far_spectrum[i]);
+        const __m128i stored = _mm_loadu_si128((const __m128i *) &aecm->channelStored[i]);
+
+        MulS16U16(stored, far, &lo, &hi);
+        _mm_storeu_si128((__m128i *) &echo_est[i], lo);
+        _mm_storeu_si128((__m128i *) &echo_est[i + 4], hi);
+    }
+    echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], far_spectrum[i]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelSSE2(AecmCore *aecm) {
+    const __m128i zero = _mm_setzero_si128();
+    int i;
+
+    // The stored channel has a significantly lower MSE than the adaptive one for
+    // two consecutive calculations. Reset the adaptive channel.
+    memcpy(aecm->channelAdapt16, aecm->channelStored, sizeof(int16_t) * PART_LEN1);
+    // Restore the W32 channel, interleaving with zeros shifts up by 16.
+    for (i = 0; i < PART_LEN; i += 8) {
+        const __m128i stored = _mm_loadu_si128((const __m128i *) &aecm->channelStored[i]);
+
+        _mm_storeu_si128((__m128i *) &aecm->channelAdapt32[i], _mm_unpacklo_epi16(zero, stored));
+        _mm_storeu_si128((__m128i *) &aecm->channelAdapt32[i + 4], _mm_unpackhi_epi16(zero, stored));
+    }
+    aecm->channelAdapt32[i] = (int32_t) aecm->channelStored[i] << 16;
+}
+
+// One radix-2 butterfly on 4 complex values of |x_i| and |x_j| each, the same
+// arithmetic as WebRtcSpl_ComplexFFT() and WebRtcSpl_ComplexIFFT() in mode 1:
+// the product with the twiddle factor is halved with rounding, the outputs are
+// rounded with |round| and shifted down by |shift|. |a| and |b| hold the two
+// factors of WebRtcAecm_kFft128Twiddles for every complex value.
+static __inline void Butterfly(__m128i *x_i, __m128i *x_j, __m128i a, __m128i b,
+                               __m128i round, __m128i shift) {
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i low_mask = _mm_set1_epi32(0xFFFF);
+    const __m128i tr = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(*x_j, a), one), 1);
+    const __m128i ti = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(*x_j, b), one), 1);
+    // The real and imaginary parts of |x_i| in Q14.
+    const __m128i qr = _mm_srai_epi32(_mm_slli_epi32(*x_i, 16), 2);
+    const __m128i qi = _mm_srai_epi32(_mm_andnot_si128(low_mask, *x_i), 2);
+    // Like the C version, the results are truncated to 16 bits.
+    const __m128i jr = _mm_sra_epi32(_mm_add_epi32(_mm_sub_epi32(qr, tr), round), shift);
+    const __m128i ji = _mm_sra_epi32(_mm_add_epi32(_mm_sub_epi32(qi, ti), round), shift);
+    const __m128i ir = _mm_sra_epi32(_mm_add_epi32(_mm_add_epi32(qr, tr), round), shift);
+    const __m128i ii = _mm_sra_epi32(_mm_add_epi32(_mm_add_epi32(qi, ti), round), shift);
+
+    *x_j = _mm_or_si128(_mm_and_si128(jr, low_mask), _mm_slli_epi32(ji, 16));
+    *x_i = _mm_or_si128(_mm_and_si128(ir, low_mask), _mm_slli_epi32(ii, 16));
+}
+
+// Largest absolute value of the 16-bit values seen so far, abs(-32768) is
+// saturated to 32767 like in WebRtcSpl_MaxAbsValueW16().
+static __inline __m128i MaxAbs(__m128i max_abs, __m128i x) {
+    return _mm_max_epi16(max_abs, _mm_max_epi16(x, _mm_subs_epi16(_mm_setzero_si128(), x)));
+}
+
+static __inline int16_t HorizontalMax(__m128i v) {
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+    return (int16_t) _mm_cvtsi128_si32(v);
+}
+
+// One FFT stage with butterfly span |l|, over all PART_LEN2 complex values.
+// Returns the largest absolute output value if |track_max| is set.
+static int16_t Stage(int16_t *frfi, int l, const int16_t *table_a, const int16_t *table_b,
+                     __m128i round, __m128i shift, int track_max) {
+    __m128i max_abs = _mm_setzero_si128();
+    __m128i *data = (__m128i *) frfi;
+    int s, m;
+
+    if (l == 1) {
+        // Neighbouring values are paired, all with the same factor.
+        const __m128i a = _mm_shuffle_epi32(_mm_loadl_epi64((const __m128i *) table_a), 0);
+        const __m128i b = _mm_shuffle_epi32(_mm_loadl_epi64((const __m128i *) table_b), 0);
+        for (s = 0; s < PART_LEN2 / 4; s += 2) {
+            const __m128 lo = _mm_castsi128_ps(_mm_loadu_si128(&data[s]));
+            const __m128 hi = _mm_castsi128_ps(_mm_loadu_si128(&data[s + 1]));
+            __m128i x_i = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+            __m128i x_j = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+            Butterfly(&x_i, &x_j, a, b, round, shift);
+            _mm_storeu_si128(&data[s], _mm_unpacklo_epi32(x_i, x_j));
+            _mm_storeu_si128(&data[s + 1], _mm_unpackhi_epi32(x_i, x_j));
+            if (track_max) {
+                max_abs = MaxAbs(MaxAbs(max_abs, x_i), x_j);
+            }
+        }
+    } else if (l == 2) {
+        // Values 0, 1 are paired with 2, 3 in every group of 4.
+        const __m128i a = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *) &table_a[2]),
+                                             _mm_loadl_epi64((const __m128i *) &table_a[2]));
+        const __m128i b = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *) &table_b[2]),
+                                             _mm_loadl_epi64((const __m128i *) &table_b[2]));
+        for (s = 0; s < PART_LEN2 / 4; s += 2) {
+            const __m128i lo = _mm_loadu_si128(&data[s]);
+            const __m128i hi = _mm_loadu_si128(&data[s + 1]);
+            __m128i x_i = _mm_unpacklo_epi64(lo, hi);
+            __m128i x_j = _mm_unpackhi_epi64(lo, hi);
+            Butterfly(&x_i, &x_j, a, b, round, shift);
+            _mm_storeu_si128(&data[s], _mm_unpacklo_epi64(x_i, x_j));
+            _mm_storeu_si128(&data[s + 1], _mm_unpackhi_epi64(x_i, x_j));
+            if (track_max) {
+                max_abs = MaxAbs(MaxAbs(max_abs, x_i), x_j);
+            }
+        }
+    } else {
+        for (s = 0; s < PART_LEN2; s += 2 * l) {
+            for (m = 0; m < l; m += 4) {
+                const __m128i a = _mm_loadu_si128((const __m128i *) &table_a[2 * (l - 1 + m)]);
+                const __m128i b = _mm_loadu_si128((const __m128i *) &table_b[2 * (l - 1 + m)]);
+                __m128i x_i = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m)]);
+                __m128i x_j = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m + l)]);
+                Butterfly(&x_i, &x_j, a, b, round, shift);
+                _mm_storeu_si128((__m128i *) &frfi[2 * (s + m)], x_i);
+                _mm_storeu_si128((__m128i *) &frfi[2 * (s + m + l)], x_j);
+                if (track_max) {
+                    max_abs = MaxAbs(MaxAbs(max_abs, x_i), x_j);
+                }
+            }
+        }
+    }
+    return HorizontalMax(max_abs);
+}
+
+// The stages with butterfly span |l| and 2 * |l| in one pass, a radix-4 step
+// that keeps the intermediate values in registers. Forward FFT only, the
+// inverse FFT picks the scaling of every stage from the data.
+static void FusedStages(int16_t *frfi, int l, const int16_t *table_a, const int16_t *table_b,
+                        __m128i round, __m128i shift) {
+    int s, m;
+
+    for (s = 0; s < PART_LEN2; s += 4 * l) {
+        for (m = 0; m < l; m += 4) {
+            const __m128i a1 = _mm_loadu_si128((const __m128i *) &table_a[2 * (l - 1 + m)]);
+            const __m128i b1 = _mm_loadu_si128((const __m128i *) &table_b[2 * (l - 1 + m)]);
+            const __m128i a2 = _mm_loadu_si128((const __m128i *) &table_a[2 * (2 * l - 1 + m)]);
+            const __m128i b2 = _mm_loadu_si128((const __m128i *) &table_b[2 * (2 * l - 1 + m)]);
+            const __m128i a3 = _mm_loadu_si128((const __m128i *) &table_a[2 * (3 * l - 1 + m)]);
+            const __m128i b3 = _mm_loadu_si128((const __m128i *) &table_b[2 * (3 * l - 1 + m)]);
+            __m128i x0 = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m)]);
+            __m128i x1 = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m + l)]);
+            __m128i x2 = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m + 2 * l)]);
+            __m128i x3 = _mm_loadu_si128((const __m128i *) &frfi[2 * (s + m + 3 * l)]);
+
+            Butterfly(&x0, &x1, a1, b1, round, shift);
+            Butterfly(&x2, &x3, a1, b1, round, shift);
+            Butterfly(&x0, &x2, a2, b2, round, shift);
+            Butterfly(&x1, &x3, a3, b3, round, shift);
+            _mm_storeu_si128((__m128i *) &frfi[2 * (s + m)], x0);
+            _mm_storeu_si128((__m128i *) &frfi[2 * (s + m + l)], x1);
+            _mm_storeu_si128((__m128i *) &frfi[2 * (s + m + 2 * l)], x2);
+            _mm_storeu_si128((__m128i *) &frfi[2 * (s + m + 3 * l)], x3);
+        }
+    }
+}
+
+int WebRtcAecm_ComplexFFT128SSE2(int16_t *frfi) {
+    const int16_t *table_a = WebRtcAecm_kFft128Twiddles[0];
+    const int16_t *table_b = WebRtcAecm_kFft128Twiddles[1];
+    const __m128i round = _mm_set1_epi32(16384);
+    const __m128i shift = _mm_cvtsi32_si128(15);
+
+    Stage(frfi, 1, table_a, table_b, round, shift, 0);
+    Stage(frfi, 2, table_a, table_b, round, shift, 0);
+    FusedStages(frfi, 4, table_a, table_b, round, shift);
+    FusedStages(frfi, 16, table_a, table_b, round, shift);
+    Stage(frfi, 64, table_a, table_b, round, shift, 0);
+    return 0;
+}
+
+int WebRtcAecm_ComplexIFFT128SSE2(int16_t *frfi) {
+    const int16_t *table_a = WebRtcAecm_kFft128Twiddles[2];
+    const int16_t *table_b = WebRtcAecm_kFft128Twiddles[3];
+    __m128i max_abs = _mm_setzero_si128();
+    int16_t max_value;
+    int scale = 0;
+    int l, i;
+
+    for (i = 0; i < PART_LEN2 * 2; i += 8) {
+        max_abs = MaxAbs(max_abs, _mm_loadu_si128((const __m128i *) &frfi[i]));
+    }
+    max_value = HorizontalMax(max_abs);
+    for (l = 1; l < PART_LEN2; l <<= 1) {
+        // Variable scaling, depending upon data
+        const int shift = (max_value > 13573) + (max_value > 27146);
+        scale += shift;
+        max_value = Stage(frfi, l, table_a, table_b, _mm_set1_epi32(8192 << shift),
+                          _mm_cvtsi32_si128(14 + shift), 1);
+    }
+    return scale;
+}
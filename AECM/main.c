@@ -7,6 +7,7 @@
 #include "dr_wav.h"
 #include "aecm.h"
 #include "timing.h"
+#include "../Tools/batch.h"
 
 #ifndef nullptr
 #define nullptr 0
@@ -16,8 +17,11 @@
 #define  MIN(A, B)        ((A) < (B) ? (A) : (B))
 #endif
 
-//写wav文件
-void wavWrite_int16(char *filename, int16_t *buffer, size_t sampleRate, size_t totalSampleCount)
+// 每次读写的 10ms 帧数, 内存占用与文件长度无关
+#define BLOCK_FRAMES 50
+
+//打开wav文件用于流式写入
+int wavOpenWrite(drwav *pWav, const char *filename, size_t sampleRate)
 {
     drwav_data_format format = {};
     format.container = drwav_container_riff;     // <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
@@ -25,37 +29,29 @@ void wavWrite_int16(char *filename, int16_t *buffer, size_t sampleRate, size_t t
     format.channels = 1;
     format.sampleRate = (drwav_uint32) sampleRate;
     format.bitsPerSample = 16;
-    drwav *pWav = drwav_open_file_write(filename, &format);
-    if (pWav)
+    if (!drwav_init_file_write(pWav, filename, &format))
     {
-        drwav_uint64 samplesWritten = drwav_write(pWav, totalSampleCount, buffer);
-        drwav_uninit(pWav);
-        if (samplesWritten != totalSampleCount)
-        {
-            fprintf(stderr, "ERROR\n");
-            exit(1);
-        }
+        fprintf(stderr, "ERROR\n");
+        return -1;
     }
+    return 0;
 }
 
-//读取wav文件
-int16_t *wavRead_int16(char *filename, uint32_t *sampleRate, uint64_t *totalSampleCount)
+//打开wav文件用于流式读取
+int wavOpenRead(drwav *pWav, const char *filename)
 {
-    unsigned int channels;
-    int16_t *buffer = drwav_open_and_read_file_s16(filename, &channels, sampleRate, totalSampleCount);
-    if (buffer == nullptr)
+    if (!drwav_init_file(pWav, filename))
     {
         printf("读取wav文件失败.");
+        return -1;
     }
     //仅仅处理单通道音频
-    if (channels != 1)
+    if (pWav->channels != 1)
     {
-        drwav_free(buffer);
-        buffer = nullptr;
-        *sampleRate = 0;
-        *totalSampleCount = 0;
+        drwav_uninit(pWav);
+        return -1;
     }
-    return buffer;
+    return 0;
 }
 
 //分割路径函数
@@ -107,28 +103,42 @@ void splitpath(const char *path, char *drv, char *dir, char *name, char *ext)
 }
 
 
-int aecProcess(int16_t *far_frame, int16_t *near_frame, uint32_t sampleRate, size_t samplesCount, int16_t nMode,
-               int16_t msInSndCardBuf)
+int aecProcess(drwav *far_reader, drwav *near_reader, drwav *writer, int16_t nMode, int16_t msInSndCardBuf,
+               double *processTime)
 {
-    if (near_frame == nullptr) return -1;
-    if (far_frame == nullptr) return -1;
-    if (samplesCount == 0) return -1;
+    if (near_reader == nullptr) return -1;
+    if (far_reader == nullptr) return -1;
+    if (writer == nullptr) return -1;
+    uint32_t sampleRate = near_reader->sampleRate;
     AecmConfig config;
     config.cngMode = AecmTrue;
     config.echoMode = nMode;// 0, 1, 2, 3 (default), 4
     size_t samples = MIN(160, sampleRate / 100);
     if (samples == 0) return -1;
     const int maxSamples = 160;
-    int16_t *near_input = near_frame;
-    int16_t *far_input = far_frame;
-    size_t nTotal = (samplesCount / samples);
+    size_t blockSamples = samples * BLOCK_FRAMES;
+    int16_t *near_block = (int16_t *) malloc(blockSamples * sizeof(int16_t));
+    int16_t *far_block = (int16_t *) malloc(blockSamples * sizeof(int16_t));
+    if (near_block == NULL || far_block == NULL)
+    {
+        if (near_block) free(near_block);
+        if (far_block) free(far_block);
+        return -1;
+    }
     void *aecmInst = WebRtcAecm_Create();
-    if (aecmInst == NULL) return -1;
+    if (aecmInst == NULL)
+    {
+        free(near_block);
+        free(far_block);
+        return -1;
+    }
     int status = WebRtcAecm_Init(aecmInst, sampleRate);//8000 or 16000 Sample rate
     if (status != 0)
     {
         printf("WebRtcAecm_Init fail\n");
         WebRtcAecm_Free(aecmInst);
+        free(near_block);
+        free(far_block);
         return -1;
     }
     status = WebRtcAecm_set_config(aecmInst, config);
@@ -136,79 +146,169 @@ int aecProcess(int16_t *far_frame, int16_t *near_frame, uint32_t sampleRate, siz
     {
         printf("WebRtcAecm_set_config fail\n");
         WebRtcAecm_Free(aecmInst);
+        free(near_block);
+        free(far_block);
         return -1;
     }
 
+    int ret = 1;
     int16_t out_buffer[maxSamples];
-    for (int i = 0; i < nTotal; i++)
+    uint64_t samplesRead;
+    while (ret > 0 && (samplesRead = drwav_read_s16(near_reader, blockSamples, near_block)) > 0)
     {
-        if (WebRtcAecm_BufferFarend(aecmInst, far_input, samples) != 0)
+        // 远端信号较短时以静音补齐
+        uint64_t farRead = drwav_read_s16(far_reader, samplesRead, far_block);
+        if (farRead < samplesRead)
+            memset(far_block + farRead, 0, (samplesRead - farRead) * sizeof(int16_t));
+
+        double startTime = now();
+        // 不足 10ms 的尾部数据原样输出
+        size_t nFrames = samplesRead / samples;
+        int16_t *near_input = near_block;
+        int16_t *far_input = far_block;
+        for (size_t i = 0; i < nFrames; i++)
         {
-            printf("WebRtcAecm_BufferFarend() failed.");
-            WebRtcAecm_Free(aecmInst);
-            return -1;
+            if (WebRtcAecm_BufferFarend(aecmInst, far_input, samples) != 0)
+            {
+                printf("WebRtcAecm_BufferFarend() failed.");
+                ret = -1;
+                break;
+            }
+            int nRet = WebRtcAecm_Process(aecmInst, near_input, NULL, out_buffer, samples, msInSndCardBuf);
+
+            if (nRet != 0)
+            {
+                printf("failed in WebRtcAecm_Process\n");
+                ret = -1;
+                break;
+            }
+            memcpy(near_input, out_buffer, samples * sizeof(int16_t));
+            near_input += samples;
+            far_input += samples;
         }
-        int nRet = WebRtcAecm_Process(aecmInst, near_input, NULL, out_buffer, samples, msInSndCardBuf);
+        *processTime += calcElapsed(startTime, now());
 
-        if (nRet != 0)
+        if (ret > 0 && drwav_write(writer, samplesRead, near_block) != samplesRead)
         {
-            printf("failed in WebRtcAecm_Process\n");
-            WebRtcAecm_Free(aecmInst);
-            return -1;
+            fprintf(stderr, "ERROR\n");
+            ret = -1;
         }
-        memcpy(near_input, out_buffer, samples * sizeof(int16_t));
-        near_input += samples;
-        far_input += samples;
     }
     WebRtcAecm_Free(aecmInst);
-    return 1;
+    free(near_block);
+    free(far_block);
+    return ret;
 }
 
-void AECM(char *near_file, char *far_file, char *out_file)
+int AECM(const char *near_file, const char *far_file, const char *out_file, double *audioSeconds,
+         double *processSeconds)
 {
-    //音频采样率
-    uint32_t sampleRate = 0;
-    uint64_t inSampleCount = 0;
-    uint32_t ref_sampleRate = 0;
-    uint64_t ref_inSampleCount = 0;
-    int16_t *near_frame = wavRead_int16(near_file, &sampleRate, &inSampleCount);
-    int16_t *far_frame = wavRead_int16(far_file, &ref_sampleRate, &ref_inSampleCount);
-    if ((near_frame == nullptr || far_frame == nullptr))
-    {
-        if (near_frame) free(near_frame);
-        if (far_frame) free(far_frame);
-        return;
+    drwav near_reader;
+    drwav far_reader;
+    drwav writer;
+    //按块读取, 避免整个文件载入内存
+    if (wavOpenRead(&near_reader, near_file) != 0)
+        return -1;
+    if (wavOpenRead(&far_reader, far_file) != 0)
+    {
+        drwav_uninit(&near_reader);
+        return -1;
+    }
+    if (wavOpenWrite(&writer, out_file, near_reader.sampleRate) != 0)
+    {
+        drwav_uninit(&near_reader);
+        drwav_uninit(&far_reader);
+        return -1;
     }
     //如果加载成功
     int16_t echoMode = 1;// 0, 1, 2, 3 (default), 4
     int16_t msInSndCardBuf = 40;
-    double startTime = now();
-    aecProcess(far_frame, near_frame, sampleRate, inSampleCount, echoMode, msInSndCardBuf);
-    double elapsed_time = calcElapsed(startTime, now());
-    printf("time interval: %d ms\n ", (int) (elapsed_time * 1000));
-    wavWrite_int16(out_file, near_frame, sampleRate, inSampleCount);
-    free(near_frame);
-    free(far_frame);
+    *processSeconds = 0;
+    int ret = aecProcess(&far_reader, &near_reader, &writer, echoMode, msInSndCardBuf, processSeconds);
+    *audioSeconds = (double) near_reader.totalSampleCount / near_reader.sampleRate;
+    drwav_uninit(&writer);
+    drwav_uninit(&near_reader);
+    drwav_uninit(&far_reader);
+    return ret > 0 ? 0 : -1;
+}
+
+//输出文件名: 近端文件名加 _out 后缀
+void outFilePath(const char *near_file, char *out_file)
+{
+    char drive[3];
+    char dir[256];
+    char fname[256];
+    char ext[256];
+    splitpath(near_file, drive, dir, fname, ext);
+    sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
+}
+
+// 批处理条目: 清单中每行为 "far_file<Tab>near_file", 路径中可以有空格,
+// 只有 near_file 的行和目录中的 xxx_near.wav 与同目录下的 xxx_far.wav 配对.
+int aecmBatchJob(const char *item, void *user, double *audioSeconds, double *processSeconds)
+{
+    char far_file[1024];
+    char near_file[1024];
+    char out_file[1024];
+    (void) user;
+    const char *tab = strchr(item, '\t');
+    if (tab != NULL)
+    {
+        size_t n = (size_t) (tab - item);
+        const char *nearPath = tab + 1;
+        while (*nearPath == '\t')
+            nearPath++;
+        if (n >= sizeof(far_file) || *nearPath == '\0' || strlen(nearPath) >= sizeof(near_file))
+            return -1;
+        memcpy(far_file, item, n);
+        far_file[n] = '\0';
+        strcpy(near_file, nearPath);
+    }
+    else
+    {
+        size_t n = strlen(item);
+        if (n < strlen("_near.wav") || n >= sizeof(near_file))
+            return -1;
+        strcpy(near_file, item);
+        n -= strlen("_near.wav");
+        memcpy(far_file, item, n);
+        strcpy(far_file + n, "_far.wav");
+    }
+    outFilePath(near_file, out_file);
+    return AECM(near_file, far_file, out_file, audioSeconds, processSeconds);
 }
 
 int main(int argc, char *argv[])
 {
     printf("WebRTC Acoustic Echo Canceller for Mobile\n");
-    printf("usage : aecm near_file.wav far_file.wav\n");
+    printf("usage : aecm far_file.wav near_file.wav\n");
+    printf("        aecm -b dir_or_manifest [threads]\n");
     if (argc < 3)
         return -1;
+    if (strcmp(argv[1], "-b") == 0)
+    {
+        //批处理模式: 每对文件一个独立实例, 线程数默认为 CPU 核数
+        BatchList list;
+        BatchStats stats;
+        if (batchListLoad(&list, argv[2], "_near.wav") != 0)
+            return -1;
+        double startTime = now();
+        int threads = batchRun(&list, argc > 3 ? atoi(argv[3]) : 0, aecmBatchJob, NULL, &stats);
+        stats.wallSeconds = calcElapsed(startTime, now());
+        batchReport(&stats, threads);
+        batchListFree(&list);
+        return stats.failed == 0 && threads > 0 ? 0 : 1;
+    }
     // echo file
     char *far_file = argv[1];
     // mixed file
     char *near_file = argv[2];
-    char drive[3];
-    char dir[256];
-    char fname[256];
-    char ext[256];
     char out_file[1024];
-    splitpath(near_file, drive, dir, fname, ext);
-    sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
-    AECM(near_file, far_file, out_file);
+    outFilePath(near_file, out_file);
+    double audioSeconds = 0;
+    double elapsed_time = 0;
+    AECM(near_file, far_file, out_file, &audioSeconds, &elapsed_time);
+    printf("time interval: %d ms\n ", (int) (elapsed_time * 1000));
     printf("press any key to exit. \n");
     getchar();
     return 0;
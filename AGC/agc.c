@@ -18,6 +18,8 @@
  */
 
 #include "agc.h"
+#include "../SPL/signal_processing_library.h"
+#include <math.h>
 #include <stdlib.h>
 
 #ifdef WEBRTC_AGC_DEBUG_DUMP
@@ -149,120 +151,6 @@ static const int32_t kTargetLevelTable[64] = {
         67};
 
 
-static __inline int16_t DivW32W16ResW16(int32_t num, int16_t den)
-{
-    // Guard against division with 0
-    return (den != 0) ? (int16_t) (num / den) : (int16_t) 0x7FFF;
-}
-
-static __inline int32_t DivW32W16(int32_t num, int16_t den)
-{
-    // Guard against division with 0
-    return (den != 0) ? (int32_t) (num / den) : (int32_t) 0x7FFFFFFF;
-}
-
-static __inline uint32_t __clz_uint32(uint32_t v)
-{
-// Never used with input 0
-    assert(v > 0);
-#if defined(__INTEL_COMPILER)
-    return _bit_scan_reverse(v) ^ 31U;
-#elif defined(__GNUC__) && (__GNUC__ >= 4 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
-// This will translate either to (bsr ^ 31U), clz , ctlz, cntlz, lzcnt depending on
-// -march= setting or to a software routine in exotic machines.
-    return __builtin_clz(v);
-#elif defined(_MSC_VER)
-    // for _BitScanReverse
-#include <intrin.h>
-    {
-        uint32_t idx;
-        _BitScanReverse(&idx, v);
-        return idx ^ 31U;
-    }
-#else
-// Will never be emitted for MSVC, GCC, Intel compilers
-    static const uint8_t byte_to_unary_table[] = {
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    };
-    return word > 0xffffff ? byte_to_unary_table[v >> 24] :
-        word > 0xffff ? byte_to_unary_table[v >> 16] + 8 :
-        word > 0xff ? byte_to_unary_table[v >> 8] + 16 :
-        byte_to_unary_table[v] + 24;
-#endif
-}
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormU32(uint32_t a)
-{
-
-    if (a == 0) return 0;
-    return (int16_t) __clz_uint32(a);
-}
-
-
-static __inline int16_t SatW32ToW16(int32_t value32)
-{
-    return (int16_t) value32 > 32767 ? (int16_t) 32767 : (value32 < -32768) ? (int16_t) (-32768) : (int16_t) value32;
-}
-
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormW32(int32_t a)
-{
-
-    if (a == 0) return 0;
-    uint32_t v = (uint32_t) (a < 0 ? ~a : a);
-    // Returns the number of leading zero bits in the argument.
-    return (int16_t) (__clz_uint32(v) - 1);
-}
-
-static __inline int16_t WebRtcSpl_AddSatW16(int16_t a, int16_t b)
-{
-    return SatW32ToW16((int32_t) a + (int32_t) b);
-}
-
-int32_t DotProductWithScale(const int16_t *vector1,
-                            const int16_t *vector2,
-                            size_t length,
-                            int scaling)
-{
-    int64_t sum = 0;
-    size_t i = 0;
-
-    /* Unroll the loop to improve performance. */
-    for (i = 0; i + 3 < length; i += 4)
-    {
-        sum += (vector1[i + 0] * vector2[i + 0]) >> scaling;
-        sum += (vector1[i + 1] * vector2[i + 1]) >> scaling;
-        sum += (vector1[i + 2] * vector2[i + 2]) >> scaling;
-        sum += (vector1[i + 3] * vector2[i + 3]) >> scaling;
-    }
-    for (; i < length; i++)
-    {
-        sum += (vector1[i] * vector2[i]) >> scaling;
-    }
-
-    return (int32_t) (sum);
-}
-
-
 static float fast_sqrt(float x)
 {
     float s;
@@ -279,61 +167,52 @@ static float fast_sqrt(float x)
     return s;
 }
 
+// One first order allpass section, state + (diff * coef) >> 16. The 64-bit
+// product is the same as the split 16-bit products of the original filter
+// and shortens the dependency chain from one sample to the next.
+#define ALLPASS_SECTION(state, diff, coef) \
+    ((int32_t) ((uint32_t) (state) + (uint32_t) (((int64_t) (diff) * (coef)) >> 16)))
+
+// Halves the rate of |len| samples with the two branch allpass half band
+// filter, the even samples go through the lower branch and the odd samples
+// through the upper one. Called on whole frames, the recursion is the same as
+// on shorter pieces with |filtState| carried over.
 static __inline void downsampleBy2(const int16_t *in, size_t len,
                                    int16_t *out, int32_t *filtState)
 {
-    int32_t tmp1, tmp2, diff, in32, out32;
+    int32_t tmp1, tmp2, tmp3, tmp4, in32, in32b;
     size_t i;
 
-    register int32_t state0 = filtState[0];
-    register int32_t state1 = filtState[1];
-    register int32_t state2 = filtState[2];
-    register int32_t state3 = filtState[3];
-    register int32_t state4 = filtState[4];
-    register int32_t state5 = filtState[5];
-    register int32_t state6 = filtState[6];
-    register int32_t state7 = filtState[7];
-
-    for (i = (len >> 1); i > 0; i--)
-    {
-        // lower allpass filter
-        in32 = (int32_t) (*in++) * (1 << 10);
-        diff = in32 - state1;
-        tmp1 = ((state0) + ((diff) >> 16) * (kResampleAllpass2[0]) +
-                (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass2[0])) >> 16));
+    int32_t state0 = filtState[0];
+    int32_t state1 = filtState[1];
+    int32_t state2 = filtState[2];
+    int32_t state3 = filtState[3];
+    int32_t state4 = filtState[4];
+    int32_t state5 = filtState[5];
+    int32_t state6 = filtState[6];
+    int32_t state7 = filtState[7];
+
+    for (i = 0; i < (len >> 1); i++)
+    {
+        // both branches side by side, they only meet in the output
+        in32 = (int32_t) in[2 * i] * (1 << 10);
+        in32b = (int32_t) in[2 * i + 1] * (1 << 10);
+        tmp1 = ALLPASS_SECTION(state0, in32 - state1, kResampleAllpass2[0]);
+        tmp3 = ALLPASS_SECTION(state4, in32b - state5, kResampleAllpass1[0]);
         state0 = in32;
-        diff = tmp1 - state2;
-        tmp2 = ((state1) + ((diff) >> 16) * (kResampleAllpass2[1]) +
-                (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass2[1])) >> 16));
+        state4 = in32b;
+        tmp2 = ALLPASS_SECTION(state1, tmp1 - state2, kResampleAllpass2[1]);
+        tmp4 = ALLPASS_SECTION(state5, tmp3 - state6, kResampleAllpass1[1]);
         state1 = tmp1;
-        diff = tmp2 - state3;
-        state3 = ((state2) + ((diff) >> 16) * (kResampleAllpass2[2]) +
-                  (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass2[2])) >> 16));
+        state5 = tmp3;
+        state3 = ALLPASS_SECTION(state2, tmp2 - state3, kResampleAllpass2[2]);
+        state7 = ALLPASS_SECTION(state6, tmp4 - state7, kResampleAllpass1[2]);
         state2 = tmp2;
+        state6 = tmp4;
 
-        // upper allpass filter
-        in32 = (int32_t) (*in++) * (1 << 10);
-        diff = in32 - state5;
-        tmp1 = ((state4) + ((diff) >> 16) * (kResampleAllpass1[0]) +
-                (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass1[0])) >> 16));
-
-        state4 = in32;
-        diff = tmp1 - state6;
-        tmp2 = ((state5) + ((diff) >> 16) * (kResampleAllpass1[1]) +
-                (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass1[1])) >> 16));
-
-        state5 = tmp1;
-        diff = tmp2 - state7;
-        state7 = ((state6) + ((diff) >> 16) * (kResampleAllpass1[2]) +
-                  (((uint32_t) ((diff) & 0x0000FFFF) * (kResampleAllpass1[2])) >> 16));
-
-        state6 = tmp2;
-
-        // add two allpass outputs, divide by two and round
-        out32 = (state3 + state7 + 1024) >> 11;
-
-        // limit amplitude to prevent wrap-around, and write to output array
-        *out++ = SatW32ToW16(out32);
+        // add two allpass outputs, divide by two and round, and limit the
+        // amplitude to prevent wrap-around
+        out[i] = WebRtcSpl_SatW32ToW16((state3 + state7 + 1024) >> 11);
     }
 
     filtState[0] = state0;
@@ -346,6 +225,40 @@ static __inline void downsampleBy2(const int16_t *in, size_t len,
     filtState[7] = state7;
 }
 
+// Lowpasses for the decimation of full band frames to 16 kHz (Q15), Kaiser
+// windowed sincs with the cutoff at 8 kHz. The 32 kHz one is a half band
+// filter, the 48 kHz one is at least 46 dB down from 12 kHz on.
+static const int16_t kDecimateBy2Taps[AGC_DECIMATOR_TAPS] = {
+        -220, 0, 924, 0, -2653, 0, 10137, 16392,
+        10137, 0, -2653, 0, 924, 0, -220};
+static const int16_t kDecimateBy3Taps[AGC_DECIMATOR_TAPS] = {
+        192, 0, -805, -1383, 0, 4043, 8837, 11000,
+        8837, 4043, 0, -1383, -805, 0, 192};
+
+// Decimates |len| samples by |factor| with the lowpass |taps|. |history|
+// holds the last AGC_DECIMATOR_TAPS - 1 input samples of the previous call.
+static void decimate(const int16_t *in, size_t len, size_t factor,
+                     const int16_t *taps, int16_t *out, int16_t *history)
+{
+    int16_t buffer[AGC_DECIMATOR_TAPS - 1 + 480];
+    size_t i, j;
+
+    assert(len <= 480);
+    memcpy(buffer, history, (AGC_DECIMATOR_TAPS - 1) * sizeof(int16_t));
+    memcpy(buffer + AGC_DECIMATOR_TAPS - 1, in, len * sizeof(int16_t));
+    for (i = 0; i < len / factor; i++)
+    {
+        const int16_t *x = &buffer[factor * (i + 1) - 1];
+        int32_t acc = 1 << 14;
+        for (j = 0; j < AGC_DECIMATOR_TAPS; j++)
+        {
+            acc += taps[j] * x[j];
+        }
+        out[i] = WebRtcSpl_SatW32ToW16(acc >> 15);
+    }
+    memcpy(history, buffer + len, (AGC_DECIMATOR_TAPS - 1) * sizeof(int16_t));
+}
+
 // To generate the gaintable, copy&paste the following lines to a Matlab window:
 // MaxGain = 6; MinGain = 0; CompRatio = 3; Knee = 1;
 // zeros = 0:31; lvl = 2.^(1-zeros);
@@ -418,7 +331,7 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
     tmp32no1 = (digCompGaindB - analogTarget) * (kCompRatio - 1);
     tmp16no1 = analogTarget - targetLevelDbfs;
     tmp16no1 +=
-            DivW32W16ResW16(tmp32no1 + (kCompRatio >> 1), kCompRatio);
+            WebRtcSpl_DivW32W16ResW16(tmp32no1 + (kCompRatio >> 1), kCompRatio);
     maxGain = MAX(tmp16no1, (analogTarget - targetLevelDbfs));
     //  tmp32no1 = maxGain * kCompRatio;
     //  zeroGainLvl = digCompGaindB;
@@ -434,7 +347,7 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
     //           = (compRatio-1)*digCompGaindB/compRatio
     tmp32no1 = digCompGaindB * (kCompRatio - 1);
     diffGain =
-            DivW32W16ResW16(tmp32no1 + (kCompRatio >> 1), kCompRatio);
+            WebRtcSpl_DivW32W16ResW16(tmp32no1 + (kCompRatio >> 1), kCompRatio);
     if (diffGain < 0 || diffGain >= kGenFuncTableSize)
     {
         assert(0);
@@ -445,10 +358,10 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
     //  limiterLvlX = analogTarget - limiterOffset
     //  limiterLvl  = targetLevelDbfs + limiterOffset/compRatio
     limiterLvlX = analogTarget - limiterOffset;
-    limiterIdx = 2 + DivW32W16ResW16((int32_t) limiterLvlX * (1 << 13),
+    limiterIdx = 2 + WebRtcSpl_DivW32W16ResW16((int32_t) limiterLvlX * (1 << 13),
                                      kLog10_2 / 2);
     tmp16no1 =
-            DivW32W16ResW16(limiterOffset + (kCompRatio >> 1), kCompRatio);
+            WebRtcSpl_DivW32W16ResW16(limiterOffset + (kCompRatio >> 1), kCompRatio);
     limiterLvl = targetLevelDbfs + tmp16no1;
 
     // Calculate (through table lookup):
@@ -472,7 +385,7 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
         //  fix((-constLog10_2*(compRatio-1)*(1-i)+fix(compRatio/2))/compRatio)
         tmp16 = (int16_t) ((kCompRatio - 1) * (i - 1));       // Q0
         tmp32 = ((int32_t) (int16_t) (tmp16) * (uint16_t) (kLog10_2)) + 1;  // Q14
-        inLevel = DivW32W16(tmp32, kCompRatio);    // Q14
+        inLevel = WebRtcSpl_DivW32W16(tmp32, kCompRatio);    // Q14
 
         // Calculate diffGain-inLevel, to map using the genFuncTable
         inLevel = (int32_t) diffGain * (1 << 14) - inLevel;  // Q14
@@ -493,7 +406,7 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
         //  log2(1 + 2^-x) = log2(1 + 2^x) - x
         if (inLevel < 0)
         {
-            zeros = NormU32(absInLevel);
+            zeros = WebRtcSpl_NormU32(absInLevel);
             zerosScale = 0;
             if (zeros < 15)
             {
@@ -531,11 +444,11 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
         // Ensure we avoid wrap-around in |den| as well.
         if (numFIX > (den >> 8) || -numFIX > (den >> 8))  // |den| is Q8.
         {
-            zeros = NormW32(numFIX);
+            zeros = WebRtcSpl_NormW32(numFIX);
         }
         else
         {
-            zeros = NormW32(den) + 8;
+            zeros = WebRtcSpl_NormW32(den) + 8;
         }
         numFIX *= 1 << zeros;  // Q(14+zeros)
 
@@ -549,7 +462,7 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable,       // Q16
         {
             tmp32 = ((int32_t) (int16_t) (i - 1) * (uint16_t) (kLog10_2));  // Q14
             tmp32 -= limiterLvl * (1 << 14);                 // Q14
-            y32 = DivW32W16(tmp32 + 10, 20);
+            y32 = WebRtcSpl_DivW32W16(tmp32 + 10, 20);
         }
         if (y32 > 39000)
         {
@@ -610,6 +523,7 @@ int32_t WebRtcAgc_InitDigital(DigitalAgc *stt, int16_t agcMode)
     stt->gain = 65536;
     stt->gatePrevious = 0;
     stt->agcMode = agcMode;
+    memset(stt->decimatorHistory, 0, sizeof(stt->decimatorHistory));
 #ifdef WEBRTC_AGC_DEBUG_DUMP
     stt->frameCounter = 0;
 #endif
@@ -632,56 +546,39 @@ int32_t WebRtcAgc_AddFarendToDigital(DigitalAgc *stt,
     return 0;
 }
 
-int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
-                                 const int16_t *const *in_near,
-                                 size_t num_bands,
-                                 int16_t *const *out,
-                                 uint32_t FS,
-                                 int16_t lowlevelSignal)
+// Gain change per sample in Q4 for a gain ramp over a subframe of |L|
+// samples, the gain of the next subframe is reached after |L| samples.
+static int32_t GainStep(int32_t diff, size_t L)
 {
-    // array for gains (one value per ms, incl start & end)
-    int32_t gains[11];
+    if (L <= 16)
+    {
+        return diff * (int32_t) (16 / L);
+    }
+    return (int32_t) ((int64_t) diff * 16 / (int64_t) L);
+}
 
-    int32_t out_tmp, tmp32;
-    int32_t env[10];
-    int32_t max_nrg;
+// Gains of one 10 ms frame (Q16, one per ms incl. start & end) from the
+// envelope |env| (largest square per ms), the VAD runs on |vadFrame| at 8 or
+// 16 kHz.
+static void ComputeDigitalGains(DigitalAgc *stt,
+                                const int16_t *vadFrame,
+                                size_t vadLength,
+                                const int32_t *env,
+                                int16_t lowlevelSignal,
+                                int32_t *gains)
+{
+    int32_t tmp32;
     int32_t cur_level;
-    int32_t gain32, delta;
+    int32_t gain32;
     int16_t logratio;
     int16_t lower_thr, upper_thr;
     int16_t zeros = 0, zeros_fast, frac = 0;
     int16_t decay;
     int16_t gate, gain_adj;
     int16_t k;
-    size_t n, i, L;
-    int16_t L2;  // samples/subframe
 
-    // determine number of samples per ms
-    if (FS == 8000)
-    {
-        L = 8;
-        L2 = 3;
-    }
-    else if (FS == 16000 || FS == 32000 || FS == 48000)
-    {
-        L = 16;
-        L2 = 4;
-    }
-    else
-    {
-        return -1;
-    }
-
-    for (i = 0; i < num_bands; ++i)
-    {
-        if (in_near[i] != out[i])
-        {
-            // Only needed if they don't already point to the same place.
-            memcpy(out[i], in_near[i], 10 * L * sizeof(in_near[i][0]));
-        }
-    }
     // VAD for near end
-    logratio = WebRtcAgc_ProcessVad(&stt->vadNearend, out[0], L * 10);
+    logratio = WebRtcAgc_ProcessVad(&stt->vadNearend, vadFrame, vadLength);
 
     // Account for far end VAD
     if (stt->vadFarend.counter > 10)
@@ -739,23 +636,6 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
     fprintf(stt->logFile, "%5.2f\t%d\t%d\t%d\t", (float)(stt->frameCounter) / 100,
             logratio, decay, stt->vadNearend.stdLongTerm);
 #endif
-    // Find max amplitude per sub frame
-    // iterate over sub frames
-    for (k = 0; k < 10; k++)
-    {
-        // iterate over samples
-        max_nrg = 0;
-        for (n = 0; n < L; n++)
-        {
-            int32_t nrg = out[0][k * L + n] * out[0][k * L + n];
-            if (nrg > max_nrg)
-            {
-                max_nrg = nrg;
-            }
-        }
-        env[k] = max_nrg;
-    }
-
     // Calculate gain per sub frame
     gains[0] = stt->gain;
     for (k = 0; k < 10; k++)
@@ -793,7 +673,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
         }
         // Translate signal level into gain, using a piecewise linear approximation
         // find number of leading zeros
-        zeros = NormU32((uint32_t) cur_level);
+        zeros = WebRtcSpl_NormU32((uint32_t) cur_level);
         if (cur_level == 0)
         {
             zeros = 31;
@@ -813,7 +693,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
     // Gate processing (lower gain during absence of speech)
     zeros = (zeros << 9) - (frac >> 3);
     // find number of leading zeros
-    zeros_fast = NormU32((uint32_t) stt->capacitorFast);
+    zeros_fast = WebRtcSpl_NormU32((uint32_t) stt->capacitorFast);
     if (stt->capacitorFast == 0)
     {
         zeros_fast = 31;
@@ -870,7 +750,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
         zeros = 10;
         if (gains[k + 1] > 47453132)
         {
-            zeros = 16 - NormW32(gains[k + 1]);
+            zeros = 16 - WebRtcSpl_NormW32(gains[k + 1]);
         }
         gain32 = (gains[k + 1] >> zeros) + 1;
         gain32 *= gain32;
@@ -902,64 +782,384 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
     }
     // save start gain for next frame
     stt->gain = gains[10];
+}
+
+// Gain of a sample of the first sub frame, |gain32| in Q20.
+static __inline int16_t FirstSubframeGain(int16_t x, int32_t gain32)
+{
+    int32_t tmp32 = x * ((gain32 + 127) >> 7);
+    int32_t out_tmp = tmp32 >> 16;
+    if (out_tmp > 4095)
+    {
+        return (int16_t) 32767;
+    }
+    else if (out_tmp < -4096)
+    {
+        return (int16_t) -32768;
+    }
+    tmp32 = x * (gain32 >> 4);
+    return (int16_t) (tmp32 >> 16);
+}
+
+// Gain of every sample after the first sub frame (Q16), ramping from one
+// gain to the next over |L| samples. The ramp is the same for all bands and
+// channels.
+static void RampGains(const int32_t *gains, size_t L, int32_t *sampleGains)
+{
+    int32_t gain32, delta;
+    size_t n;
+    int16_t k;
+
+    for (k = 1; k < 10; k++)
+    {
+        delta = GainStep(gains[k + 1] - gains[k], L);
+        gain32 = gains[k] * (1 << 4);
+        // iterate over samples
+        for (n = 0; n < L; n++)
+        {
+            sampleGains[(k - 1) * L + n] = gain32 >> 4;
+            gain32 += delta;
+        }
+    }
+}
+
+// The digital AGC on one 10 ms frame, already copied to |out|. |L| is the
+// number of samples per ms of the bands in |out|, the VAD runs on |vadFrame|
+// at 8 or 16 kHz.
+static int32_t ProcessDigitalFrame(DigitalAgc *stt,
+                                   const int16_t *vadFrame,
+                                   size_t vadLength,
+                                   int16_t *const *out,
+                                   size_t num_bands,
+                                   size_t L,
+                                   int16_t lowlevelSignal)
+{
+    // array for gains (one value per ms, incl start & end)
+    int32_t gains[11];
+    // gain of every sample after the first sub frame (Q16)
+    int32_t sampleGains[9 * AGC_MAX_SAMPLES_PER_MS];
+    int32_t env[10];
+    int32_t gain32, delta;
+    size_t n, i;
+
+    // Find max amplitude per sub frame
+    WebRtcSpl_MaxSquareBlocksW16(out[0], L, 10, env);
+    ComputeDigitalGains(stt, vadFrame, vadLength, env, lowlevelSignal, gains);
 
     // Apply gain
     // handle first sub frame separately
-    delta = (gains[1] - gains[0]) * (1 << (4 - L2));
+    delta = GainStep(gains[1] - gains[0], L);
     gain32 = gains[0] * (1 << 4);
     // iterate over samples
     for (n = 0; n < L; n++)
     {
         for (i = 0; i < num_bands; ++i)
         {
-            tmp32 = out[i][n] * ((gain32 + 127) >> 7);
-            out_tmp = tmp32 >> 16;
-            if (out_tmp > 4095)
-            {
-                out[i][n] = (int16_t) 32767;
-            }
-            else if (out_tmp < -4096)
-            {
-                out[i][n] = (int16_t) -32768;
-            }
-            else
-            {
-                tmp32 = out[i][n] * (gain32 >> 4);
-                out[i][n] = (int16_t) (tmp32 >> 16);
-            }
+            out[i][n] = FirstSubframeGain(out[i][n], gain32);
         }
-        //
+        gain32 += delta;
+    }
+    RampGains(gains, L, sampleGains);
+    for (i = 0; i < num_bands; ++i)
+    {
+        WebRtcSpl_ApplyGainsW16(out[i] + L, sampleGains, 9 * L);
+    }
+
+    return 0;
+}
 
+int32_t WebRtcAgc_ProcessDigital(DigitalAgc *stt,
+                                 const int16_t *const *in_near,
+                                 size_t num_bands,
+                                 int16_t *const *out,
+                                 uint32_t FS,
+                                 int16_t lowlevelSignal)
+{
+    size_t i, L;
+
+    // determine number of samples per ms
+    if (FS == 8000)
+    {
+        L = 8;
+    }
+    else if (FS == 16000 || FS == 32000 || FS == 48000)
+    {
+        L = 16;
+    }
+    else
+    {
+        return -1;
+    }
+
+    for (i = 0; i < num_bands; ++i)
+    {
+        if (in_near[i] != out[i])
+        {
+            // Only needed if they don't already point to the same place.
+            memcpy(out[i], in_near[i], 10 * L * sizeof(in_near[i][0]));
+        }
+    }
+    return ProcessDigitalFrame(stt, out[0], 10 * L, out, num_bands, L, lowlevelSignal);
+}
+
+int32_t WebRtcAgc_ProcessDigitalFullBand(DigitalAgc *stt,
+                                         const int16_t *in_near,
+                                         int16_t *out,
+                                         uint32_t FS,
+                                         int16_t lowlevelSignal)
+{
+    // the 16 kHz copy for the VAD
+    int16_t wideband[160];
+    int16_t *const bands[1] = {out};
+    const size_t L = FS / 1000;
+
+    if (FS != 32000 && FS != 48000)
+    {
+        return -1;
+    }
+    if (in_near != out)
+    {
+        memcpy(out, in_near, 10 * L * sizeof(in_near[0]));
+    }
+    decimate(out, 10 * L, L / 16,
+             FS == 32000 ? kDecimateBy2Taps : kDecimateBy3Taps,
+             wideband, stt->decimatorHistory);
+    return ProcessDigitalFrame(stt, wideband, 160, bands, 1, L, lowlevelSignal);
+}
+
+int32_t WebRtcAgc_ProcessDigitalInterleaved(DigitalAgc *stt,
+                                            int16_t *buffer,
+                                            size_t num_channels,
+                                            uint32_t FS,
+                                            int16_t lowlevelSignal)
+{
+    // mean of the channels and its 16 kHz copy, for the VAD
+    int16_t mono[10 * AGC_MAX_SAMPLES_PER_MS];
+    int16_t wideband[160];
+    const int16_t *vadFrame = buffer;
+    int32_t gains[11];
+    int32_t sampleGains[9 * AGC_MAX_SAMPLES_PER_MS];
+    int32_t env[10];
+    int32_t gain32, delta;
+    const size_t L = FS / 1000;
+    size_t n, c;
+
+    if ((FS != 8000 && FS != 16000 && FS != 32000 && FS != 48000) ||
+        num_channels == 0 || num_channels > 32768)
+    {
+        return -1;
+    }
+
+    // the loudest channel sets the envelope of each ms
+    WebRtcSpl_MaxSquareBlocksW16(buffer, L * num_channels, 10, env);
+    // the VAD listens to the mean of the channels
+    if (num_channels > 1)
+    {
+        WebRtcSpl_MeanChannelsW16(buffer, num_channels, 10 * L, mono);
+        vadFrame = mono;
+    }
+    if (L > 16)
+    {
+        decimate(vadFrame, 10 * L, L / 16,
+                 FS == 32000 ? kDecimateBy2Taps : kDecimateBy3Taps,
+                 wideband, stt->decimatorHistory);
+        vadFrame = wideband;
+    }
+    ComputeDigitalGains(stt, vadFrame, L > 16 ? 160 : 10 * L, env,
+                        lowlevelSignal, gains);
+
+    // Apply the gains to all channels, first sub frame as in
+    // ProcessDigitalFrame()
+    delta = GainStep(gains[1] - gains[0], L);
+    gain32 = gains[0] * (1 << 4);
+    for (n = 0; n < L; n++)
+    {
+        for (c = 0; c < num_channels; c++)
+        {
+            buffer[n * num_channels + c] =
+                    FirstSubframeGain(buffer[n * num_channels + c], gain32);
+        }
         gain32 += delta;
     }
-    // iterate over subframes
-    for (k = 1; k < 10; k++)
+    RampGains(gains, L, sampleGains);
+    WebRtcSpl_ApplyGainsStridedW16(buffer + L * num_channels, num_channels,
+                                   sampleGains, 9 * L);
+
+    return 0;
+}
+
+// Nearest 16-bit value of a float sample. The sample is offset to
+// non-negative values, which the conversion truncates down.
+static __inline int16_t FloatToW16(float x)
+{
+    x = MAX(MIN(x + 32768.5f, 65535.f), 0.f);
+    return (int16_t) ((int32_t) x - 32768);
+}
+
+// Multiplies |frames| interleaved frames of |channels| channels by a gain
+// ramping linearly from |gain| by |step| per frame, limited to the 16-bit
+// range.
+static __inline void GainRampFloat(float *x, size_t channels, size_t frames,
+                                   float gain, float step)
+{
+    float g, y;
+    int n;
+    size_t c;
+
+    for (n = 0; n < (int) frames; n++)
     {
-        delta = (gains[k + 1] - gains[k]) * (1 << (4 - L2));
-        gain32 = gains[k] * (1 << 4);
-        // iterate over samples
-        for (n = 0; n < L; n++)
+        g = gain + step * (float) n;
+        for (c = 0; c < channels; c++)
         {
-            for (i = 0; i < num_bands; ++i)
+            y = x[n * channels + c] * g;
+            x[n * channels + c] = MAX(MIN(y, 32767.f), -32768.f);
+        }
+    }
+}
+
+// Mean of |frames| interleaved frames of |channels| channels, with the Q15
+// reciprocal of WebRtcSpl_MeanChannelsW16().
+static __inline void MeanChannelsFloat(const float *x, size_t channels,
+                                       size_t frames, int16_t *mean)
+{
+    const int32_t scale = (int32_t) (32768 / channels);
+    const float upper = 32767.f * (float) channels;
+    const float lower = -32768.f * (float) channels;
+    float sum;
+    int n;
+    size_t c;
+
+    for (n = 0; n < (int) frames; n++)
+    {
+        sum = 0.f;
+        for (c = 0; c < channels; c++)
+        {
+            sum += x[n * channels + c];
+        }
+        sum = MAX(MIN(sum, upper), lower);
+        mean[n] = (int16_t) (((int32_t) sum * scale) >> 15);
+    }
+}
+
+// The usual channel counts are spelled out so that the loops above are
+// vectorized for them.
+static void ApplyGainRampFloat(float *x, size_t channels, size_t frames,
+                               float gain, float step)
+{
+    switch (channels)
+    {
+        case 1:
+            GainRampFloat(x, 1, frames, gain, step);
+            break;
+        case 2:
+            GainRampFloat(x, 2, frames, gain, step);
+            break;
+        case 4:
+            GainRampFloat(x, 4, frames, gain, step);
+            break;
+        default:
+            GainRampFloat(x, channels, frames, gain, step);
+            break;
+    }
+}
+
+static void MeanChannelsToW16(const float *x, size_t channels, size_t frames,
+                              int16_t *mean)
+{
+    switch (channels)
+    {
+        case 2:
+            MeanChannelsFloat(x, 2, frames, mean);
+            break;
+        case 4:
+            MeanChannelsFloat(x, 4, frames, mean);
+            break;
+        default:
+            MeanChannelsFloat(x, channels, frames, mean);
+            break;
+    }
+}
+
+int32_t WebRtcAgc_ProcessDigitalFloat(DigitalAgc *stt,
+                                      float *buffer,
+                                      size_t num_channels,
+                                      uint32_t FS,
+                                      int16_t lowlevelSignal)
+{
+    // 16-bit mean of the channels and its 16 kHz copy, for the VAD
+    int16_t mono[10 * AGC_MAX_SAMPLES_PER_MS];
+    int16_t wideband[160];
+    const int16_t *vadFrame = mono;
+    int32_t gains[11];
+    int32_t env[10];
+    const size_t L = FS / 1000;
+    const size_t blockLength = L * num_channels;
+    const float scale = 1.f / 65536.f;
+    float peaks[8], peak;
+    int32_t level;
+    size_t k, n, c;
+
+    if ((FS != 8000 && FS != 16000 && FS != 32000 && FS != 48000) ||
+        num_channels == 0 || num_channels > 32768)
+    {
+        return -1;
+    }
+
+    // The envelope is the largest square per ms of the samples rounded to
+    // 16 bits, as WebRtcSpl_MaxSquareBlocksW16() sees them.
+    for (k = 0; k < 10; k++)
+    {
+        const float *block = buffer + k * blockLength;
+        // eight running maxima, |blockLength| is a multiple of 8
+        for (c = 0; c < 8; c++)
+        {
+            peaks[c] = 0.f;
+        }
+        for (n = 0; n < blockLength; n += 8)
+        {
+            for (c = 0; c < 8; c++)
             {
-                int64_t tmp64 = ((int64_t) (out[i][k * L + n])) * (gain32 >> 4);
-                tmp64 = tmp64 >> 16;
-                if (tmp64 > 32767)
-                {
-                    out[i][k * L + n] = 32767;
-                }
-                else if (tmp64 < -32768)
-                {
-                    out[i][k * L + n] = -32768;
-                }
-                else
-                {
-                    out[i][k * L + n] = (int16_t) (tmp64);
-                }
+                peaks[c] = MAX(peaks[c], fabsf(block[n + c]));
             }
-            gain32 += delta;
+        }
+        peak = peaks[0];
+        for (c = 1; c < 8; c++)
+        {
+            peak = MAX(peak, peaks[c]);
+        }
+        level = (int32_t) (MIN(peak, 32768.f) + 0.5f);
+        env[k] = level * level;
+    }
+    // The VAD and its state stay in 16 bits, so that it decides as on the
+    // 16-bit frame.
+    if (num_channels == 1)
+    {
+        for (n = 0; n < 10 * L; n++)
+        {
+            mono[n] = FloatToW16(buffer[n]);
         }
     }
+    else
+    {
+        MeanChannelsToW16(buffer, num_channels, 10 * L, mono);
+    }
+    if (L > 16)
+    {
+        decimate(mono, 10 * L, L / 16,
+                 FS == 32000 ? kDecimateBy2Taps : kDecimateBy3Taps,
+                 wideband, stt->decimatorHistory);
+        vadFrame = wideband;
+    }
+    ComputeDigitalGains(stt, vadFrame, L > 16 ? 160 : 10 * L, env,
+                        lowlevelSignal, gains);
+
+    // Apply the gains, ramping over each ms from one to the next
+    for (k = 0; k < 10; k++)
+    {
+        ApplyGainRampFloat(buffer + k * blockLength, num_channels, L,
+                           (float) gains[k] * scale,
+                           (float) (gains[k + 1] - gains[k]) * scale / (float) L);
+    }
 
     return 0;
 }
@@ -993,58 +1193,58 @@ void WebRtcAgc_InitVad(AgcVad *state)
     }
 }
 
-int16_t WebRtcAgc_ProcessVad(AgcVad *state,      // (i) VAD state
-                             const int16_t *in,  // (i) Speech signal
-                             size_t nrSamples)   // (i) number of samples
+// Energy of the high passed 4 kHz signal of one 10 ms frame at 8 or 16 kHz,
+// the front end of the VAD. The frame is averaged down to 8 kHz (16 kHz
+// only) and decimated to 4 kHz in one pass each, with the same filter states
+// as 10 sub frames of 1 ms.
+static uint32_t VadFrameEnergy(AgcVad *state, const int16_t *in, size_t nrSamples)
 {
-    uint32_t nrg;
-    int32_t out, tmp32, tmp32b;
-    uint16_t tmpU16;
-    int16_t k, subfr, tmp16;
-    int16_t buf1[8];
-    int16_t buf2[4];
+    int16_t half[80];
+    int16_t low[40];
+    uint32_t nrg = 0;
+    int32_t out;
     int16_t HPstate;
-    int16_t zeros, dB;
+    size_t k;
 
-    // process in 10 sub frames of 1 ms (to save on memory)
-    nrg = 0;
-    HPstate = state->HPstate;
-    for (subfr = 0; subfr < 10; subfr++)
+    // downsample to 4 kHz
+    if (nrSamples == 160)
     {
-        // downsample to 4 kHz
-        if (nrSamples == 160)
+        for (k = 0; k < 80; k++)
         {
-            for (k = 0; k < 8; k++)
-            {
-                tmp32 = (int32_t) in[2 * k] + (int32_t) in[2 * k + 1];
-                tmp32 >>= 1;
-                buf1[k] = (int16_t) tmp32;
-            }
-            in += 16;
-
-            downsampleBy2(buf1, 8, buf2, state->downState);
-        }
-        else
-        {
-            downsampleBy2(in, 8, buf2, state->downState);
-            in += 8;
+            half[k] = (int16_t) (((int32_t) in[2 * k] + (int32_t) in[2 * k + 1]) >> 1);
         }
+        in = half;
+    }
+    downsampleBy2(in, 80, low, state->downState);
 
-        // high pass filter and compute energy
-        for (k = 0; k < 4; k++)
-        {
-            out = buf2[k] + HPstate;
-            tmp32 = 600 * out;
-            HPstate = (int16_t) ((tmp32 >> 10) - buf2[k]);
+    // high pass filter and compute energy
+    HPstate = state->HPstate;
+    for (k = 0; k < 40; k++)
+    {
+        out = low[k] + HPstate;
+        HPstate = (int16_t) (((600 * out) >> 10) - low[k]);
 
-            // Add 'out * out / 2**6' to 'nrg' in a non-overflowing
-            // way. Guaranteed to work as long as 'out * out / 2**6' fits in
-            // an int32_t.
-            nrg += out * (out / (1 << 6));
-            nrg += out * (out % (1 << 6)) / (1 << 6);
-        }
+        // Add 'out * out / 2**6' to 'nrg' in a non-overflowing
+        // way. Guaranteed to work as long as 'out * out / 2**6' fits in
+        // an int32_t.
+        nrg += out * (out / (1 << 6));
+        nrg += out * (out % (1 << 6)) / (1 << 6);
     }
     state->HPstate = HPstate;
+    return nrg;
+}
+
+int16_t WebRtcAgc_ProcessVad(AgcVad *state,      // (i) VAD state
+                             const int16_t *in,  // (i) Speech signal
+                             size_t nrSamples)   // (i) number of samples
+{
+    uint32_t nrg;
+    int32_t tmp32, tmp32b;
+    uint16_t tmpU16;
+    int16_t tmp16;
+    int16_t zeros, dB;
+
+    nrg = VadFrameEnergy(state, in, nrSamples);
 
     // find number of leading zeros
     if (!(0xFFFF0000 & nrg))
@@ -1100,13 +1300,13 @@ int16_t WebRtcAgc_ProcessVad(AgcVad *state,      // (i) VAD state
     // update long-term estimate of mean energy level (Q10)
     tmp32 = state->meanLongTerm * state->counter + dB;
     state->meanLongTerm =
-            DivW32W16ResW16(tmp32, WebRtcSpl_AddSatW16(state->counter, 1));
+            WebRtcSpl_DivW32W16ResW16(tmp32, WebRtcSpl_AddSatW16(state->counter, 1));
 
     // update long-term estimate of variance in energy level (Q8)
     tmp32 = (dB * dB) >> 12;
     tmp32 += state->varianceLongTerm * state->counter;
     state->varianceLongTerm =
-            DivW32W16(tmp32, WebRtcSpl_AddSatW16(state->counter, 1));
+            WebRtcSpl_DivW32W16(tmp32, WebRtcSpl_AddSatW16(state->counter, 1));
 
     // update long-term estimate of standard deviation in energy level (Q10)
     tmp32 = state->meanLongTerm * state->meanLongTerm;
@@ -1121,7 +1321,7 @@ int16_t WebRtcAgc_ProcessVad(AgcVad *state,      // (i) VAD state
     // significant bits. This cause logRatio to max out positive, rather than
     // negative. This is a bug, but has very little significance.
     tmp32 = tmp16 * (int16_t) (dB - state->meanLongTerm);
-    tmp32 = DivW32W16(tmp32, state->stdLongTerm);
+    tmp32 = WebRtcSpl_DivW32W16(tmp32, state->stdLongTerm);
     tmpU16 = (13 << 12);
     tmp32b = ((int32_t) (int16_t) (state->logRatio) * (uint16_t) (tmpU16));
     tmp32 += tmp32b >> 10;
@@ -1146,11 +1346,12 @@ int WebRtcAgc_AddMic(void *state,
                      size_t num_bands,
                      size_t samples)
 {
-    int32_t nrg, max_nrg, sample, tmp32;
+    int32_t sample, tmp32;
     int32_t *ptr;
     uint16_t targetGainIdx, gain;
     size_t i;
-    int16_t n, L, tmp16, tmp_speech[16];
+    int16_t L, tmp16, tmp_speech[80];
+    const int16_t *speech;
     LegacyAgc *stt;
     stt = (LegacyAgc *) state;
 
@@ -1236,20 +1437,7 @@ int WebRtcAgc_AddMic(void *state,
         ptr = stt->env[0];
     }
 
-    for (i = 0; i < kNumSubframes; i++)
-    {
-        /* iterate over samples */
-        max_nrg = 0;
-        for (n = 0; n < L; n++)
-        {
-            nrg = in_mic[0][i * L + n] * in_mic[0][i * L + n];
-            if (nrg > max_nrg)
-            {
-                max_nrg = nrg;
-            }
-        }
-        ptr[i] = max_nrg;
-    }
+    WebRtcSpl_MaxSquareBlocksW16(in_mic[0], (size_t) L, kNumSubframes, ptr);
 
     /* compute energy */
     if (stt->inQueue > 0)
@@ -1261,19 +1449,20 @@ int WebRtcAgc_AddMic(void *state,
         ptr = stt->Rxx16w32_array[0];
     }
 
+    /* the whole frame at 8 kHz */
+    if (stt->fs == 16000)
+    {
+        downsampleBy2(in_mic[0], 160, tmp_speech, stt->filterState);
+        speech = tmp_speech;
+    }
+    else
+    {
+        speech = in_mic[0];
+    }
     for (i = 0; i < kNumSubframes / 2; i++)
     {
-        if (stt->fs == 16000)
-        {
-            downsampleBy2(&in_mic[0][i * 32], 32, tmp_speech,
-                          stt->filterState);
-        }
-        else
-        {
-            memcpy(tmp_speech, &in_mic[0][i * 16], 16 * sizeof(short));
-        }
         /* Compute energy in blocks of 16 samples */
-        ptr[i] = DotProductWithScale(tmp_speech, tmp_speech, 16, 4);
+        ptr[i] = WebRtcSpl_DotProductWithScale(&speech[i * 16], &speech[i * 16], 16, 4);
     }
 
     /* update queue information */
@@ -1496,7 +1685,7 @@ void WebRtcAgc_UpdateAgcThresholds(LegacyAgc *stt)
 
     /* Set analog target level in envelope dBOv scale */
     tmp16 = (DIFF_REF_TO_ANALOG * stt->compressionGaindB) + ANALOG_TARGET_LEVEL_2;
-    tmp16 = DivW32W16ResW16((int32_t) tmp16, ANALOG_TARGET_LEVEL);
+    tmp16 = WebRtcSpl_DivW32W16ResW16((int32_t) tmp16, ANALOG_TARGET_LEVEL);
     stt->analogTarget = DIGITAL_REF_AT_0_COMP_GAIN + tmp16;
     if (stt->analogTarget < DIGITAL_REF_AT_0_COMP_GAIN)
     {
@@ -2218,15 +2407,14 @@ int32_t WebRtcAgc_ProcessAnalog(void *state,
     return 0;
 }
 
-int WebRtcAgc_Process(void *agcInst,
-                      const int16_t *const *in_near,
-                      size_t num_bands,
-                      size_t samples,
-                      int16_t *const *out,
-                      int32_t inMicLevel,
-                      int32_t *outMicLevel,
-                      int16_t echo,
-                      uint8_t *saturationWarning)
+int WebRtcAgc_ProcessDigitalStage(void *agcInst,
+                                  const int16_t *const *in_near,
+                                  size_t num_bands,
+                                  size_t samples,
+                                  int16_t *const *out,
+                                  int32_t inMicLevel,
+                                  int32_t *outMicLevel,
+                                  uint8_t *saturationWarning)
 {
     LegacyAgc *stt;
     stt = (LegacyAgc *) agcInst;
@@ -2241,13 +2429,23 @@ int WebRtcAgc_Process(void *agcInst,
             return -1;
         }
     }
-    else if (stt->fs == 16000 || stt->fs == 32000 || stt->fs == 48000)
+    else if (stt->fs == 16000)
     {
         if (samples != 160)
         {
             return -1;
         }
     }
+    else if (stt->fs == 32000 || stt->fs == 48000)
+    {
+        // 160 samples per band, or one full band frame. WebRtcAgc_AddMic()
+        // only takes bands, the analog mode has no input level otherwise.
+        if (samples != 160 && (samples != stt->fs / 100 || num_bands != 1 ||
+                               stt->agcMode == kAgcModeAdaptiveAnalog))
+        {
+            return -1;
+        }
+    }
     else
     {
         return -1;
@@ -2261,8 +2459,16 @@ int WebRtcAgc_Process(void *agcInst,
     stt->fcount++;
 #endif
 
-    if (WebRtcAgc_ProcessDigital(&stt->digitalAgc, in_near, num_bands, out,
-                                 stt->fs, stt->lowLevelSignal) == -1)
+    if (samples > 160)
+    {
+        if (WebRtcAgc_ProcessDigitalFullBand(&stt->digitalAgc, in_near[0], out[0],
+                                             stt->fs, stt->lowLevelSignal) == -1)
+        {
+            return -1;
+        }
+    }
+    else if (WebRtcAgc_ProcessDigital(&stt->digitalAgc, in_near, num_bands, out,
+                                      stt->fs, stt->lowLevelSignal) == -1)
     {
 #ifdef WEBRTC_AGC_DEBUG_DUMP
         fprintf(stt->fpt, "AGC->Process, frame %d: Error from DigAGC\n\n",
@@ -2270,6 +2476,21 @@ int WebRtcAgc_Process(void *agcInst,
 #endif
         return -1;
     }
+    return 0;
+}
+
+int WebRtcAgc_ProcessAnalogStage(void *agcInst,
+                                 int32_t inMicLevel,
+                                 int32_t *outMicLevel,
+                                 int16_t echo,
+                                 uint8_t *saturationWarning)
+{
+    LegacyAgc *stt;
+    stt = (LegacyAgc *) agcInst;
+    if (stt == NULL)
+    {
+        return -1;
+    }
     if (stt->agcMode < kAgcModeFixedDigital &&
         (stt->lowLevelSignal == 0 || stt->agcMode != kAgcModeAdaptiveDigital))
     {
@@ -2300,6 +2521,93 @@ int WebRtcAgc_Process(void *agcInst,
     return 0;
 }
 
+int WebRtcAgc_Process(void *agcInst,
+                      const int16_t *const *in_near,
+                      size_t num_bands,
+                      size_t samples,
+                      int16_t *const *out,
+                      int32_t inMicLevel,
+                      int32_t *outMicLevel,
+                      int16_t echo,
+                      uint8_t *saturationWarning)
+{
+    if (WebRtcAgc_ProcessDigitalStage(agcInst, in_near, num_bands, samples, out,
+                                      inMicLevel, outMicLevel, saturationWarning) != 0)
+    {
+        return -1;
+    }
+    return WebRtcAgc_ProcessAnalogStage(agcInst, inMicLevel, outMicLevel, echo,
+                                        saturationWarning);
+}
+
+int WebRtcAgc_ProcessInterleaved(void *agcInst,
+                                 int16_t *buffer,
+                                 size_t num_channels,
+                                 size_t samples,
+                                 int32_t inMicLevel,
+                                 int32_t *outMicLevel,
+                                 int16_t echo,
+                                 uint8_t *saturationWarning)
+{
+    LegacyAgc *stt;
+    stt = (LegacyAgc *) agcInst;
+    // WebRtcAgc_AddMic() does not take interleaved frames, the analog mode
+    // would run without an input level.
+    if (stt == NULL || samples != stt->fs / 100 || stt->agcMode == kAgcModeAdaptiveAnalog)
+    {
+        return -1;
+    }
+
+    *saturationWarning = 0;
+    *outMicLevel = inMicLevel;
+
+#ifdef WEBRTC_AGC_DEBUG_DUMP
+    stt->fcount++;
+#endif
+
+    if (WebRtcAgc_ProcessDigitalInterleaved(&stt->digitalAgc, buffer, num_channels,
+                                            stt->fs, stt->lowLevelSignal) == -1)
+    {
+        return -1;
+    }
+    return WebRtcAgc_ProcessAnalogStage(agcInst, inMicLevel, outMicLevel, echo,
+                                        saturationWarning);
+}
+
+int WebRtcAgc_ProcessInterleavedFloat(void *agcInst,
+                                      float *buffer,
+                                      size_t num_channels,
+                                      size_t samples,
+                                      int32_t inMicLevel,
+                                      int32_t *outMicLevel,
+                                      int16_t echo,
+                                      uint8_t *saturationWarning)
+{
+    LegacyAgc *stt;
+    stt = (LegacyAgc *) agcInst;
+    // WebRtcAgc_AddMic() does not take interleaved frames, the analog mode
+    // would run without an input level.
+    if (stt == NULL || samples != stt->fs / 100 || stt->agcMode == kAgcModeAdaptiveAnalog)
+    {
+        return -1;
+    }
+
+    *saturationWarning = 0;
+    *outMicLevel = inMicLevel;
+
+#ifdef WEBRTC_AGC_DEBUG_DUMP
+    stt->fcount++;
+#endif
+
+    if (WebRtcAgc_ProcessDigitalFloat(&stt->digitalAgc, buffer, num_channels,
+                                      stt->fs, stt->lowLevelSignal) == -1)
+    {
+        return -1;
+    }
+    return WebRtcAgc_ProcessAnalogStage(agcInst, inMicLevel, outMicLevel, echo,
+                                        saturationWarning);
+}
+
 int WebRtcAgc_set_config(void *agcInst, WebRtcAgcConfig agcConfig)
 {
     LegacyAgc *stt;
@@ -2392,6 +2700,8 @@ void *WebRtcAgc_Create()
 {
     LegacyAgc *stt = malloc(sizeof(LegacyAgc));
 
+    WebRtcSpl_Init();
+
 #ifdef WEBRTC_AGC_DEBUG_DUMP
     stt->fpt = fopen("./agc_test_log.txt", "wt");
     stt->agcLog = fopen("./agc_debug_log.txt", "wt");
@@ -2469,7 +2779,7 @@ int WebRtcAgc_Init(void *agcInst,
 
     /* If the volume range is smaller than 0-256 then
      * the levels are shifted up to Q8-domain */
-    tmpNorm = NormU32((uint32_t) maxLevel);
+    tmpNorm = WebRtcSpl_NormU32((uint32_t) maxLevel);
     stt->scale = tmpNorm - 23;
     if (stt->scale < 0)
     {
@@ -45,6 +45,10 @@ typedef struct {
     int16_t stdShortTerm;       // Q10
 } AgcVad;                     // total = 54 bytes
 
+// Samples per ms of a full band frame at 48 kHz.
+#define AGC_MAX_SAMPLES_PER_MS 48
+#define AGC_DECIMATOR_TAPS 15
+
 typedef struct {
     int32_t capacitorSlow;
     int32_t capacitorFast;
@@ -54,6 +58,8 @@ typedef struct {
     int16_t agcMode;
     AgcVad vadNearend;
     AgcVad vadFarend;
+    // Decimation of full band frames to 16 kHz for the VAD, at 32 and 48 kHz.
+    int16_t decimatorHistory[AGC_DECIMATOR_TAPS - 1];
 #ifdef WEBRTC_AGC_DEBUG_DUMP
     FILE* logFile;
     int frameCounter;
@@ -69,6 +75,33 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc *digitalAgcInst,
                                  uint32_t FS,
                                  int16_t lowLevelSignal);
 
+// Same as WebRtcAgc_ProcessDigital() on one full band 10 ms frame of 320
+// samples at 32 kHz or 480 at 48 kHz. The VAD runs on a copy decimated to
+// 16 kHz, the envelope and the gain use the full rate.
+int32_t WebRtcAgc_ProcessDigitalFullBand(DigitalAgc *digitalAgcInst,
+                                         const int16_t *in_near,
+                                         int16_t *out,
+                                         uint32_t FS,
+                                         int16_t lowLevelSignal);
+
+// Linked digital AGC on one 10 ms frame of |num_channels| interleaved
+// channels at any rate, in place. One gain for all channels, from the VAD on
+// the channel mean and the envelope of the loudest channel.
+int32_t WebRtcAgc_ProcessDigitalInterleaved(DigitalAgc *digitalAgcInst,
+                                            int16_t *buffer,
+                                            size_t num_channels,
+                                            uint32_t FS,
+                                            int16_t lowLevelSignal);
+
+// Same as WebRtcAgc_ProcessDigitalInterleaved() on float samples in the
+// 16-bit range, with the same gains and VAD decisions. The gains are applied
+// in float, the output is limited to the 16-bit range but not rounded.
+int32_t WebRtcAgc_ProcessDigitalFloat(DigitalAgc *digitalAgcInst,
+                                      float *buffer,
+                                      size_t num_channels,
+                                      uint32_t FS,
+                                      int16_t lowLevelSignal);
+
 int32_t WebRtcAgc_AddFarendToDigital(DigitalAgc *digitalAgcInst,
                                      const int16_t *inFar,
                                      size_t nrSamples);
@@ -206,9 +239,12 @@ int WebRtcAgc_VirtualMic(void *agcInst,
  * This function processes a 10 ms frame and adjusts (normalizes) the gain both
  * analog and digitally. The gain adjustments are done only during active
  * periods of speech. The length of the speech vectors must be given in samples
- * (80 when FS=8000, and 160 when FS=16000, FS=32000 or FS=48000). The echo
- * parameter can be used to ensure the AGC will not adjust upward in the
- * presence of echo.
+ * (80 when FS=8000, and 160 when FS=16000, FS=32000 or FS=48000). At 32 and
+ * 48 kHz a full band frame of 320 or 480 samples with num_bands 1 is accepted
+ * too, the gain is then applied at the full rate. WebRtcAgc_AddMic() only
+ * takes bands, so full band frames are rejected in kAgcModeAdaptiveAnalog.
+ * The echo parameter can be used to ensure the AGC will not adjust upward in
+ * the presence of echo.
  *
  * This function should be called after processing the near-end microphone
  * signal, in any case after any echo cancellation.
@@ -246,6 +282,81 @@ int WebRtcAgc_Process(void *agcInst,
                       int16_t echo,
                       uint8_t *saturationWarning);
 
+/*
+ * This function does the same as WebRtcAgc_Process() on one 10 ms frame of
+ * |num_channels| interleaved channels, in place. The channels are linked:
+ * the VAD runs once on their mean, the envelope follows the loudest channel,
+ * and every channel gets the same gain so that the spatial image is kept.
+ * The analog level control needs WebRtcAgc_AddMic(), which does not take
+ * interleaved frames, so kAgcModeAdaptiveAnalog is rejected.
+ *
+ * Input:
+ *      - agcInst           : AGC instance
+ *      - buffer            : Interleaved near-end speech, sample k of channel
+ *                            c at buffer[k * num_channels + c]
+ *      - num_channels      : Number of channels
+ *      - samples           : Number of samples per channel, FS / 100
+ *      - inMicLevel        : Current microphone volume level
+ *      - echo              : Same as in WebRtcAgc_Process()
+ *
+ * Output:
+ *      - buffer            : Gain-adjusted near-end speech
+ *      - outMicLevel       : Adjusted microphone volume level
+ *      - saturationWarning : Same as in WebRtcAgc_Process()
+ *
+ * Return value:
+ *                          :  0 - Normal operation.
+ *                          : -1 - Error
+ */
+int WebRtcAgc_ProcessInterleaved(void *agcInst,
+                                 int16_t *buffer,
+                                 size_t num_channels,
+                                 size_t samples,
+                                 int32_t inMicLevel,
+                                 int32_t *outMicLevel,
+                                 int16_t echo,
+                                 uint8_t *saturationWarning);
+
+/*
+ * This function does the same as WebRtcAgc_ProcessInterleaved() on float
+ * samples in the 16-bit range, without converting the frame to 16 bits and
+ * back. The output is limited to that range but not rounded.
+ */
+int WebRtcAgc_ProcessInterleavedFloat(void *agcInst,
+                                      float *buffer,
+                                      size_t num_channels,
+                                      size_t samples,
+                                      int32_t inMicLevel,
+                                      int32_t *outMicLevel,
+                                      int16_t echo,
+                                      uint8_t *saturationWarning);
+
+/*
+ * These two functions are the two halves of WebRtcAgc_Process(), split so
+ * that the digital compressor and the analog level control can be timed
+ * separately. Calling WebRtcAgc_ProcessDigitalStage() and then
+ * WebRtcAgc_ProcessAnalogStage() on the same frame is the same as one call
+ * to WebRtcAgc_Process(); the parameters have the same meaning.
+ *
+ * Return value:
+ *                          :  0 - Normal operation.
+ *                          : -1 - Error
+ */
+int WebRtcAgc_ProcessDigitalStage(void *agcInst,
+                                  const int16_t *const *in_near,
+                                  size_t num_bands,
+                                  size_t samples,
+                                  int16_t *const *out,
+                                  int32_t inMicLevel,
+                                  int32_t *outMicLevel,
+                                  uint8_t *saturationWarning);
+
+int WebRtcAgc_ProcessAnalogStage(void *agcInst,
+                                 int32_t inMicLevel,
+                                 int32_t *outMicLevel,
+                                 int16_t echo,
+                                 uint8_t *saturationWarning);
+
 /*
  * This function sets the config parameters (targetLevelDbfs,
  * compressionGaindB and limiterEnable).
@@ -6,6 +6,7 @@
 
 #include "dr_wav.h"
 #include "agc.h"
+#include "../Tools/batch.h"
 
 #ifndef nullptr
 #define nullptr 0
@@ -88,8 +89,11 @@ double calcElapsed(double start, double end)
     return took + end;
 }
 
-//写wav文件
-void wavWrite_int16(char *filename, int16_t *buffer, size_t sampleRate, size_t totalSampleCount, unsigned int channels)
+// 每次读写的 10ms 帧数, 内存占用与文件长度无关
+#define BLOCK_FRAMES 50
+
+//打开wav文件用于流式写入
+int wavOpenWrite(drwav *pWav, const char *filename, size_t sampleRate, unsigned int channels)
 {
     drwav_data_format format = {};
     format.container = drwav_container_riff;     // <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
@@ -97,28 +101,23 @@ void wavWrite_int16(char *filename, int16_t *buffer, size_t sampleRate, size_t t
     format.channels = channels;
     format.sampleRate = (drwav_uint32) sampleRate;
     format.bitsPerSample = 16;
-    drwav *pWav = drwav_open_file_write(filename, &format);
-    if (pWav)
+    if (!drwav_init_file_write(pWav, filename, &format))
     {
-        drwav_uint64 samplesWritten = drwav_write(pWav, totalSampleCount, buffer);
-        drwav_uninit(pWav);
-        if (samplesWritten != totalSampleCount)
-        {
-            fprintf(stderr, "ERROR\n");
-            exit(1);
-        }
+        fprintf(stderr, "ERROR\n");
+        return -1;
     }
+    return 0;
 }
 
-//读取wav文件
-int16_t *wavRead_int16(char *filename, uint32_t *sampleRate, uint64_t *totalSampleCount, unsigned int *channels)
+//打开wav文件用于流式读取
+int wavOpenRead(drwav *pWav, const char *filename)
 {
-    int16_t *buffer = drwav_open_and_read_file_s16(filename, channels, sampleRate, totalSampleCount);
-    if (buffer == nullptr)
+    if (!drwav_init_file(pWav, filename))
     {
         printf("读取wav文件失败.");
+        return -1;
     }
-    return buffer;
+    return 0;
 }
 
 //分割路径函数
@@ -170,28 +169,40 @@ void splitpath(const char *path, char *drv, char *dir, char *name, char *ext)
 }
 
 
-int agcProcess(int16_t *buffer, uint32_t sampleRate, size_t samplesCount, int16_t agcMode)
+int agcProcess(drwav *reader, drwav *writer, int16_t agcMode, double *processTime)
 {
-    if (buffer == nullptr) return -1;
-    if (samplesCount == 0) return -1;
+    if (reader == nullptr || writer == nullptr) return -1;
+    uint32_t sampleRate = reader->sampleRate;
+    size_t channels = reader->channels;
     WebRtcAgcConfig agcConfig;
     agcConfig.compressionGaindB = 9; // default 9 dB
     agcConfig.limiterEnable = 1; // default kAgcTrue (on)
     agcConfig.targetLevelDbfs = 3; // default 3 (-3 dBOv)
     int minLevel = 0;
     int maxLevel = 255;
-    size_t samples = MIN(160, sampleRate / 100);
-    if (samples == 0) return -1;
-    const int maxSamples = 320;
-    int16_t *input = buffer;
-    size_t nTotal = (samplesCount / samples);
+    // 10 ms frames, at 32 and 48 kHz full band frames
+    size_t samples = sampleRate / 100;
+    if (samples == 0 || samples > 480 || channels == 0) return -1;
+    // 所有声道交错存放, 共用一个增益
+    size_t frameSamples = samples * channels;
+    size_t blockSamples = frameSamples * BLOCK_FRAMES;
+    int16_t *block = (int16_t *) malloc((blockSamples + 2 * frameSamples) * sizeof(int16_t));
+    if (block == NULL) return -1;
+    // 尾部拼帧用的缓冲, 以及最后一个完整帧的输出
+    int16_t *tail_buffer = block + blockSamples;
+    int16_t *last_buffer = tail_buffer + frameSamples;
     void *agcInst = WebRtcAgc_Create();
-    if (agcInst == NULL) return -1;
+    if (agcInst == NULL)
+    {
+        free(block);
+        return -1;
+    }
     int status = WebRtcAgc_Init(agcInst, minLevel, maxLevel, agcMode, sampleRate);
     if (status != 0)
     {
         printf("WebRtcAgc_Init fail\n");
         WebRtcAgc_Free(agcInst);
+        free(block);
         return -1;
     }
     status = WebRtcAgc_set_config(agcInst, agcConfig);
@@ -199,83 +210,127 @@ int agcProcess(int16_t *buffer, uint32_t sampleRate, size_t samplesCount, int16_
     {
         printf("WebRtcAgc_set_config fail\n");
         WebRtcAgc_Free(agcInst);
+        free(block);
         return -1;
     }
-    size_t num_bands = 1;
     int inMicLevel, outMicLevel = -1;
-    int16_t out_buffer[maxSamples];
-    int16_t *out16 = out_buffer;
+    size_t nTotal = 0;
     uint8_t saturationWarning = 1;               //是否有溢出发生，增益放大以后的最大值超过了65536
     int16_t echo = 0;                            //增益放大是否考虑回声影响
-    for (int i = 0; i < nTotal; i++)
+    uint64_t samplesRead;
+    while ((samplesRead = drwav_read_s16(reader, blockSamples, block)) > 0)
     {
-        inMicLevel = 0;
-        int nAgcRet = WebRtcAgc_Process(agcInst, (const int16_t *const *) &input, num_bands, samples,
-                                        (int16_t *const *) &out16, inMicLevel, &outMicLevel, echo,
-                                        &saturationWarning);
-
-        if (nAgcRet != 0)
+        double startTime = now();
+        size_t nFrames = samplesRead / frameSamples;
+        int16_t *input = block;
+        for (size_t i = 0; i < nFrames; i++)
         {
-            printf("failed in WebRtcAgc_Process\n");
-            WebRtcAgc_Free(agcInst);
-            return -1;
+            inMicLevel = 0;
+            int nAgcRet = WebRtcAgc_ProcessInterleaved(agcInst, input, channels, samples, inMicLevel,
+                                                       &outMicLevel, echo, &saturationWarning);
+
+            if (nAgcRet != 0)
+            {
+                printf("failed in WebRtcAgc_Process\n");
+                WebRtcAgc_Free(agcInst);
+                free(block);
+                return -1;
+            }
+            input += frameSamples;
         }
-        memcpy(input, out_buffer, samples * sizeof(int16_t));
-        input += samples;
-    }
+        nTotal += nFrames;
 
-    const size_t remainedSamples = samplesCount - nTotal * samples;
-    if (remainedSamples > 0)
-    {
-        if (nTotal > 0)
+        const size_t remainedSamples = samplesRead - nFrames * frameSamples;
+        if (remainedSamples > 0)
         {
-            input = input - samples + remainedSamples;
-        }
+            // 尾部与前一帧的输出拼成一个完整帧
+            memset(tail_buffer, 0, frameSamples * sizeof(int16_t));
+            if (nTotal > 0)
+            {
+                const int16_t *prev = nFrames > 0 ? input - frameSamples : last_buffer;
+                memcpy(tail_buffer, prev + remainedSamples, (frameSamples - remainedSamples) * sizeof(int16_t));
+                memcpy(&tail_buffer[frameSamples - remainedSamples], input, remainedSamples * sizeof(int16_t));
+            }
+            else
+            {
+                memcpy(tail_buffer, input, remainedSamples * sizeof(int16_t));
+            }
+            inMicLevel = 0;
+            int nAgcRet = WebRtcAgc_ProcessInterleaved(agcInst, tail_buffer, channels, samples, inMicLevel,
+                                                       &outMicLevel, echo, &saturationWarning);
 
-        inMicLevel = 0;
-        int nAgcRet = WebRtcAgc_Process(agcInst, (const int16_t *const *) &input, num_bands, samples,
-                                        (int16_t *const *) &out16, inMicLevel, &outMicLevel, echo,
-                                        &saturationWarning);
+            if (nAgcRet != 0)
+            {
+                printf("failed in WebRtcAgc_Process during filtering the last chunk\n");
+                WebRtcAgc_Free(agcInst);
+                free(block);
+                return -1;
+            }
+            memcpy(input, nTotal > 0 ? &tail_buffer[frameSamples - remainedSamples] : tail_buffer,
+                   remainedSamples * sizeof(int16_t));
+        }
+        else if (nFrames > 0)
+        {
+            memcpy(last_buffer, input - frameSamples, frameSamples * sizeof(int16_t));
+        }
+        *processTime += calcElapsed(startTime, now());
 
-        if (nAgcRet != 0)
+        if (drwav_write(writer, samplesRead, block) != samplesRead)
         {
-            printf("failed in WebRtcAgc_Process during filtering the last chunk\n");
+            fprintf(stderr, "ERROR\n");
             WebRtcAgc_Free(agcInst);
+            free(block);
             return -1;
         }
-        memcpy(&input[samples - remainedSamples], &out_buffer[samples - remainedSamples],
-               remainedSamples * sizeof(int16_t));
-        input += samples;
     }
 
     WebRtcAgc_Free(agcInst);
+    free(block);
     return 1;
 }
 
-void auto_gain(char *in_file, char *out_file)
+int auto_gain(const char *in_file, const char *out_file, double *audioSeconds, double *processSeconds)
 {
-    //音频采样率
-    uint32_t sampleRate = 0;
-    //总音频采样数
-    uint64_t inSampleCount = 0;
-    unsigned int channels = 0;
-    int16_t *inBuffer = wavRead_int16(in_file, &sampleRate, &inSampleCount, &channels);
-    //如果加载成功
-    if (inBuffer != nullptr)
+    drwav reader;
+    drwav writer;
+    //按块读取, 避免整个文件载入内存
+    if (wavOpenRead(&reader, in_file) != 0)
+        return -1;
+    if (wavOpenWrite(&writer, out_file, reader.sampleRate, reader.channels) != 0)
     {
-        //  kAgcModeAdaptiveAnalog  模拟音量调节
-        //  kAgcModeAdaptiveDigital 自适应增益
-        //  kAgcModeFixedDigital 固定增益
-        double startTime = now();
+        drwav_uninit(&reader);
+        return -1;
+    }
+    //  kAgcModeAdaptiveAnalog  模拟音量调节
+    //  kAgcModeAdaptiveDigital 自适应增益
+    //  kAgcModeFixedDigital 固定增益
+    *processSeconds = 0;
 
-        agcProcess(inBuffer, sampleRate, inSampleCount, kAgcModeAdaptiveDigital);
+    int ret = agcProcess(&reader, &writer, kAgcModeAdaptiveDigital, processSeconds);
 
-        double elapsed_time = calcElapsed(startTime, now());
+    *audioSeconds = (double) reader.totalSampleCount / (reader.channels * reader.sampleRate);
+    drwav_uninit(&writer);
+    drwav_uninit(&reader);
+    return ret > 0 ? 0 : -1;
+}
 
-        printf("time: %d ms\n ", (int) (elapsed_time * 1000));
-        wavWrite_int16(out_file, inBuffer, sampleRate, inSampleCount, channels);
-        free(inBuffer);
-    }
+//输出文件名: 输入文件名加 _out 后缀
+void outFilePath(const char *in_file, char *out_file)
+{
+    char drive[3];
+    char dir[256];
+    char fname[256];
+    char ext[256];
+    splitpath(in_file, drive, dir, fname, ext);
+    sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
+}
+
+int agcBatchJob(const char *in_file, void *user, double *audioSeconds, double *processSeconds)
+{
+    char out_file[1024];
+    (void) user;
+    outFilePath(in_file, out_file);
+    return auto_gain(in_file, out_file, audioSeconds, processSeconds);
 }
 
 int main(int argc, char *argv[])
@@ -283,18 +338,36 @@ int main(int argc, char *argv[])
     printf("WebRTC Automatic Gain Control\n");
     printf("音频自动增益\n");
     if (argc < 2)
+    {
+        printf("usage : AGC in_file.wav\n");
+        printf("        AGC -b dir_or_manifest [threads]\n");
         return -1;
+    }
+    if (strcmp(argv[1], "-b") == 0)
+    {
+        //批处理模式: 每个文件一个独立实例, 线程数默认为 CPU 核数
+        if (argc < 3)
+            return -1;
+        BatchList list;
+        BatchStats stats;
+        if (batchListLoad(&list, argv[2], ".wav") != 0)
+            return -1;
+        double startTime = now();
+        int threads = batchRun(&list, argc > 3 ? atoi(argv[3]) : 0, agcBatchJob, NULL, &stats);
+        stats.wallSeconds = calcElapsed(startTime, now());
+        batchReport(&stats, threads);
+        batchListFree(&list);
+        return stats.failed == 0 && threads > 0 ? 0 : 1;
+    }
     char *in_file = argv[1];
-    char drive[3];
-    char dir[256];
-    char fname[256];
-    char ext[256];
     char out_file[1024];
-    splitpath(in_file, drive, dir, fname, ext);
-    sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
-    auto_gain(in_file, out_file);
+    outFilePath(in_file, out_file);
+    double audioSeconds = 0;
+    double elapsed_time = 0;
+    auto_gain(in_file, out_file, &audioSeconds, &elapsed_time);
+    printf("time: %d ms\n ", (int) (elapsed_time * 1000));
 
     printf("按任意键退出程序 \n");
     getchar();
     return 0;
-}
\ No newline at end of file
+}
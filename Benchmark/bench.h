@@ -0,0 +1,52 @@
+/*
+ * Kernel microbenchmarks for the DSP hot paths of the 3A1V modules.
+ *
+ * Every kernel is described by a BenchKernel entry. The driver creates a state
+ * for each sampling rate, runs the kernel until the measurement time is
+ * reached and reports ns/call and processed 10 ms frames per second.
+ */
+
+#ifndef WEBRTC_3A1V_BENCHMARK_BENCH_H_
+#define WEBRTC_3A1V_BENCHMARK_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BENCH_SIGNAL_FRAMES 100     // distinct 10 ms input frames per kernel
+
+typedef struct
+{
+    const char *name;
+    // Creates the state for sampling rate |fs|. Returns NULL when the kernel
+    // does not run at that rate. |samplesPerCall| receives the number of input
+    // samples at |fs| one call of |run| accounts for.
+    void *(*create)(int fs, size_t *samplesPerCall);
+    // Runs the kernel once, must consume fresh input on every call.
+    void (*run)(void *state);
+    void (*destroy)(void *state);
+} BenchKernel;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Fills |out| with a reproducible speech-like test signal (tones, amplitude
+// modulation and noise), |seed| selects the noise sequence.
+void Bench_FillSignal(int16_t *out, size_t length, int fs, uint32_t seed);
+
+// Kernel tables, one per module.
+const BenchKernel *BenchNs_Kernels(size_t *count);
+const BenchKernel *BenchAecm_Kernels(size_t *count);
+const BenchKernel *BenchAgc_Kernels(size_t *count);
+const BenchKernel *BenchVad_Kernels(size_t *count);
+const BenchKernel *BenchCng_Kernels(size_t *count);
+
+// Prints the output SNR of the NS fast math path against the libm path, the
+// speed of both is in the kernel table.
+void BenchNs_FastMathReport(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_3A1V_BENCHMARK_BENCH_H_
@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../AECM/aecm.h"
+
+// The real FFT of the AECM is not part of aecm.h.
+struct RealFFT;
+
+struct RealFFT *WebRtcSpl_CreateRealFFT(int order);
+
+void WebRtcSpl_FreeRealFFT(struct RealFFT *self);
+
+int WebRtcSpl_RealForwardFFT(struct RealFFT *self, const int16_t *real_data_in, int16_t *complex_data_out);
+
+#define BENCH_AECM_BLOCKS (BENCH_SIGNAL_FRAMES * 2)
+
+// The AECM runs at 8 and 16 kHz only, its kernels work on blocks of PART_LEN
+// samples at the native rate.
+static int aecmSupported(int fs)
+{
+    return fs == 8000 || fs == 16000;
+}
+
+typedef struct
+{
+    struct RealFFT *fft;
+    size_t next;
+    int16_t signal[BENCH_AECM_BLOCKS * PART_LEN2];
+    int16_t spectrum[PART_LEN2 + 2];
+} FftState;
+
+static void *fftCreate(int fs, size_t *samplesPerCall)
+{
+    if (!aecmSupported(fs))
+        return NULL;
+    FftState *self = (FftState *) calloc(1, sizeof(FftState));
+    if (self == NULL)
+        return NULL;
+    self->fft = WebRtcSpl_CreateRealFFT(PART_LEN_SHIFT);
+    if (self->fft == NULL)
+    {
+        free(self);
+        return NULL;
+    }
+    Bench_FillSignal(self->signal, BENCH_AECM_BLOCKS * PART_LEN2, fs, 3);
+    // One forward transform per block of PART_LEN new samples.
+    *samplesPerCall = PART_LEN;
+    return self;
+}
+
+static void fftRun(void *state)
+{
+    FftState *self = (FftState *) state;
+    WebRtcSpl_RealForwardFFT(self->fft, &self->signal[self->next * PART_LEN2], self->spectrum);
+    self->next = (self->next + 1) % BENCH_AECM_BLOCKS;
+}
+
+static void fftDestroy(void *state)
+{
+    FftState *self = (FftState *) state;
+    WebRtcSpl_FreeRealFFT(self->fft);
+    free(self);
+}
+
+typedef struct
+{
+    AecmCore *aecm;
+    size_t next;
+    int16_t farend[BENCH_AECM_BLOCKS * PART_LEN];
+    int16_t nearend[BENCH_AECM_BLOCKS * PART_LEN];
+    int16_t out[PART_LEN];
+} BlockState;
+
+static void *blockCreate(int fs, size_t *samplesPerCall)
+{
+    if (!aecmSupported(fs))
+        return NULL;
+    BlockState *self = (BlockState *) calloc(1, sizeof(BlockState));
+    if (self == NULL)
+        return NULL;
+    self->aecm = WebRtcAecm_CreateCore();
+    if (self->aecm == NULL || WebRtcAecm_InitCore(self->aecm, fs) != 0)
+    {
+        WebRtcAecm_FreeCore(self->aecm);
+        free(self);
+        return NULL;
+    }
+    Bench_FillSignal(self->farend, BENCH_AECM_BLOCKS * PART_LEN, fs, 4);
+    // Near-end: attenuated echo of the far-end plus local noise.
+    Bench_FillSignal(self->nearend, BENCH_AECM_BLOCKS * PART_LEN, fs, 5);
+    for (size_t i = 0; i < BENCH_AECM_BLOCKS * PART_LEN; i++)
+        self->nearend[i] = (int16_t) (self->nearend[i] / 4 + self->farend[i] / 2);
+    *samplesPerCall = PART_LEN;
+    return self;
+}
+
+static void blockRun(void *state)
+{
+    BlockState *self = (BlockState *) state;
+    const size_t offset = self->next * PART_LEN;
+    WebRtcAecm_ProcessBlock(self->aecm, &self->farend[offset], &self->nearend[offset], NULL, self->out);
+    self->next = (self->next + 1) % BENCH_AECM_BLOCKS;
+}
+
+static void blockDestroy(void *state)
+{
+    BlockState *self = (BlockState *) state;
+    WebRtcAecm_FreeCore(self->aecm);
+    free(self);
+}
+
+typedef struct
+{
+    BinaryDelayEstimatorFarend *farend;
+    BinaryDelayEstimator *estimator;
+    size_t next;
+    uint32_t nearSpectrum[BENCH_AECM_BLOCKS];
+} DelayState;
+
+static void *delayCreate(int fs, size_t *samplesPerCall)
+{
+    if (!aecmSupported(fs))
+        return NULL;
+    DelayState *self = (DelayState *) calloc(1, sizeof(DelayState));
+    if (self == NULL)
+        return NULL;
+    // Same history and lookahead as the AECM core.
+    self->farend = WebRtc_CreateBinaryDelayEstimatorFarend(MAX_DELAY);
+    self->estimator = self->farend ? WebRtc_CreateBinaryDelayEstimator(self->farend, 0) : NULL;
+    if (self->estimator == NULL)
+    {
+        WebRtc_FreeBinaryDelayEstimatorFarend(self->farend);
+        free(self);
+        return NULL;
+    }
+    WebRtc_InitBinaryDelayEstimatorFarend(self->farend);
+    WebRtc_InitBinaryDelayEstimator(self->estimator);
+    uint32_t seed = 12345;
+    for (int i = 0; i < MAX_DELAY; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        WebRtc_AddBinaryFarSpectrum(self->farend, seed);
+    }
+    for (size_t i = 0; i < BENCH_AECM_BLOCKS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        self->nearSpectrum[i] = seed;
+    }
+    *samplesPerCall = PART_LEN;
+    return self;
+}
+
+static void delayRun(void *state)
+{
+    DelayState *self = (DelayState *) state;
+    WebRtc_ProcessBinarySpectrum(self->estimator, self->nearSpectrum[self->next]);
+    self->next = (self->next + 1) % BENCH_AECM_BLOCKS;
+}
+
+static void delayDestroy(void *state)
+{
+    DelayState *self = (DelayState *) state;
+    WebRtc_FreeBinaryDelayEstimator(self->estimator);
+    WebRtc_FreeBinaryDelayEstimatorFarend(self->farend);
+    free(self);
+}
+
+static const BenchKernel kAecmKernels[] = {
+        {"WebRtcSpl_RealForwardFFT", fftCreate, fftRun, fftDestroy},
+        {"WebRtcAecm_ProcessBlock", blockCreate, blockRun, blockDestroy},
+        {"WebRtc_ProcessBinarySpectrum", delayCreate, delayRun, delayDestroy},
+};
+
+const BenchKernel *BenchAecm_Kernels(size_t *count)
+{
+    *count = sizeof(kAecmKernels) / sizeof(kAecmKernels[0]);
+    return kAecmKernels;
+}
@@ -0,0 +1,243 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../AGC/agc.h"
+
+#define BENCH_AGC_FRAME_MAX 480
+
+typedef struct
+{
+    void *agc;
+    size_t frameLength;
+    uint32_t fs;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BENCH_AGC_FRAME_MAX];
+    int16_t out[BENCH_AGC_FRAME_MAX];
+} DigitalState;
+
+static void *digitalCreate(int fs, size_t *samplesPerCall)
+{
+    DigitalState *self = (DigitalState *) calloc(1, sizeof(DigitalState));
+    if (self == NULL)
+        return NULL;
+    // Same configuration as the AGC tool, the gain table is set up by
+    // WebRtcAgc_set_config().
+    WebRtcAgcConfig config;
+    config.compressionGaindB = 9;
+    config.limiterEnable = kAgcTrue;
+    config.targetLevelDbfs = 3;
+    self->agc = WebRtcAgc_Create();
+    if (self->agc == NULL ||
+        WebRtcAgc_Init(self->agc, 0, 255, kAgcModeAdaptiveDigital, (uint32_t) fs) != 0 ||
+        WebRtcAgc_set_config(self->agc, config) != 0)
+    {
+        WebRtcAgc_Free(self->agc);
+        free(self);
+        return NULL;
+    }
+    self->fs = (uint32_t) fs;
+    // 10 ms per call, full band frames at 32 and 48 kHz like the AGC tool.
+    self->frameLength = (size_t) fs / 100;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 6);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+static void digitalRun(void *state)
+{
+    DigitalState *self = (DigitalState *) state;
+    LegacyAgc *stt = (LegacyAgc *) self->agc;
+    const int16_t *in[1] = {&self->signal[self->next * self->frameLength]};
+    int16_t *out[1] = {self->out};
+    if (self->fs > 16000)
+        WebRtcAgc_ProcessDigitalFullBand(&stt->digitalAgc, in[0], out[0], self->fs, stt->lowLevelSignal);
+    else
+        WebRtcAgc_ProcessDigital(&stt->digitalAgc, in, 1, out, self->fs, stt->lowLevelSignal);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void digitalDestroy(void *state)
+{
+    DigitalState *self = (DigitalState *) state;
+    WebRtcAgc_Free(self->agc);
+    free(self);
+}
+
+typedef struct
+{
+    AgcVad vad;
+    size_t frameLength;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * 160];
+} VadState;
+
+// The VAD runs on 8 or 16 kHz frames only.
+static void *vadCreate(int fs, size_t *samplesPerCall)
+{
+    if (fs != 8000 && fs != 16000)
+        return NULL;
+    VadState *self = (VadState *) calloc(1, sizeof(VadState));
+    if (self == NULL)
+        return NULL;
+    WebRtcAgc_InitVad(&self->vad);
+    self->frameLength = (size_t) fs / 100;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 7);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+static void vadRun(void *state)
+{
+    VadState *self = (VadState *) state;
+    WebRtcAgc_ProcessVad(&self->vad, &self->signal[self->next * self->frameLength], self->frameLength);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void vadDestroy(void *state)
+{
+    free(state);
+}
+
+#define BENCH_AGC_CHANNELS_MAX 8
+
+typedef struct
+{
+    void *agc;
+    size_t frameLength;
+    size_t channels;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BENCH_AGC_FRAME_MAX * BENCH_AGC_CHANNELS_MAX];
+    int16_t buffer[BENCH_AGC_FRAME_MAX * BENCH_AGC_CHANNELS_MAX];
+} InterleavedState;
+
+// One 10 ms frame of |channels| interleaved channels per call, linked.
+static void *interleavedCreate(int fs, size_t channels, size_t *samplesPerCall)
+{
+    InterleavedState *self = (InterleavedState *) calloc(1, sizeof(InterleavedState));
+    if (self == NULL)
+        return NULL;
+    WebRtcAgcConfig config;
+    config.compressionGaindB = 9;
+    config.limiterEnable = kAgcTrue;
+    config.targetLevelDbfs = 3;
+    self->agc = WebRtcAgc_Create();
+    if (self->agc == NULL ||
+        WebRtcAgc_Init(self->agc, 0, 255, kAgcModeAdaptiveDigital, (uint32_t) fs) != 0 ||
+        WebRtcAgc_set_config(self->agc, config) != 0)
+    {
+        WebRtcAgc_Free(self->agc);
+        free(self);
+        return NULL;
+    }
+    self->frameLength = (size_t) fs / 100;
+    self->channels = channels;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength * channels, fs, 6);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+static void *stereoCreate(int fs, size_t *samplesPerCall)
+{
+    return interleavedCreate(fs, 2, samplesPerCall);
+}
+
+static void *eightChannelCreate(int fs, size_t *samplesPerCall)
+{
+    return interleavedCreate(fs, 8, samplesPerCall);
+}
+
+static void interleavedRun(void *state)
+{
+    InterleavedState *self = (InterleavedState *) state;
+    size_t frameSamples = self->frameLength * self->channels;
+    memcpy(self->buffer, &self->signal[self->next * frameSamples], frameSamples * sizeof(int16_t));
+    int32_t micLevel = 0;
+    uint8_t saturationWarning = 0;
+    WebRtcAgc_ProcessInterleaved(self->agc, self->buffer, self->channels, self->frameLength, 0, &micLevel, 0,
+                                 &saturationWarning);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void interleavedDestroy(void *state)
+{
+    InterleavedState *self = (InterleavedState *) state;
+    WebRtcAgc_Free(self->agc);
+    free(self);
+}
+
+typedef struct
+{
+    void *agc;
+    size_t frameLength;
+    size_t next;
+    float signal[BENCH_SIGNAL_FRAMES * BENCH_AGC_FRAME_MAX];
+    float buffer[BENCH_AGC_FRAME_MAX];
+} FloatState;
+
+// One 10 ms mono frame of float samples per call, no conversion to 16 bits.
+static void *floatCreate(int fs, size_t *samplesPerCall)
+{
+    size_t i;
+    int16_t *signal = (int16_t *) malloc(BENCH_SIGNAL_FRAMES * BENCH_AGC_FRAME_MAX * sizeof(int16_t));
+    FloatState *self = (FloatState *) calloc(1, sizeof(FloatState));
+    if (self == NULL || signal == NULL)
+    {
+        free(signal);
+        free(self);
+        return NULL;
+    }
+    WebRtcAgcConfig config;
+    config.compressionGaindB = 9;
+    config.limiterEnable = kAgcTrue;
+    config.targetLevelDbfs = 3;
+    self->agc = WebRtcAgc_Create();
+    if (self->agc == NULL ||
+        WebRtcAgc_Init(self->agc, 0, 255, kAgcModeAdaptiveDigital, (uint32_t) fs) != 0 ||
+        WebRtcAgc_set_config(self->agc, config) != 0)
+    {
+        WebRtcAgc_Free(self->agc);
+        free(signal);
+        free(self);
+        return NULL;
+    }
+    self->frameLength = (size_t) fs / 100;
+    Bench_FillSignal(signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 6);
+    for (i = 0; i < BENCH_SIGNAL_FRAMES * self->frameLength; i++)
+        self->signal[i] = signal[i];
+    free(signal);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+static void floatRun(void *state)
+{
+    FloatState *self = (FloatState *) state;
+    memcpy(self->buffer, &self->signal[self->next * self->frameLength], self->frameLength * sizeof(float));
+    int32_t micLevel = 0;
+    uint8_t saturationWarning = 0;
+    WebRtcAgc_ProcessInterleavedFloat(self->agc, self->buffer, 1, self->frameLength, 0, &micLevel, 0,
+                                      &saturationWarning);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void floatDestroy(void *state)
+{
+    FloatState *self = (FloatState *) state;
+    WebRtcAgc_Free(self->agc);
+    free(self);
+}
+
+static const BenchKernel kAgcKernels[] = {
+        {"WebRtcAgc_ProcessDigital", digitalCreate, digitalRun, digitalDestroy},
+        {"WebRtcAgc_ProcessVad", vadCreate, vadRun, vadDestroy},
+        {"WebRtcAgc_ProcessInterleaved (2 ch)", stereoCreate, interleavedRun, interleavedDestroy},
+        {"WebRtcAgc_ProcessInterleaved (8 ch)", eightChannelCreate, interleavedRun, interleavedDestroy},
+        {"WebRtcAgc_ProcessInterleavedFloat", floatCreate, floatRun, floatDestroy},
+};
+
+const BenchKernel *BenchAgc_Kernels(size_t *count)
+{
+    *count = sizeof(kAgcKernels) / sizeof(kAgcKernels[0]);
+    return kAgcKernels;
+}
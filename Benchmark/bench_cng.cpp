@@ -0,0 +1,72 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../CNG/cng.h"
+
+#define BENCH_CNG_FRAME_MAX 480
+
+namespace {
+
+const int kSidIntervalMs = 100;
+const int kQuality = 8;
+
+struct CngState
+{
+    CngState(int fs) : encoder(fs, kSidIntervalMs, kQuality), fs(fs), frameLength(fs / 100), next(0)
+    {
+    }
+
+    ComfortNoiseEncoder encoder;
+    ComfortNoiseDecoder decoder;
+    Buffer sid;
+    int fs;
+    size_t frameLength;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BENCH_CNG_FRAME_MAX];
+    int16_t out[BENCH_CNG_FRAME_MAX];
+};
+
+void *cngCreate(int fs, size_t *samplesPerCall)
+{
+    CngState *self = new CngState(fs);
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 8);
+    // The decoder needs one SID frame to generate noise from.
+    self->encoder.Encode(ArrayView<const int16_t>(self->signal, self->frameLength), true, &self->sid);
+    self->decoder.UpdateSid(ArrayView<const uint8_t>(self->sid.data(), self->sid.size()));
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+void encodeRun(void *state)
+{
+    CngState *self = static_cast<CngState *>(state);
+    self->sid.Clear();
+    self->encoder.Encode(ArrayView<const int16_t>(&self->signal[self->next * self->frameLength], self->frameLength),
+                         false, &self->sid);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+void generateRun(void *state)
+{
+    CngState *self = static_cast<CngState *>(state);
+    self->decoder.Generate(ArrayView<int16_t>(self->out, self->frameLength), false);
+}
+
+void cngDestroy(void *state)
+{
+    delete static_cast<CngState *>(state);
+}
+
+const BenchKernel kCngKernels[] = {
+        {"ComfortNoiseEncoder::Encode", cngCreate, encodeRun, cngDestroy},
+        {"ComfortNoiseDecoder::Generate", cngCreate, generateRun, cngDestroy},
+};
+
+}  // namespace
+
+const BenchKernel *BenchCng_Kernels(size_t *count)
+{
+    *count = sizeof(kCngKernels) / sizeof(kCngKernels[0]);
+    return kCngKernels;
+}
@@ -0,0 +1,506 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../NS/noise_suppression.h"
+#include "../NS/ns_lockstep.h"
+#include "../SPL/signal_processing_library.h"
+
+// The kernels of the L band alone run at 8 and 16 kHz, 32 and 48 kHz report
+// n/a. The kernels of a whole instance also run the upper bands at 32 and
+// 48 kHz.
+static size_t nsFrameLength(int fs)
+{
+    return (fs == 8000 || fs == 16000) ? (size_t) fs / 100 : 0;
+}
+
+typedef struct
+{
+    size_t length;
+    float src[ANAL_BLOCKL_MAX];
+    float data[ANAL_BLOCKL_MAX];
+    size_t ip[IP_LENGTH];
+    float wfft[W_LENGTH];
+} RdftState;
+
+static void *rdftCreate(int fs, size_t *samplesPerCall)
+{
+    size_t frameLength = nsFrameLength(fs);
+    if (frameLength == 0)
+        return NULL;
+    RdftState *self = (RdftState *) calloc(1, sizeof(RdftState));
+    if (self == NULL)
+        return NULL;
+    int16_t signal[ANAL_BLOCKL_MAX];
+    // Same analysis length as WebRtcNs_InitCore: 128 at 8 kHz, 256 at 16 kHz.
+    self->length = fs == 8000 ? 128 : 256;
+    Bench_FillSignal(signal, self->length, fs, 1);
+    for (size_t i = 0; i < self->length; i++)
+        self->src[i] = signal[i];
+    self->ip[0] = 0;
+    *samplesPerCall = frameLength;
+    return self;
+}
+
+static void rdftRun(void *state)
+{
+    RdftState *self = (RdftState *) state;
+    memcpy(self->data, self->src, self->length * sizeof(float));
+    WebRtc_rdft(self->length, 1, self->data, self->ip, self->wfft);
+}
+
+// Same transform through WebRtcNs_Rdft, the version WebRtcNs_InitCore()
+// selects for the CPU.
+static void *nsRdftCreate(int fs, size_t *samplesPerCall)
+{
+    NsHandle *ns = WebRtcNs_Create();
+    if (ns == NULL)
+        return NULL;
+    WebRtcNs_Init(ns, (uint32_t) fs);
+    WebRtcNs_Free(ns);
+    return rdftCreate(fs, samplesPerCall);
+}
+
+static void nsRdftRun(void *state)
+{
+    RdftState *self = (RdftState *) state;
+    memcpy(self->data, self->src, self->length * sizeof(float));
+    WebRtcNs_Rdft(self->length, 1, self->data, self->ip, self->wfft);
+}
+
+typedef struct
+{
+    size_t magnLen;
+    size_t next;
+    int counter[SIMULT];
+    float lmagn[BENCH_SIGNAL_FRAMES][HALF_ANAL_BLOCKL];
+    float lquantile[SIMULT * HALF_ANAL_BLOCKL];
+    float density[SIMULT * HALF_ANAL_BLOCKL];
+} QuantileState;
+
+// The quantile update of the noise estimation, through the version
+// WebRtcNs_InitCore() selects for the CPU.
+static void *quantileCreate(int fs, size_t *samplesPerCall)
+{
+    size_t frameLength = nsFrameLength(fs);
+    if (frameLength == 0)
+        return NULL;
+    NsHandle *ns = WebRtcNs_Create();
+    if (ns == NULL)
+        return NULL;
+    WebRtcNs_Init(ns, (uint32_t) fs);
+    WebRtcNs_Free(ns);
+    QuantileState *self = (QuantileState *) calloc(1, sizeof(QuantileState));
+    if (self == NULL)
+        return NULL;
+    int16_t signal[BENCH_SIGNAL_FRAMES * HALF_ANAL_BLOCKL];
+    self->magnLen = (fs == 8000 ? 128 : 256) / 2 + 1;
+    Bench_FillSignal(signal, BENCH_SIGNAL_FRAMES * self->magnLen, fs, 3);
+    for (size_t f = 0; f < BENCH_SIGNAL_FRAMES; f++)
+    {
+        for (size_t i = 0; i < self->magnLen; i++)
+            self->lmagn[f][i] = logf(fabsf((float) signal[f * self->magnLen + i]) + 1.f);
+    }
+    // Same start values as WebRtcNs_InitCore.
+    for (size_t i = 0; i < SIMULT * HALF_ANAL_BLOCKL; i++)
+    {
+        self->lquantile[i] = 8.f;
+        self->density[i] = 0.3f;
+    }
+    for (int s = 0; s < SIMULT; s++)
+        self->counter[s] = END_STARTUP_LONG * (s + 1) / SIMULT;
+    *samplesPerCall = frameLength;
+    return self;
+}
+
+static void quantileRun(void *state)
+{
+    QuantileState *self = (QuantileState *) state;
+    WebRtcNs_UpdateQuantiles(self->lmagn[self->next], self->magnLen, self->counter,
+                             self->lquantile, self->density);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+// One instance at any sampling frequency. The signal is split into bands
+// once, so the kernels on |bands| measure the noise suppression alone.
+typedef struct
+{
+    NsHandle *ns;
+    WebRtcSpl_BandSplitState split;
+    size_t frameLength;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BLOCKL_MAX * SPL_MAX_BANDS];
+    int16_t frame[BLOCKL_MAX * SPL_MAX_BANDS];
+    int16_t bands[SPL_MAX_BANDS][BENCH_SIGNAL_FRAMES * BLOCKL_MAX];
+    int16_t out[SPL_MAX_BANDS][BENCH_SIGNAL_FRAMES * BLOCKL_MAX];
+} NsState;
+
+static void *nsCreate(int fs, size_t *samplesPerCall)
+{
+    NsState *self = (NsState *) calloc(1, sizeof(NsState));
+    if (self == NULL)
+        return NULL;
+    self->ns = WebRtcNs_Create();
+    if (self->ns == NULL || WebRtcNs_Init(self->ns, (uint32_t) fs) != 0 ||
+        WebRtcNs_set_policy(self->ns, 1) != 0 || WebRtcSpl_BandSplitInit(&self->split, (uint32_t) fs) != 0)
+    {
+        WebRtcNs_Free(self->ns);
+        free(self);
+        return NULL;
+    }
+    self->frameLength = (size_t) fs / 100;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 2);
+    for (size_t f = 0; f < BENCH_SIGNAL_FRAMES; f++)
+    {
+        int16_t *bands[SPL_MAX_BANDS];
+        for (size_t b = 0; b < SPL_MAX_BANDS; b++)
+            bands[b] = &self->bands[b][f * self->split.bandLength];
+        WebRtcSpl_BandSplitAnalysis(&self->split, &self->signal[f * self->frameLength], bands);
+    }
+    WebRtcSpl_BandSplitInit(&self->split, (uint32_t) fs);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+// Band pointers of the next frame of |bands| and of |out|.
+static void nsNextFrame(NsState *self, const int16_t **in, int16_t **out)
+{
+    const size_t offset = self->next * self->split.bandLength;
+    for (size_t b = 0; b < self->split.numBands; b++)
+    {
+        in[b] = &self->bands[b][offset];
+        out[b] = &self->out[b][offset];
+    }
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void analyzeRun(void *state)
+{
+    NsState *self = (NsState *) state;
+    const int16_t *in[SPL_MAX_BANDS];
+    int16_t *out[SPL_MAX_BANDS];
+    nsNextFrame(self, in, out);
+    WebRtcNs_AnalyzeCore((NoiseSuppressionC *) self->ns, in[0]);
+}
+
+static void processRun(void *state)
+{
+    NsState *self = (NsState *) state;
+    const int16_t *in[SPL_MAX_BANDS];
+    int16_t *out[SPL_MAX_BANDS];
+    nsNextFrame(self, in, out);
+    WebRtcNs_ProcessCore((NoiseSuppressionC *) self->ns, in, self->split.numBands, out);
+}
+
+static void analyzeProcessRun(void *state)
+{
+    NsState *self = (NsState *) state;
+    const int16_t *in[SPL_MAX_BANDS];
+    int16_t *out[SPL_MAX_BANDS];
+    nsNextFrame(self, in, out);
+    WebRtcNs_AnalyzeProcessCore((NoiseSuppressionC *) self->ns, in, self->split.numBands, out);
+}
+
+// The whole frame through the band split, the noise suppression and the band
+// merge, like the NS driver.
+static void bandSplitRun(void *state)
+{
+    NsState *self = (NsState *) state;
+    int16_t *bands[SPL_MAX_BANDS] = {self->out[0], self->out[1], self->out[2]};
+    memcpy(self->frame, &self->signal[self->next * self->frameLength], self->frameLength * sizeof(int16_t));
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+    WebRtcSpl_BandSplitAnalysis(&self->split, self->frame, bands);
+    WebRtcNs_AnalyzeProcess(self->ns, (const int16_t *const *) bands, self->split.numBands, bands);
+    WebRtcSpl_BandSplitSynthesis(&self->split, (const int16_t *const *) bands, self->frame);
+}
+
+// All frames of the signal in one call.
+static void *nsBatchCreate(int fs, size_t *samplesPerCall)
+{
+    NsState *self = (NsState *) nsCreate(fs, samplesPerCall);
+    *samplesPerCall *= BENCH_SIGNAL_FRAMES;
+    return self;
+}
+
+static void batchRun(void *state)
+{
+    NsState *self = (NsState *) state;
+    const int16_t *in[SPL_MAX_BANDS] = {self->bands[0], self->bands[1], self->bands[2]};
+    int16_t *out[SPL_MAX_BANDS] = {self->out[0], self->out[1], self->out[2]};
+    WebRtcNs_ProcessBatchCore((NoiseSuppressionC *) self->ns, in, self->split.numBands, BENCH_SIGNAL_FRAMES,
+                              out);
+}
+
+#define INTERLEAVED_CHANNELS 2
+
+typedef struct
+{
+    NsHandle *ns[INTERLEAVED_CHANNELS];
+    int16_t signal[BENCH_SIGNAL_FRAMES * BLOCKL_MAX * INTERLEAVED_CHANNELS];
+    int16_t buffer[BENCH_SIGNAL_FRAMES * BLOCKL_MAX * INTERLEAVED_CHANNELS];
+} NsInterleavedState;
+
+static void nsInterleavedDestroy(void *state)
+{
+    NsInterleavedState *self = (NsInterleavedState *) state;
+    for (size_t c = 0; c < INTERLEAVED_CHANNELS; c++)
+        WebRtcNs_Free(self->ns[c]);
+    free(self);
+}
+
+// All frames of an interleaved stereo signal in one call, in place.
+static void *nsInterleavedCreate(int fs, size_t *samplesPerCall)
+{
+    size_t frameLength = nsFrameLength(fs);
+    if (frameLength == 0)
+        return NULL;
+    NsInterleavedState *self = (NsInterleavedState *) calloc(1, sizeof(NsInterleavedState));
+    if (self == NULL)
+        return NULL;
+    for (size_t c = 0; c < INTERLEAVED_CHANNELS; c++)
+    {
+        self->ns[c] = WebRtcNs_Create();
+        if (self->ns[c] == NULL || WebRtcNs_Init(self->ns[c], (uint32_t) fs) != 0 ||
+            WebRtcNs_set_policy(self->ns[c], 1) != 0)
+        {
+            nsInterleavedDestroy(self);
+            return NULL;
+        }
+    }
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * frameLength * INTERLEAVED_CHANNELS, fs, 2);
+    *samplesPerCall = BENCH_SIGNAL_FRAMES * frameLength;
+    return self;
+}
+
+static void interleavedRun(void *state)
+{
+    NsInterleavedState *self = (NsInterleavedState *) state;
+    memcpy(self->buffer, self->signal, sizeof(self->buffer));
+    WebRtcNs_ProcessInterleavedCore((NoiseSuppressionC *const *) self->ns, INTERLEAVED_CHANNELS,
+                                    self->buffer, INTERLEAVED_CHANNELS, BENCH_SIGNAL_FRAMES);
+}
+
+#define LOCKSTEP_STREAMS 8
+
+typedef struct
+{
+    NsLockstep *ls;
+    size_t frameLength;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BLOCKL_MAX];
+    int16_t out[LOCKSTEP_STREAMS][BLOCKL_MAX];
+} NsLockstepState;
+
+static void nsLockstepDestroy(void *state)
+{
+    NsLockstepState *self = (NsLockstepState *) state;
+    WebRtcNsLs_Free(self->ls);
+    free(self);
+}
+
+// One frame of every stream per call, the streams read the signal at
+// different offsets.
+static void *nsLockstepCreate(int fs, size_t *samplesPerCall)
+{
+    size_t frameLength = nsFrameLength(fs);
+    if (frameLength == 0)
+        return NULL;
+    NsLockstepState *self = (NsLockstepState *) calloc(1, sizeof(NsLockstepState));
+    if (self == NULL)
+        return NULL;
+    self->ls = WebRtcNsLs_Create(LOCKSTEP_STREAMS);
+    if (self->ls == NULL || WebRtcNsLs_Init(self->ls, (uint32_t) fs, 1) != 0)
+    {
+        nsLockstepDestroy(self);
+        return NULL;
+    }
+    self->frameLength = frameLength;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * frameLength, fs, 2);
+    *samplesPerCall = LOCKSTEP_STREAMS * frameLength;
+    return self;
+}
+
+static void lockstepRun(void *state)
+{
+    NsLockstepState *self = (NsLockstepState *) state;
+    const int16_t *in[LOCKSTEP_STREAMS];
+    int16_t *out[LOCKSTEP_STREAMS];
+    for (size_t l = 0; l < LOCKSTEP_STREAMS; l++)
+    {
+        in[l] = &self->signal[((self->next + 5 * l) % BENCH_SIGNAL_FRAMES) * self->frameLength];
+        out[l] = self->out[l];
+    }
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+    WebRtcNsLs_Process(self->ls, in, out);
+}
+
+#define POOLED_SESSIONS 4096
+
+typedef struct
+{
+    NsPool *pool;
+    NsHandle *ns[POOLED_SESSIONS];
+    size_t frameLength;
+    size_t session;
+    size_t next;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BLOCKL_MAX];
+    int16_t out[BLOCKL_MAX];
+} NsPooledState;
+
+static void nsPooledDestroy(void *state)
+{
+    NsPooledState *self = (NsPooledState *) state;
+    WebRtcNs_FreePool(self->pool);
+    free(self);
+}
+
+// One frame of the next session per call, round robin over many sessions of
+// one pool, so the state of each session is cold in the cache like on a
+// server.
+static void *nsPooledCreate(int fs, size_t *samplesPerCall)
+{
+    size_t frameLength = nsFrameLength(fs);
+    if (frameLength == 0)
+        return NULL;
+    NsPooledState *self = (NsPooledState *) calloc(1, sizeof(NsPooledState));
+    if (self == NULL)
+        return NULL;
+    self->pool = WebRtcNs_CreatePool(POOLED_SESSIONS);
+    if (self->pool == NULL)
+    {
+        free(self);
+        return NULL;
+    }
+    for (size_t s = 0; s < POOLED_SESSIONS; s++)
+    {
+        self->ns[s] = WebRtcNs_CreateFromPool(self->pool);
+        if (self->ns[s] == NULL || WebRtcNs_Init(self->ns[s], (uint32_t) fs) != 0 ||
+            WebRtcNs_set_policy(self->ns[s], 1) != 0)
+        {
+            nsPooledDestroy(self);
+            return NULL;
+        }
+    }
+    self->frameLength = frameLength;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * frameLength, fs, 2);
+    *samplesPerCall = frameLength;
+    return self;
+}
+
+static void pooledRun(void *state)
+{
+    NsPooledState *self = (NsPooledState *) state;
+    const int16_t *in[1] = {&self->signal[self->next * self->frameLength]};
+    int16_t *out[1] = {self->out};
+    WebRtcNs_AnalyzeProcessCore((NoiseSuppressionC *) self->ns[self->session], in, 1, out);
+    if (++self->session == POOLED_SESSIONS)
+    {
+        self->session = 0;
+        self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+    }
+}
+
+// The same instance with the fast math approximations instead of libm.
+static void *nsFastMathCreate(int fs, size_t *samplesPerCall)
+{
+    NsState *self = (NsState *) nsCreate(fs, samplesPerCall);
+    if (self != NULL)
+        WebRtcNs_set_fast_math(self->ns, 1);
+    return self;
+}
+
+static void nsDestroy(void *state)
+{
+    NsState *self = (NsState *) state;
+    WebRtcNs_Free(self->ns);
+    free(self);
+}
+
+static const BenchKernel kNsKernels[] = {
+        {"WebRtc_rdft", rdftCreate, rdftRun, free},
+        {"WebRtcNs_Rdft", nsRdftCreate, nsRdftRun, free},
+        {"WebRtcNs_UpdateQuantiles", quantileCreate, quantileRun, free},
+        {"WebRtcNs_AnalyzeCore", nsCreate, analyzeRun, nsDestroy},
+        {"WebRtcNs_ProcessCore", nsCreate, processRun, nsDestroy},
+        {"WebRtcNs_AnalyzeProcessCore", nsCreate, analyzeProcessRun, nsDestroy},
+        {"WebRtcNs_ProcessBatchCore", nsBatchCreate, batchRun, nsDestroy},
+        {"WebRtcNs_AnalyzeProcess (band split)", nsCreate, bandSplitRun, nsDestroy},
+        {"WebRtcNs_ProcessInterleavedCore", nsInterleavedCreate, interleavedRun, nsInterleavedDestroy},
+        {"WebRtcNsLs_Process (8 streams)", nsLockstepCreate, lockstepRun, nsLockstepDestroy},
+        {"WebRtcNs_AnalyzeProcess (4k pooled)", nsPooledCreate, pooledRun, nsPooledDestroy},
+        {"WebRtcNs_AnalyzeProcessCore (fast)", nsFastMathCreate, analyzeProcessRun, nsDestroy},
+};
+
+const BenchKernel *BenchNs_Kernels(size_t *count)
+{
+    *count = sizeof(kNsKernels) / sizeof(kNsKernels[0]);
+    return kNsKernels;
+}
+
+#define FAST_MATH_SECONDS 10
+
+void BenchNs_FastMathReport(void)
+{
+    static const int kNsRates[] = {8000, 16000};
+
+    printf("%-36s %6s %12s %14s %10s\n", "NS fast math vs libm", "fs", "SNR dB", "worst 10ms dB", "max diff");
+    for (size_t r = 0; r < sizeof(kNsRates) / sizeof(kNsRates[0]); r++)
+    {
+        const int fs = kNsRates[r];
+        const size_t frameLength = nsFrameLength(fs);
+        const size_t frames = FAST_MATH_SECONDS * 100;
+        int16_t *signal = (int16_t *) malloc(frames * frameLength * sizeof(int16_t));
+        NsHandle *ns[2] = {WebRtcNs_Create(), WebRtcNs_Create()};
+        if (signal == NULL || ns[0] == NULL || ns[1] == NULL)
+        {
+            free(signal);
+            WebRtcNs_Free(ns[0]);
+            WebRtcNs_Free(ns[1]);
+            continue;
+        }
+        Bench_FillSignal(signal, frames * frameLength, fs, 4);
+        for (int k = 0; k < 2; k++)
+        {
+            WebRtcNs_Init(ns[k], (uint32_t) fs);
+            WebRtcNs_set_policy(ns[k], 1);
+            WebRtcNs_set_fast_math(ns[k], k);
+        }
+
+        // Output SNR of the fast math path with the libm output as reference,
+        // over the whole signal and for the worst frame with signal.
+        double signalEnergy = 0, errorEnergy = 0, worst = 1e9;
+        int maxDiff = 0;
+        for (size_t f = 0; f < frames; f++)
+        {
+            const int16_t *in[1] = {&signal[f * frameLength]};
+            int16_t out[2][BLOCKL_MAX];
+            double frameSignal = 0, frameError = 0;
+            for (int k = 0; k < 2; k++)
+            {
+                int16_t *outBands[1] = {out[k]};
+                WebRtcNs_AnalyzeProcess(ns[k], in, 1, outBands);
+            }
+            for (size_t i = 0; i < frameLength; i++)
+            {
+                const int diff = out[1][i] - out[0][i];
+                frameSignal += (double) out[0][i] * out[0][i];
+                frameError += (double) diff * diff;
+                maxDiff = abs(diff) > maxDiff ? abs(diff) : maxDiff;
+            }
+            signalEnergy += frameSignal;
+            errorEnergy += frameError;
+            if (frameSignal > 0 && frameError > 0 && 10 * log10(frameSignal / frameError) < worst)
+                worst = 10 * log10(frameSignal / frameError);
+        }
+        if (errorEnergy == 0)
+            printf("%-36s %6d %12s %14s %10d\n", "", fs, "exact", "exact", 0);
+        else
+            printf("%-36s %6d %12.1f %14.1f %10d\n", "", fs, 10 * log10(signalEnergy / errorEnergy), worst,
+                   maxDiff);
+        free(signal);
+        WebRtcNs_Free(ns[0]);
+        WebRtcNs_Free(ns[1]);
+    }
+}
@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+// GmmProbability() is file local, the VAD is compiled into this unit.
+#include "../VAD/vad.c"
+
+#define BENCH_VAD_FRAME_MAX 480
+#define BENCH_VAD_FRAME_8KHZ 80
+
+typedef struct
+{
+    VadInstT vad;
+    size_t frameLength;
+    int fs;
+    size_t next;
+    int16_t features[kNumChannels];
+    int16_t totalPower;
+    int16_t signal[BENCH_SIGNAL_FRAMES * BENCH_VAD_FRAME_MAX];
+} VadState;
+
+static void *vadCreate(int fs, size_t *samplesPerCall)
+{
+    VadState *self = (VadState *) calloc(1, sizeof(VadState));
+    if (self == NULL)
+        return NULL;
+    if (WebRtcVad_InitCore(&self->vad) != 0 || WebRtcVad_set_mode_core(&self->vad, 1) != 0)
+    {
+        free(self);
+        return NULL;
+    }
+    self->fs = fs;
+    self->frameLength = (size_t) fs / 100;
+    Bench_FillSignal(self->signal, BENCH_SIGNAL_FRAMES * self->frameLength, fs, 7);
+    *samplesPerCall = self->frameLength;
+    return self;
+}
+
+// The VAD features and the GMM always run on the 8 kHz signal, the other
+// rates only add the resampling measured by WebRtcVad_Process and report n/a.
+static void *featureCreate(int fs, size_t *samplesPerCall)
+{
+    if (fs != 8000)
+        return NULL;
+    VadState *self = (VadState *) vadCreate(fs, samplesPerCall);
+    if (self == NULL)
+        return NULL;
+    self->totalPower = WebRtcVad_CalculateFeatures(&self->vad, self->signal, BENCH_VAD_FRAME_8KHZ,
+                                                   self->features);
+    return self;
+}
+
+static void featureRun(void *state)
+{
+    VadState *self = (VadState *) state;
+    WebRtcVad_CalculateFeatures(&self->vad, &self->signal[self->next * BENCH_VAD_FRAME_8KHZ],
+                                BENCH_VAD_FRAME_8KHZ, self->features);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static void gmmRun(void *state)
+{
+    VadState *self = (VadState *) state;
+    GmmProbability(&self->vad, self->features, self->totalPower, BENCH_VAD_FRAME_8KHZ);
+}
+
+static void processRun(void *state)
+{
+    VadState *self = (VadState *) state;
+    WebRtcVad_Process((VadInst *) &self->vad, self->fs, &self->signal[self->next * self->frameLength],
+                      self->frameLength, 0);
+    self->next = (self->next + 1) % BENCH_SIGNAL_FRAMES;
+}
+
+static const BenchKernel kVadKernels[] = {
+        {"WebRtcVad_CalculateFeatures", featureCreate, featureRun, free},
+        {"GmmProbability", featureCreate, gmmRun, free},
+        {"WebRtcVad_Process", vadCreate, processRun, free},
+};
+
+const BenchKernel *BenchVad_Kernels(size_t *count)
+{
+    *count = sizeof(kVadKernels) / sizeof(kVadKernels[0]);
+    return kVadKernels;
+}
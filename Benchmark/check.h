@@ -0,0 +1,48 @@
+/*
+ * Differential tests of the kernels behind the run time dispatch.
+ *
+ * Every SIMD version the CPU supports is run next to its C reference on the
+ * same random input, at the lengths and rates the modules use and at the
+ * ragged lengths around the vector widths, and the outputs have to be bit
+ * exact. The C versions are the same on every CPU, so a mismatch means the
+ * output of a module depends on the CPU it runs on.
+ */
+
+#ifndef WEBRTC_3A1V_BENCHMARK_CHECK_H_
+#define WEBRTC_3A1V_BENCHMARK_CHECK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CHECK_X86
+#endif
+
+#define CHECK_TRIALS 16     // random inputs per kernel and length
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Next value of a reproducible pseudo random sequence, |state| is its seed.
+uint32_t Check_Rand(uint32_t *state);
+
+// Fills |out| with random 16-bit samples. One in four samples is one of the
+// extremes -32768, 32767, -1 or 0, and |out| may start with a run of them.
+void Check_FillW16(int16_t *out, size_t length, uint32_t *state);
+
+// Prints the result of version |isa| of |kernel| and returns 1 for a
+// mismatch, |length| is the first length that failed.
+int Check_Report(const char *kernel, const char *isa, int failed, size_t length);
+
+// Differential tests, one per module. Return the number of kernel versions
+// that do not match their C reference.
+int CheckSpl_Run(void);
+int CheckAecm_Run(void);
+int CheckNs_Run(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_3A1V_BENCHMARK_CHECK_H_
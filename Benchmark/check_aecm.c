@@ -0,0 +1,247 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+// The C versions of the AECM kernels are static, the test is compiled
+// together with them.
+#include "../AECM/aecm.c"
+
+#define CHECK_MAX_HISTORY 300
+
+// Random spectrum magnitudes, spread over all magnitudes and with zeros.
+static void fillSpectrum(uint16_t *out, size_t length, uint32_t *state)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint32_t r = Check_Rand(state);
+        out[i] = r % 8 == 0 ? 0 : (uint16_t) ((r >> 16) >> (r % 16));
+    }
+}
+
+// Random channels in both cores: the 32-bit adaptive channel is either the
+// 16-bit one in Q16 plus some low bits or anything.
+static void fillChannels(AecmCore *aecm1, AecmCore *aecm2, uint32_t *state)
+{
+    Check_FillW16(aecm1->channelStored, PART_LEN1, state);
+    Check_FillW16(aecm1->channelAdapt16, PART_LEN1, state);
+    for (int i = 0; i < PART_LEN1; i++)
+    {
+        uint32_t r = Check_Rand(state);
+        aecm1->channelAdapt32[i] = r % 2 ? (int32_t) r
+                                         : (int32_t) ((uint32_t) aecm1->channelAdapt16[i] << 16) +
+                                           (int32_t) (r >> 17);
+    }
+    aecm1->dfaNoisyQDomain = (int16_t) (Check_Rand(state) % 16);
+    memcpy(aecm2->channelStored, aecm1->channelStored, PART_LEN1 * sizeof(int16_t));
+    memcpy(aecm2->channelAdapt16, aecm1->channelAdapt16, PART_LEN1 * sizeof(int16_t));
+    memcpy(aecm2->channelAdapt32, aecm1->channelAdapt32, PART_LEN1 * sizeof(int32_t));
+    aecm2->dfaNoisyQDomain = aecm1->dfaNoisyQDomain;
+}
+
+static int sameChannels(const AecmCore *aecm1, const AecmCore *aecm2)
+{
+    return memcmp(aecm1->channelStored, aecm2->channelStored, PART_LEN1 * sizeof(int16_t)) == 0 &&
+           memcmp(aecm1->channelAdapt16, aecm2->channelAdapt16, PART_LEN1 * sizeof(int16_t)) == 0 &&
+           memcmp(aecm1->channelAdapt32, aecm2->channelAdapt32, PART_LEN1 * sizeof(int32_t)) == 0;
+}
+
+static int checkLinearEnergies(AecmCore *aecm1, AecmCore *aecm2, const char *isa,
+                               CalcLinearEnergies version)
+{
+    uint32_t seed = 21;
+    for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+    {
+        uint16_t far[PART_LEN1];
+        int32_t echo1[PART_LEN1], echo2[PART_LEN1];
+        uint32_t energies1[3], energies2[3];
+
+        fillChannels(aecm1, aecm2, &seed);
+        fillSpectrum(far, PART_LEN1, &seed);
+        for (int k = 0; k < 3; k++)
+            energies1[k] = energies2[k] = Check_Rand(&seed);
+        CalcLinearEnergiesC(aecm1, far, echo1, &energies1[0], &energies1[1], &energies1[2]);
+        version(aecm2, far, echo2, &energies2[0], &energies2[1], &energies2[2]);
+        if (memcmp(echo1, echo2, sizeof(echo1)) != 0 ||
+            memcmp(energies1, energies2, sizeof(energies1)) != 0)
+            return Check_Report("WebRtcAecm_CalcLinearEnergies", isa, 1, PART_LEN1);
+    }
+    return Check_Report("WebRtcAecm_CalcLinearEnergies", isa, 0, 0);
+}
+
+static int checkStoreChannel(AecmCore *aecm1, AecmCore *aecm2, const char *isa,
+                             StoreAdaptiveChannel version)
+{
+    uint32_t seed = 22;
+    for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+    {
+        uint16_t far[PART_LEN1];
+        int32_t echo1[PART_LEN1], echo2[PART_LEN1];
+
+        fillChannels(aecm1, aecm2, &seed);
+        fillSpectrum(far, PART_LEN1, &seed);
+        StoreAdaptiveChannelC(aecm1, far, echo1);
+        version(aecm2, far, echo2);
+        if (memcmp(echo1, echo2, sizeof(echo1)) != 0 || !sameChannels(aecm1, aecm2))
+            return Check_Report("WebRtcAecm_StoreAdaptiveChannel", isa, 1, PART_LEN1);
+    }
+    return Check_Report("WebRtcAecm_StoreAdaptiveChannel", isa, 0, 0);
+}
+
+static int checkResetChannel(AecmCore *aecm1, AecmCore *aecm2, const char *isa,
+                             ResetAdaptiveChannel version)
+{
+    uint32_t seed = 23;
+    for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+    {
+        fillChannels(aecm1, aecm2, &seed);
+        // The C version shifts the stored channel left, which has to be
+        // positive like the channels of the AECM.
+        for (int i = 0; i < PART_LEN1; i++)
+        {
+            aecm1->channelStored[i] &= 0x7FFF;
+            aecm2->channelStored[i] &= 0x7FFF;
+        }
+        ResetAdaptiveChannelC(aecm1);
+        version(aecm2);
+        if (!sameChannels(aecm1, aecm2))
+            return Check_Report("WebRtcAecm_ResetAdaptiveChannel", isa, 1, PART_LEN1);
+    }
+    return Check_Report("WebRtcAecm_ResetAdaptiveChannel", isa, 0, 0);
+}
+
+static int checkChannelError(AecmCore *aecm1, AecmCore *aecm2, const char *isa,
+                             CalcChannelError version)
+{
+    uint32_t seed = 24;
+    for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+    {
+        uint16_t far[PART_LEN1], dfa[PART_LEN1];
+        int32_t out1[4][PART_LEN1], out2[4][PART_LEN1];
+        int16_t farQ = (int16_t) (Check_Rand(&seed) % 16);
+
+        fillChannels(aecm1, aecm2, &seed);
+        fillSpectrum(far, PART_LEN1, &seed);
+        fillSpectrum(dfa, PART_LEN1, &seed);
+        CalcChannelErrorC(aecm1, far, farQ, dfa, out1[0], out1[1], out1[2], out1[3]);
+        version(aecm2, far, farQ, dfa, out2[0], out2[1], out2[2], out2[3]);
+        if (memcmp(out1, out2, sizeof(out1)) != 0)
+            return Check_Report("WebRtcAecm_CalcChannelError", isa, 1, PART_LEN1);
+    }
+    return Check_Report("WebRtcAecm_CalcChannelError", isa, 0, 0);
+}
+
+static int checkBitCount(const char *isa, BitCountComparison version)
+{
+    uint32_t seed = 25;
+    uint32_t matrix[CHECK_MAX_HISTORY];
+    int32_t counts1[CHECK_MAX_HISTORY + 1], counts2[CHECK_MAX_HISTORY + 1];
+
+    for (int size = 0; size <= CHECK_MAX_HISTORY; size++)
+    {
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            uint32_t vector = Check_Rand(&seed);
+            for (int i = 0; i < size; i++)
+                matrix[i] = t % 4 == 0 ? vector ^ (1u << (Check_Rand(&seed) % 32)) : Check_Rand(&seed);
+            counts1[size] = counts2[size] = -1;
+            BitCountComparisonC(vector, matrix, size, counts1);
+            version(vector, matrix, size, counts2);
+            if (memcmp(counts1, counts2, (size + 1) * sizeof(int32_t)) != 0)
+                return Check_Report("WebRtc_BitCountComparison", isa, 1, (size_t) size);
+        }
+    }
+    return Check_Report("WebRtc_BitCountComparison", isa, 0, 0);
+}
+
+static int checkCandidateDelay(const char *isa, FindCandidateDelay version)
+{
+    uint32_t seed = 26;
+    int32_t counts[CHECK_MAX_HISTORY];
+
+    for (int size = 1; size <= CHECK_MAX_HISTORY; size++)
+    {
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            // Few distinct values give ties, values from kMaxBitCountsQ9 on
+            // leave no candidate.
+            int32_t base = (int32_t) (Check_Rand(&seed) % (kMaxBitCountsQ9 + 64));
+            int32_t spread = t % 2 ? 4 : kMaxBitCountsQ9;
+            for (int i = 0; i < size; i++)
+                counts[i] = base + (int32_t) (Check_Rand(&seed) % spread);
+            int32_t best1 = -1, worst1 = -1, best2 = -2, worst2 = -2;
+            int delay1 = FindCandidateDelayC(counts, size, &best1, &worst1);
+            int delay2 = version(counts, size, &best2, &worst2);
+            if (delay1 != delay2 || best1 != best2 || worst1 != worst2)
+                return Check_Report("WebRtc_FindCandidateDelay", isa, 1, (size_t) size);
+        }
+    }
+    return Check_Report("WebRtc_FindCandidateDelay", isa, 0, 0);
+}
+
+static int checkFft(const char *name, const char *isa, ComplexFFT128 reference,
+                    ComplexFFT128 version)
+{
+    uint32_t seed = 27;
+    for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+    {
+        int16_t data1[PART_LEN2 * 2], data2[PART_LEN2 * 2];
+
+        // Full scale and quieter blocks, which the inverse FFT scales less.
+        Check_FillW16(data1, PART_LEN2 * 2, &seed);
+        int shift = (int) (Check_Rand(&seed) % 16);
+        for (int i = 0; i < PART_LEN2 * 2; i++)
+            data1[i] = (int16_t) (data1[i] >> shift);
+        memcpy(data2, data1, sizeof(data1));
+        if (reference(data1) != version(data2) || memcmp(data1, data2, sizeof(data1)) != 0)
+            return Check_Report(name, isa, 1, PART_LEN2);
+    }
+    return Check_Report(name, isa, 0, 0);
+}
+
+int CheckAecm_Run(void)
+{
+    int failures = 0;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    const int features = WebRtcSpl_CpuFeatures();
+    AecmCore *aecm1 = WebRtcAecm_CreateCore();
+    AecmCore *aecm2 = WebRtcAecm_CreateCore();
+
+    if (aecm1 == NULL || aecm2 == NULL)
+    {
+        WebRtcAecm_FreeCore(aecm1);
+        WebRtcAecm_FreeCore(aecm2);
+        return Check_Report("WebRtcAecm_CreateCore", "C", 1, 0);
+    }
+    if (features & kSplCpuSSE2)
+    {
+        failures += checkLinearEnergies(aecm1, aecm2, "SSE2", WebRtcAecm_CalcLinearEnergiesSSE2);
+        failures += checkStoreChannel(aecm1, aecm2, "SSE2", WebRtcAecm_StoreAdaptiveChannelSSE2);
+        failures += checkResetChannel(aecm1, aecm2, "SSE2", WebRtcAecm_ResetAdaptiveChannelSSE2);
+        failures += checkFft("WebRtcAecm_ComplexFFT128", "SSE2", ComplexFFT128C,
+                             WebRtcAecm_ComplexFFT128SSE2);
+        failures += checkFft("WebRtcAecm_ComplexIFFT128", "SSE2", ComplexIFFT128C,
+                             WebRtcAecm_ComplexIFFT128SSE2);
+    }
+    if (features & kSplCpuPOPCNT)
+    {
+        failures += checkBitCount("POPCNT", WebRtc_BitCountComparisonPOPCNT);
+    }
+    if (features & kSplCpuAVX2)
+    {
+        failures += checkLinearEnergies(aecm1, aecm2, "AVX2", WebRtcAecm_CalcLinearEnergiesAVX2);
+        failures += checkStoreChannel(aecm1, aecm2, "AVX2", WebRtcAecm_StoreAdaptiveChannelAVX2);
+        failures += checkResetChannel(aecm1, aecm2, "AVX2", WebRtcAecm_ResetAdaptiveChannelAVX2);
+        failures += checkChannelError(aecm1, aecm2, "AVX2", WebRtcAecm_CalcChannelErrorAVX2);
+        failures += checkBitCount("AVX2", WebRtc_BitCountComparisonAVX2);
+        failures += checkCandidateDelay("AVX2", WebRtc_FindCandidateDelayAVX2);
+        failures += checkFft("WebRtcAecm_ComplexFFT128", "AVX2", ComplexFFT128C,
+                             WebRtcAecm_ComplexFFT128AVX2);
+        failures += checkFft("WebRtcAecm_ComplexIFFT128", "AVX2", ComplexIFFT128C,
+                             WebRtcAecm_ComplexIFFT128AVX2);
+    }
+    WebRtcAecm_FreeCore(aecm1);
+    WebRtcAecm_FreeCore(aecm2);
+#endif
+    return failures;
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "check.h"
+#include "../SPL/signal_processing_library.h"
+
+uint32_t Check_Rand(uint32_t *state)
+{
+    // xorshift32, the state must not be 0.
+    uint32_t x = *state ? *state : 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void Check_FillW16(int16_t *out, size_t length, uint32_t *state)
+{
+    static const int16_t kExtremes[] = {-32768, 32767, -1, 0};
+    size_t run = Check_Rand(state) % 4 == 0 ? Check_Rand(state) % (length + 1) : 0;
+    int16_t extreme = kExtremes[Check_Rand(state) % 4];
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uint32_t r = Check_Rand(state);
+        if (i < run)
+            out[i] = extreme;
+        else if (r % 4 == 0)
+            out[i] = kExtremes[(r >> 2) % 4];
+        else
+            out[i] = (int16_t) (r >> 16);
+    }
+}
+
+int Check_Report(const char *kernel, const char *isa, int failed, size_t length)
+{
+    if (failed)
+        printf("%-36s %-6s FAIL at length %zu\n", kernel, isa, length);
+    else
+        printf("%-36s %-6s ok\n", kernel, isa);
+    return failed ? 1 : 0;
+}
+
+int main(void)
+{
+    printf("WebRTC 3A1V kernel test\n");
+    printf("cpu features :%s%s%s%s\n",
+           WebRtcSpl_CpuFeatures() & kSplCpuSSE2 ? " SSE2" : "",
+           WebRtcSpl_CpuFeatures() & kSplCpuSSE41 ? " SSE4.1" : "",
+           WebRtcSpl_CpuFeatures() & kSplCpuAVX2 ? " AVX2" : "",
+           WebRtcSpl_CpuFeatures() & kSplCpuPOPCNT ? " POPCNT" : "");
+
+    int failures = CheckSpl_Run() + CheckAecm_Run() + CheckNs_Run();
+    if (failures != 0)
+    {
+        printf("%d kernel versions differ from their C reference\n", failures);
+        return 1;
+    }
+    printf("all kernel versions match their C reference\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "../NS/noise_suppression.h"
+#include "../NS/ns_fast_math.h"
+#include "../NS/ns_lockstep.h"
+#include "../SPL/signal_processing_library.h"
+
+#define CHECK_MAX_VECTOR    (HALF_ANAL_BLOCKL + 11)
+#define CHECK_NS_FRAMES     300
+
+static const size_t kRdftLengths[] = {64, 128, 256};
+
+static const size_t kLockstepStreams[] = {4, 8, 12, 16};
+
+// Random float in [-amplitude, amplitude).
+static float randomFloat(uint32_t *state, float amplitude)
+{
+    return ((float) (Check_Rand(state) >> 8) / (1 << 23) - 1.f) * amplitude;
+}
+
+// The 128 and 256 point transforms of the analysis, 64 points go to
+// WebRtc_rdft() in every version.
+static int checkRdft(const char *isa, Rdft version)
+{
+    uint32_t seed = 31;
+    for (size_t k = 0; k < sizeof(kRdftLengths) / sizeof(kRdftLengths[0]); k++)
+    {
+        size_t n = kRdftLengths[k];
+        size_t ip1[IP_LENGTH], ip2[IP_LENGTH];
+        float w1[W_LENGTH], w2[W_LENGTH];
+        float data1[ANAL_BLOCKL_MAX], data2[ANAL_BLOCKL_MAX];
+
+        // Setting ip[0] to 0 makes the first transform initialize the tables.
+        ip1[0] = ip2[0] = 0;
+        memset(data1, 0, sizeof(data1));
+        memset(data2, 0, sizeof(data2));
+        WebRtc_rdft(n, 1, data1, ip1, w1);
+        WebRtc_rdft(n, 1, data2, ip2, w2);
+        for (int t = 0; t < 64 * CHECK_TRIALS; t++)
+        {
+            int isgn = t % 2 ? -1 : 1;
+            float amplitude = t % 4 < 2 ? 32768.f : 1.f;
+            for (size_t i = 0; i < n; i++)
+                data1[i] = randomFloat(&seed, amplitude);
+            memcpy(data2, data1, n * sizeof(float));
+            WebRtc_rdft(n, isgn, data1, ip1, w1);
+            version(n, isgn, data2, ip2, w2);
+            if (memcmp(data1, data2, n * sizeof(float)) != 0)
+                return Check_Report("WebRtcNs_Rdft", isa, 1, n);
+        }
+    }
+    return Check_Report("WebRtcNs_Rdft", isa, 0, 0);
+}
+
+// The quantile update over a run of frames, on the magnitude lengths of 8 and
+// 16 kHz and the lengths around them.
+static int checkQuantiles(const char *isa, UpdateQuantiles version)
+{
+    static float lquantile1[SIMULT * CHECK_MAX_VECTOR], lquantile2[SIMULT * CHECK_MAX_VECTOR];
+    static float density1[SIMULT * CHECK_MAX_VECTOR], density2[SIMULT * CHECK_MAX_VECTOR];
+    uint32_t seed = 32;
+
+    for (size_t magnLen = 1; magnLen <= CHECK_MAX_VECTOR; magnLen++)
+    {
+        float lmagn[CHECK_MAX_VECTOR];
+        int counter[SIMULT];
+        size_t size = SIMULT * magnLen;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            lquantile1[i] = randomFloat(&seed, 8.f) + 8.f;
+            // Densities below, at and above 1.
+            density1[i] = Check_Rand(&seed) % 8 == 0 ? 1.f : randomFloat(&seed, 2.f) + 2.f;
+        }
+        memcpy(lquantile2, lquantile1, size * sizeof(float));
+        memcpy(density2, density1, size * sizeof(float));
+        for (int s = 0; s < SIMULT; s++)
+            counter[s] = (int) (Check_Rand(&seed) % 200);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            for (size_t i = 0; i < magnLen; i++)
+            {
+                // Some bins sit right on the estimate.
+                lmagn[i] = Check_Rand(&seed) % 8 == 0 ? lquantile1[i] : randomFloat(&seed, 8.f) + 8.f;
+            }
+            WebRtcNs_UpdateQuantileBins(lmagn, magnLen, counter, 0, lquantile1, density1);
+            version(lmagn, magnLen, counter, lquantile2, density2);
+            if (memcmp(lquantile1, lquantile2, size * sizeof(float)) != 0 ||
+                memcmp(density1, density2, size * sizeof(float)) != 0)
+                return Check_Report("WebRtcNs_UpdateQuantiles", isa, 1, magnLen);
+            for (int s = 0; s < SIMULT; s++)
+                counter[s] = (counter[s] + 1) % 200;
+        }
+    }
+    return Check_Report("WebRtcNs_UpdateQuantiles", isa, 0, 0);
+}
+
+// The fast math arrays, in place and out of place. |minValue| and |maxValue|
+// bound the arguments, the log and sqrt arguments are also drawn from all
+// octaves in between.
+static int checkVectorMath(const char *name, const char *isa, float (*reference)(float),
+                           VectorMath version, float minValue, float maxValue)
+{
+    uint32_t seed = 33;
+    for (size_t length = 0; length <= CHECK_MAX_VECTOR; length++)
+    {
+        float in[CHECK_MAX_VECTOR + 1], out1[CHECK_MAX_VECTOR + 1], out2[CHECK_MAX_VECTOR + 1];
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                float u = (float) (Check_Rand(&seed) >> 8) / (1 << 24);
+                in[i] = minValue + u * (maxValue - minValue);
+                // Positive arguments spread over all octaves of the range.
+                if (t % 2 && minValue >= 0.f)
+                    in[i] = ldexpf(1.f + u, (int) (Check_Rand(&seed) % 181) - 90);
+            }
+            for (size_t i = 0; i < length; i++)
+                out1[i] = reference(in[i]);
+            out1[length] = out2[length] = 1234.f;
+            version(in, out2, length);
+            if (memcmp(out1, out2, (length + 1) * sizeof(float)) != 0)
+                return Check_Report(name, isa, 1, length);
+            version(in, in, length);
+            if (memcmp(out1, in, length * sizeof(float)) != 0)
+                return Check_Report(name, isa, 1, length);
+        }
+    }
+    return Check_Report(name, isa, 0, 0);
+}
+
+static float logApprox(float x)
+{
+    return WebRtcNs_LogApprox(x);
+}
+
+static float expApprox(float x)
+{
+    return WebRtcNs_ExpApprox(x);
+}
+
+static float sqrtApprox(float x)
+{
+    return WebRtcNs_SqrtApprox(x);
+}
+
+// Noise with an envelope that changes every frame, one in four streams turns
+// silent after a while.
+static void fillStream(int16_t *out, size_t length, size_t stream, int frame, uint32_t *state)
+{
+    int shift = (int) (Check_Rand(state) % 12);
+    int silent = stream % 4 == 3 && frame >= CHECK_NS_FRAMES / 2;
+    for (size_t i = 0; i < length; i++)
+        out[i] = silent ? 0 : (int16_t) ((int16_t) (Check_Rand(state) >> 16) >> shift);
+}
+
+// The lockstep engine against one instance per stream.
+static int checkLockstep(void)
+{
+    static const uint32_t kRates[] = {8000, 16000};
+    static const char *const kNames[] = {"WebRtcNsLs_Process 8 kHz", "WebRtcNsLs_Process 16 kHz"};
+    uint32_t seed = 34;
+
+    for (size_t r = 0; r < sizeof(kRates) / sizeof(kRates[0]); r++)
+    {
+        for (size_t c = 0; c < sizeof(kLockstepStreams) / sizeof(kLockstepStreams[0]); c++)
+        {
+            size_t streams = kLockstepStreams[c];
+            size_t frameLength = kRates[r] / 100;
+            int mode = (int) (c % 4);
+            NsLockstep *ls = WebRtcNsLs_Create(streams);
+            NsHandle *ns[NS_LS_MAX_STREAMS] = {NULL};
+            int16_t in[NS_LS_MAX_STREAMS][BLOCKL_MAX];
+            int16_t out1[NS_LS_MAX_STREAMS][BLOCKL_MAX], out2[NS_LS_MAX_STREAMS][BLOCKL_MAX];
+            const int16_t *inFrames[NS_LS_MAX_STREAMS];
+            int16_t *outFrames[NS_LS_MAX_STREAMS];
+            int failed = ls == NULL || WebRtcNsLs_Init(ls, kRates[r], mode) != 0;
+
+            for (size_t s = 0; s < streams && !failed; s++)
+            {
+                ns[s] = WebRtcNs_Create();
+                failed = ns[s] == NULL || WebRtcNs_Init(ns[s], kRates[r]) != 0 ||
+                         WebRtcNs_set_policy(ns[s], mode) != 0;
+                inFrames[s] = in[s];
+                outFrames[s] = out2[s];
+            }
+            for (int frame = 0; frame < CHECK_NS_FRAMES && !failed; frame++)
+            {
+                for (size_t s = 0; s < streams; s++)
+                {
+                    const int16_t *inBand = in[s];
+                    int16_t *outBand = out1[s];
+                    fillStream(in[s], frameLength, s, frame, &seed);
+                    failed |= WebRtcNs_AnalyzeProcess(ns[s], &inBand, 1, &outBand) != 0;
+                }
+                failed |= WebRtcNsLs_Process(ls, inFrames, outFrames) != 0;
+                for (size_t s = 0; s < streams; s++)
+                    failed |= memcmp(out1[s], out2[s], frameLength * sizeof(int16_t)) != 0;
+            }
+            for (size_t s = 0; s < streams; s++)
+                WebRtcNs_Free(ns[s]);
+            WebRtcNsLs_Free(ls);
+            if (failed)
+                return Check_Report(kNames[r], "C", 1, streams);
+        }
+        Check_Report(kNames[r], "C", 0, 0);
+    }
+    return 0;
+}
+
+int CheckNs_Run(void)
+{
+    int failures = 0;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuSSE2)
+    {
+        failures += checkRdft("SSE2", WebRtcNs_RdftSSE2);
+        failures += checkQuantiles("SSE2", WebRtcNs_UpdateQuantilesSSE2);
+        failures += checkVectorMath("WebRtcNs_LogVector", "SSE2", logApprox,
+                                    WebRtcNs_LogVectorSSE2, 1e-30f, 1e30f);
+        failures += checkVectorMath("WebRtcNs_ExpVector", "SSE2", expApprox,
+                                    WebRtcNs_ExpVectorSSE2, -100.f, 100.f);
+        failures += checkVectorMath("WebRtcNs_SqrtVector", "SSE2", sqrtApprox,
+                                    WebRtcNs_SqrtVectorSSE2, 0.f, 1e30f);
+    }
+    if (features & kSplCpuAVX2)
+    {
+        failures += checkRdft("AVX2", WebRtcNs_RdftAVX2);
+        failures += checkQuantiles("AVX2", WebRtcNs_UpdateQuantilesAVX2);
+        failures += checkVectorMath("WebRtcNs_LogVector", "AVX2", logApprox,
+                                    WebRtcNs_LogVectorAVX2, 1e-30f, 1e30f);
+        failures += checkVectorMath("WebRtcNs_ExpVector", "AVX2", expApprox,
+                                    WebRtcNs_ExpVectorAVX2, -100.f, 100.f);
+        failures += checkVectorMath("WebRtcNs_SqrtVector", "AVX2", sqrtApprox,
+                                    WebRtcNs_SqrtVectorAVX2, 0.f, 1e30f);
+    }
+#endif
+    // The stream loops of the lockstep engine are vectorized by the compiler,
+    // on every CPU.
+    failures += checkLockstep();
+    return failures;
+}
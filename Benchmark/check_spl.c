@@ -0,0 +1,272 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "../SPL/spl_simd.h"
+
+// Every length up to a few vectors of the widest version, then the frame and
+// block lengths of the modules and their neighbours.
+#define CHECK_SHORT_LENGTHS 73
+#define CHECK_MAX_LENGTH    1027
+#define CHECK_MAX_CHANNELS  8
+
+static const size_t kLongLengths[] = {127, 128, 129, 159, 160, 161, 255, 256, 257, 320, 480,
+                                      CHECK_MAX_LENGTH};
+
+static const size_t kChannels[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+static const size_t kMeanChannels[] = {1, 2, 3, 4, 5, 6, 7, 8, 16, 32};
+
+#define NUM_LENGTHS (CHECK_SHORT_LENGTHS + sizeof(kLongLengths) / sizeof(kLongLengths[0]))
+
+static size_t checkLength(size_t k)
+{
+    return k < CHECK_SHORT_LENGTHS ? k : kLongLengths[k - CHECK_SHORT_LENGTHS];
+}
+
+// The outputs have room for a guard value after the last sample.
+static int16_t in1[CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH];
+static int16_t in2[CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH];
+static int16_t out1[CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH + 1];
+static int16_t out2[CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH + 1];
+static int32_t gains[CHECK_MAX_LENGTH];
+static int32_t squares1[CHECK_MAX_LENGTH];
+static int32_t squares2[CHECK_MAX_LENGTH];
+
+// Gains in Q16, mostly below 16 like the AGC uses, some anywhere in 32 bits.
+static void fillGains(int32_t *out, size_t length, uint32_t *state)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint32_t r = Check_Rand(state);
+        out[i] = Check_Rand(state) % 3 == 0 ? (int32_t) r : (int32_t) (r % (1u << 20));
+    }
+}
+
+static int checkMaxAbs(const char *isa, MaxAbsValueW16 version)
+{
+    uint32_t seed = 1;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            Check_FillW16(in1, length, &seed);
+            if (version(in1, length) != WebRtcSpl_MaxAbsValueW16C(in1, length))
+                return Check_Report("WebRtcSpl_MaxAbsValueW16", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_MaxAbsValueW16", isa, 0, 0);
+}
+
+static int checkScalingSquare(const char *isa, GetScalingSquare version)
+{
+    uint32_t seed = 2;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            size_t times = t % 2 ? length : Check_Rand(&seed) % 4096;
+            Check_FillW16(in1, length, &seed);
+            if (version(in1, length, times) != WebRtcSpl_GetScalingSquareC(in1, length, times))
+                return Check_Report("WebRtcSpl_GetScalingSquare", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_GetScalingSquare", isa, 0, 0);
+}
+
+static int checkEnergy(const char *isa, EnergyW16 version)
+{
+    uint32_t seed = 3;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            int scale1 = -1, scale2 = -2;
+            Check_FillW16(in1, length, &seed);
+            // The scaling does not see -32768, the sum of its squares would
+            // overflow the C version.
+            for (size_t i = 0; i < length; i++)
+                in1[i] = in1[i] == -32768 ? -32767 : in1[i];
+            if (version(in1, length, &scale1) != WebRtcSpl_EnergyC(in1, length, &scale2) ||
+                scale1 != scale2)
+                return Check_Report("WebRtcSpl_Energy", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_Energy", isa, 0, 0);
+}
+
+static int checkDotProduct(const char *isa, DotProductWithScale version)
+{
+    uint32_t seed = 4;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            int scaling = (int) (Check_Rand(&seed) % 32);
+            Check_FillW16(in1, length, &seed);
+            Check_FillW16(in2, length, &seed);
+            if (version(in1, in2, length, scaling) !=
+                WebRtcSpl_DotProductWithScaleC(in1, in2, length, scaling))
+                return Check_Report("WebRtcSpl_DotProductWithScale", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_DotProductWithScale", isa, 0, 0);
+}
+
+static int checkAddSat(const char *isa, AddSatVectorW16 version)
+{
+    uint32_t seed = 5;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            Check_FillW16(in1, length, &seed);
+            Check_FillW16(in2, length, &seed);
+            // The output one past the end must be left alone.
+            out1[length] = out2[length] = 0x1234;
+            WebRtcSpl_AddSatVectorW16C(in1, in2, out1, length);
+            version(in1, in2, out2, length);
+            if (memcmp(out1, out2, (length + 1) * sizeof(int16_t)) != 0)
+                return Check_Report("WebRtcSpl_AddSatVectorW16", isa, 1, length);
+            // In place, as the AGC calls it.
+            memcpy(out2, in1, length * sizeof(int16_t));
+            version(out2, in2, out2, length);
+            if (memcmp(out1, out2, length * sizeof(int16_t)) != 0)
+                return Check_Report("WebRtcSpl_AddSatVectorW16", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_AddSatVectorW16", isa, 0, 0);
+}
+
+static int checkMaxSquareBlocks(const char *isa, MaxSquareBlocksW16 version)
+{
+    uint32_t seed = 6;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t blockLength = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            size_t blocks = 1 + Check_Rand(&seed) % 10;
+            if (blockLength * blocks > CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH)
+                blocks = 1;
+            Check_FillW16(in1, blockLength * blocks, &seed);
+            squares1[blocks] = squares2[blocks] = 0x12345678;
+            WebRtcSpl_MaxSquareBlocksW16C(in1, blockLength, blocks, squares1);
+            version(in1, blockLength, blocks, squares2);
+            if (memcmp(squares1, squares2, (blocks + 1) * sizeof(int32_t)) != 0)
+                return Check_Report("WebRtcSpl_MaxSquareBlocksW16", isa, 1, blockLength);
+        }
+    }
+    return Check_Report("WebRtcSpl_MaxSquareBlocksW16", isa, 0, 0);
+}
+
+static int checkApplyGains(const char *isa, ApplyGainsW16 version)
+{
+    uint32_t seed = 7;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t length = checkLength(k);
+        for (int t = 0; t < CHECK_TRIALS; t++)
+        {
+            Check_FillW16(out1, length + 1, &seed);
+            memcpy(out2, out1, (length + 1) * sizeof(int16_t));
+            fillGains(gains, length, &seed);
+            WebRtcSpl_ApplyGainsW16C(out1, gains, length);
+            version(out2, gains, length);
+            if (memcmp(out1, out2, (length + 1) * sizeof(int16_t)) != 0)
+                return Check_Report("WebRtcSpl_ApplyGainsW16", isa, 1, length);
+        }
+    }
+    return Check_Report("WebRtcSpl_ApplyGainsW16", isa, 0, 0);
+}
+
+static int checkApplyGainsStrided(const char *isa, ApplyGainsStridedW16 version)
+{
+    uint32_t seed = 8;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t frames = checkLength(k);
+        for (size_t c = 0; c < sizeof(kChannels) / sizeof(kChannels[0]); c++)
+        {
+            size_t channels = kChannels[c];
+            size_t length = channels * frames;
+            Check_FillW16(out1, length + 1, &seed);
+            memcpy(out2, out1, (length + 1) * sizeof(int16_t));
+            fillGains(gains, frames, &seed);
+            WebRtcSpl_ApplyGainsStridedW16C(out1, channels, gains, frames);
+            version(out2, channels, gains, frames);
+            if (memcmp(out1, out2, (length + 1) * sizeof(int16_t)) != 0)
+                return Check_Report("WebRtcSpl_ApplyGainsStridedW16", isa, 1, frames);
+        }
+    }
+    return Check_Report("WebRtcSpl_ApplyGainsStridedW16", isa, 0, 0);
+}
+
+static int checkMeanChannels(const char *isa, MeanChannelsW16 version)
+{
+    uint32_t seed = 9;
+    for (size_t k = 0; k < NUM_LENGTHS; k++)
+    {
+        size_t frames = checkLength(k);
+        for (size_t c = 0; c < sizeof(kMeanChannels) / sizeof(kMeanChannels[0]); c++)
+        {
+            size_t channels = kMeanChannels[c];
+            if (channels * frames > CHECK_MAX_CHANNELS * CHECK_MAX_LENGTH)
+                continue;
+            Check_FillW16(in1, channels * frames, &seed);
+            out1[frames] = out2[frames] = 0x1234;
+            WebRtcSpl_MeanChannelsW16C(in1, channels, frames, out1);
+            version(in1, channels, frames, out2);
+            if (memcmp(out1, out2, (frames + 1) * sizeof(int16_t)) != 0)
+                return Check_Report("WebRtcSpl_MeanChannelsW16", isa, 1, frames);
+        }
+    }
+    return Check_Report("WebRtcSpl_MeanChannelsW16", isa, 0, 0);
+}
+
+int CheckSpl_Run(void)
+{
+    int failures = 0;
+
+#if defined(CHECK_X86)
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuSSE2)
+    {
+        failures += checkMaxAbs("SSE2", WebRtcSpl_MaxAbsValueW16SSE2);
+        failures += checkScalingSquare("SSE2", WebRtcSpl_GetScalingSquareSSE2);
+        failures += checkEnergy("SSE2", WebRtcSpl_EnergySSE2);
+        failures += checkDotProduct("SSE2", WebRtcSpl_DotProductWithScaleSSE2);
+        failures += checkAddSat("SSE2", WebRtcSpl_AddSatVectorW16SSE2);
+        failures += checkMaxSquareBlocks("SSE2", WebRtcSpl_MaxSquareBlocksW16SSE2);
+        failures += checkApplyGains("SSE2", WebRtcSpl_ApplyGainsW16SSE2);
+        failures += checkApplyGainsStrided("SSE2", WebRtcSpl_ApplyGainsStridedW16SSE2);
+        failures += checkMeanChannels("SSE2", WebRtcSpl_MeanChannelsW16SSE2);
+    }
+    if (features & kSplCpuSSE41)
+    {
+        failures += checkMaxAbs("SSE4.1", WebRtcSpl_MaxAbsValueW16SSE41);
+        failures += checkScalingSquare("SSE4.1", WebRtcSpl_GetScalingSquareSSE41);
+        failures += checkEnergy("SSE4.1", WebRtcSpl_EnergySSE41);
+        failures += checkDotProduct("SSE4.1", WebRtcSpl_DotProductWithScaleSSE41);
+        failures += checkMaxSquareBlocks("SSE4.1", WebRtcSpl_MaxSquareBlocksW16SSE41);
+    }
+    if (features & kSplCpuAVX2)
+    {
+        failures += checkMaxAbs("AVX2", WebRtcSpl_MaxAbsValueW16AVX2);
+        failures += checkScalingSquare("AVX2", WebRtcSpl_GetScalingSquareAVX2);
+        failures += checkEnergy("AVX2", WebRtcSpl_EnergyAVX2);
+        failures += checkDotProduct("AVX2", WebRtcSpl_DotProductWithScaleAVX2);
+        failures += checkAddSat("AVX2", WebRtcSpl_AddSatVectorW16AVX2);
+        failures += checkMaxSquareBlocks("AVX2", WebRtcSpl_MaxSquareBlocksW16AVX2);
+        failures += checkApplyGains("AVX2", WebRtcSpl_ApplyGainsW16AVX2);
+        failures += checkApplyGainsStrided("AVX2", WebRtcSpl_ApplyGainsStridedW16AVX2);
+    }
+#endif
+    return failures;
+}
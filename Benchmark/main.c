@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "timing.h"
+#include "bench.h"
+
+#ifndef nullptr
+#define nullptr 0
+#endif
+
+static const int kRates[] = {8000, 16000, 32000, 48000};
+
+void Bench_FillSignal(int16_t *out, size_t length, int fs, uint32_t seed)
+{
+    const double pi = 3.14159265358979323846;
+    uint32_t state = seed * 2654435761u + 1;
+    for (size_t i = 0; i < length; i++)
+    {
+        double t = (double) i / fs;
+        double env = 0.5 * (1.0 + sin(2 * pi * 0.7 * t + seed));
+        double s = env * (0.3 * sin(2 * pi * 220 * t) + 0.2 * sin(2 * pi * 440 * t + 1) +
+                          0.1 * sin(2 * pi * 1300 * t));
+        state = state * 1664525u + 1013904223u;
+        double noise = ((double) (state >> 8) / (1u << 24)) - 0.5;
+        out[i] = (int16_t) ((s + 0.1 * noise) * 20000);
+    }
+}
+
+// Runs |kernel| for at least |minSeconds| and returns the time per call in ns.
+static double benchRun(const BenchKernel *kernel, void *state, double minSeconds)
+{
+    for (int i = 0; i < 100; i++)
+        kernel->run(state);
+
+    uint64_t calls = 16;
+    for (;;)
+    {
+        uint64_t start = nanotimer();
+        for (uint64_t i = 0; i < calls; i++)
+            kernel->run(state);
+        double elapsed = (double) (nanotimer() - start) / 1e9;
+        if (elapsed >= minSeconds)
+            return elapsed * 1e9 / calls;
+        calls = elapsed > 0 ? (uint64_t) (calls * 1.2 * minSeconds / elapsed) + 1 : calls * 16;
+    }
+}
+
+static void benchTable(const BenchKernel *kernels, size_t count, const char *filter, double minSeconds)
+{
+    for (size_t k = 0; k < count; k++)
+    {
+        const BenchKernel *kernel = &kernels[k];
+        if (filter && strstr(kernel->name, filter) == NULL)
+            continue;
+        for (size_t r = 0; r < sizeof(kRates) / sizeof(kRates[0]); r++)
+        {
+            size_t samplesPerCall = 0;
+            void *state = kernel->create(kRates[r], &samplesPerCall);
+            if (state == nullptr)
+            {
+                printf("%-36s %6d %12s %14s\n", kernel->name, kRates[r], "n/a", "n/a");
+                continue;
+            }
+            double nsPerCall = benchRun(kernel, state, minSeconds);
+            double framesPerSec = 1e9 / nsPerCall * samplesPerCall / (kRates[r] / 100);
+            printf("%-36s %6d %12.1f %14.0f\n", kernel->name, kRates[r], nsPerCall, framesPerSec);
+            kernel->destroy(state);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    printf("WebRTC 3A1V kernel benchmark\n");
+    printf("usage : benchmark [-t seconds] [kernel_name_filter]\n");
+    double minSeconds = 0.2;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            minSeconds = atof(argv[++i]);
+        else
+            filter = argv[i];
+    }
+
+    printf("%-36s %6s %12s %14s\n", "kernel", "fs", "ns/call", "frames/sec");
+    const BenchKernel *(*tables[])(size_t *) = {
+            BenchNs_Kernels,
+            BenchAecm_Kernels,
+            BenchAgc_Kernels,
+            BenchVad_Kernels,
+            BenchCng_Kernels,
+    };
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++)
+    {
+        size_t count = 0;
+        const BenchKernel *kernels = tables[t](&count);
+        benchTable(kernels, count, filter, minSeconds);
+    }
+    if (filter == nullptr || strstr("NS fast math", filter) != NULL)
+        BenchNs_FastMathReport();
+    return 0;
+}
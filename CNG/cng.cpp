@@ -9,6 +9,7 @@
  */
 
 #include "cng.h"
+#include "../SPL/signal_processing_library.h"
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
@@ -27,15 +28,6 @@
 // We cannot do casting here due to signed/unsigned problem
 #define WEBRTC_SPL_LSHIFT_W32(x, c)     ((x) << (c))
 
-int32_t WebRtcSpl_DivW32W16(int32_t num, int16_t den) {
-    // Guard against division with 0
-    if (den != 0) {
-        return (int32_t) (num / den);
-    } else {
-        return (int32_t) 0x7FFFFFFF;
-    }
-}
-
 void WebRtcSpl_ScaleVector(const int16_t *in_vector, int16_t *out_vector,
                            int16_t gain, size_t in_vector_length,
                            int16_t right_shifts) {
@@ -149,10 +141,10 @@ size_t WebRtcSpl_FilterAR(const int16_t *a,
                           int16_t *state,
                           size_t state_length,
                           int16_t *state_low,
-                          size_t state_low_length,
+                          size_t /* state_low_length */,
                           int16_t *filtered,
                           int16_t *filtered_low,
-                          size_t filtered_low_length) {
+                          size_t /* filtered_low_length */) {
     int64_t o;
     int32_t oLOW;
     size_t i, j, stop;
@@ -241,6 +233,7 @@ const int16_t WebRtcCng_kCorrWindow[WEBRTC_CNG_MAX_LPC_ORDER] = {
 
 ComfortNoiseDecoder::ComfortNoiseDecoder() {
     /* Needed to get the right function pointers in SPLIB. */
+    WebRtcSpl_Init();
     Reset();
 }
 
@@ -408,7 +401,7 @@ ComfortNoiseEncoder::ComfortNoiseEncoder(int fs, int interval, int quality)
     RTC_CHECK_GT(quality, 0);
     RTC_CHECK_LE(quality, WEBRTC_CNG_MAX_LPC_ORDER);
     /* Needed to get the right function pointers in SPLIB. */
-
+    WebRtcSpl_Init();
 }
 
 void ComfortNoiseEncoder::Reset(int fs, int interval, int quality) {
@@ -426,96 +419,6 @@ void ComfortNoiseEncoder::Reset(int fs, int interval, int quality) {
     enc_seed_ = 7777;  /* For debugging only. */
 }
 
-const int8_t kWebRtcSpl_CountLeadingZeros32_Table[64] = {
-        32, 8, 17, -1, -1, 14, -1, -1, -1, 20, -1, -1, -1, 28, -1, 18,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 26, 25, 24,
-        4, 11, 23, 31, 3, 7, 10, 16, 22, 30, -1, -1, 2, 6, 13, 9,
-        -1, 15, -1, 21, -1, 29, 19, -1, -1, -1, -1, -1, 1, 27, 5, 12,
-};
-
-
-// Don't call this directly except in tests!
-static __inline int WebRtcSpl_CountLeadingZeros32_NotBuiltin(uint32_t n) {
-    // Normalize n by rounding up to the nearest number that is a sequence of 0
-    // bits followed by a sequence of 1 bits. This number has the same number of
-    // leading zeros as the original n. There are exactly 33 such values.
-    n |= n >> 1;
-    n |= n >> 2;
-    n |= n >> 4;
-    n |= n >> 8;
-    n |= n >> 16;
-
-    // Multiply the modified n with a constant selected (by exhaustive search)
-    // such that each of the 33 possible values of n give a product whose 6 most
-    // significant bits are unique. Then look up the answer in the table.
-    return kWebRtcSpl_CountLeadingZeros32_Table[(n * 0x8c0b2891) >> 26];
-}
-
-// Don't call this directly except in tests!
-static __inline int WebRtcSpl_CountLeadingZeros64_NotBuiltin(uint64_t n) {
-    const int leading_zeros = n >> 32 == 0 ? 32 : 0;
-    return leading_zeros + WebRtcSpl_CountLeadingZeros32_NotBuiltin(
-            (uint32_t) (n >> (32 - leading_zeros)));
-}
-
-// Returns the number of leading zero bits in the argument.
-static __inline int WebRtcSpl_CountLeadingZeros32(uint32_t n) {
-    return WebRtcSpl_CountLeadingZeros32_NotBuiltin(n);
-}
-
-static __inline int16_t WebRtcSpl_GetSizeInBits(uint32_t n) {
-    return 32 - WebRtcSpl_CountLeadingZeros32(n);
-}
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t WebRtcSpl_NormW32(int32_t a) {
-    return a == 0 ? 0 : WebRtcSpl_CountLeadingZeros32(a < 0 ? ~a : a) - 1;
-}
-
-int16_t WebRtcSpl_GetScalingSquare(int16_t *in_vector,
-                                   size_t in_vector_length,
-                                   size_t times) {
-    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) times);
-    size_t i;
-    int16_t smax = -1;
-    int16_t sabs;
-    int16_t *sptr = in_vector;
-    int16_t t;
-    size_t looptimes = in_vector_length;
-
-    for (i = looptimes; i > 0; i--) {
-        sabs = (*sptr > 0 ? *sptr++ : -*sptr++);
-        smax = (sabs > smax ? sabs : smax);
-    }
-    t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax, smax));
-
-    if (smax == 0) {
-        return 0; // Since norm(0) returns 0
-    } else {
-        return (t > nbits) ? 0 : nbits - t;
-    }
-}
-
-int32_t WebRtcSpl_Energy(int16_t *vector,
-                         size_t vector_length,
-                         int *scale_factor) {
-    int32_t en = 0;
-    size_t i;
-    int scaling =
-            WebRtcSpl_GetScalingSquare(vector, vector_length, vector_length);
-    size_t looptimes = vector_length;
-    int16_t *vectorptr = vector;
-
-    for (i = 0; i < looptimes; i++) {
-        en += (*vectorptr * *vectorptr) >> scaling;
-        vectorptr++;
-    }
-    *scale_factor = scaling;
-
-    return en;
-}
-
 // Hanning table with 256 entries
 static const int16_t kHanningTable[] = {
         1, 2, 6, 10, 15, 22, 30, 39,
@@ -573,28 +476,6 @@ void WebRtcSpl_GetHanningWindow(int16_t *v, size_t size) {
 
 }
 
-int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t *vector, size_t length) {
-    size_t i = 0;
-    int absolute = 0, maximum = 0;
-
-    RTC_DCHECK_GT(length, 0);
-
-    for (i = 0; i < length; i++) {
-        absolute = abs((int) vector[i]);
-
-        if (absolute > maximum) {
-            maximum = absolute;
-        }
-    }
-
-    // Guard the case for abs(-32768).
-    if (maximum > WEBRTC_SPL_WORD16_MAX) {
-        maximum = WEBRTC_SPL_WORD16_MAX;
-    }
-
-    return (int16_t) maximum;
-}
-
 void WebRtcSpl_ElementwiseVectorMult(int16_t *out, const int16_t *in,
                                      const int16_t *win, size_t vector_length,
                                      int16_t right_shifts) {
@@ -620,7 +501,7 @@ size_t WebRtcSpl_AutoCorrelation(const int16_t *in_vector,
     RTC_DCHECK_LE(order, in_vector_length);
 
     // Find the maximum absolute value of the samples.
-    smax = WebRtcSpl_MaxAbsValueW16C(in_vector, in_vector_length);
+    smax = WebRtcSpl_MaxAbsValueW16(in_vector, in_vector_length);
 
     // In order to avoid overflow when computing the sum we should scale the
     // samples so that (in_vector_length * smax * smax) will not overflow.
@@ -16,7 +16,7 @@
 #endif
 
 //写wav文件
-void wavWrite_int16(char *filename, int16_t *buffer, size_t sampleRate, size_t totalSampleCount) {
+void wavWrite_int16(const char *filename, int16_t *buffer, size_t sampleRate, size_t totalSampleCount) {
     drwav_data_format format = {};
     format.container = drwav_container_riff;     // <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
     format.format = DR_WAVE_FORMAT_PCM;          // <-- Any of the DR_WAVE_FORMAT_* codes.
@@ -93,7 +93,7 @@ enum {
     kForceSid
 };
 
-int main(int argc, char *argv[]) {
+int main() {
     printf("WebRtc Comfort Noise Generator\n");
     printf("舒适噪音生成器\n");
     int sample_rate_hz = 8000;//  8000, 16000,  32000,  48000, 64000
@@ -109,7 +109,7 @@ int main(int argc, char *argv[]) {
     if (ret == 0) {
         size_t size = cng_encoder.Encode(ArrayView<const int16_t>(speech_data_, num_samples_10ms),
                                          kForceSid, &sid_data);
-        if (size == (quality + 1))
+        if (size == (size_t) (quality + 1))
             printf("done \n");
         wavWrite_int16("cng.wav", speech_data_, sample_rate_hz, num_samples_10ms);
     }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #define DR_MP3_IMPLEMENTATION
 
@@ -10,8 +11,11 @@
 
 #include "dr_wav.h"
 #include "timing.h"
+#include "../Tools/batch.h"
 
 #include "noise_suppression.h"
+#include "ns_multichannel.h"
+#include "../SPL/signal_processing_library.h"
 
 #ifndef nullptr
 #define nullptr 0
@@ -22,58 +26,110 @@
 #endif
 
 
-void wavWrite_int16(char *filename, int16_t *buffer, int sampleRate, uint64_t totalSampleCount, uint32_t channels)
+// 每次读写的 10ms 帧数, 内存占用与文件长度无关
+#define BLOCK_FRAMES 50
+
+//流式读取 wav 或 mp3 文件
+typedef struct
 {
-    drwav_data_format format;
-    format.container = drwav_container_riff;
-    format.format = DR_WAVE_FORMAT_PCM;
-    format.channels = channels;
-    format.sampleRate = (drwav_uint32) sampleRate;
-    format.bitsPerSample = 16;
+    drwav *wav;
+    drmp3 *mp3;
+    float *mp3Buffer;
+    uint64_t capacity;
+    uint64_t framesRead;
+    uint32_t sampleRate;
+    uint32_t channels;
+} AudioReader;
 
-    drwav *pWav = drwav_open_file_write(filename, &format);
-    if (pWav)
+void audioReaderClose(AudioReader *reader)
+{
+    if (reader->wav)
     {
-        drwav_uint64 samplesWritten = drwav_write(pWav, totalSampleCount, buffer);
-        drwav_uninit(pWav);
-        if (samplesWritten != totalSampleCount)
-        {
-            fprintf(stderr, "write file [%s] error.\n", filename);
-            exit(1);
-        }
+        drwav_uninit(reader->wav);
+        free(reader->wav);
     }
+    if (reader->mp3)
+    {
+        drmp3_uninit(reader->mp3);
+        free(reader->mp3);
+    }
+    if (reader->mp3Buffer)
+        free(reader->mp3Buffer);
+    memset(reader, 0, sizeof(*reader));
 }
 
-int16_t *wavRead_int16(const char *filename, uint32_t *sampleRate, uint64_t *sampleCount, uint32_t *channels)
+int audioReaderOpen(AudioReader *reader, const char *filename, uint64_t capacity)
 {
-    drwav_uint64 totalSampleCount = 0;
-    int16_t *input = drwav_open_file_and_read_pcm_frames_s16(filename, channels, sampleRate, &totalSampleCount);
-    if (input == NULL)
+    memset(reader, 0, sizeof(*reader));
+    reader->capacity = capacity;
+    reader->wav = (drwav *) malloc(sizeof(drwav));
+    if (reader->wav && drwav_init_file(reader->wav, filename))
     {
-        drmp3_config pConfig;
-        float *mp3_buf = drmp3_open_file_and_read_f32(filename, &pConfig, &totalSampleCount);
-        if (mp3_buf != NULL)
-        {
-            *channels = pConfig.outputChannels;
-            *sampleRate = pConfig.outputSampleRate;
-        }
-        input = (int16_t *) mp3_buf;
-        for (int32_t i = 0; i < *sampleCount; ++i)
+        reader->sampleRate = reader->wav->sampleRate;
+        reader->channels = reader->wav->channels;
+        return 0;
+    }
+    free(reader->wav);
+    reader->wav = NULL;
+    reader->mp3 = (drmp3 *) malloc(sizeof(drmp3));
+    if (reader->mp3 && drmp3_init_file(reader->mp3, filename, NULL))
+    {
+        reader->sampleRate = reader->mp3->sampleRate;
+        reader->channels = reader->mp3->channels;
+        reader->mp3Buffer = (float *) malloc(sizeof(float) * capacity * reader->channels);
+        if (reader->mp3Buffer)
+            return 0;
+        drmp3_uninit(reader->mp3);
+    }
+    free(reader->mp3);
+    reader->mp3 = NULL;
+    fprintf(stderr, "read file [%s] error.\n", filename);
+    return -1;
+}
+
+//读取最多 frames 帧, 返回实际读取的帧数
+uint64_t audioReaderRead(AudioReader *reader, int16_t *buffer, uint64_t frames)
+{
+    uint64_t framesRead;
+    if (reader->wav)
+    {
+        framesRead = drwav_read_pcm_frames_s16(reader->wav, frames, buffer);
+    }
+    else
+    {
+        if (frames > reader->capacity)
+            frames = reader->capacity;
+        framesRead = drmp3_read_pcm_frames_f32(reader->mp3, frames, reader->mp3Buffer);
+        for (uint64_t i = 0; i < framesRead * reader->channels; ++i)
         {
-            input[i] = (int16_t) drwav_clamp((mp3_buf[i] * 32768.0f), -32768, 32767);
+            buffer[i] = (int16_t) drwav_clamp((reader->mp3Buffer[i] * 32768.0f), -32768, 32767);
         }
     }
-    if (input == NULL)
+    reader->framesRead += framesRead;
+    return framesRead;
+}
+
+//打开 wav 文件用于流式写入
+int wavOpenWrite(drwav *pWav, const char *filename, uint32_t sampleRate, uint32_t channels)
+{
+    drwav_data_format format;
+    format.container = drwav_container_riff;
+    format.format = DR_WAVE_FORMAT_PCM;
+    format.channels = channels;
+    format.sampleRate = (drwav_uint32) sampleRate;
+    format.bitsPerSample = 16;
+
+    if (!drwav_init_file_write(pWav, filename, &format))
     {
-        fprintf(stderr, "read file [%s] error.\n", filename);
-        exit(1);
+        fprintf(stderr, "write file [%s] error.\n", filename);
+        return -1;
     }
-    *sampleCount = totalSampleCount * (*channels);
-
-    return input;
+    return 0;
 }
 
 
+
+
 //分割路径函数
 void splitpath(const char *path, char *drv, char *dir, char *name, char *ext)
 {
@@ -132,27 +188,26 @@ enum nsLevel
 };
 
 
-int nsProcess(int16_t *buffer, uint32_t sampleRate, uint64_t samplesCount, uint32_t channels, enum nsLevel level)
+int nsProcess(AudioReader *reader, drwav *writer, enum nsLevel level, double *processTime)
 {
-    if (buffer == nullptr) return -1;
-    if (samplesCount == 0) return -1;
+    if (reader == nullptr || writer == nullptr) return -1;
+    uint32_t sampleRate = reader->sampleRate;
+    uint32_t channels = reader->channels;
     size_t samples = MIN(160, sampleRate / 100);
-    if (samples == 0) return -1;
-    uint32_t num_bands = 1;
-    int16_t *input = buffer;
-    size_t frames = (samplesCount / (samples * channels));
-    int16_t *frameBuffer = (int16_t *) malloc(sizeof(*frameBuffer) * channels * samples);
+    if (samples == 0 || channels == 0) return -1;
+    uint64_t blockFrames = samples * BLOCK_FRAMES;
+    int16_t *block = (int16_t *) malloc(sizeof(*block) * channels * blockFrames);
     NsHandle **NsHandles = (NsHandle **) malloc(channels * sizeof(NsHandle *));
-    if (NsHandles == NULL || frameBuffer == NULL)
+    if (NsHandles == NULL || block == NULL)
     {
         if (NsHandles)
             free(NsHandles);
-        if (frameBuffer)
-            free(frameBuffer);
+        if (block)
+            free(block);
         fprintf(stderr, "malloc error.\n");
         return -1;
     }
-    for (int i = 0; i < channels; i++)
+    for (uint32_t i = 0; i < channels; i++)
     {
         NsHandles[i] = WebRtcNs_Create(); //
         if (NsHandles[i] != NULL)
@@ -177,7 +232,7 @@ int nsProcess(int16_t *buffer, uint32_t sampleRate, uint64_t samplesCount, uint3
         }
         if (NsHandles[i] == NULL)
         {
-            for (int x = 0; x < i; x++)
+            for (uint32_t x = 0; x < i; x++)
             {
                 if (NsHandles[x])
                 {
@@ -185,28 +240,32 @@ int nsProcess(int16_t *buffer, uint32_t sampleRate, uint64_t samplesCount, uint3
                 }
             }
             free(NsHandles);
-            free(frameBuffer);
+            free(block);
             return -1;
         }
     }
-    for (int i = 0; i < frames; i++)
+    int ret = 1;
+    uint64_t framesRead;
+    while ((framesRead = audioReaderRead(reader, block, blockFrames)) > 0)
     {
-        for (int c = 0; c < channels; c++)
+        double startTime = now();
+        // 不足 10ms 的尾部数据原样输出
+        if (WebRtcNs_ProcessInterleaved(NsHandles, channels, block, channels, framesRead / samples) != 0)
         {
-            for (int k = 0; k < samples; k++)
-                frameBuffer[k] = input[k * channels + c];
-
-            int16_t *nsIn[1] = {frameBuffer};   //ns input[band][data]
-            int16_t *nsOut[1] = {frameBuffer};  //ns output[band][data]
-            WebRtcNs_Analyze(NsHandles[c], nsIn[0]);
-            WebRtcNs_Process(NsHandles[c], (const int16_t *const *) nsIn, num_bands, nsOut);
-            for (int k = 0; k < samples; k++)
-                input[k * channels + c] = frameBuffer[k];
+            fprintf(stderr, "WebRtcNs_ProcessInterleaved fail\n");
+            ret = -1;
+            break;
+        }
+        *processTime += calcElapsed(startTime, now());
+        if (drwav_write_pcm_frames(writer, framesRead, block) != framesRead)
+        {
+            fprintf(stderr, "write error.\n");
+            ret = -1;
+            break;
         }
-        input += samples * channels;
     }
 
-    for (int i = 0; i < channels; i++)
+    for (uint32_t i = 0; i < channels; i++)
     {
         if (NsHandles[i])
         {
@@ -214,47 +273,211 @@ int nsProcess(int16_t *buffer, uint32_t sampleRate, uint64_t samplesCount, uint3
         }
     }
     free(NsHandles);
-    free(frameBuffer);
-    return 1;
+    free(block);
+    return ret;
 }
 
-void noise_suppression(char *in_file, char *out_file)
+//多通道: 每个通道一个工作线程, 按块并行处理
+int nsProcessMultiChannel(AudioReader *reader, drwav *writer, enum nsLevel level, double *processTime)
 {
-    //音频采样率
-    uint32_t sampleRate = 0;
-    uint32_t channels = 0;
-    //总音频采样数
-    uint64_t inSampleCount = 0;
-    int16_t *inBuffer = wavRead_int16(in_file, &sampleRate, &inSampleCount, &channels);
-
-    //如果加载成功
-    if (inBuffer != nullptr)
+    if (reader == nullptr || writer == nullptr) return -1;
+    uint32_t sampleRate = reader->sampleRate;
+    uint32_t channels = reader->channels;
+    size_t samples = MIN(160, sampleRate / 100);
+    if (samples == 0 || channels == 0) return -1;
+    //线程创建失败时退回逐通道串行处理
+    NsMultiChannel *engine = WebRtcNsMc_Create(channels, BLOCK_FRAMES);
+    if (engine == NULL)
+        return nsProcess(reader, writer, level, processTime);
+    uint64_t blockFrames = samples * BLOCK_FRAMES;
+    int16_t *block = (int16_t *) malloc(sizeof(*block) * channels * blockFrames);
+    if (block == NULL)
+    {
+        WebRtcNsMc_Free(engine);
+        fprintf(stderr, "malloc error.\n");
+        return -1;
+    }
+    if (WebRtcNsMc_Init(engine, sampleRate, level) != 0)
+    {
+        fprintf(stderr, "WebRtcNsMc_Init fail\n");
+        WebRtcNsMc_Free(engine);
+        free(block);
+        return -1;
+    }
+    int ret = 1;
+    uint64_t framesRead;
+    while ((framesRead = audioReaderRead(reader, block, blockFrames)) > 0)
     {
         double startTime = now();
-        nsProcess(inBuffer, sampleRate, inSampleCount, channels, kModerate);
-        double time_interval = calcElapsed(startTime, now());
-        printf("time interval: %d ms\n ", (int) (time_interval * 1000));
+        // 不足 10ms 的尾部数据原样输出
+        if (WebRtcNsMc_Process(engine, block, framesRead / samples) != 0)
+        {
+            fprintf(stderr, "WebRtcNsMc_Process fail\n");
+            ret = -1;
+            break;
+        }
+        *processTime += calcElapsed(startTime, now());
+        if (drwav_write_pcm_frames(writer, framesRead, block) != framesRead)
+        {
+            fprintf(stderr, "write error.\n");
+            ret = -1;
+            break;
+        }
+    }
+    WebRtcNsMc_Free(engine);
+    free(block);
+    return ret;
+}
 
+//32/48 kHz: 每个 10ms 帧先分成 2/3 个 16 kHz 子带, 低频子带降噪, 高频子带按低频结果加增益
+int nsProcessBands(AudioReader *reader, drwav *writer, enum nsLevel level, double *processTime)
+{
+    if (reader == nullptr || writer == nullptr) return -1;
+    uint32_t sampleRate = reader->sampleRate;
+    uint32_t channels = reader->channels;
+    size_t samples = sampleRate / 100;
+    if (samples == 0 || channels == 0) return -1;
+    uint64_t blockFrames = samples * BLOCK_FRAMES;
+    int16_t *block = (int16_t *) malloc(sizeof(*block) * channels * blockFrames);
+    NsHandle **NsHandles = (NsHandle **) calloc(channels, sizeof(NsHandle *));
+    WebRtcSpl_BandSplitState *splits = (WebRtcSpl_BandSplitState *) malloc(channels * sizeof(*splits));
+    int ret = 1;
+    if (block == NULL || NsHandles == NULL || splits == NULL)
+    {
+        fprintf(stderr, "malloc error.\n");
+        ret = -1;
+    }
+    for (uint32_t c = 0; ret > 0 && c < channels; c++)
+    {
+        NsHandles[c] = WebRtcNs_Create();
+        if (NsHandles[c] == NULL || WebRtcNs_Init(NsHandles[c], sampleRate) != 0 ||
+            WebRtcNs_set_policy(NsHandles[c], level) != 0 ||
+            WebRtcSpl_BandSplitInit(&splits[c], sampleRate) != 0)
+        {
+            fprintf(stderr, "WebRtcNs_Init fail\n");
+            ret = -1;
+        }
+    }
+    int16_t frame[BLOCKL_MAX * SPL_MAX_BANDS];
+    int16_t bandData[SPL_MAX_BANDS][BLOCKL_MAX];
+    int16_t *bands[SPL_MAX_BANDS] = {bandData[0], bandData[1], bandData[2]};
+    uint64_t framesRead;
+    while (ret > 0 && (framesRead = audioReaderRead(reader, block, blockFrames)) > 0)
+    {
+        double startTime = now();
+        // 不足 10ms 的尾部数据原样输出
+        for (uint64_t f = 0; f < framesRead / samples; f++)
+        {
+            int16_t *input = block + f * samples * channels;
+            for (uint32_t c = 0; c < channels; c++)
+            {
+                for (size_t k = 0; k < samples; k++)
+                    frame[k] = input[k * channels + c];
+                WebRtcSpl_BandSplitAnalysis(&splits[c], frame, bands);
+                WebRtcNs_AnalyzeProcess(NsHandles[c], (const int16_t *const *) bands, splits[c].numBands,
+                                        bands);
+                WebRtcSpl_BandSplitSynthesis(&splits[c], (const int16_t *const *) bands, frame);
+                for (size_t k = 0; k < samples; k++)
+                    input[k * channels + c] = frame[k];
+            }
+        }
+        *processTime += calcElapsed(startTime, now());
+        if (drwav_write_pcm_frames(writer, framesRead, block) != framesRead)
+        {
+            fprintf(stderr, "write error.\n");
+            ret = -1;
+        }
+    }
 
-        wavWrite_int16(out_file, inBuffer, sampleRate, inSampleCount, channels);
-        free(inBuffer);
+    for (uint32_t c = 0; NsHandles && c < channels; c++)
+    {
+        if (NsHandles[c])
+            WebRtcNs_Free(NsHandles[c]);
     }
+    free(NsHandles);
+    free(splits);
+    free(block);
+    return ret;
 }
 
-int main(int argc, char *argv[])
+int noise_suppression(const char *in_file, const char *out_file, double *audioSeconds, double *processSeconds)
 {
-    printf("WebRtc Noise Suppression\n");
-    if (argc < 2)
+    AudioReader reader;
+    drwav writer;
+    //按块读取, 避免整个文件载入内存
+    if (audioReaderOpen(&reader, in_file, 480 * BLOCK_FRAMES) != 0)
         return -1;
-    char *in_file = argv[1];
+    if (wavOpenWrite(&writer, out_file, reader.sampleRate, reader.channels) != 0)
+    {
+        audioReaderClose(&reader);
+        return -1;
+    }
+    *processSeconds = 0;
+    int ret;
+    if (reader.sampleRate > 16000)
+        ret = nsProcessBands(&reader, &writer, kModerate, processSeconds);
+    else if (reader.channels > 1)
+        ret = nsProcessMultiChannel(&reader, &writer, kModerate, processSeconds);
+    else
+        ret = nsProcess(&reader, &writer, kModerate, processSeconds);
+    *audioSeconds = reader.sampleRate ? (double) reader.framesRead / reader.sampleRate : 0;
+
+    drwav_uninit(&writer);
+    audioReaderClose(&reader);
+    return ret > 0 ? 0 : -1;
+}
+
+//输出文件名: 输入文件名加 _out 后缀
+void outFilePath(const char *in_file, char *out_file)
+{
     char drive[3];
     char dir[256];
     char fname[256];
     char ext[256];
-    char out_file[1024];
     splitpath(in_file, drive, dir, fname, ext);
     sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
-    noise_suppression(in_file, out_file);
+}
+
+int nsBatchJob(const char *in_file, void *user, double *audioSeconds, double *processSeconds)
+{
+    char out_file[1024];
+    (void) user;
+    outFilePath(in_file, out_file);
+    return noise_suppression(in_file, out_file, audioSeconds, processSeconds);
+}
+
+int main(int argc, char *argv[])
+{
+    printf("WebRtc Noise Suppression\n");
+    if (argc < 2)
+    {
+        printf("usage : NS in_file.wav\n");
+        printf("        NS -b dir_or_manifest [threads]\n");
+        return -1;
+    }
+    if (strcmp(argv[1], "-b") == 0)
+    {
+        //批处理模式: 每个文件一个独立实例, 线程数默认为 CPU 核数
+        if (argc < 3)
+            return -1;
+        BatchList list;
+        BatchStats stats;
+        if (batchListLoad(&list, argv[2], ".wav") != 0)
+            return -1;
+        double startTime = now();
+        int threads = batchRun(&list, argc > 3 ? atoi(argv[3]) : 0, nsBatchJob, NULL, &stats);
+        stats.wallSeconds = calcElapsed(startTime, now());
+        batchReport(&stats, threads);
+        batchListFree(&list);
+        return stats.failed == 0 && threads > 0 ? 0 : 1;
+    }
+    char *in_file = argv[1];
+    char out_file[1024];
+    outFilePath(in_file, out_file);
+    double audioSeconds = 0;
+    double time_interval = 0;
+    noise_suppression(in_file, out_file, &audioSeconds, &time_interval);
+    printf("time interval: %d ms\n ", (int) (time_interval * 1000));
 
     printf("press any key to exit. \n");
     getchar();
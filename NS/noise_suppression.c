@@ -9,11 +9,24 @@
  */
 
 #include "noise_suppression.h"
+#include "ns_fast_math.h"
+#include "../SPL/signal_processing_library.h"
 
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
 
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+
+# include <windows.h>
+
+#else
+
+# include <pthread.h>
+
+#endif
+
 #ifndef SPL_SAT
 #define SPL_SAT(a, b, c)         ((b) > (a) ? (a) : (b) < (c) ? (c) : (b))
 #endif
@@ -104,6 +117,302 @@ static const float kBlocks160w256[256] = {
         (float) 0.01636173
 };
 
+// Twiddle factors of the 128 and 256 point WebRtc_rdft(), as computed by
+// makewt() and makect(), see NsFftTables.
+const NsFftTables WebRtcNs_kFftTables128 = {
+        // bitReverse
+        {
+                0, 64, 32, 96, 16, 80, 48, 112, 8, 72, 40, 104, 24, 88, 56, 120,
+                4, 68, 36, 100, 20, 84, 52, 116, 12, 76, 44, 108, 28, 92, 60, 124,
+                2, 66, 34, 98, 18, 82, 50, 114, 10, 74, 42, 106, 26, 90, 58, 122,
+                6, 70, 38, 102, 22, 86, 54, 118, 14, 78, 46, 110, 30, 94, 62, 126,
+        },
+        // w
+        {
+                1.0f, 0.0f, 0.707106769f, 0.707106769f,
+                0.923879504f, 0.382683456f, 0.382683456f, 0.923879504f,
+                0.980785251f, 0.195090324f, 0.555570245f, 0.831469595f,
+                0.831469595f, 0.555570245f, 0.195090324f, 0.980785251f,
+                0.99518472f, 0.0980171412f, 0.634393334f, 0.773010433f,
+                0.881921232f, 0.471396744f, 0.290284693f, 0.956940353f,
+                0.956940353f, 0.290284693f, 0.471396744f, 0.881921232f,
+                0.773010433f, 0.634393334f, 0.0980171412f, 0.99518472f,
+        },
+        // wk1r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.923879504f, 0.923879504f, 0.382683456f, 0.382683456f,
+                0.980785251f, 0.980785251f, 0.555570245f, 0.555570245f,
+                0.831469595f, 0.831469595f, 0.195090324f, 0.195090324f,
+                0.99518472f, 0.99518472f, 0.634393334f, 0.634393334f,
+                0.881921232f, 0.881921232f, 0.290284693f, 0.290284693f,
+                0.956940353f, 0.956940353f, 0.471396744f, 0.471396744f,
+                0.773010433f, 0.773010433f, 0.0980171412f, 0.0980171412f,
+        },
+        // wk1i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.382683456f, 0.382683456f, -0.923879504f, 0.923879504f,
+                -0.195090324f, 0.195090324f, -0.831469595f, 0.831469595f,
+                -0.555570245f, 0.555570245f, -0.980785251f, 0.980785251f,
+                -0.0980171412f, 0.0980171412f, -0.773010433f, 0.773010433f,
+                -0.471396744f, 0.471396744f, -0.956940353f, 0.956940353f,
+                -0.290284693f, 0.290284693f, -0.881921232f, 0.881921232f,
+                -0.634393334f, 0.634393334f, -0.99518472f, 0.99518472f,
+        },
+        // wk2r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.707106769f, 0.707106769f, -0.707106769f, -0.707106769f,
+                0.923879504f, 0.923879504f, -0.382683456f, -0.382683456f,
+                0.382683456f, 0.382683456f, -0.923879504f, -0.923879504f,
+                0.980785251f, 0.980785251f, -0.195090324f, -0.195090324f,
+                0.555570245f, 0.555570245f, -0.831469595f, -0.831469595f,
+                0.831469595f, 0.831469595f, -0.555570245f, -0.555570245f,
+                0.195090324f, 0.195090324f, -0.980785251f, -0.980785251f,
+        },
+        // wk2i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.707106769f, 0.707106769f, -0.707106769f, 0.707106769f,
+                -0.382683456f, 0.382683456f, -0.923879504f, 0.923879504f,
+                -0.923879504f, 0.923879504f, -0.382683456f, 0.382683456f,
+                -0.195090324f, 0.195090324f, -0.980785251f, 0.980785251f,
+                -0.831469595f, 0.831469595f, -0.555570245f, 0.555570245f,
+                -0.555570245f, 0.555570245f, -0.831469595f, 0.831469595f,
+                -0.980785251f, 0.980785251f, -0.195090324f, 0.195090324f,
+        },
+        // wk3r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.382683396f, 0.382683396f, -0.923879445f, -0.923879445f,
+                0.831469536f, 0.831469536f, -0.980785131f, -0.980785131f,
+                -0.195090353f, -0.195090353f, -0.555570245f, -0.555570245f,
+                0.956940353f, 0.956940353f, -0.881921172f, -0.881921172f,
+                0.0980170965f, 0.0980170965f, -0.773010433f, -0.773010433f,
+                0.634393275f, 0.634393275f, -0.9951846f, -0.9951846f,
+                -0.471396863f, -0.471396863f, -0.290284693f, -0.290284693f,
+        },
+        // wk3i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.923879445f, 0.923879445f, 0.382683396f, -0.382683396f,
+                -0.555570245f, 0.555570245f, -0.195090353f, 0.195090353f,
+                -0.980785131f, 0.980785131f, 0.831469536f, -0.831469536f,
+                -0.290284693f, 0.290284693f, -0.471396863f, 0.471396863f,
+                -0.9951846f, 0.9951846f, 0.634393275f, -0.634393275f,
+                -0.773010433f, 0.773010433f, 0.0980170965f, -0.0980170965f,
+                -0.881921172f, 0.881921172f, 0.956940353f, -0.956940353f,
+        },
+        // rftWkr
+        {
+                0.0f, 0.475466162f, 0.450991422f, 0.426634759f,
+                0.402454853f, 0.378509909f, 0.354857653f, 0.331555068f,
+                0.308658272f, 0.286222458f, 0.264301628f, 0.242948622f,
+                0.222214878f, 0.202150345f, 0.182803333f, 0.164220512f,
+                0.146446615f, 0.12952444f, 0.113494784f, 0.0983962417f,
+                0.0842652023f, 0.0711356997f, 0.0590393841f, 0.0480053425f,
+                0.0380602479f, 0.029227972f, 0.0215298235f, 0.0149843693f,
+                0.00960737467f, 0.00541174412f, 0.00240764022f, 0.000602275133f,
+        },
+        // rftWki
+        {
+                0.0f, 0.499397725f, 0.49759236f, 0.494588256f,
+                0.490392625f, 0.485015631f, 0.478470176f, 0.470772028f,
+                0.461939752f, 0.451994658f, 0.440960616f, 0.4288643f,
+                0.415734798f, 0.401603758f, 0.386505216f, 0.37047556f,
+                0.353553385f, 0.335779488f, 0.317196667f, 0.297849655f,
+                0.277785122f, 0.257051378f, 0.235698372f, 0.213777542f,
+                0.191341728f, 0.168444932f, 0.145142347f, 0.121490099f,
+                0.0975451618f, 0.0733652338f, 0.0490085706f, 0.024533838f,
+        },
+};
+
+const NsFftTables WebRtcNs_kFftTables256 = {
+        // bitReverse
+        {
+                0, 128, 64, 192, 32, 160, 96, 224, 16, 144, 80, 208, 48, 176, 112, 240,
+                8, 136, 72, 200, 40, 168, 104, 232, 24, 152, 88, 216, 56, 184, 120, 248,
+                4, 132, 68, 196, 36, 164, 100, 228, 20, 148, 84, 212, 52, 180, 116, 244,
+                12, 140, 76, 204, 44, 172, 108, 236, 28, 156, 92, 220, 60, 188, 124, 252,
+                2, 130, 66, 194, 34, 162, 98, 226, 18, 146, 82, 210, 50, 178, 114, 242,
+                10, 138, 74, 202, 42, 170, 106, 234, 26, 154, 90, 218, 58, 186, 122, 250,
+                6, 134, 70, 198, 38, 166, 102, 230, 22, 150, 86, 214, 54, 182, 118, 246,
+                14, 142, 78, 206, 46, 174, 110, 238, 30, 158, 94, 222, 62, 190, 126, 254,
+        },
+        // w
+        {
+                1.0f, 0.0f, 0.707106769f, 0.707106769f,
+                0.923879504f, 0.382683456f, 0.382683456f, 0.923879504f,
+                0.980785251f, 0.195090324f, 0.555570245f, 0.831469595f,
+                0.831469595f, 0.555570245f, 0.195090324f, 0.980785251f,
+                0.99518472f, 0.0980171412f, 0.634393334f, 0.773010433f,
+                0.881921232f, 0.471396744f, 0.290284693f, 0.956940353f,
+                0.956940353f, 0.290284693f, 0.471396744f, 0.881921232f,
+                0.773010433f, 0.634393334f, 0.0980171412f, 0.99518472f,
+                0.99879545f, 0.0490676761f, 0.671558976f, 0.740951121f,
+                0.903989315f, 0.427555084f, 0.336889863f, 0.941544056f,
+                0.970031261f, 0.242980197f, 0.514102757f, 0.857728601f,
+                0.803207517f, 0.59569931f, 0.146730468f, 0.989176512f,
+                0.989176512f, 0.146730468f, 0.59569931f, 0.803207517f,
+                0.857728601f, 0.514102757f, 0.242980197f, 0.970031261f,
+                0.941544056f, 0.336889863f, 0.427555084f, 0.903989315f,
+                0.740951121f, 0.671558976f, 0.0490676761f, 0.99879545f,
+        },
+        // wk1r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.923879504f, 0.923879504f, 0.382683456f, 0.382683456f,
+                0.980785251f, 0.980785251f, 0.555570245f, 0.555570245f,
+                0.831469595f, 0.831469595f, 0.195090324f, 0.195090324f,
+                0.99518472f, 0.99518472f, 0.634393334f, 0.634393334f,
+                0.881921232f, 0.881921232f, 0.290284693f, 0.290284693f,
+                0.956940353f, 0.956940353f, 0.471396744f, 0.471396744f,
+                0.773010433f, 0.773010433f, 0.0980171412f, 0.0980171412f,
+                0.99879545f, 0.99879545f, 0.671558976f, 0.671558976f,
+                0.903989315f, 0.903989315f, 0.336889863f, 0.336889863f,
+                0.970031261f, 0.970031261f, 0.514102757f, 0.514102757f,
+                0.803207517f, 0.803207517f, 0.146730468f, 0.146730468f,
+                0.989176512f, 0.989176512f, 0.59569931f, 0.59569931f,
+                0.857728601f, 0.857728601f, 0.242980197f, 0.242980197f,
+                0.941544056f, 0.941544056f, 0.427555084f, 0.427555084f,
+                0.740951121f, 0.740951121f, 0.0490676761f, 0.0490676761f,
+        },
+        // wk1i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.382683456f, 0.382683456f, -0.923879504f, 0.923879504f,
+                -0.195090324f, 0.195090324f, -0.831469595f, 0.831469595f,
+                -0.555570245f, 0.555570245f, -0.980785251f, 0.980785251f,
+                -0.0980171412f, 0.0980171412f, -0.773010433f, 0.773010433f,
+                -0.471396744f, 0.471396744f, -0.956940353f, 0.956940353f,
+                -0.290284693f, 0.290284693f, -0.881921232f, 0.881921232f,
+                -0.634393334f, 0.634393334f, -0.99518472f, 0.99518472f,
+                -0.0490676761f, 0.0490676761f, -0.740951121f, 0.740951121f,
+                -0.427555084f, 0.427555084f, -0.941544056f, 0.941544056f,
+                -0.242980197f, 0.242980197f, -0.857728601f, 0.857728601f,
+                -0.59569931f, 0.59569931f, -0.989176512f, 0.989176512f,
+                -0.146730468f, 0.146730468f, -0.803207517f, 0.803207517f,
+                -0.514102757f, 0.514102757f, -0.970031261f, 0.970031261f,
+                -0.336889863f, 0.336889863f, -0.903989315f, 0.903989315f,
+                -0.671558976f, 0.671558976f, -0.99879545f, 0.99879545f,
+        },
+        // wk2r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.707106769f, 0.707106769f, -0.707106769f, -0.707106769f,
+                0.923879504f, 0.923879504f, -0.382683456f, -0.382683456f,
+                0.382683456f, 0.382683456f, -0.923879504f, -0.923879504f,
+                0.980785251f, 0.980785251f, -0.195090324f, -0.195090324f,
+                0.555570245f, 0.555570245f, -0.831469595f, -0.831469595f,
+                0.831469595f, 0.831469595f, -0.555570245f, -0.555570245f,
+                0.195090324f, 0.195090324f, -0.980785251f, -0.980785251f,
+                0.99518472f, 0.99518472f, -0.0980171412f, -0.0980171412f,
+                0.634393334f, 0.634393334f, -0.773010433f, -0.773010433f,
+                0.881921232f, 0.881921232f, -0.471396744f, -0.471396744f,
+                0.290284693f, 0.290284693f, -0.956940353f, -0.956940353f,
+                0.956940353f, 0.956940353f, -0.290284693f, -0.290284693f,
+                0.471396744f, 0.471396744f, -0.881921232f, -0.881921232f,
+                0.773010433f, 0.773010433f, -0.634393334f, -0.634393334f,
+                0.0980171412f, 0.0980171412f, -0.99518472f, -0.99518472f,
+        },
+        // wk2i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.707106769f, 0.707106769f, -0.707106769f, 0.707106769f,
+                -0.382683456f, 0.382683456f, -0.923879504f, 0.923879504f,
+                -0.923879504f, 0.923879504f, -0.382683456f, 0.382683456f,
+                -0.195090324f, 0.195090324f, -0.980785251f, 0.980785251f,
+                -0.831469595f, 0.831469595f, -0.555570245f, 0.555570245f,
+                -0.555570245f, 0.555570245f, -0.831469595f, 0.831469595f,
+                -0.980785251f, 0.980785251f, -0.195090324f, 0.195090324f,
+                -0.0980171412f, 0.0980171412f, -0.99518472f, 0.99518472f,
+                -0.773010433f, 0.773010433f, -0.634393334f, 0.634393334f,
+                -0.471396744f, 0.471396744f, -0.881921232f, 0.881921232f,
+                -0.956940353f, 0.956940353f, -0.290284693f, 0.290284693f,
+                -0.290284693f, 0.290284693f, -0.956940353f, 0.956940353f,
+                -0.881921232f, 0.881921232f, -0.471396744f, 0.471396744f,
+                -0.634393334f, 0.634393334f, -0.773010433f, 0.773010433f,
+                -0.99518472f, 0.99518472f, -0.0980171412f, 0.0980171412f,
+        },
+        // wk3r
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                0.382683396f, 0.382683396f, -0.923879445f, -0.923879445f,
+                0.831469536f, 0.831469536f, -0.980785131f, -0.980785131f,
+                -0.195090353f, -0.195090353f, -0.555570245f, -0.555570245f,
+                0.956940353f, 0.956940353f, -0.881921172f, -0.881921172f,
+                0.0980170965f, 0.0980170965f, -0.773010433f, -0.773010433f,
+                0.634393275f, 0.634393275f, -0.9951846f, -0.9951846f,
+                -0.471396863f, -0.471396863f, -0.290284693f, -0.290284693f,
+                0.989176512f, 0.989176512f, -0.803207517f, -0.803207517f,
+                0.242980242f, 0.242980242f, -0.85772872f, -0.85772872f,
+                0.740951121f, 0.740951121f, -0.998795331f, -0.998795331f,
+                -0.336889863f, -0.336889863f, -0.427555144f, -0.427555144f,
+                0.903989315f, 0.903989315f, -0.941544056f, -0.941544056f,
+                -0.0490676761f, -0.0490676761f, -0.671558976f, -0.671558976f,
+                0.514102697f, 0.514102697f, -0.970031261f, -0.970031261f,
+                -0.59569937f, -0.59569937f, -0.146730468f, -0.146730468f,
+        },
+        // wk3i
+        {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                -0.923879445f, 0.923879445f, 0.382683396f, -0.382683396f,
+                -0.555570245f, 0.555570245f, -0.195090353f, 0.195090353f,
+                -0.980785131f, 0.980785131f, 0.831469536f, -0.831469536f,
+                -0.290284693f, 0.290284693f, -0.471396863f, 0.471396863f,
+                -0.9951846f, 0.9951846f, 0.634393275f, -0.634393275f,
+                -0.773010433f, 0.773010433f, 0.0980170965f, -0.0980170965f,
+                -0.881921172f, 0.881921172f, 0.956940353f, -0.956940353f,
+                -0.146730468f, 0.146730468f, -0.59569937f, 0.59569937f,
+                -0.970031261f, 0.970031261f, 0.514102697f, -0.514102697f,
+                -0.671558976f, 0.671558976f, -0.0490676761f, 0.0490676761f,
+                -0.941544056f, 0.941544056f, 0.903989315f, -0.903989315f,
+                -0.427555144f, 0.427555144f, -0.336889863f, 0.336889863f,
+                -0.998795331f, 0.998795331f, 0.740951121f, -0.740951121f,
+                -0.85772872f, 0.85772872f, 0.242980242f, -0.242980242f,
+                -0.803207517f, 0.803207517f, 0.989176512f, -0.989176512f,
+        },
+        // rftWkr
+        {
+                0.0f, 0.487729371f, 0.475466162f, 0.463217705f,
+                0.450991422f, 0.438794672f, 0.426634759f, 0.414519042f,
+                0.402454853f, 0.390449375f, 0.378509909f, 0.366643608f,
+                0.354857653f, 0.343159139f, 0.331555068f, 0.320052475f,
+                0.308658272f, 0.297379315f, 0.286222458f, 0.275194347f,
+                0.264301628f, 0.253550887f, 0.242948622f, 0.232501209f,
+                0.222214878f, 0.212095886f, 0.202150345f, 0.192384183f,
+                0.182803333f, 0.173413575f, 0.164220512f, 0.155229717f,
+                0.146446615f, 0.137876451f, 0.12952444f, 0.121395588f,
+                0.113494784f, 0.105826795f, 0.0983962417f, 0.0912075937f,
+                0.0842652023f, 0.07757321f, 0.0711356997f, 0.064956516f,
+                0.0590393841f, 0.0533878505f, 0.0480053425f, 0.0428951383f,
+                0.0380602479f, 0.033503592f, 0.029227972f, 0.0252359211f,
+                0.0215298235f, 0.018111974f, 0.0149843693f, 0.0121489465f,
+                0.00960737467f, 0.00736117363f, 0.00541174412f, 0.00376021862f,
+                0.00240764022f, 0.00135478377f, 0.000602275133f, 0.000150591135f,
+        },
+        // rftWki
+        {
+                0.0f, 0.499849409f, 0.499397725f, 0.498645216f,
+                0.49759236f, 0.496239781f, 0.494588256f, 0.492638826f,
+                0.490392625f, 0.487851053f, 0.485015631f, 0.481888026f,
+                0.478470176f, 0.474764079f, 0.470772028f, 0.466496408f,
+                0.461939752f, 0.457104862f, 0.451994658f, 0.446612149f,
+                0.440960616f, 0.435043484f, 0.4288643f, 0.42242679f,
+                0.415734798f, 0.408792406f, 0.401603758f, 0.394173205f,
+                0.386505216f, 0.378604412f, 0.37047556f, 0.362123549f,
+                0.353553385f, 0.344770283f, 0.335779488f, 0.326586425f,
+                0.317196667f, 0.307615817f, 0.297849655f, 0.287904114f,
+                0.277785122f, 0.267498791f, 0.257051378f, 0.246449113f,
+                0.235698372f, 0.224805668f, 0.213777542f, 0.20262067f,
+                0.191341728f, 0.179947525f, 0.168444932f, 0.156840876f,
+                0.145142347f, 0.133356392f, 0.121490099f, 0.109550618f,
+                0.0975451618f, 0.0854809508f, 0.0733652338f, 0.0612053387f,
+                0.0490085706f, 0.0367822833f, 0.024533838f, 0.0122706145f,
+        },
+};
+
 /*
  * http://www.kurims.kyoto-u.ac.jp/~ooura/fft.html
  * Copyright Takuya OOURA, 1996-2001
@@ -185,6 +494,39 @@ void WebRtc_rdft(size_t n, int isgn, float *a, size_t *ip, float *w)
     }
 }
 
+Rdft WebRtcNs_Rdft = WebRtc_rdft;
+
+static void LogVectorC(const float *in, float *out, size_t length)
+{
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        out[i] = WebRtcNs_LogApprox(in[i]);
+    }
+}
+
+static void ExpVectorC(const float *in, float *out, size_t length)
+{
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        out[i] = WebRtcNs_ExpApprox(in[i]);
+    }
+}
+
+static void SqrtVectorC(const float *in, float *out, size_t length)
+{
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        out[i] = WebRtcNs_SqrtApprox(in[i]);
+    }
+}
+
+VectorMath WebRtcNs_LogVector = LogVectorC;
+VectorMath WebRtcNs_ExpVector = ExpVectorC;
+VectorMath WebRtcNs_SqrtVector = SqrtVectorC;
+
 /* -------- initializing routines -------- */
 
 
@@ -812,6 +1154,91 @@ static void set_feature_extraction_parameters(NoiseSuppressionC *self)
 }
 
 // Initialize state.
+// Initialize function pointers for x86 platforms.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcNs_InitX86(void)
+{
+    const int features = WebRtcSpl_CpuFeatures();
+
+    if (features & kSplCpuAVX2)
+    {
+        WebRtcNs_Rdft = WebRtcNs_RdftAVX2;
+        WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesAVX2;
+        WebRtcNs_LogVector = WebRtcNs_LogVectorAVX2;
+        WebRtcNs_ExpVector = WebRtcNs_ExpVectorAVX2;
+        WebRtcNs_SqrtVector = WebRtcNs_SqrtVectorAVX2;
+    }
+    else if (features & kSplCpuSSE2)
+    {
+        WebRtcNs_Rdft = WebRtcNs_RdftSSE2;
+        WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesSSE2;
+        WebRtcNs_LogVector = WebRtcNs_LogVectorSSE2;
+        WebRtcNs_ExpVector = WebRtcNs_ExpVectorSSE2;
+        WebRtcNs_SqrtVector = WebRtcNs_SqrtVectorSSE2;
+    }
+}
+#endif
+
+// Tables shared by all instances: the WebRtc_rdft() work arrays of both
+// analysis lengths, which the transforms only read once initialized, and the
+// log of the bin index for the pink noise fit.
+typedef struct {
+    size_t ip[IP_LENGTH];
+    float wfft[W_LENGTH];
+} NsRdftTables;
+
+static NsRdftTables rdftTables128;
+static NsRdftTables rdftTables256;
+static float logLut[HALF_ANAL_BLOCKL];
+static float logLutSqr[HALF_ANAL_BLOCKL];
+
+static void InitSharedTables(void)
+{
+    float data[ANAL_BLOCKL_MAX];
+    int i;
+
+    // Setting ip[0] to 0 triggers initialization.
+    memset(data, 0, sizeof(data));
+    rdftTables128.ip[0] = 0;
+    WebRtc_rdft(128, 1, data, rdftTables128.ip, rdftTables128.wfft);
+    memset(data, 0, sizeof(data));
+    rdftTables256.ip[0] = 0;
+    WebRtc_rdft(256, 1, data, rdftTables256.ip, rdftTables256.wfft);
+
+    for (i = 0; i < HALF_ANAL_BLOCKL; i++)
+    {
+        logLut[i] = logf((float) i);
+        logLutSqr[i] = logLut[i] * logLut[i];
+    }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    WebRtcNs_InitX86();
+#endif
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK InitOnce(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+    (void) once;
+    (void) param;
+    (void) context;
+    InitSharedTables();
+    return TRUE;
+}
+
+static void once(void)
+{
+    static INIT_ONCE lock = INIT_ONCE_STATIC_INIT;
+    InitOnceExecuteOnce(&lock, InitOnce, NULL, NULL);
+}
+#else
+static void once(void)
+{
+    static pthread_once_t lock = PTHREAD_ONCE_INIT;
+    pthread_once(&lock, InitSharedTables);
+}
+#endif
+
 int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
 {
     int i;
@@ -821,7 +1248,9 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
         return -1;
     }
     // Initialization of struct.
-    if (fs == 8000 || fs == 16000)
+    // Above 16 kHz the L band is the lowest 16 kHz band of a band split, see
+    // WebRtcSpl_BandSplitAnalysis().
+    if (fs == 8000 || fs == 16000 || fs == 32000 || fs == 48000)
     {
         self->fs = fs;
     }
@@ -831,33 +1260,46 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
     }
     self->windShift = 0;
     // We only support 10ms frames.
+    once();
     if (fs == 8000)
     {
         self->blockLen = 80;
         self->anaLen = 128;
         self->window = kBlocks80w128;
+        self->ip = rdftTables128.ip;
+        self->wfft = rdftTables128.wfft;
     }
     else
     {
         self->blockLen = 160;
         self->anaLen = 256;
         self->window = kBlocks160w256;
+        self->ip = rdftTables256.ip;
+        self->wfft = rdftTables256.wfft;
     }
     self->magnLen = self->anaLen / 2 + 1;  // Number of frequency bins.
     self->normMagnLen = 1.0f / self->magnLen;
-    // Initialize FFT work arrays.
-    self->ip[0] = 0;  // Setting this triggers initialization.
-    memset(self->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
-    WebRtc_rdft(self->anaLen, 1, self->dataBuf, self->ip, self->wfft);
 
     memset(self->analyzeBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
     memset(self->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
     memset(self->syntBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
 
-    // For HB processing.
-    memset(self->dataBufHB,
-           0,
-           sizeof(float) * NUM_HIGH_BANDS_MAX * ANAL_BLOCKL_MAX);
+    // For HB processing, only the band split rates have high bands.
+    if (fs > 16000)
+    {
+        if (self->dataBufHB == NULL)
+        {
+            self->dataBufHB = (float (*)[ANAL_BLOCKL_MAX]) malloc(
+                    sizeof(float) * NUM_HIGH_BANDS_MAX * ANAL_BLOCKL_MAX);
+            if (self->dataBufHB == NULL)
+            {
+                return -1;
+            }
+        }
+        memset(self->dataBufHB,
+               0,
+               sizeof(float) * NUM_HIGH_BANDS_MAX * ANAL_BLOCKL_MAX);
+    }
 
     // For quantile noise estimation.
     memset(self->quantile, 0, sizeof(float) * HALF_ANAL_BLOCKL);
@@ -879,8 +1321,6 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
     for (i = 0; i < HALF_ANAL_BLOCKL; i++)
     {
         self->smooth[i] = 1.f;
-        self->log_lut[i] = logf((float) i);
-        self->log_lut_sqr[i] = self->log_lut[i] * self->log_lut[i];
     }
 
     // Set the aggressiveness: default.
@@ -922,9 +1362,9 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
     self->featureData[6] = 0.f;
 
     // Histogram quantities: used to estimate/update thresholds for features.
-    memset(self->histLrt, 0, sizeof(int) * HIST_PAR_EST);
-    memset(self->histSpecFlat, 0, sizeof(int) * HIST_PAR_EST);
-    memset(self->histSpecDiff, 0, sizeof(int) * HIST_PAR_EST);
+    memset(self->histLrt, 0, sizeof(self->histLrt));
+    memset(self->histSpecFlat, 0, sizeof(self->histSpecFlat));
+    memset(self->histSpecDiff, 0, sizeof(self->histSpecDiff));
 
 
     self->blockInd = -1;  // Frame counter.
@@ -962,69 +1402,134 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs)
 
     // Default mode.
     WebRtcNs_set_policy_core(self, 0);
+    WebRtcNs_set_fast_math_core(self, 0);
 
     self->initFlag = 1;
     return 0;
 }
 
-// Estimate noise.
-static void NoiseEstimation(NoiseSuppressionC *self,
-                            float *lmagn,
-                            float *noise)
+// exp() of |length| values, from libm or ns_fast_math.h as selected on the
+// instance. |out| may be |in|.
+static void ExpVector(const NoiseSuppressionC *self, const float *in, float *out, size_t length)
 {
-    size_t i, s, offset = 0;
-    float delta;
+    size_t i;
 
-    if (self->updates < END_STARTUP_LONG)
+    if (self->fastMath)
     {
-        self->updates++;
+        WebRtcNs_ExpVector(in, out, length);
+        return;
+    }
+    for (i = 0; i < length; i++)
+    {
+        out[i] = expf(in[i]);
+    }
+}
+
+// log() of |length| values, see ExpVector().
+static void LogVector(const NoiseSuppressionC *self, const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    if (self->fastMath)
+    {
+        WebRtcNs_LogVector(in, out, length);
+        return;
+    }
+    for (i = 0; i < length; i++)
+    {
+        out[i] = logf(in[i]);
     }
+}
+
+static float Tanh(const NoiseSuppressionC *self, float x)
+{
+    return self->fastMath ? WebRtcNs_TanhApprox(x) : tanhf(x);
+}
+
+void WebRtcNs_UpdateQuantileBins(const float *lmagn,
+                                 size_t magnLen,
+                                 const int *counter,
+                                 size_t first,
+                                 float *lquantile,
+                                 float *density)
+{
+    size_t i, s, offset;
+    float delta;
 
-    // Loop over simultaneous estimates.
     for (s = 0; s < SIMULT; s++)
     {
-        offset = s * self->magnLen;
-        float norm_counter_weight = 1.f / (self->counter[s] + 1);
-        // newquantest(...)
-        for (i = 0; i < self->magnLen; i++)
+        offset = s * magnLen;
+        float norm_counter_weight = 1.f / (counter[s] + 1);
+        for (i = first; i < magnLen; i++)
         {
             // Compute delta.
-            if (self->density[offset + i] > 1.0)
+            if (density[offset + i] > 1.0)
             {
-                delta = FACTOR / self->density[offset + i];
+                delta = FACTOR / density[offset + i];
             }
             else
             {
                 delta = FACTOR;
             }
             // Update log quantile estimate.
-            if (lmagn[i] > self->lquantile[offset + i])
+            if (lmagn[i] > lquantile[offset + i])
             {
-                self->lquantile[offset + i] += QUANTILE * delta * norm_counter_weight;
+                lquantile[offset + i] += QUANTILE * delta * norm_counter_weight;
             }
             else
             {
-                self->lquantile[offset + i] -= (1.f - QUANTILE) * delta * norm_counter_weight;
+                lquantile[offset + i] -= (1.f - QUANTILE) * delta * norm_counter_weight;
             }
 
             // Update density estimate.
-            if (fabsf(lmagn[i] - self->lquantile[offset + i]) < WIDTH)
+            if (fabsf(lmagn[i] - lquantile[offset + i]) < WIDTH)
             {
-                self->density[offset + i] =
-                        ((float) self->counter[s] * self->density[offset + i] + 1.f / (2.f * WIDTH)) *
+                density[offset + i] =
+                        ((float) counter[s] * density[offset + i] + 1.f / (2.f * WIDTH)) *
                         norm_counter_weight;
             }
         }  // End loop over magnitude spectrum.
+    }  // End loop over simultaneous estimates.
+}
+
+static void UpdateQuantilesC(const float *lmagn,
+                             size_t magnLen,
+                             const int *counter,
+                             float *lquantile,
+                             float *density)
+{
+    WebRtcNs_UpdateQuantileBins(lmagn, magnLen, counter, 0, lquantile, density);
+}
+
+UpdateQuantiles WebRtcNs_UpdateQuantiles = UpdateQuantilesC;
+
+// Estimate noise.
+static void NoiseEstimation(NoiseSuppressionC *self,
+                            const float *lmagn,
+                            float *noise)
+{
+    size_t s, offset = 0;
+
+    if (self->updates < END_STARTUP_LONG)
+    {
+        self->updates++;
+    }
+
+    // newquantest(...) of all simultaneous estimates.
+    WebRtcNs_UpdateQuantiles(lmagn, self->magnLen, self->counter,
+                             self->lquantile, self->density);
+
+    // Loop over simultaneous estimates.
+    for (s = 0; s < SIMULT; s++)
+    {
+        offset = s * self->magnLen;
 
         if (self->counter[s] >= END_STARTUP_LONG)
         {
             self->counter[s] = 0;
             if (self->updates >= END_STARTUP_LONG)
             {
-                for (i = 0; i < self->magnLen; i++)
-                {
-                    self->quantile[i] = expf(self->lquantile[offset + i]);
-                }
+                ExpVector(self, &self->lquantile[offset], self->quantile, self->magnLen);
             }
         }
 
@@ -1035,10 +1540,7 @@ static void NoiseEstimation(NoiseSuppressionC *self,
     if (self->updates < END_STARTUP_LONG)
     {
         // Use the last "s" to get noise during startup that differ from zero.
-        for (i = 0; i < self->magnLen; i++)
-        {
-            self->quantile[i] = expf(self->lquantile[offset + i]);
-        }
+        ExpVector(self, &self->lquantile[offset], self->quantile, self->magnLen);
         memcpy(noise, self->quantile, self->magnLen * sizeof(*noise));
     }
     else
@@ -1084,7 +1586,7 @@ static void FeatureParameterExtraction(NoiseSuppressionC *self, int flag)
         }
         // Spectral flatness.
         if ((self->featureData[0] <
-             HIST_PAR_EST * self->featureExtractionParams.binSizeSpecFlat) &&
+             HIST_SPEC_FLAT_EST * self->featureExtractionParams.binSizeSpecFlat) &&
             (self->featureData[0] >= 0.0))
         {
             i = (int) (self->featureData[0] /
@@ -1161,7 +1663,7 @@ static void FeatureParameterExtraction(NoiseSuppressionC *self, int flag)
         weightPeak2SpecFlat = 0;
 
         // Peaks for flatness.
-        for (i = 0; i < HIST_PAR_EST; i++)
+        for (i = 0; i < HIST_SPEC_FLAT_EST; i++)
         {
             binMid =
                     (i + 0.5f) * self->featureExtractionParams.binSizeSpecFlat;
@@ -1305,12 +1807,9 @@ static void FeatureParameterExtraction(NoiseSuppressionC *self, int flag)
         // Set hists to zero for next update.
         if (self->modelUpdatePars[0] >= 1)
         {
-            for (i = 0; i < HIST_PAR_EST; i++)
-            {
-                self->histLrt[i] = 0;
-                self->histSpecFlat[i] = 0;
-                self->histSpecDiff[i] = 0;
-            }
+            memset(self->histLrt, 0, sizeof(self->histLrt));
+            memset(self->histSpecFlat, 0, sizeof(self->histSpecFlat));
+            memset(self->histSpecDiff, 0, sizeof(self->histSpecDiff));
         }
     }  // End of flag == 1.
 }
@@ -1352,7 +1851,9 @@ static void ComputeSpectralFlatness(NoiseSuppressionC *self,
     avgSpectralFlatnessNum = avgSpectralFlatnessNum * self->normMagnLen;
 
     // Ratio and inverse log: check for case of log(0).
-    spectralTmp = expf(avgSpectralFlatnessNum) / avgSpectralFlatnessDen;
+    spectralTmp = self->fastMath ? WebRtcNs_ExpApprox(avgSpectralFlatnessNum)
+                                 : expf(avgSpectralFlatnessNum);
+    spectralTmp /= avgSpectralFlatnessDen;
 
     // Time-avg update of spectral flatness feature.
     self->featureData[0] += SPECT_FL_TAVG * (spectralTmp - self->featureData[0]);
@@ -1391,8 +1892,9 @@ static void ComputeSnr(const NoiseSuppressionC *self,
         // Directed decision update of snrPrior.
         snrLocPrior[i] = 2.f * (
                 DD_PR_SNR * previousEstimateStsa + (1.f - DD_PR_SNR) * snrLocPost[i]);
-        logSnrLocPrior[i] = logf(snrLocPrior[i] + 1.0f);
+        logSnrLocPrior[i] = snrLocPrior[i] + 1.0f;
     }  // End of loop over frequencies.
+    LogVector(self, logSnrLocPrior, logSnrLocPrior, self->magnLen);
 }
 
 // Compute the difference measure between input spectrum and a template/learned
@@ -1457,9 +1959,39 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
                             const float *snrLocPost)
 {
     size_t i;
-    int sgnMap;
-    float invLrt, gainPrior, indPrior;
+    float invLrt, gainPrior;
     float logLrtTimeAvgKsum, besselTmp;
+    float tmpSnrLocPrior;
+
+    // Compute feature based on average LR factor.
+    // This is the average over all frequencies of the smooth log LRT.
+    logLrtTimeAvgKsum = 0.0;
+    for (i = 0; i < self->magnLen; i++)
+    {
+        tmpSnrLocPrior = snrLocPrior[i];
+        besselTmp = (snrLocPost[i] * tmpSnrLocPrior + tmpSnrLocPrior) / (tmpSnrLocPrior + 1.0001f);
+        self->logLrtTimeAvg[i] += LRT_TAVG * (besselTmp - logSnrLocPrior[i] - self->logLrtTimeAvg[i]);
+        logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
+    }
+    gainPrior = WebRtcNs_UpdatePriorSpeechProb(self, logLrtTimeAvgKsum);
+
+    // Final speech probability: combine prior model with LR factor:.
+    for (i = 0; i < self->magnLen; i++)
+    {
+        probSpeechFinal[i] = -self->logLrtTimeAvg[i];
+    }
+    ExpVector(self, probSpeechFinal, probSpeechFinal, self->magnLen);
+    for (i = 0; i < self->magnLen; i++)
+    {
+        invLrt = gainPrior * probSpeechFinal[i];
+        probSpeechFinal[i] = 1.f / (1.f + invLrt);
+    }
+}
+
+float WebRtcNs_UpdatePriorSpeechProb(NoiseSuppressionC *self, float logLrtTimeAvgKsum)
+{
+    int sgnMap;
+    float indPrior;
     float indicator0, indicator1, indicator2;
     float tmpSnrLocPrior;
     float weightIndPrior0, weightIndPrior1, weightIndPrior2;
@@ -1484,16 +2016,6 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
     weightIndPrior1 = self->priorModelPars[5];
     weightIndPrior2 = self->priorModelPars[6];
 
-    // Compute feature based on average LR factor.
-    // This is the average over all frequencies of the smooth log LRT.
-    logLrtTimeAvgKsum = 0.0;
-    for (i = 0; i < self->magnLen; i++)
-    {
-        tmpSnrLocPrior = snrLocPrior[i];
-        besselTmp = (snrLocPost[i] * tmpSnrLocPrior + tmpSnrLocPrior) / (tmpSnrLocPrior + 1.0001f);
-        self->logLrtTimeAvg[i] += LRT_TAVG * (besselTmp - logSnrLocPrior[i] - self->logLrtTimeAvg[i]);
-        logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
-    }
     logLrtTimeAvgKsum = logLrtTimeAvgKsum * self->normMagnLen;
     self->featureData[3] = logLrtTimeAvgKsum;
     // Done with computation of LR factor.
@@ -1507,7 +2029,7 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
         widthPrior = widthPrior1;
     }
     // Compute indicator function: sigmoid map.
-    indicator0 = 0.5f * tanhf(widthPrior * (logLrtTimeAvgKsum - threshPrior0)) + 0.5f;
+    indicator0 = 0.5f * Tanh(self, widthPrior * (logLrtTimeAvgKsum - threshPrior0)) + 0.5f;
 
     // Spectral flatness feature.
     tmpSnrLocPrior = self->featureData[0];
@@ -1522,7 +2044,7 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
         widthPrior = widthPrior1;
     }
     // Compute indicator function: sigmoid map.
-    indicator1 = 0.5f * tanhf((float) sgnMap * widthPrior * (threshPrior1 - tmpSnrLocPrior)) + 0.5f;
+    indicator1 = 0.5f * Tanh(self, (float) sgnMap * widthPrior * (threshPrior1 - tmpSnrLocPrior)) + 0.5f;
 
     // For template spectrum-difference.
     tmpSnrLocPrior = self->featureData[4];
@@ -1533,7 +2055,7 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
         widthPrior = widthPrior2;
     }
     // Compute indicator function: sigmoid map.
-    indicator2 = 0.5f * tanhf(widthPrior * (tmpSnrLocPrior - threshPrior2)) + 0.5f;
+    indicator2 = 0.5f * Tanh(self, widthPrior * (tmpSnrLocPrior - threshPrior2)) + 0.5f;
 
     // Combine the indicator function with the feature weights.
     indPrior = weightIndPrior0 * indicator0 + weightIndPrior1 * indicator1 +
@@ -1552,14 +2074,9 @@ static void SpeechNoiseProb(NoiseSuppressionC *self,
         self->priorSpeechProb = 0.01f;
     }
 
+
     // Final speech probability: combine prior model with LR factor:.
-    gainPrior = (1.f - self->priorSpeechProb) / (self->priorSpeechProb + 0.0001f);
-    for (i = 0; i < self->magnLen; i++)
-    {
-        invLrt = expf(-self->logLrtTimeAvg[i]);
-        invLrt = gainPrior * invLrt;
-        probSpeechFinal[i] = 1.f / (1.f + invLrt);
-    }
+    return (1.f - self->priorSpeechProb) / (self->priorSpeechProb + 0.0001f);
 }
 
 // Update the noise features.
@@ -1574,6 +2091,11 @@ static void FeatureUpdate(NoiseSuppressionC *self,
     ComputeSpectralFlatness(self, magn, lmagn);
     // Compute difference of input spectrum with learned/estimated noise spectrum.
     ComputeSpectralDifference(self, magn);
+    WebRtcNs_UpdateFeatureParameters(self, updateParsFlag);
+}
+
+void WebRtcNs_UpdateFeatureParameters(NoiseSuppressionC *self, int updateParsFlag)
+{
     // Compute histograms for parameter decisions (thresholds and weights for
     // features).
     // Parameters are extracted once every window time.
@@ -1691,7 +2213,7 @@ static void UpdateBuffer(const int16_t *frame,
            sizeof(*buffer) * (buffer_length - frame_length));
     if (frame)
     {
-        int i = 0;
+        size_t i = 0;
         for (i = 0; i < frame_length; ++i)
         {
             buffer[buffer_length - frame_length + i] = frame[i];
@@ -1705,6 +2227,20 @@ static void UpdateBuffer(const int16_t *frame,
     }
 }
 
+// Same as UpdateBuffer() for a frame of float samples.
+static void UpdateBufferFloat(const float *frame,
+                              size_t frame_length,
+                              size_t buffer_length,
+                              float *buffer)
+{
+    assert(buffer_length < 2 * frame_length);
+
+    memcpy(buffer,
+           buffer + frame_length,
+           sizeof(*buffer) * (buffer_length - frame_length));
+    memcpy(buffer + buffer_length - frame_length, frame, sizeof(*buffer) * frame_length);
+}
+
 // Transforms the signal from time to frequency domain.
 // Inputs:
 //   * |time_data| is the signal in the time domain.
@@ -1728,7 +2264,7 @@ static void FFT(NoiseSuppressionC *self,
 
     assert(magnitude_length == time_data_length / 2 + 1);
 
-    WebRtc_rdft(time_data_length, 1, time_data, self->ip, self->wfft);
+    WebRtcNs_Rdft(time_data_length, 1, time_data, self->ip, self->wfft);
 
     imag[0] = 0;
     real[0] = time_data[0];
@@ -1737,7 +2273,41 @@ static void FFT(NoiseSuppressionC *self,
     real[magnitude_length - 1] = time_data[1];
     magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
     float *time_data_ptr = time_data + 2;
-    if (prev_calc == 1)
+    if (self->fastMath)
+    {
+        // Same as below, with the square roots and logarithms of all bins
+        // computed in one pass.
+        for (i = 1; i < magnitude_length - 1; ++i)
+        {
+            real[i] = time_data_ptr[0];
+            imag[i] = time_data_ptr[1];
+            magn[i] = real[i] * real[i] + imag[i] * imag[i];
+            time_data_ptr += 2;
+        }
+        if (prev_calc == 1)
+        {
+            *signalEnergy = real[0] * real[0] + real[magnitude_length - 1] * real[magnitude_length - 1];
+            for (i = 1; i < magnitude_length - 1; ++i)
+            {
+                *signalEnergy += magn[i];
+            }
+        }
+        WebRtcNs_SqrtVector(&magn[1], &magn[1], magnitude_length - 2);
+        for (i = 1; i < magnitude_length - 1; ++i)
+        {
+            magn[i] += 1.f;
+        }
+        if (prev_calc == 1)
+        {
+            *sumMagn = magn[0] + magn[magnitude_length - 1];
+            for (i = 1; i < magnitude_length - 1; ++i)
+            {
+                *sumMagn += magn[i];
+            }
+            WebRtcNs_LogVector(magn, lmagn, magnitude_length);
+        }
+    }
+    else if (prev_calc == 1)
     {
         float first = real[0] * real[0] + imag[0] * imag[0];
         float last = real[magnitude_length - 1] * real[magnitude_length - 1] +
@@ -1802,7 +2372,7 @@ static void IFFT(NoiseSuppressionC *self,
         time_data_ptr[1] = imag[i];
         time_data_ptr += 2;
     }
-    WebRtc_rdft(time_data_length, -1, time_data, self->ip, self->wfft);
+    WebRtcNs_Rdft(time_data_length, -1, time_data, self->ip, self->wfft);
     float norm = 2.f / time_data_length;
     for (i = 0; i < time_data_length; ++i)
     {
@@ -1843,26 +2413,6 @@ static float Energy(const float *buffer, size_t length)
     return energy;
 }
 
-// Windows a buffer.
-// Inputs:
-//   * |window| is the window by which to multiply.
-//   * |data| is the data without windowing.
-//   * |length| is the length of the window and data.
-// Output:
-//   * |data_windowed| is the windowed data.
-static void Windowing(const float *window,
-                      const float *data,
-                      size_t length,
-                      float *data_windowed)
-{
-    size_t i;
-
-    for (i = 0; i < length; ++i)
-    {
-        data_windowed[i] = window[i] * data[i];
-    }
-}
-
 // Estimate prior SNR decision-directed and compute DD based Wiener Filter.
 // Input:
 //   * |magn| is the signal magnitude spectrum estimate.
@@ -1937,21 +2487,68 @@ int WebRtcNs_set_policy_core(NoiseSuppressionC *self, int mode)
     return 0;
 }
 
-void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
+int WebRtcNs_set_fast_math_core(NoiseSuppressionC *self, int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        return -1;
+    }
+    self->fastMath = enable;
+    return 0;
+}
+
+// Windowed spectrum of an analysis block. It only depends on the input, so
+// WebRtcNs_AnalyzeProcessCore() hands it from the analysis to the processing
+// and WebRtcNs_ProcessBatchCore() computes it ahead for several frames.
+typedef struct
+{
+    float energy;  // Energy of the windowed block, the rest is unset if 0.
+    float signalEnergy;
+    float sumMagn;
+    float real[ANAL_BLOCKL_MAX];
+    float imag[HALF_ANAL_BLOCKL];
+    float magn[HALF_ANAL_BLOCKL];
+    float lmagn[HALF_ANAL_BLOCKL];
+} NsSpectrum;
+
+// Windows and transforms the analysis block in |buffer|.
+static void ComputeSpectrum(NoiseSuppressionC *self, const float *buffer, NsSpectrum *spectrum)
+{
+    float winData[ANAL_BLOCKL_MAX];
+
+    spectrum->energy = WindowingEnergy(self->window, buffer, self->anaLen, winData);
+    if (spectrum->energy == 0.0)
+    {
+        return;
+    }
+    spectrum->signalEnergy = 0.f;
+    spectrum->sumMagn = 0.f;
+    FFT(self, winData, self->anaLen, self->magnLen, spectrum->real, spectrum->imag,
+        spectrum->magn, spectrum->lmagn, 1, &spectrum->signalEnergy, &spectrum->sumMagn);
+}
+
+// Windows and transforms the processing block, without the quantities only
+// the analysis needs.
+static void ComputeProcessSpectrum(NoiseSuppressionC *self, NsSpectrum *spectrum)
+{
+    float winData[ANAL_BLOCKL_MAX];
+
+    spectrum->energy = WindowingEnergy(self->window, self->dataBuf, self->anaLen, winData);
+    if (spectrum->energy == 0.0)
+    {
+        return;
+    }
+    FFT(self, winData, self->anaLen, self->magnLen, spectrum->real, spectrum->imag,
+        spectrum->magn, NULL, 0, NULL, NULL);
+}
+
+void WebRtcNs_UpdateStartupNoise(NoiseSuppressionC *self, const float *lmagn, float sumMagn,
+                                 float *noise)
 {
     size_t i;
     const size_t kStartBand = 5;  // Skip first frequency bins during estimation.
-    int updateParsFlag;
-    float energy;
-    float signalEnergy = 0.f;
-    float sumMagn = 0.f;
+    const float norm = 1.0f / (self->blockInd + 1);
     float tmpFloat1, tmpFloat2, tmpFloat3;
-    float winData[ANAL_BLOCKL_MAX];
-    float lmagn[HALF_ANAL_BLOCKL];
-    float magn[HALF_ANAL_BLOCKL], noise[HALF_ANAL_BLOCKL];
-    float snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL], logSnrLocPrior[HALF_ANAL_BLOCKL];
-    float real[ANAL_BLOCKL_MAX], imag[HALF_ANAL_BLOCKL];
-    // Variables during startup.
     float sum_log_i = 0.0;
     float sum_log_i_square = 0.0;
     float sum_log_magn = 0.0;
@@ -1959,21 +2556,100 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
     float parametric_exp = 0.0;
     float parametric_num = 0.0;
 
-    // Check that initiation has been done.
-    assert(1 == self->initFlag);
-    updateParsFlag = self->modelUpdatePars[0];
-
-    // Update analysis buffer for L band.
-    UpdateBuffer(speechFrame, self->blockLen, self->anaLen, self->analyzeBuf);
-    energy = WindowingEnergy(self->window, self->analyzeBuf, self->anaLen, winData);
-    if (energy == 0.0)
+    for (i = kStartBand; i < self->magnLen; i++)
     {
-        // We want to avoid updating statistics in this case:
-        // Updating feature statistics when we have zeros only will cause
-        // thresholds to move towards zero signal situations. This in turn has the
-        // effect that once the signal is "turned on" (non-zero values) everything
-        // will be treated as speech and there is no noise suppression effect.
-        // Depending on the duration of the inactive signal it takes a
+        sum_log_i += logLut[i];
+        sum_log_i_square += logLutSqr[i];
+        sum_log_magn += lmagn[i];
+        sum_log_i_log_magn += logLut[i] * lmagn[i];
+    }
+    // Estimate White noise.
+    self->whiteNoiseLevel += sumMagn * self->normMagnLen * self->overdrive;
+    // Estimate Pink noise parameters.
+    tmpFloat1 = sum_log_i_square * (self->magnLen - kStartBand);
+    tmpFloat1 -= (sum_log_i * sum_log_i);
+    tmpFloat2 = (sum_log_i_square * sum_log_magn - sum_log_i * sum_log_i_log_magn);
+    tmpFloat3 = tmpFloat2 / tmpFloat1;
+    // Constrain the estimated spectrum to be positive.
+    if (tmpFloat3 < 0.f)
+    {
+        tmpFloat3 = 0.f;
+    }
+    self->pinkNoiseNumerator += tmpFloat3;
+    tmpFloat2 = (sum_log_i * sum_log_magn);
+    tmpFloat2 -= (self->magnLen - kStartBand) * sum_log_i_log_magn;
+    tmpFloat3 = tmpFloat2 / tmpFloat1;
+    // Constrain the pink noise power to be in the interval [0, 1].
+    if (tmpFloat3 < 0.f)
+    {
+        tmpFloat3 = 0.f;
+    }
+    if (tmpFloat3 > 1.f)
+    {
+        tmpFloat3 = 1.f;
+    }
+    self->pinkNoiseExp += tmpFloat3;
+    if (self->pinkNoiseExp == 0.f)
+    {
+        for (i = 0; i < self->magnLen; i++)
+        {
+            // Estimate the background noise using the white and pink noise
+            // parameters.
+            self->parametricNoise[i] = self->whiteNoiseLevel;
+            // Weight quantile noise with modeled noise.
+            noise[i] *= (self->blockInd);
+            tmpFloat2 = self->parametricNoise[i] * (END_STARTUP_SHORT - self->blockInd);
+            noise[i] += tmpFloat2 * norm;
+            noise[i] /= END_STARTUP_SHORT;
+        }
+    }
+    else
+    {
+        // Calculate frequency independent parts of parametric noise estimate.
+
+        // Use pink noise estimate.
+        parametric_num = expf(self->pinkNoiseNumerator * norm);
+        parametric_num *= (float) (self->blockInd + 1);
+        parametric_exp = self->pinkNoiseExp * norm;
+        for (i = 0; i < self->magnLen; i++)
+        {
+            // Estimate the background noise using the white and pink noise
+            // parameters.
+            // Use pink noise estimate.
+            float use_band = (float) (i < kStartBand ? kStartBand : i);
+            self->parametricNoise[i] = parametric_num / powf(use_band, parametric_exp);
+            // Weight quantile noise with modeled noise.
+            noise[i] *= (self->blockInd);
+            tmpFloat2 = self->parametricNoise[i] * (END_STARTUP_SHORT - self->blockInd);
+            noise[i] += tmpFloat2 * norm;
+            noise[i] /= END_STARTUP_SHORT;
+        }
+    }
+}
+
+// Updates the noise estimate with the spectrum of the analysis block.
+static void Analyze(NoiseSuppressionC *self, const NsSpectrum *spectrum)
+{
+    int updateParsFlag;
+    float signalEnergy = spectrum->signalEnergy;
+    const float sumMagn = spectrum->sumMagn;
+    float noise[HALF_ANAL_BLOCKL];
+    float snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL], logSnrLocPrior[HALF_ANAL_BLOCKL];
+    const float *magn = spectrum->magn;
+    const float *lmagn = spectrum->lmagn;
+
+    // Check that initiation has been done.
+    assert(1 == self->initFlag);
+    updateParsFlag = self->modelUpdatePars[0];
+
+    if (spectrum->energy == 0.0)
+    {
+        // We want to avoid updating statistics in this case:
+        // Updating feature statistics when we have zeros only will cause
+        // thresholds to move towards zero signal situations. This in turn has the
+        // effect that once the signal is "turned on" (non-zero values) everything
+        // will be treated as speech and there is no noise suppression effect.
+        // Depending on the duration of the inactive signal it takes a
         // considerable amount of time for the system to learn what is noise and
         // what is speech.
         return;
@@ -1981,17 +2657,6 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
 
     self->blockInd++;  // Update the block index only when we process a block.
 
-    FFT(self, winData, self->anaLen, self->magnLen, real, imag, magn, lmagn, 1, &signalEnergy, &sumMagn);
-    if (self->blockInd < END_STARTUP_SHORT)
-    {
-        for (i = kStartBand; i < self->magnLen; i++)
-        {
-            sum_log_i += self->log_lut[i];
-            sum_log_i_square += self->log_lut_sqr[i];
-            sum_log_magn += lmagn[i];
-            sum_log_i_log_magn += self->log_lut[i] * lmagn[i];
-        }
-    }
     signalEnergy *= self->normMagnLen;
     self->signalEnergy = signalEnergy;
     self->sumMagn = sumMagn;
@@ -2002,68 +2667,7 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
     // Compute simplified noise model during startup.
     if (self->blockInd < END_STARTUP_SHORT)
     {
-        // Estimate White noise.
-        self->whiteNoiseLevel += sumMagn * self->normMagnLen * self->overdrive;
-        // Estimate Pink noise parameters.
-        tmpFloat1 = sum_log_i_square * (self->magnLen - kStartBand);
-        tmpFloat1 -= (sum_log_i * sum_log_i);
-        tmpFloat2 = (sum_log_i_square * sum_log_magn - sum_log_i * sum_log_i_log_magn);
-        tmpFloat3 = tmpFloat2 / tmpFloat1;
-        // Constrain the estimated spectrum to be positive.
-        if (tmpFloat3 < 0.f)
-        {
-            tmpFloat3 = 0.f;
-        }
-        self->pinkNoiseNumerator += tmpFloat3;
-        tmpFloat2 = (sum_log_i * sum_log_magn);
-        tmpFloat2 -= (self->magnLen - kStartBand) * sum_log_i_log_magn;
-        tmpFloat3 = tmpFloat2 / tmpFloat1;
-        // Constrain the pink noise power to be in the interval [0, 1].
-        if (tmpFloat3 < 0.f)
-        {
-            tmpFloat3 = 0.f;
-        }
-        if (tmpFloat3 > 1.f)
-        {
-            tmpFloat3 = 1.f;
-        }
-        self->pinkNoiseExp += tmpFloat3;
-        if (self->pinkNoiseExp == 0.f)
-        {
-            for (i = 0; i < self->magnLen; i++)
-            {
-                // Estimate the background noise using the white and pink noise
-                // parameters.
-                self->parametricNoise[i] = self->whiteNoiseLevel;
-                // Weight quantile noise with modeled noise.
-                noise[i] *= (self->blockInd);
-                tmpFloat2 = self->parametricNoise[i] * (END_STARTUP_SHORT - self->blockInd);
-                noise[i] += tmpFloat2 * norm;
-                noise[i] /= END_STARTUP_SHORT;
-            }
-        }
-        else
-        {
-            // Calculate frequency independent parts of parametric noise estimate.
-
-            // Use pink noise estimate.
-            parametric_num = expf(self->pinkNoiseNumerator * norm);
-            parametric_num *= (float) (self->blockInd + 1);
-            parametric_exp = self->pinkNoiseExp * norm;
-            for (i = 0; i < self->magnLen; i++)
-            {
-                // Estimate the background noise using the white and pink noise
-                // parameters.
-                // Use pink noise estimate.
-                float use_band = (float) (i < kStartBand ? kStartBand : i);
-                self->parametricNoise[i] = parametric_num / powf(use_band, parametric_exp);
-                // Weight quantile noise with modeled noise.
-                noise[i] *= (self->blockInd);
-                tmpFloat2 = self->parametricNoise[i] * (END_STARTUP_SHORT - self->blockInd);
-                noise[i] += tmpFloat2 * norm;
-                noise[i] /= END_STARTUP_SHORT;
-            }
-        }
+        WebRtcNs_UpdateStartupNoise(self, lmagn, sumMagn, noise);
     }
     // Compute average signal during END_STARTUP_LONG time:
     // used to normalize spectral difference measure.
@@ -2086,21 +2690,36 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
     memcpy(self->magnPrevAnalyze, magn, sizeof(*magn) * self->magnLen);
 }
 
-void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
-                          const int16_t *const *speechFrame,
-                          size_t num_bands,
-                          int16_t *const *outFrame)
+void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame)
+{
+    NsSpectrum spectrum;
+
+    // Update analysis buffer for L band.
+    UpdateBuffer(speechFrame, self->blockLen, self->anaLen, self->analyzeBuf);
+    ComputeSpectrum(self, self->analyzeBuf, &spectrum);
+    Analyze(self, &spectrum);
+}
+
+// Noise suppression of one frame with the spectrum of its processing block.
+// The caller updates the L band processing buffer. The L band output is
+// written to |fout| before it is limited to 16 bits.
+static void Process(NoiseSuppressionC *self,
+                    NsSpectrum *spectrum,
+                    const int16_t *const *speechFrameHB,
+                    size_t num_high_bands,
+                    float *fout,
+                    int16_t *const *outFrameHB)
 {
     // Main routine for noise reduction.
     int flagHB = 0;
     size_t i, j;
 
     float energy1, energy2, gain, factor, factor1, factor2;
-    float fout[BLOCKL_MAX];
     float winData[ANAL_BLOCKL_MAX];
-    float magn[HALF_ANAL_BLOCKL];
     float theFilter[HALF_ANAL_BLOCKL], theFilterTmp[HALF_ANAL_BLOCKL];
-    float real[ANAL_BLOCKL_MAX], imag[HALF_ANAL_BLOCKL];
+    float *real = spectrum->real;
+    float *imag = spectrum->imag;
+    const float *magn = spectrum->magn;
 
     // SWB variables.
     int deltaBweHB = 1;
@@ -2112,27 +2731,15 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
 
     // Check that initiation has been done.
     assert(1 == self->initFlag);
-    assert(num_bands - 1 <= NUM_HIGH_BANDS_MAX);
+    assert(num_high_bands <= NUM_HIGH_BANDS_MAX);
+    assert(num_high_bands == 0 || self->dataBufHB != NULL);
 
-    const int16_t *const *speechFrameHB = NULL;
-    int16_t *const *outFrameHB = NULL;
-    size_t num_high_bands = 0;
-    if (num_bands > 1)
+    if (num_high_bands > 0)
     {
-        speechFrameHB = &speechFrame[1];
-        outFrameHB = &outFrame[1];
-        num_high_bands = num_bands - 1;
         flagHB = 1;
         // Range for averaging low band quantities for H band gain.
         deltaBweHB = (int) self->magnLen / 4;
         deltaGainHB = deltaBweHB;
-    }
-
-    // Update analysis buffer for L band.
-    UpdateBuffer(speechFrame[0], self->blockLen, self->anaLen, self->dataBuf);
-
-    if (flagHB == 1)
-    {
         // Update analysis buffer for H bands.
         for (i = 0; i < num_high_bands; ++i)
         {
@@ -2142,7 +2749,7 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
                          self->dataBufHB[i]);
         }
     }
-    energy1 = WindowingEnergy(self->window, self->dataBuf, self->anaLen, winData);
+    energy1 = spectrum->energy;
     if (energy1 == 0.0)
     {
         // Synthesize the special case of zero input.
@@ -2154,10 +2761,6 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
         // Update synthesis buffer.
         UpdateBuffer(NULL, self->blockLen, self->anaLen, self->syntBuf);
 
-        for (i = 0; i < self->blockLen; ++i)
-            outFrame[0][i] =
-                    SPL_SAT(32767, fout[i], (-32768));
-
         // For time-domain gain of HB.
         if (flagHB == 1)
         {
@@ -2175,8 +2778,6 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
         return;
     }
 
-    FFT(self, winData, self->anaLen, self->magnLen, real, imag, magn, NULL, 0, NULL, NULL);
-
     if (self->blockInd < END_STARTUP_SHORT)
     {
         for (i = 0; i < self->magnLen; i++)
@@ -2288,10 +2889,6 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
     // Update synthesis buffer.
     UpdateBuffer(NULL, self->blockLen, self->anaLen, self->syntBuf);
 
-    for (i = 0; i < self->blockLen; ++i)
-        outFrame[0][i] =
-                SPL_SAT(32767, fout[i], (-32768));
-
     // For time-domain gain of HB.
     if (flagHB == 1)
     {
@@ -2324,7 +2921,7 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
         avgFilterGainHB = avgFilterGainHB / ((float) (deltaGainHB));
         avgProbSpeechHBTmp = 2.f * avgProbSpeechHB - 1.f;
         // Gain based on speech probability.
-        gainModHB = 0.5f + 0.5f * tanhf(gainMapParHB * avgProbSpeechHBTmp);
+        gainModHB = 0.5f + 0.5f * Tanh(self, gainMapParHB * avgProbSpeechHBTmp);
         // Combine gain with low band gain.
         float gainTimeDomainHB = 0.5f * (gainModHB + avgFilterGainHB);
         if (avgProbSpeechHB >= 0.5f)
@@ -2357,12 +2954,334 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
     }  // End of H band gain computation.
 }
 
+// Limits the L band output to 16 bits.
+static void SaturateFrame(const float *fout, size_t length, int16_t *outFrame)
+{
+    size_t i;
+
+    for (i = 0; i < length; ++i)
+        outFrame[i] = SPL_SAT(32767, fout[i], (-32768));
+}
+
+// Returns 0 if |self| can process |num_bands| bands. The upper bands need the
+// buffers WebRtcNs_InitCore() only allocates at 32 and 48 kHz.
+static int CheckBands(const NoiseSuppressionC *self, size_t num_bands)
+{
+    if (self->initFlag != 1 || num_bands == 0 || num_bands - 1 > NUM_HIGH_BANDS_MAX)
+    {
+        return -1;
+    }
+    if (num_bands > 1 && self->dataBufHB == NULL)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int WebRtcNs_ProcessCore(NoiseSuppressionC *self,
+                         const int16_t *const *speechFrame,
+                         size_t num_bands,
+                         int16_t *const *outFrame)
+{
+    NsSpectrum spectrum;
+    float fout[BLOCKL_MAX];
+
+    if (CheckBands(self, num_bands) != 0)
+    {
+        return -1;
+    }
+
+    // Update analysis buffer for L band.
+    UpdateBuffer(speechFrame[0], self->blockLen, self->anaLen, self->dataBuf);
+    ComputeProcessSpectrum(self, &spectrum);
+    Process(self, &spectrum, &speechFrame[1], num_bands - 1, fout, &outFrame[1]);
+    SaturateFrame(fout, self->blockLen, outFrame[0]);
+    return 0;
+}
+
+int WebRtcNs_AnalyzeProcessCore(NoiseSuppressionC *self,
+                                const int16_t *const *speechFrame,
+                                size_t num_bands,
+                                int16_t *const *outFrame)
+{
+    NsSpectrum spectrum;
+    float fout[BLOCKL_MAX];
+    int sameBuffers;
+
+    if (CheckBands(self, num_bands) != 0)
+    {
+        return -1;
+    }
+
+    // The buffers differ after separate WebRtcNs_AnalyzeCore() and
+    // WebRtcNs_ProcessCore() calls on different input.
+    sameBuffers = memcmp(self->dataBuf, self->analyzeBuf, sizeof(float) * self->anaLen) == 0;
+    UpdateBuffer(speechFrame[0], self->blockLen, self->anaLen, self->analyzeBuf);
+    ComputeSpectrum(self, self->analyzeBuf, &spectrum);
+    Analyze(self, &spectrum);
+    if (sameBuffers)
+    {
+        memcpy(self->dataBuf, self->analyzeBuf, sizeof(float) * self->anaLen);
+    }
+    else
+    {
+        UpdateBuffer(speechFrame[0], self->blockLen, self->anaLen, self->dataBuf);
+        ComputeProcessSpectrum(self, &spectrum);
+    }
+    Process(self, &spectrum, &speechFrame[1], num_bands - 1, fout, &outFrame[1]);
+    SaturateFrame(fout, self->blockLen, outFrame[0]);
+    return 0;
+}
+
+// Frames WebRtcNs_ProcessBatchCore() transforms ahead of the noise estimation,
+// few enough to keep the scratch arena in the L1 cache.
+#define BATCH_FRAMES 4
+
+// Scratch arena of the batch processing. The analysis block of frame |f|
+// starts at samples[f * blockLen], so no buffer is shifted per frame.
+typedef struct
+{
+    float samples[ANAL_BLOCKL_MAX + (BATCH_FRAMES - 1) * BLOCKL_MAX];
+    float out[BATCH_FRAMES * BLOCKL_MAX];
+    NsSpectrum spectra[BATCH_FRAMES];
+} NsBatchScratch;
+
+// L band samples of consecutive frames, sample k at index k * stride. Either
+// the 16-bit or the float pointer of the input and of the output is set, float
+// samples are in the 16-bit range.
+typedef struct
+{
+    const int16_t *in;
+    const float *inFloat;
+    int16_t *out;
+    float *outFloat;
+    size_t stride;
+} NsFrames;
+
+// Reads |length| samples from sample |offset| on.
+static void ReadFrames(const NsFrames *frames, size_t offset, size_t length, float *samples)
+{
+    const size_t stride = frames->stride;
+    size_t i;
+
+    if (frames->in != NULL)
+    {
+        const int16_t *in = &frames->in[offset * stride];
+        for (i = 0; i < length; i++)
+        {
+            samples[i] = in[i * stride];
+        }
+    }
+    else
+    {
+        const float *in = &frames->inFloat[offset * stride];
+        for (i = 0; i < length; i++)
+        {
+            samples[i] = in[i * stride];
+        }
+    }
+}
+
+// Writes |length| samples from sample |offset| on, limited to 16 bits.
+static void WriteFrames(const NsFrames *frames, size_t offset, const float *samples, size_t length)
+{
+    const size_t stride = frames->stride;
+    size_t i;
+
+    if (frames->out != NULL)
+    {
+        int16_t *out = &frames->out[offset * stride];
+        for (i = 0; i < length; i++)
+        {
+            out[i * stride] = SPL_SAT(32767, samples[i], (-32768));
+        }
+    }
+    else
+    {
+        float *out = &frames->outFloat[offset * stride];
+        for (i = 0; i < length; i++)
+        {
+            out[i * stride] = SPL_SAT(32767.f, samples[i], -32768.f);
+        }
+    }
+}
+
+// Same as WebRtcNs_AnalyzeProcessCore() on |num_frames| consecutive frames
+// whose L band is read from and written to |frames|.
+static void ProcessFrames(NoiseSuppressionC *self,
+                          const NsFrames *frames,
+                          const int16_t *const *inFramesHB,
+                          size_t num_high_bands,
+                          size_t num_frames,
+                          int16_t *const *outFramesHB)
+{
+    NsBatchScratch scratch;
+    const size_t history = self->anaLen - self->blockLen;
+    const int16_t *in[NUM_HIGH_BANDS_MAX];
+    int16_t *out[NUM_HIGH_BANDS_MAX];
+    size_t first = 0, count, f, b;
+
+    assert(1 == self->initFlag);
+    assert(num_high_bands <= NUM_HIGH_BANDS_MAX);
+
+    // Align the analysis and processing buffers.
+    while (first < num_frames &&
+           memcmp(self->dataBuf, self->analyzeBuf, sizeof(float) * self->anaLen) != 0)
+    {
+        for (b = 0; b < num_high_bands; b++)
+        {
+            in[b] = &inFramesHB[b][first * self->blockLen];
+            out[b] = &outFramesHB[b][first * self->blockLen];
+        }
+        ReadFrames(frames, first * self->blockLen, self->blockLen, scratch.samples);
+        UpdateBufferFloat(scratch.samples, self->blockLen, self->anaLen, self->analyzeBuf);
+        ComputeSpectrum(self, self->analyzeBuf, &scratch.spectra[0]);
+        Analyze(self, &scratch.spectra[0]);
+        UpdateBufferFloat(scratch.samples, self->blockLen, self->anaLen, self->dataBuf);
+        ComputeProcessSpectrum(self, &scratch.spectra[0]);
+        Process(self, &scratch.spectra[0], in, num_high_bands, scratch.out, out);
+        WriteFrames(frames, first * self->blockLen, scratch.out, self->blockLen);
+        first++;
+    }
+
+    for (; first < num_frames; first += count)
+    {
+        count = num_frames - first < BATCH_FRAMES ? num_frames - first : BATCH_FRAMES;
+
+        // The analysis blocks only depend on the input, transform them back
+        // to back.
+        memcpy(scratch.samples, &self->analyzeBuf[self->blockLen], sizeof(float) * history);
+        ReadFrames(frames, first * self->blockLen, count * self->blockLen,
+                   &scratch.samples[history]);
+        for (f = 0; f < count; f++)
+        {
+            ComputeSpectrum(self, &scratch.samples[f * self->blockLen], &scratch.spectra[f]);
+        }
+
+        // The noise estimation and the suppression depend on the previous
+        // frame and run in order.
+        for (f = 0; f < count; f++)
+        {
+            for (b = 0; b < num_high_bands; b++)
+            {
+                in[b] = &inFramesHB[b][(first + f) * self->blockLen];
+                out[b] = &outFramesHB[b][(first + f) * self->blockLen];
+            }
+            Analyze(self, &scratch.spectra[f]);
+            Process(self, &scratch.spectra[f], in, num_high_bands,
+                    &scratch.out[f * self->blockLen], out);
+        }
+        WriteFrames(frames, first * self->blockLen, scratch.out, count * self->blockLen);
+
+        memcpy(self->analyzeBuf, &scratch.samples[(count - 1) * self->blockLen],
+               sizeof(float) * self->anaLen);
+        memcpy(self->dataBuf, self->analyzeBuf, sizeof(float) * self->anaLen);
+    }
+}
+
+int WebRtcNs_ProcessBatchCore(NoiseSuppressionC *self,
+                              const int16_t *const *inFrames,
+                              size_t num_bands,
+                              size_t num_frames,
+                              int16_t *const *outFrames)
+{
+    NsFrames frames = {inFrames[0], NULL, outFrames[0], NULL, 1};
+
+    if (CheckBands(self, num_bands) != 0)
+    {
+        return -1;
+    }
+    ProcessFrames(self, &frames, &inFrames[1], num_bands - 1, num_frames, &outFrames[1]);
+    return 0;
+}
+
+// Runs the channels chunk by chunk, so the interleaved samples of a chunk are
+// still cached when the next channel reads them.
+static void ProcessInterleaved(NoiseSuppressionC *const *self,
+                               size_t num_channels,
+                               const NsFrames *frames,
+                               size_t num_frames)
+{
+    size_t first, count, c, offset;
+
+    for (first = 0; first < num_frames; first += count)
+    {
+        count = num_frames - first < BATCH_FRAMES ? num_frames - first : BATCH_FRAMES;
+        for (c = 0; c < num_channels; c++)
+        {
+            NsFrames channel = *frames;
+            offset = first * self[0]->blockLen * frames->stride + c;
+            channel.in = channel.in ? channel.in + offset : NULL;
+            channel.inFloat = channel.inFloat ? channel.inFloat + offset : NULL;
+            channel.out = channel.out ? channel.out + offset : NULL;
+            channel.outFloat = channel.outFloat ? channel.outFloat + offset : NULL;
+            ProcessFrames(self[c], &channel, NULL, 0, count, NULL);
+        }
+    }
+}
+
+// Returns 0 if the instances can process |num_channels| interleaved channels:
+// all initialized for the L band alone, 8 or 16 kHz, at the same frequency.
+static int CheckInterleaved(NoiseSuppressionC *const *self,
+                            size_t num_channels,
+                            size_t stride)
+{
+    size_t c;
+
+    if (self == NULL || num_channels == 0 || stride < num_channels)
+    {
+        return -1;
+    }
+    for (c = 0; c < num_channels; c++)
+    {
+        if (self[c] == NULL || CheckBands(self[c], 1) != 0 || self[c]->fs > 16000 ||
+            self[c]->blockLen != self[0]->blockLen)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int WebRtcNs_ProcessInterleavedCore(NoiseSuppressionC *const *self,
+                                    size_t num_channels,
+                                    int16_t *buffer,
+                                    size_t stride,
+                                    size_t num_frames)
+{
+    NsFrames frames = {buffer, NULL, buffer, NULL, stride};
+
+    if (buffer == NULL || CheckInterleaved(self, num_channels, stride) != 0)
+    {
+        return -1;
+    }
+    ProcessInterleaved(self, num_channels, &frames, num_frames);
+    return 0;
+}
+
+int WebRtcNs_ProcessInterleavedFloatCore(NoiseSuppressionC *const *self,
+                                         size_t num_channels,
+                                         float *buffer,
+                                         size_t stride,
+                                         size_t num_frames)
+{
+    NsFrames frames = {NULL, buffer, NULL, buffer, stride};
+
+    if (buffer == NULL || CheckInterleaved(self, num_channels, stride) != 0)
+    {
+        return -1;
+    }
+    ProcessInterleaved(self, num_channels, &frames, num_frames);
+    return 0;
+}
+
 NsHandle *WebRtcNs_Create()
 {
     NoiseSuppressionC *self = (NoiseSuppressionC *) malloc(sizeof(NoiseSuppressionC));
     if (self != NULL)
     {
         self->initFlag = 0;
+        self->dataBufHB = NULL;
     }
     return (NsHandle *) self;
 }
@@ -2370,7 +3289,111 @@ NsHandle *WebRtcNs_Create()
 void WebRtcNs_Free(NsHandle *NS_inst)
 {
     if (NS_inst)
+    {
+        free(((NoiseSuppressionC *) NS_inst)->dataBufHB);
         free(NS_inst);
+    }
+}
+
+// initFlag of the slots on the free list. A free slot starts with the pointer
+// to the next free slot.
+#define NS_POOL_SLOT_FREE   (-1)
+#define NS_POOL_ALIGNMENT   64
+
+struct NsPoolT {
+    void *memory;
+    unsigned char *slots;  // First slot, cache line aligned.
+    size_t slotSize;
+    size_t capacity;
+    void *freeList;
+};
+
+NsPool *WebRtcNs_CreatePool(size_t capacity)
+{
+    NsPool *pool;
+    size_t i;
+
+    if (capacity == 0)
+    {
+        return NULL;
+    }
+    pool = (NsPool *) malloc(sizeof(NsPool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->slotSize = (sizeof(NoiseSuppressionC) + NS_POOL_ALIGNMENT - 1) &
+                     ~(size_t) (NS_POOL_ALIGNMENT - 1);
+    pool->capacity = capacity;
+    pool->memory = malloc(pool->slotSize * capacity + NS_POOL_ALIGNMENT - 1);
+    if (pool->memory == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+    pool->slots = (unsigned char *) (((uintptr_t) pool->memory + NS_POOL_ALIGNMENT - 1) &
+                                     ~(uintptr_t) (NS_POOL_ALIGNMENT - 1));
+    // Hand out the slots in address order.
+    pool->freeList = NULL;
+    for (i = capacity; i > 0; i--)
+    {
+        NoiseSuppressionC *slot = (NoiseSuppressionC *) (pool->slots + (i - 1) * pool->slotSize);
+        slot->initFlag = NS_POOL_SLOT_FREE;
+        *(void **) slot = pool->freeList;
+        pool->freeList = slot;
+    }
+    return pool;
+}
+
+void WebRtcNs_FreePool(NsPool *pool)
+{
+    size_t i;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < pool->capacity; i++)
+    {
+        NoiseSuppressionC *slot = (NoiseSuppressionC *) (pool->slots + i * pool->slotSize);
+        if (slot->initFlag != NS_POOL_SLOT_FREE)
+        {
+            free(slot->dataBufHB);
+        }
+    }
+    free(pool->memory);
+    free(pool);
+}
+
+NsHandle *WebRtcNs_CreateFromPool(NsPool *pool)
+{
+    NoiseSuppressionC *self;
+
+    if (pool == NULL || pool->freeList == NULL)
+    {
+        return NULL;
+    }
+    self = (NoiseSuppressionC *) pool->freeList;
+    pool->freeList = *(void **) self;
+    self->initFlag = 0;
+    self->dataBufHB = NULL;
+    return (NsHandle *) self;
+}
+
+void WebRtcNs_FreeToPool(NsPool *pool, NsHandle *NS_inst)
+{
+    NoiseSuppressionC *self = (NoiseSuppressionC *) NS_inst;
+
+    if (pool == NULL || self == NULL)
+    {
+        return;
+    }
+    assert((unsigned char *) self >= pool->slots &&
+           (unsigned char *) self < pool->slots + pool->capacity * pool->slotSize);
+    free(self->dataBufHB);
+    self->initFlag = NS_POOL_SLOT_FREE;
+    *(void **) self = pool->freeList;
+    pool->freeList = self;
 }
 
 int WebRtcNs_Init(NsHandle *NS_inst, uint32_t fs)
@@ -2383,18 +3406,62 @@ int WebRtcNs_set_policy(NsHandle *NS_inst, int mode)
     return WebRtcNs_set_policy_core((NoiseSuppressionC *) NS_inst, mode);
 }
 
+int WebRtcNs_set_fast_math(NsHandle *NS_inst, int enable)
+{
+    return WebRtcNs_set_fast_math_core((NoiseSuppressionC *) NS_inst, enable);
+}
+
 void WebRtcNs_Analyze(NsHandle *NS_inst, const int16_t *spframe)
 {
     WebRtcNs_AnalyzeCore((NoiseSuppressionC *) NS_inst, spframe);
 }
 
-void WebRtcNs_Process(NsHandle *NS_inst,
-                      const int16_t *const *spframe,
-                      size_t num_bands,
-                      int16_t *const *outframe)
+int WebRtcNs_Process(NsHandle *NS_inst,
+                     const int16_t *const *spframe,
+                     size_t num_bands,
+                     int16_t *const *outframe)
+{
+    return WebRtcNs_ProcessCore((NoiseSuppressionC *) NS_inst, spframe, num_bands,
+                                outframe);
+}
+
+int WebRtcNs_AnalyzeProcess(NsHandle *NS_inst,
+                            const int16_t *const *spframe,
+                            size_t num_bands,
+                            int16_t *const *outframe)
+{
+    return WebRtcNs_AnalyzeProcessCore((NoiseSuppressionC *) NS_inst, spframe, num_bands,
+                                       outframe);
+}
+
+int WebRtcNs_ProcessBatch(NsHandle *NS_inst,
+                          const int16_t *const *spframes,
+                          size_t num_bands,
+                          size_t num_frames,
+                          int16_t *const *outframes)
+{
+    return WebRtcNs_ProcessBatchCore((NoiseSuppressionC *) NS_inst, spframes, num_bands,
+                                     num_frames, outframes);
+}
+
+int WebRtcNs_ProcessInterleaved(NsHandle *const *NS_inst,
+                                size_t num_channels,
+                                int16_t *buffer,
+                                size_t stride,
+                                size_t num_frames)
+{
+    return WebRtcNs_ProcessInterleavedCore((NoiseSuppressionC *const *) NS_inst, num_channels,
+                                           buffer, stride, num_frames);
+}
+
+int WebRtcNs_ProcessInterleavedFloat(NsHandle *const *NS_inst,
+                                     size_t num_channels,
+                                     float *buffer,
+                                     size_t stride,
+                                     size_t num_frames)
 {
-    WebRtcNs_ProcessCore((NoiseSuppressionC *) NS_inst, spframe, num_bands,
-                         outframe);
+    return WebRtcNs_ProcessInterleavedFloatCore((NoiseSuppressionC *const *) NS_inst, num_channels,
+                                                buffer, stride, num_frames);
 }
 
 float WebRtcNs_prior_speech_probability(NsHandle *handle)
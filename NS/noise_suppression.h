@@ -13,6 +13,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define WEBRTC_ARCH_X86_FAMILY
+#endif
+
 #define BLOCKL_MAX          160 // max processing block length: 160
 #define ANAL_BLOCKL_MAX     256 // max analysis block length: 256
 #define HALF_ANAL_BLOCKL    129 // half max analysis block length + 1
@@ -44,6 +48,8 @@
 #define PROB_RANGE          (float)0.20 // probability threshold for noise state in
 // speech/noise likelihood
 #define HIST_PAR_EST         1000       // histogram size for estimation of parameters
+#define HIST_SPEC_FLAT_EST   32         // histogram size for spectral flatness, the geometric
+// over the arithmetic mean of the magnitudes, at most ~1 by the AM-GM inequality
 #define GAMMA_PAUSE         (float)0.05 // update for conservative noise estimate
 //
 #define B_LIM               (float)0.5  // threshold in final energy gain factor calculation
@@ -53,6 +59,7 @@
 
 
 typedef struct NsHandleT NsHandle;
+typedef struct NsPoolT NsPool;
 
 #ifdef __cplusplus
 extern "C" {
@@ -116,14 +123,13 @@ typedef struct NoiseSuppressionC_ {
     int updates;
     // Parameters for Wiener filter.
     float smooth[HALF_ANAL_BLOCKL];
-    float log_lut[HALF_ANAL_BLOCKL];
-    float log_lut_sqr[HALF_ANAL_BLOCKL];
     float overdrive;
     float denoiseBound;
     int gainmap;
-    // FFT work arrays.
-    size_t ip[IP_LENGTH];
-    float wfft[W_LENGTH];
+    // FFT work arrays of |anaLen|, shared by all instances and read only once
+    // initialized.
+    size_t *ip;
+    float *wfft;
 
     // Parameters for new method: some not needed, will reduce/cleanup later.
     int32_t blockInd;  // Frame index counter.
@@ -150,20 +156,121 @@ typedef struct NoiseSuppressionC_ {
     float parametricNoise[HALF_ANAL_BLOCKL];
     // Parameters for feature extraction.
     NSParaExtract featureExtractionParams;
-    // Histograms for parameter estimation.
-    int histLrt[HIST_PAR_EST];
-    int histSpecFlat[HIST_PAR_EST];
-    int histSpecDiff[HIST_PAR_EST];
+    // Histograms for parameter estimation, they count at most
+    // modelUpdatePars[1] frames.
+    uint16_t histLrt[HIST_PAR_EST];
+    uint16_t histSpecFlat[HIST_SPEC_FLAT_EST];
+    uint16_t histSpecDiff[HIST_PAR_EST];
     // Quantities for high band estimate.
     float speechProb[HALF_ANAL_BLOCKL];  // Final speech/noise prob: prior + LRT.
-    // Buffering data for HB.
-    float dataBufHB[NUM_HIGH_BANDS_MAX][ANAL_BLOCKL_MAX];
+    // Buffering data for HB, allocated by WebRtcNs_InitCore() above 16 kHz
+    // and NULL before.
+    float (*dataBufHB)[ANAL_BLOCKL_MAX];
+    // Use the approximations of ns_fast_math.h instead of libm.
+    int fastMath;
 
 } NoiseSuppressionC;
 
 // Refer to fft4g.c for documentation.
 void WebRtc_rdft(size_t n, int isgn, float *a, size_t *ip, float *w);
 
+// Same as WebRtc_rdft(), used for all NS transforms. The x86 versions compute
+// the 128 and 256 point transforms from the static tables below and leave
+// |ip| and |w| alone, other lengths go to WebRtc_rdft(). The version is
+// selected from the CPU features by WebRtcNs_InitCore().
+typedef void (*Rdft)(size_t n, int isgn, float *a, size_t *ip, float *w);
+extern Rdft WebRtcNs_Rdft;
+
+// Precomputed twiddle factors of the size specialized transforms, the same
+// float values WebRtc_rdft() computes for |n| = 128 and 256, so the results
+// are bit exact.
+typedef struct {
+    // Offset into the input of the complex value that goes to position |k|
+    // after the bit reversal.
+    uint8_t bitReverse[ANAL_BLOCKL_MAX / 2];
+    // The w table of WebRtc_rdft(), used by the middle radix-4 stages.
+    float w[ANAL_BLOCKL_MAX / 4];
+    // Factors of the first radix-4 stage, 4 per group of 8 complex values:
+    // [wr, wr] of the first and second half, the imaginary parts are stored
+    // as [-wi, wi].
+    float wk1r[ANAL_BLOCKL_MAX / 4];
+    float wk1i[ANAL_BLOCKL_MAX / 4];
+    float wk2r[ANAL_BLOCKL_MAX / 4];
+    float wk2i[ANAL_BLOCKL_MAX / 4];
+    float wk3r[ANAL_BLOCKL_MAX / 4];
+    float wk3i[ANAL_BLOCKL_MAX / 4];
+    // Factors of the real to complex split, per complex index.
+    float rftWkr[ANAL_BLOCKL_MAX / 4];
+    float rftWki[ANAL_BLOCKL_MAX / 4];
+} NsFftTables;
+
+extern const NsFftTables WebRtcNs_kFftTables128;
+extern const NsFftTables WebRtcNs_kFftTables256;
+
+// Updates the SIMULT log quantile estimates of the noise and their densities
+// with the log magnitude spectrum of one frame, the bin loop of the quantile
+// noise estimation. |lquantile| and |density| hold SIMULT rows of |magnLen|
+// bins, |counter| the frame counter of each estimate.
+//
+// The x86 versions handle all estimates in one pass over the bins, without
+// branches, and are bit exact with the C version. The division by the density
+// is kept exact: the sign of each update depends on the previous estimate, so
+// a reciprocal approximation off by one ulp lets the log quantiles drift apart
+// by up to 0.4 within an hour of noise, and vector division is not slower.
+typedef void (*UpdateQuantiles)(const float *lmagn,
+                                size_t magnLen,
+                                const int *counter,
+                                float *lquantile,
+                                float *density);
+extern UpdateQuantiles WebRtcNs_UpdateQuantiles;
+
+// The C version of WebRtcNs_UpdateQuantiles() for the bins from |first| on.
+// Used by the vector versions for the bins after the last full vector.
+void WebRtcNs_UpdateQuantileBins(const float *lmagn,
+                                 size_t magnLen,
+                                 const int *counter,
+                                 size_t first,
+                                 float *lquantile,
+                                 float *density);
+
+// Frame level steps of the analysis, also used by the stream-parallel engine
+// of ns_lockstep.c on the instance of each stream.
+
+// Adds the frame to the white and pink noise model of the startup phase and
+// mixes the modeled noise into the quantile estimate |noise|. Only called
+// while blockInd < END_STARTUP_SHORT.
+void WebRtcNs_UpdateStartupNoise(NoiseSuppressionC *self, const float *lmagn, float sumMagn,
+                                 float *noise);
+
+// Updates the feature histograms and, once every window, the thresholds and
+// weights of the prior model.
+void WebRtcNs_UpdateFeatureParameters(NoiseSuppressionC *self, int updateParsFlag);
+
+// Updates the prior speech probability from the features, with
+// |logLrtTimeAvgKsum| the sum of the smoothed log LR factors over the bins.
+// Returns the gain of the inverse LR factor in the final speech probability.
+float WebRtcNs_UpdatePriorSpeechProb(NoiseSuppressionC *self, float logLrtTimeAvgKsum);
+
+// The x86 versions are defined in noise_suppression_sse2.c and
+// noise_suppression_avx2.c.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcNs_RdftSSE2(size_t n, int isgn, float *a, size_t *ip, float *w);
+
+void WebRtcNs_RdftAVX2(size_t n, int isgn, float *a, size_t *ip, float *w);
+
+void WebRtcNs_UpdateQuantilesSSE2(const float *lmagn,
+                                  size_t magnLen,
+                                  const int *counter,
+                                  float *lquantile,
+                                  float *density);
+
+void WebRtcNs_UpdateQuantilesAVX2(const float *lmagn,
+                                  size_t magnLen,
+                                  const int *counter,
+                                  float *lquantile,
+                                  float *density);
+#endif
+
 /****************************************************************************
  * WebRtcNs_InitCore(...)
  *
@@ -198,6 +305,25 @@ int WebRtcNs_InitCore(NoiseSuppressionC *self, uint32_t fs);
  */
 int WebRtcNs_set_policy_core(NoiseSuppressionC *self, int mode);
 
+/****************************************************************************
+ * WebRtcNs_set_fast_math_core(...)
+ *
+ * This selects between libm and the faster approximations of ns_fast_math.h
+ * for the logarithms, exponentials, square roots and tanh of the per-bin
+ * loops. WebRtcNs_InitCore() selects libm.
+ *
+ * Input:
+ *      - self          : Instance that should be initialized
+ *      - enable        : 0: libm, 1: fast math
+ *
+ * Output:
+ *      - self          : Updated instance
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_set_fast_math_core(NoiseSuppressionC *self, int enable);
+
 /****************************************************************************
  * WebRtcNs_AnalyzeCore
  *
@@ -225,11 +351,114 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC *self, const int16_t *speechFrame);
  * Output:
  *      - self          : Updated instance
  *      - outFrame      : Output speech frame for each band
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessCore(NoiseSuppressionC *self,
+                         const int16_t *const *inFrame,
+                         size_t num_bands,
+                         int16_t *const *outFrame);
+
+/****************************************************************************
+ * WebRtcNs_AnalyzeProcessCore
+ *
+ * Same as WebRtcNs_AnalyzeCore() on the lower band followed by
+ * WebRtcNs_ProcessCore(), with bit exact results. The windowed spectrum of
+ * the lower band is computed once when the analysis and processing buffers
+ * hold the same samples, which they do when every frame goes through here.
+ *
+ * Input:
+ *      - self          : Instance that should be initialized
+ *      - inFrame       : Input speech frame for each band
+ *      - num_bands     : Number of bands
+ *
+ * Output:
+ *      - self          : Updated instance
+ *      - outFrame      : Output speech frame for each band
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
  */
-void WebRtcNs_ProcessCore(NoiseSuppressionC *self,
-                          const int16_t *const *inFrame,
-                          size_t num_bands,
-                          int16_t *const *outFrame);
+int WebRtcNs_AnalyzeProcessCore(NoiseSuppressionC *self,
+                                const int16_t *const *inFrame,
+                                size_t num_bands,
+                                int16_t *const *outFrame);
+
+/****************************************************************************
+ * WebRtcNs_ProcessBatchCore
+ *
+ * Same as WebRtcNs_AnalyzeProcessCore() on |num_frames| consecutive frames,
+ * with bit exact results. The spectra of the analysis blocks, which only
+ * depend on the input, are computed a few frames ahead of the noise
+ * estimation and the suppression.
+ *
+ * Input:
+ *      - self          : Instance that should be initialized
+ *      - inFrames      : Input speech for each band, |num_frames| frames of
+ *                        blockLen samples back to back
+ *      - num_bands     : Number of bands
+ *      - num_frames    : Number of frames
+ *
+ * Output:
+ *      - self          : Updated instance
+ *      - outFrames     : Output speech for each band, may be |inFrames|
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessBatchCore(NoiseSuppressionC *self,
+                              const int16_t *const *inFrames,
+                              size_t num_bands,
+                              size_t num_frames,
+                              int16_t *const *outFrames);
+
+/****************************************************************************
+ * WebRtcNs_ProcessInterleavedCore
+ *
+ * Same as WebRtcNs_ProcessBatchCore() on the lower band of each of
+ * |num_channels| interleaved channels, in place. The samples of a channel are
+ * read straight from the interleaved buffer a few frames at a time, without a
+ * planar copy of the whole signal.
+ *
+ * Input:
+ *      - self          : Instances that should be initialized, one per
+ *                        channel, all at the same sampling frequency of 8 or
+ *                        16 kHz
+ *      - num_channels  : Number of channels
+ *      - buffer        : Input speech, sample k of channel c at
+ *                        buffer[k * stride + c]
+ *      - stride        : Distance between two samples of a channel, at least
+ *                        |num_channels|
+ *      - num_frames    : Number of frames
+ *
+ * Output:
+ *      - self          : Updated instances
+ *      - buffer        : Output speech
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessInterleavedCore(NoiseSuppressionC *const *self,
+                                    size_t num_channels,
+                                    int16_t *buffer,
+                                    size_t stride,
+                                    size_t num_frames);
+
+/****************************************************************************
+ * WebRtcNs_ProcessInterleavedFloatCore
+ *
+ * Same as WebRtcNs_ProcessInterleavedCore() on float samples in the 16-bit
+ * range. The output is limited to the same range but not rounded.
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessInterleavedFloatCore(NoiseSuppressionC *const *self,
+                                         size_t num_channels,
+                                         float *buffer,
+                                         size_t stride,
+                                         size_t num_frames);
 
 /*
  * This function creates an instance of the floating point Noise Suppression.
@@ -245,13 +474,59 @@ NsHandle *WebRtcNs_Create();
  */
 void WebRtcNs_Free(NsHandle *NS_inst);
 
+/*
+ * This function creates a pool of noise suppression instances in one cache
+ * line aligned block of memory, for servers running many sessions. Only the
+ * high band buffers of instances initialized to 32 or 48 kHz are allocated
+ * separately. The pool functions are not thread safe.
+ *
+ * Input:
+ *      - capacity      : Number of instances
+ *
+ * Return value         : Pointer to the new pool
+ *                        NULL - Error
+ */
+NsPool *WebRtcNs_CreatePool(size_t capacity);
+
+/*
+ * This function frees the pool and all of its instances.
+ *
+ * Input:
+ *      - pool          : Pointer to the pool that should be freed
+ */
+void WebRtcNs_FreePool(NsPool *pool);
+
+/*
+ * This function takes an instance from the pool, the instance is used like
+ * one of WebRtcNs_Create().
+ *
+ * Input:
+ *      - pool          : Pool to take the instance from
+ *
+ * Return value         : Pointer to the instance
+ *                        NULL - The pool is exhausted
+ */
+NsHandle *WebRtcNs_CreateFromPool(NsPool *pool);
+
+/*
+ * This function returns an instance of WebRtcNs_CreateFromPool() to its pool.
+ *
+ * Input:
+ *      - pool          : Pool the instance was taken from
+ *      - NS_inst       : Instance that should be returned
+ */
+void WebRtcNs_FreeToPool(NsPool *pool, NsHandle *NS_inst);
+
 /*
  * This function initializes a NS instance and has to be called before any other
  * processing is made.
  *
  * Input:
  *      - NS_inst       : Instance that should be initialized
- *      - fs            : sampling frequency
+ *      - fs            : sampling frequency, 8000, 16000, 32000 or 48000.
+ *                        Above 16 kHz the 10ms frames are split into bands of
+ *                        160 samples with WebRtcSpl_BandSplitAnalysis(), the
+ *                        lowest is the L band
  *
  * Output:
  *      - NS_inst       : Initialized instance
@@ -276,6 +551,23 @@ int WebRtcNs_Init(NsHandle *NS_inst, uint32_t fs);
  */
 int WebRtcNs_set_policy(NsHandle *NS_inst, int mode);
 
+/*
+ * This selects libm or the fast math approximations for the per-bin loops.
+ * Fast math is faster and changes the output slightly, the output SNR
+ * against libm is reported by the benchmark. Off after WebRtcNs_Init().
+ *
+ * Input:
+ *      - NS_inst       : Noise suppression instance.
+ *      - enable        : 0: libm, 1: fast math
+ *
+ * Output:
+ *      - NS_inst       : Updated instance.
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_set_fast_math(NsHandle *NS_inst, int enable);
+
 /*
  * This functions estimates the background noise for the inserted speech frame.
  * The input and output signals should always be 10ms (80 or 160 samples).
@@ -291,7 +583,31 @@ void WebRtcNs_Analyze(NsHandle *NS_inst, const int16_t *spframe);
 
 /*
  * This functions does Noise Suppression for the inserted speech frame. The
- * input and output signals should always be 10ms (80 or 160 samples).
+ * input and output signals should always be 10ms (80 or 160 samples per band).
+ * The upper bands get the time domain gain of the upper half of the L band.
+ *
+ * Input
+ *      - NS_inst       : Noise suppression instance.
+ *      - spframe       : Pointer to speech frame buffer for each band
+ *      - num_bands     : Number of bands, 2 at 32 kHz and 3 at 48 kHz
+ *
+ * Output:
+ *      - NS_inst       : Updated NS instance
+ *      - outframe      : Pointer to output frame for each band
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_Process(NsHandle *NS_inst,
+                     const int16_t *const *spframe,
+                     size_t num_bands,
+                     int16_t *const *outframe);
+
+/*
+ * This function estimates the background noise and does Noise Suppression
+ * for a frame that would otherwise be passed to both WebRtcNs_Analyze() and
+ * WebRtcNs_Process(). The result is the same, but the frame is windowed and
+ * transformed only once.
  *
  * Input
  *      - NS_inst       : Noise suppression instance.
@@ -301,11 +617,83 @@ void WebRtcNs_Analyze(NsHandle *NS_inst, const int16_t *spframe);
  * Output:
  *      - NS_inst       : Updated NS instance
  *      - outframe      : Pointer to output frame for each band
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_AnalyzeProcess(NsHandle *NS_inst,
+                            const int16_t *const *spframe,
+                            size_t num_bands,
+                            int16_t *const *outframe);
+
+/*
+ * This function does the same as WebRtcNs_AnalyzeProcess() for |num_frames|
+ * consecutive 10ms frames, for offline processing of longer signals. The
+ * output is the same as with one call per frame.
+ *
+ * Input
+ *      - NS_inst       : Noise suppression instance.
+ *      - spframes      : Pointer to the speech frames of each band, back to
+ *                        back
+ *      - num_bands     : Number of bands
+ *      - num_frames    : Number of frames
+ *
+ * Output:
+ *      - NS_inst       : Updated NS instance
+ *      - outframes     : Pointer to the output frames of each band, may be
+ *                        the same as spframes
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessBatch(NsHandle *NS_inst,
+                          const int16_t *const *spframes,
+                          size_t num_bands,
+                          size_t num_frames,
+                          int16_t *const *outframes);
+
+/*
+ * This function suppresses noise in |num_frames| consecutive 10ms frames of
+ * |num_channels| interleaved channels in place, with one NS instance per
+ * channel. The output is the same as with WebRtcNs_ProcessBatch() on each
+ * deinterleaved channel. Only the lower band is processed, so the instances
+ * should run at 8 or 16 kHz.
+ *
+ * Input
+ *      - NS_inst       : Noise suppression instances, one per channel
+ *      - num_channels  : Number of channels
+ *      - buffer        : Interleaved speech, sample k of channel c at
+ *                        buffer[k * stride + c]
+ *      - stride        : Distance between two samples of a channel, at least
+ *                        num_channels
+ *      - num_frames    : Number of frames
+ *
+ * Output:
+ *      - NS_inst       : Updated NS instances
+ *      - buffer        : Noise suppressed speech
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessInterleaved(NsHandle *const *NS_inst,
+                                size_t num_channels,
+                                int16_t *buffer,
+                                size_t stride,
+                                size_t num_frames);
+
+/*
+ * This function does the same as WebRtcNs_ProcessInterleaved() on float
+ * samples in the 16-bit range. The output is limited to that range but not
+ * rounded.
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
  */
-void WebRtcNs_Process(NsHandle *NS_inst,
-                      const int16_t *const *spframe,
-                      size_t num_bands,
-                      int16_t *const *outframe);
+int WebRtcNs_ProcessInterleavedFloat(NsHandle *const *NS_inst,
+                                     size_t num_channels,
+                                     float *buffer,
+                                     size_t stride,
+                                     size_t num_frames);
 
 /* Returns the internally used prior speech probability of the current frame.
  * There is a frequency bin based one as well, with which this should not be
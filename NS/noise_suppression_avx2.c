@@ -0,0 +1,580 @@
+/*
+ * AVX2 versions of the NS kernels, bit exact with the C versions in
+ * noise_suppression.c.
+ */
+
+#include <immintrin.h>
+
+#include "noise_suppression.h"
+#include "ns_fast_math.h"
+
+// The registers hold interleaved complex values, [re, im, re, im, ...]. See
+// noise_suppression_sse2.c for the rounding of the butterflies.
+
+// Swaps the real and imaginary parts.
+static __inline __m256 Swap(__m256 x)
+{
+    return _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// The real parts from |re| and the imaginary parts from |im|.
+static __inline __m256 Blend(__m256 re, __m256 im)
+{
+    return _mm256_blend_ps(re, im, 0xAA);
+}
+
+// Reverses the order of the four complex values.
+static __inline __m256 Reverse(__m256 x)
+{
+    return _mm256_permute_ps(_mm256_permute2f128_ps(x, x, 0x01), _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+// Complex product with the factor given as [wr, wr] and [-wi, wi].
+static __inline __m256 ComplexMul(__m256 x, __m256 wr, __m256 wi)
+{
+    return _mm256_add_ps(_mm256_mul_ps(wr, x), _mm256_mul_ps(wi, Swap(x)));
+}
+
+// The imaginary part of a factor, [-wi, wi].
+static __inline __m256 Imag(float wi)
+{
+    return _mm256_set_ps(wi, -wi, wi, -wi, wi, -wi, wi, -wi);
+}
+
+// Four complex values from arbitrary offsets of |a|.
+static __inline __m256 Gather(const float *a, const uint8_t *offsets)
+{
+    const __m128 lo = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd((const double *) &a[offsets[0]]),
+                                                 (const double *) &a[offsets[4]]));
+    const __m128 hi = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd((const double *) &a[offsets[8]]),
+                                                 (const double *) &a[offsets[12]]));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+static __inline void Radix4In(__m256 a0, __m256 a1, __m256 a2, __m256 a3,
+                              __m256 *x0, __m256 *x1, __m256 *x2, __m256 *x3)
+{
+    *x0 = _mm256_add_ps(a0, a1);
+    *x1 = _mm256_sub_ps(a0, a1);
+    *x2 = _mm256_add_ps(a2, a3);
+    *x3 = _mm256_sub_ps(a2, a3);
+}
+
+static __inline void Radix4(__m256 *a0, __m256 *a1, __m256 *a2, __m256 *a3)
+{
+    const __m256 sign_re = Imag(0.f);
+    const __m256 sign_im = _mm256_xor_ps(sign_re, _mm256_set1_ps(-0.f));
+    __m256 x0, x1, x2, x3;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm256_add_ps(x0, x2);
+    *a2 = _mm256_sub_ps(x0, x2);
+    *a1 = _mm256_add_ps(x1, _mm256_xor_ps(Swap(x3), sign_re));
+    *a3 = _mm256_add_ps(x1, _mm256_xor_ps(Swap(x3), sign_im));
+}
+
+static __inline void Radix4Wk1r(__m256 *a0, __m256 *a1, __m256 *a2, __m256 *a3, __m256 wk1r)
+{
+    const __m256 sign_re = Imag(0.f);
+    const __m256 sign_im = _mm256_xor_ps(sign_re, _mm256_set1_ps(-0.f));
+    __m256 x0, x1, x2, x3, y0, y1;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm256_add_ps(x0, x2);
+    // [x2i - x0i, x0r - x2r]
+    x0 = Swap(x0);
+    x2 = Swap(x2);
+    *a2 = _mm256_sub_ps(Blend(x2, x0), Blend(x0, x2));
+    // wk1r * [x0r - x0i, x0r + x0i] with x0 = [x1r - x3i, x1i + x3r]
+    y0 = _mm256_add_ps(x1, _mm256_xor_ps(Swap(x3), sign_re));
+    *a1 = _mm256_mul_ps(wk1r, _mm256_add_ps(_mm256_moveldup_ps(y0),
+                                            _mm256_xor_ps(_mm256_movehdup_ps(y0), sign_re)));
+    // wk1r * [x0i - x0r, x0i + x0r] with x0 = [x3i + x1r, x3r - x1i]
+    y1 = _mm256_add_ps(Swap(x3), _mm256_xor_ps(x1, sign_im));
+    *a3 = _mm256_mul_ps(wk1r, _mm256_add_ps(_mm256_movehdup_ps(y1),
+                                            _mm256_xor_ps(_mm256_moveldup_ps(y1), sign_re)));
+}
+
+static __inline void Radix4Twiddle(__m256 *a0, __m256 *a1, __m256 *a2, __m256 *a3,
+                                   __m256 wk1r, __m256 wk1i, __m256 wk2r, __m256 wk2i,
+                                   __m256 wk3r, __m256 wk3i)
+{
+    const __m256 sign_re = Imag(0.f);
+    const __m256 sign_im = _mm256_xor_ps(sign_re, _mm256_set1_ps(-0.f));
+    __m256 x0, x1, x2, x3;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm256_add_ps(x0, x2);
+    *a2 = ComplexMul(_mm256_sub_ps(x0, x2), wk2r, wk2i);
+    *a1 = ComplexMul(_mm256_add_ps(x1, _mm256_xor_ps(Swap(x3), sign_re)), wk1r, wk1i);
+    *a3 = ComplexMul(_mm256_add_ps(x1, _mm256_xor_ps(Swap(x3), sign_im)), wk3r, wk3i);
+}
+
+// Bit reversal and the first radix-4 stage, from |src| to |dst|. Each 128-bit
+// lane holds one group of 8 complex values, laid out as in the SSE2 version.
+static void Cft1st(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const uint8_t *rev = tables->bitReverse;
+    __m256 a0, a1, a2, a3, r0, r1, r2, r3;
+    size_t g;
+
+    for (g = 0; g < n / 16; g += 2, rev += 16)
+    {
+        a0 = Gather(src, &rev[0]);
+        a1 = Gather(src, &rev[1]);
+        a2 = Gather(src, &rev[2]);
+        a3 = Gather(src, &rev[3]);
+        r0 = a0;
+        r1 = a1;
+        r2 = a2;
+        r3 = a3;
+        Radix4Twiddle(&a0, &a1, &a2, &a3,
+                      _mm256_loadu_ps(&tables->wk1r[4 * g]), _mm256_loadu_ps(&tables->wk1i[4 * g]),
+                      _mm256_loadu_ps(&tables->wk2r[4 * g]), _mm256_loadu_ps(&tables->wk2i[4 * g]),
+                      _mm256_loadu_ps(&tables->wk3r[4 * g]), _mm256_loadu_ps(&tables->wk3i[4 * g]));
+        if (g == 0)
+        {
+            // The first group has no factors in its first half and powers of
+            // exp(i pi / 4) in its second half.
+            __m256 b0 = r0, b1 = r1, b2 = r2, b3 = r3;
+            Radix4(&r0, &r1, &r2, &r3);
+            Radix4Wk1r(&b0, &b1, &b2, &b3, _mm256_set1_ps(tables->w[2]));
+            a0 = _mm256_blend_ps(_mm256_blend_ps(a0, r0, 0x03), b0, 0x0C);
+            a1 = _mm256_blend_ps(_mm256_blend_ps(a1, r1, 0x03), b1, 0x0C);
+            a2 = _mm256_blend_ps(_mm256_blend_ps(a2, r2, 0x03), b2, 0x0C);
+            a3 = _mm256_blend_ps(_mm256_blend_ps(a3, r3, 0x03), b3, 0x0C);
+        }
+        r0 = _mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(a2, a3, _MM_SHUFFLE(1, 0, 1, 0));
+        r2 = _mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 2, 3, 2));
+        r3 = _mm256_shuffle_ps(a2, a3, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm256_storeu_ps(&dst[16 * g], _mm256_permute2f128_ps(r0, r1, 0x20));
+        _mm256_storeu_ps(&dst[16 * g + 8], _mm256_permute2f128_ps(r2, r3, 0x20));
+        _mm256_storeu_ps(&dst[16 * g + 16], _mm256_permute2f128_ps(r0, r1, 0x31));
+        _mm256_storeu_ps(&dst[16 * g + 24], _mm256_permute2f128_ps(r2, r3, 0x31));
+    }
+}
+
+static void CftMdl(float *a, size_t n, size_t l, const float *w)
+{
+    const size_t m = l << 2;
+    __m256 a0, a1, a2, a3;
+    size_t j, k, k1;
+
+    for (j = 0; j < l; j += 8)
+    {
+        a0 = _mm256_loadu_ps(&a[j]);
+        a1 = _mm256_loadu_ps(&a[j + l]);
+        a2 = _mm256_loadu_ps(&a[j + 2 * l]);
+        a3 = _mm256_loadu_ps(&a[j + 3 * l]);
+        Radix4(&a0, &a1, &a2, &a3);
+        _mm256_storeu_ps(&a[j], a0);
+        _mm256_storeu_ps(&a[j + l], a1);
+        _mm256_storeu_ps(&a[j + 2 * l], a2);
+        _mm256_storeu_ps(&a[j + 3 * l], a3);
+    }
+    for (j = m; j < l + m; j += 8)
+    {
+        a0 = _mm256_loadu_ps(&a[j]);
+        a1 = _mm256_loadu_ps(&a[j + l]);
+        a2 = _mm256_loadu_ps(&a[j + 2 * l]);
+        a3 = _mm256_loadu_ps(&a[j + 3 * l]);
+        Radix4Wk1r(&a0, &a1, &a2, &a3, _mm256_set1_ps(w[2]));
+        _mm256_storeu_ps(&a[j], a0);
+        _mm256_storeu_ps(&a[j + l], a1);
+        _mm256_storeu_ps(&a[j + 2 * l], a2);
+        _mm256_storeu_ps(&a[j + 3 * l], a3);
+    }
+    for (k = 2 * m, k1 = 2; k < n; k += 2 * m, k1 += 2)
+    {
+        const float wk2r = w[k1];
+        const float wk2i = w[k1 + 1];
+        float wk1r = w[2 * k1];
+        float wk1i = w[2 * k1 + 1];
+        float wk3r = wk1r - 2 * wk2i * wk1i;
+        float wk3i = 2 * wk2i * wk1r - wk1i;
+
+        for (j = k; j < l + k; j += 8)
+        {
+            a0 = _mm256_loadu_ps(&a[j]);
+            a1 = _mm256_loadu_ps(&a[j + l]);
+            a2 = _mm256_loadu_ps(&a[j + 2 * l]);
+            a3 = _mm256_loadu_ps(&a[j + 3 * l]);
+            Radix4Twiddle(&a0, &a1, &a2, &a3,
+                          _mm256_set1_ps(wk1r), Imag(wk1i),
+                          _mm256_set1_ps(wk2r), Imag(wk2i),
+                          _mm256_set1_ps(wk3r), Imag(wk3i));
+            _mm256_storeu_ps(&a[j], a0);
+            _mm256_storeu_ps(&a[j + l], a1);
+            _mm256_storeu_ps(&a[j + 2 * l], a2);
+            _mm256_storeu_ps(&a[j + 3 * l], a3);
+        }
+        wk1r = w[2 * k1 + 2];
+        wk1i = w[2 * k1 + 3];
+        wk3r = wk1r - 2 * wk2r * wk1i;
+        wk3i = 2 * wk2r * wk1r - wk1i;
+        for (j = k + m; j < l + (k + m); j += 8)
+        {
+            a0 = _mm256_loadu_ps(&a[j]);
+            a1 = _mm256_loadu_ps(&a[j + l]);
+            a2 = _mm256_loadu_ps(&a[j + 2 * l]);
+            a3 = _mm256_loadu_ps(&a[j + 3 * l]);
+            Radix4Twiddle(&a0, &a1, &a2, &a3,
+                          _mm256_set1_ps(wk1r), Imag(wk1i),
+                          _mm256_set1_ps(-wk2i), Imag(wk2r),
+                          _mm256_set1_ps(wk3r), Imag(wk3i));
+            _mm256_storeu_ps(&a[j], a0);
+            _mm256_storeu_ps(&a[j + l], a1);
+            _mm256_storeu_ps(&a[j + 2 * l], a2);
+            _mm256_storeu_ps(&a[j + 3 * l], a3);
+        }
+    }
+}
+
+static void CftLast(float *a, size_t n, int inverse)
+{
+    const __m256 sign_im = _mm256_xor_ps(Imag(0.f), _mm256_set1_ps(-0.f));
+    const __m256 conj = inverse ? sign_im : _mm256_setzero_ps();
+    __m256 a0, a1, a2, a3, x0, x1, x2, x3;
+    size_t j;
+
+    if (n == 128)
+    {
+        for (j = 0; j < 32; j += 8)
+        {
+            a0 = _mm256_xor_ps(_mm256_loadu_ps(&a[j]), conj);
+            a1 = _mm256_xor_ps(_mm256_loadu_ps(&a[j + 32]), conj);
+            a2 = _mm256_loadu_ps(&a[j + 64]);
+            a3 = _mm256_loadu_ps(&a[j + 96]);
+            if (inverse)
+            {
+                Radix4In(a0, a1, a2, a3, &x0, &x1, &x2, &x3);
+                _mm256_storeu_ps(&a[j], _mm256_add_ps(x0, _mm256_xor_ps(x2, sign_im)));
+                _mm256_storeu_ps(&a[j + 64], _mm256_sub_ps(x0, _mm256_xor_ps(x2, sign_im)));
+                _mm256_storeu_ps(&a[j + 32], _mm256_sub_ps(x1, Swap(x3)));
+                _mm256_storeu_ps(&a[j + 96], _mm256_add_ps(x1, Swap(x3)));
+            }
+            else
+            {
+                Radix4(&a0, &a1, &a2, &a3);
+                _mm256_storeu_ps(&a[j], a0);
+                _mm256_storeu_ps(&a[j + 32], a1);
+                _mm256_storeu_ps(&a[j + 64], a2);
+                _mm256_storeu_ps(&a[j + 96], a3);
+            }
+        }
+    }
+    else
+    {
+        for (j = 0; j < 128; j += 8)
+        {
+            a0 = _mm256_xor_ps(_mm256_loadu_ps(&a[j]), conj);
+            a1 = _mm256_xor_ps(_mm256_loadu_ps(&a[j + 128]), conj);
+            _mm256_storeu_ps(&a[j], _mm256_add_ps(a0, a1));
+            _mm256_storeu_ps(&a[j + 128], _mm256_sub_ps(a0, a1));
+        }
+    }
+}
+
+// Loads eight pairs of complex values j1 + i and m - j1 - i as real and
+// imaginary parts. Within the lanes the values are ordered i = 0, 1, 4, 5 and
+// 2, 3, 6, 7.
+static __inline void LoadPairs(const float *a, const float *wr, const float *wi, size_t m, size_t j1,
+                               __m256 *ajr, __m256 *aji, __m256 *akr, __m256 *aki,
+                               __m256 *wkr, __m256 *wki)
+{
+    const __m256 j_lo = _mm256_loadu_ps(&a[2 * j1]);
+    const __m256 j_hi = _mm256_loadu_ps(&a[2 * j1 + 8]);
+    const __m256 k_lo = Reverse(_mm256_loadu_ps(&a[2 * (m - j1 - 3)]));
+    const __m256 k_hi = Reverse(_mm256_loadu_ps(&a[2 * (m - j1 - 7)]));
+
+    *ajr = _mm256_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(2, 0, 2, 0));
+    *aji = _mm256_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(3, 1, 3, 1));
+    *akr = _mm256_shuffle_ps(k_lo, k_hi, _MM_SHUFFLE(2, 0, 2, 0));
+    *aki = _mm256_shuffle_ps(k_lo, k_hi, _MM_SHUFFLE(3, 1, 3, 1));
+    *wkr = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(&wr[j1])),
+                                                  _MM_SHUFFLE(3, 1, 2, 0)));
+    *wki = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(&wi[j1])),
+                                                  _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+static __inline void StorePairs(float *a, size_t m, size_t j1,
+                                __m256 cjr, __m256 cji, __m256 ckr, __m256 cki)
+{
+    _mm256_storeu_ps(&a[2 * j1], _mm256_unpacklo_ps(cjr, cji));
+    _mm256_storeu_ps(&a[2 * j1 + 8], _mm256_unpackhi_ps(cjr, cji));
+    _mm256_storeu_ps(&a[2 * (m - j1 - 3)], Reverse(_mm256_unpacklo_ps(ckr, cki)));
+    _mm256_storeu_ps(&a[2 * (m - j1 - 7)], Reverse(_mm256_unpackhi_ps(ckr, cki)));
+}
+
+static void Rftfsub(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const size_t m = n >> 1;
+    __m256 ajr, aji, akr, aki, wkr, wki, xr, xi, yr, yi;
+    size_t j1 = 1;
+
+    for (; j1 + 8 <= n / 4; j1 += 8)
+    {
+        LoadPairs(src, tables->rftWkr, tables->rftWki, m, j1, &ajr, &aji, &akr, &aki, &wkr, &wki);
+        xr = _mm256_sub_ps(ajr, akr);
+        xi = _mm256_add_ps(aji, aki);
+        yr = _mm256_sub_ps(_mm256_mul_ps(wkr, xr), _mm256_mul_ps(wki, xi));
+        yi = _mm256_add_ps(_mm256_mul_ps(wkr, xi), _mm256_mul_ps(wki, xr));
+        StorePairs(dst, m, j1, _mm256_sub_ps(ajr, yr), _mm256_sub_ps(aji, yi),
+                   _mm256_add_ps(akr, yr), _mm256_sub_ps(aki, yi));
+    }
+    for (; j1 < n / 4; j1++)
+    {
+        const size_t j = 2 * j1;
+        const size_t k = n - j;
+        const float wkr1 = tables->rftWkr[j1];
+        const float wki1 = tables->rftWki[j1];
+        const float xr1 = src[j] - src[k];
+        const float xi1 = src[j + 1] + src[k + 1];
+        const float yr1 = wkr1 * xr1 - wki1 * xi1;
+        const float yi1 = wkr1 * xi1 + wki1 * xr1;
+        dst[j] = src[j] - yr1;
+        dst[j + 1] = src[j + 1] - yi1;
+        dst[k] = src[k] + yr1;
+        dst[k + 1] = src[k + 1] - yi1;
+    }
+    dst[0] = src[0] + src[1];
+    dst[1] = src[0] - src[1];
+    dst[m] = src[m];
+    dst[m + 1] = src[m + 1];
+}
+
+static void Rftbsub(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const size_t m = n >> 1;
+    const float a1 = 0.5f * (src[0] - src[1]);
+    __m256 ajr, aji, akr, aki, wkr, wki, xr, xi, yr, yi;
+    size_t j1 = 1;
+
+    for (; j1 + 8 <= n / 4; j1 += 8)
+    {
+        LoadPairs(src, tables->rftWkr, tables->rftWki, m, j1, &ajr, &aji, &akr, &aki, &wkr, &wki);
+        xr = _mm256_sub_ps(ajr, akr);
+        xi = _mm256_add_ps(aji, aki);
+        yr = _mm256_add_ps(_mm256_mul_ps(wkr, xr), _mm256_mul_ps(wki, xi));
+        yi = _mm256_sub_ps(_mm256_mul_ps(wkr, xi), _mm256_mul_ps(wki, xr));
+        StorePairs(dst, m, j1, _mm256_sub_ps(ajr, yr), _mm256_sub_ps(yi, aji),
+                   _mm256_add_ps(akr, yr), _mm256_sub_ps(yi, aki));
+    }
+    for (; j1 < n / 4; j1++)
+    {
+        const size_t j = 2 * j1;
+        const size_t k = n - j;
+        const float wkr1 = tables->rftWkr[j1];
+        const float wki1 = tables->rftWki[j1];
+        const float xr1 = src[j] - src[k];
+        const float xi1 = src[j + 1] + src[k + 1];
+        const float yr1 = wkr1 * xr1 + wki1 * xi1;
+        const float yi1 = wkr1 * xi1 - wki1 * xr1;
+        dst[j] = src[j] - yr1;
+        dst[j + 1] = yi1 - src[j + 1];
+        dst[k] = src[k] + yr1;
+        dst[k + 1] = yi1 - src[k + 1];
+    }
+    dst[0] = src[0] - a1;
+    dst[1] = -a1;
+    dst[m] = src[m];
+    dst[m + 1] = -src[m + 1];
+}
+
+void WebRtcNs_RdftAVX2(size_t n, int isgn, float *a, size_t *ip, float *w)
+{
+    const NsFftTables *tables;
+    float buffer[ANAL_BLOCKL_MAX];
+
+    if (n == 128)
+    {
+        tables = &WebRtcNs_kFftTables128;
+    }
+    else if (n == 256)
+    {
+        tables = &WebRtcNs_kFftTables256;
+    }
+    else
+    {
+        WebRtc_rdft(n, isgn, a, ip, w);
+        return;
+    }
+    if (isgn >= 0)
+    {
+        Cft1st(a, buffer, n, tables);
+        CftMdl(buffer, n, 8, tables->w);
+        if (n == 256)
+        {
+            CftMdl(buffer, n, 32, tables->w);
+        }
+        CftLast(buffer, n, 0);
+        Rftfsub(buffer, a, n, tables);
+    }
+    else
+    {
+        Rftbsub(a, buffer, n, tables);
+        Cft1st(buffer, a, n, tables);
+        CftMdl(a, n, 8, tables->w);
+        if (n == 256)
+        {
+            CftMdl(a, n, 32, tables->w);
+        }
+        CftLast(a, n, 1);
+    }
+}
+
+// FACTOR / density where the density is above 1, FACTOR elsewhere.
+static __inline __m256 QuantileStep(__m256 density)
+{
+    const __m256 factor = _mm256_set1_ps(FACTOR);
+    const __m256 above = _mm256_cmp_ps(density, _mm256_set1_ps(1.f), _CMP_GT_OQ);
+
+    return _mm256_blendv_ps(factor, _mm256_div_ps(factor, density), above);
+}
+
+void WebRtcNs_UpdateQuantilesAVX2(const float *lmagn,
+                                  size_t magnLen,
+                                  const int *counter,
+                                  float *lquantile,
+                                  float *density)
+{
+    const __m256 up = _mm256_set1_ps(QUANTILE);
+    const __m256 down = _mm256_set1_ps(-(1.f - QUANTILE));
+    const __m256 width = _mm256_set1_ps(WIDTH);
+    const __m256 peak = _mm256_set1_ps(1.f / (2.f * WIDTH));
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 count[SIMULT], weight[SIMULT];
+    size_t i, s;
+
+    for (s = 0; s < SIMULT; s++)
+    {
+        count[s] = _mm256_set1_ps((float) counter[s]);
+        weight[s] = _mm256_set1_ps(1.f / (counter[s] + 1));
+    }
+    for (i = 0; i + 8 <= magnLen; i += 8)
+    {
+        const __m256 magn = _mm256_loadu_ps(&lmagn[i]);
+
+        for (s = 0; s < SIMULT; s++)
+        {
+            float *lq = &lquantile[s * magnLen + i];
+            float *dens = &density[s * magnLen + i];
+            __m256 q = _mm256_loadu_ps(lq);
+            const __m256 d = _mm256_loadu_ps(dens);
+            const __m256 sign = _mm256_blendv_ps(down, up, _mm256_cmp_ps(magn, q, _CMP_GT_OQ));
+            __m256 inside, updated;
+
+            // Update log quantile estimate.
+            q = _mm256_add_ps(q, _mm256_mul_ps(_mm256_mul_ps(sign, QuantileStep(d)), weight[s]));
+            _mm256_storeu_ps(lq, q);
+
+            // Update density estimate.
+            inside = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(magn, q), absMask), width,
+                                   _CMP_LT_OQ);
+            updated = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(count[s], d), peak), weight[s]);
+            _mm256_storeu_ps(dens, _mm256_blendv_ps(d, updated, inside));
+        }
+    }
+    WebRtcNs_UpdateQuantileBins(lmagn, magnLen, counter, i, lquantile, density);
+}
+
+// The vector versions of the fast math approximations in ns_fast_math.h, same
+// operations in the same order as the scalar versions.
+static __inline __m256 LogApprox(__m256 x)
+{
+    const __m256i bits = _mm256_castps_si256(x);
+    const __m256i shifted = _mm256_add_epi32(bits, _mm256_set1_epi32(0x3f800000 - 0x3f3504f3));
+    const __m256i e = _mm256_sub_epi32(_mm256_srai_epi32(shifted, 23), _mm256_set1_epi32(127));
+    const __m256i mantissa = _mm256_sub_epi32(bits, _mm256_slli_epi32(e, 23));
+    const __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(1.f));
+    __m256 p = _mm256_set1_ps(NS_LOG_C7);
+
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C6));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C2));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C1));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(NS_LOG_C0));
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(e), _mm256_set1_ps(NS_LOG_LN2)), _mm256_mul_ps(t, p));
+}
+
+static __inline __m256 ExpApprox(__m256 x)
+{
+    __m256 y, r, p;
+    __m256i n;
+
+    x = _mm256_max_ps(x, _mm256_set1_ps(NS_EXP_MIN));
+    x = _mm256_min_ps(x, _mm256_set1_ps(NS_EXP_MAX));
+    y = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(NS_EXP_LOG2E)), _mm256_set1_ps(0.5f));
+    n = _mm256_cvttps_epi32(y);
+    n = _mm256_add_epi32(n, _mm256_castps_si256(
+            _mm256_cmp_ps(y, _mm256_cvtepi32_ps(n), _CMP_LT_OQ)));
+    y = _mm256_cvtepi32_ps(n);
+    r = _mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(NS_EXP_LN2_HI))),
+                      _mm256_mul_ps(y, _mm256_set1_ps(NS_EXP_LN2_LO)));
+    p = _mm256_set1_ps(NS_EXP_C6);
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(NS_EXP_C5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(NS_EXP_C4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(NS_EXP_C3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(NS_EXP_C2));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(NS_EXP_C1));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.f));
+    n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(n));
+}
+
+static __inline __m256 SqrtApprox(__m256 x)
+{
+    const __m256 half = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    __m256 y = _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_set1_epi32(NS_RSQRT_MAGIC),
+                                                 _mm256_srai_epi32(_mm256_castps_si256(x), 1)));
+
+    y = _mm256_mul_ps(y, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, y), y)));
+    y = _mm256_mul_ps(y, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, y), y)));
+    return _mm256_mul_ps(x, y);
+}
+
+void WebRtcNs_LogVectorAVX2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= length; i += 8)
+    {
+        _mm256_storeu_ps(&out[i], LogApprox(_mm256_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_LogApprox(in[i]);
+    }
+}
+
+void WebRtcNs_ExpVectorAVX2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= length; i += 8)
+    {
+        _mm256_storeu_ps(&out[i], ExpApprox(_mm256_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_ExpApprox(in[i]);
+    }
+}
+
+void WebRtcNs_SqrtVectorAVX2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 8 <= length; i += 8)
+    {
+        _mm256_storeu_ps(&out[i], SqrtApprox(_mm256_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_SqrtApprox(in[i]);
+    }
+}
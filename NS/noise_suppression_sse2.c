@@ -0,0 +1,593 @@
+/*
+ * SSE2 versions of the NS kernels, bit exact with the C versions in
+ * noise_suppression.c.
+ */
+
+#include <emmintrin.h>
+
+#include "noise_suppression.h"
+#include "ns_fast_math.h"
+
+// The registers hold interleaved complex values, [re, im, re, im].
+
+// Swaps the real and imaginary parts.
+static __inline __m128 Swap(__m128 x)
+{
+    return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static __inline __m128 DupReal(__m128 x)
+{
+    return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 0, 0));
+}
+
+static __inline __m128 DupImag(__m128 x)
+{
+    return _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+// Complex product with the factor given as [wr, wr] and [-wi, wi], rounded
+// like wr * xr - wi * xi and wr * xi + wi * xr.
+static __inline __m128 ComplexMul(__m128 x, __m128 wr, __m128 wi)
+{
+    return _mm_add_ps(_mm_mul_ps(wr, x), _mm_mul_ps(wi, Swap(x)));
+}
+
+// The imaginary part of a factor, [-wi, wi].
+static __inline __m128 Imag(float wi)
+{
+    return _mm_set_ps(wi, -wi, wi, -wi);
+}
+
+// Two complex values from arbitrary offsets of |a|.
+static __inline __m128 Gather(const float *a, int offset0, int offset1)
+{
+    return _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd((const double *) &a[offset0]),
+                                      (const double *) &a[offset1]));
+}
+
+// The first half of a radix-4 butterfly, shared by all its forms.
+static __inline void Radix4In(__m128 a0, __m128 a1, __m128 a2, __m128 a3,
+                              __m128 *x0, __m128 *x1, __m128 *x2, __m128 *x3)
+{
+    *x0 = _mm_add_ps(a0, a1);
+    *x1 = _mm_sub_ps(a0, a1);
+    *x2 = _mm_add_ps(a2, a3);
+    *x3 = _mm_sub_ps(a2, a3);
+}
+
+// Radix-4 butterfly without twiddle factors, the first block of every stage.
+static __inline void Radix4(__m128 *a0, __m128 *a1, __m128 *a2, __m128 *a3)
+{
+    const __m128 sign_re = _mm_set_ps(0.f, -0.f, 0.f, -0.f);
+    const __m128 sign_im = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+    __m128 x0, x1, x2, x3;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm_add_ps(x0, x2);
+    *a2 = _mm_sub_ps(x0, x2);
+    *a1 = _mm_add_ps(x1, _mm_xor_ps(Swap(x3), sign_re));
+    *a3 = _mm_add_ps(x1, _mm_xor_ps(Swap(x3), sign_im));
+}
+
+// Radix-4 butterfly of the second block of every stage, where the factors
+// are powers of exp(i pi / 4) and WebRtc_rdft() rounds differently.
+static __inline void Radix4Wk1r(__m128 *a0, __m128 *a1, __m128 *a2, __m128 *a3, __m128 wk1r)
+{
+    const __m128 sign_re = _mm_set_ps(0.f, -0.f, 0.f, -0.f);
+    const __m128 sign_im = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+    const __m128 mask_im = _mm_castsi128_ps(_mm_set_epi32(-1, 0, -1, 0));
+    __m128 x0, x1, x2, x3, y0, y1;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm_add_ps(x0, x2);
+    // [x2i - x0i, x0r - x2r]
+    x0 = Swap(x0);
+    x2 = Swap(x2);
+    y0 = _mm_or_ps(_mm_andnot_ps(mask_im, x2), _mm_and_ps(mask_im, x0));
+    y1 = _mm_or_ps(_mm_andnot_ps(mask_im, x0), _mm_and_ps(mask_im, x2));
+    *a2 = _mm_sub_ps(y0, y1);
+    // wk1r * [x0r - x0i, x0r + x0i] with x0 = [x1r - x3i, x1i + x3r]
+    y0 = _mm_add_ps(x1, _mm_xor_ps(Swap(x3), sign_re));
+    *a1 = _mm_mul_ps(wk1r, _mm_add_ps(DupReal(y0), _mm_xor_ps(DupImag(y0), sign_re)));
+    // wk1r * [x0i - x0r, x0i + x0r] with x0 = [x3i + x1r, x3r - x1i]
+    y1 = _mm_add_ps(Swap(x3), _mm_xor_ps(x1, sign_im));
+    *a3 = _mm_mul_ps(wk1r, _mm_add_ps(DupImag(y1), _mm_xor_ps(DupReal(y1), sign_re)));
+}
+
+static __inline void Radix4Twiddle(__m128 *a0, __m128 *a1, __m128 *a2, __m128 *a3,
+                                   __m128 wk1r, __m128 wk1i, __m128 wk2r, __m128 wk2i,
+                                   __m128 wk3r, __m128 wk3i)
+{
+    const __m128 sign_re = _mm_set_ps(0.f, -0.f, 0.f, -0.f);
+    const __m128 sign_im = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+    __m128 x0, x1, x2, x3;
+
+    Radix4In(*a0, *a1, *a2, *a3, &x0, &x1, &x2, &x3);
+    *a0 = _mm_add_ps(x0, x2);
+    *a2 = ComplexMul(_mm_sub_ps(x0, x2), wk2r, wk2i);
+    *a1 = ComplexMul(_mm_add_ps(x1, _mm_xor_ps(Swap(x3), sign_re)), wk1r, wk1i);
+    *a3 = ComplexMul(_mm_add_ps(x1, _mm_xor_ps(Swap(x3), sign_im)), wk3r, wk3i);
+}
+
+// Bit reversal and the first radix-4 stage (cft1st() of WebRtc_rdft()), from
+// |src| to |dst|. A group of 8 complex values is done in 4 registers, each
+// with one value of the first and one of the second half.
+static void Cft1st(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const uint8_t *rev = tables->bitReverse;
+    __m128 a0, a1, a2, a3, b0, b1, b2, b3;
+    size_t g;
+
+    for (g = 0; g < n / 16; g++, rev += 8)
+    {
+        a0 = Gather(src, rev[0], rev[4]);
+        a1 = Gather(src, rev[1], rev[5]);
+        a2 = Gather(src, rev[2], rev[6]);
+        a3 = Gather(src, rev[3], rev[7]);
+        if (g == 0)
+        {
+            // No factors in the first half, powers of exp(i pi / 4) in the
+            // second half.
+            b0 = a0;
+            b1 = a1;
+            b2 = a2;
+            b3 = a3;
+            Radix4(&a0, &a1, &a2, &a3);
+            Radix4Wk1r(&b0, &b1, &b2, &b3, _mm_set1_ps(tables->w[2]));
+            a0 = _mm_shuffle_ps(a0, b0, _MM_SHUFFLE(3, 2, 1, 0));
+            a1 = _mm_shuffle_ps(a1, b1, _MM_SHUFFLE(3, 2, 1, 0));
+            a2 = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(3, 2, 1, 0));
+            a3 = _mm_shuffle_ps(a3, b3, _MM_SHUFFLE(3, 2, 1, 0));
+        }
+        else
+        {
+            Radix4Twiddle(&a0, &a1, &a2, &a3,
+                          _mm_loadu_ps(&tables->wk1r[4 * g]), _mm_loadu_ps(&tables->wk1i[4 * g]),
+                          _mm_loadu_ps(&tables->wk2r[4 * g]), _mm_loadu_ps(&tables->wk2i[4 * g]),
+                          _mm_loadu_ps(&tables->wk3r[4 * g]), _mm_loadu_ps(&tables->wk3i[4 * g]));
+        }
+        _mm_storeu_ps(&dst[16 * g], _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm_storeu_ps(&dst[16 * g + 4], _mm_shuffle_ps(a2, a3, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm_storeu_ps(&dst[16 * g + 8], _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 2, 3, 2)));
+        _mm_storeu_ps(&dst[16 * g + 12], _mm_shuffle_ps(a2, a3, _MM_SHUFFLE(3, 2, 3, 2)));
+    }
+}
+
+// A radix-4 stage with butterfly span |l| >= 8, cftmdl() of WebRtc_rdft().
+static void CftMdl(float *a, size_t n, size_t l, const float *w)
+{
+    const size_t m = l << 2;
+    __m128 a0, a1, a2, a3;
+    size_t j, k, k1;
+
+    for (j = 0; j < l; j += 4)
+    {
+        a0 = _mm_loadu_ps(&a[j]);
+        a1 = _mm_loadu_ps(&a[j + l]);
+        a2 = _mm_loadu_ps(&a[j + 2 * l]);
+        a3 = _mm_loadu_ps(&a[j + 3 * l]);
+        Radix4(&a0, &a1, &a2, &a3);
+        _mm_storeu_ps(&a[j], a0);
+        _mm_storeu_ps(&a[j + l], a1);
+        _mm_storeu_ps(&a[j + 2 * l], a2);
+        _mm_storeu_ps(&a[j + 3 * l], a3);
+    }
+    for (j = m; j < l + m; j += 4)
+    {
+        a0 = _mm_loadu_ps(&a[j]);
+        a1 = _mm_loadu_ps(&a[j + l]);
+        a2 = _mm_loadu_ps(&a[j + 2 * l]);
+        a3 = _mm_loadu_ps(&a[j + 3 * l]);
+        Radix4Wk1r(&a0, &a1, &a2, &a3, _mm_set1_ps(w[2]));
+        _mm_storeu_ps(&a[j], a0);
+        _mm_storeu_ps(&a[j + l], a1);
+        _mm_storeu_ps(&a[j + 2 * l], a2);
+        _mm_storeu_ps(&a[j + 3 * l], a3);
+    }
+    for (k = 2 * m, k1 = 2; k < n; k += 2 * m, k1 += 2)
+    {
+        const float wk2r = w[k1];
+        const float wk2i = w[k1 + 1];
+        float wk1r = w[2 * k1];
+        float wk1i = w[2 * k1 + 1];
+        float wk3r = wk1r - 2 * wk2i * wk1i;
+        float wk3i = 2 * wk2i * wk1r - wk1i;
+
+        for (j = k; j < l + k; j += 4)
+        {
+            a0 = _mm_loadu_ps(&a[j]);
+            a1 = _mm_loadu_ps(&a[j + l]);
+            a2 = _mm_loadu_ps(&a[j + 2 * l]);
+            a3 = _mm_loadu_ps(&a[j + 3 * l]);
+            Radix4Twiddle(&a0, &a1, &a2, &a3,
+                          _mm_set1_ps(wk1r), Imag(wk1i),
+                          _mm_set1_ps(wk2r), Imag(wk2i),
+                          _mm_set1_ps(wk3r), Imag(wk3i));
+            _mm_storeu_ps(&a[j], a0);
+            _mm_storeu_ps(&a[j + l], a1);
+            _mm_storeu_ps(&a[j + 2 * l], a2);
+            _mm_storeu_ps(&a[j + 3 * l], a3);
+        }
+        wk1r = w[2 * k1 + 2];
+        wk1i = w[2 * k1 + 3];
+        wk3r = wk1r - 2 * wk2r * wk1i;
+        wk3i = 2 * wk2r * wk1r - wk1i;
+        for (j = k + m; j < l + (k + m); j += 4)
+        {
+            a0 = _mm_loadu_ps(&a[j]);
+            a1 = _mm_loadu_ps(&a[j + l]);
+            a2 = _mm_loadu_ps(&a[j + 2 * l]);
+            a3 = _mm_loadu_ps(&a[j + 3 * l]);
+            Radix4Twiddle(&a0, &a1, &a2, &a3,
+                          _mm_set1_ps(wk1r), Imag(wk1i),
+                          _mm_set1_ps(-wk2i), Imag(wk2r),
+                          _mm_set1_ps(wk3r), Imag(wk3i));
+            _mm_storeu_ps(&a[j], a0);
+            _mm_storeu_ps(&a[j + l], a1);
+            _mm_storeu_ps(&a[j + 2 * l], a2);
+            _mm_storeu_ps(&a[j + 3 * l], a3);
+        }
+    }
+}
+
+// The last stage of the complex transform, radix-4 for 128 and radix-2 for
+// 256 points. The inverse transform works on the conjugates.
+static void CftLast(float *a, size_t n, int inverse)
+{
+    const __m128 sign_im = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+    const __m128 conj = inverse ? sign_im : _mm_setzero_ps();
+    __m128 a0, a1, a2, a3, x0, x1, x2, x3;
+    size_t j;
+
+    if (n == 128)
+    {
+        for (j = 0; j < 32; j += 4)
+        {
+            a0 = _mm_xor_ps(_mm_loadu_ps(&a[j]), conj);
+            a1 = _mm_xor_ps(_mm_loadu_ps(&a[j + 32]), conj);
+            a2 = _mm_loadu_ps(&a[j + 64]);
+            a3 = _mm_loadu_ps(&a[j + 96]);
+            if (inverse)
+            {
+                Radix4In(a0, a1, a2, a3, &x0, &x1, &x2, &x3);
+                _mm_storeu_ps(&a[j], _mm_add_ps(x0, _mm_xor_ps(x2, sign_im)));
+                _mm_storeu_ps(&a[j + 64], _mm_sub_ps(x0, _mm_xor_ps(x2, sign_im)));
+                _mm_storeu_ps(&a[j + 32], _mm_sub_ps(x1, Swap(x3)));
+                _mm_storeu_ps(&a[j + 96], _mm_add_ps(x1, Swap(x3)));
+            }
+            else
+            {
+                Radix4(&a0, &a1, &a2, &a3);
+                _mm_storeu_ps(&a[j], a0);
+                _mm_storeu_ps(&a[j + 32], a1);
+                _mm_storeu_ps(&a[j + 64], a2);
+                _mm_storeu_ps(&a[j + 96], a3);
+            }
+        }
+    }
+    else
+    {
+        for (j = 0; j < 128; j += 4)
+        {
+            a0 = _mm_xor_ps(_mm_loadu_ps(&a[j]), conj);
+            a1 = _mm_xor_ps(_mm_loadu_ps(&a[j + 128]), conj);
+            _mm_storeu_ps(&a[j], _mm_add_ps(a0, a1));
+            _mm_storeu_ps(&a[j + 128], _mm_sub_ps(a0, a1));
+        }
+    }
+}
+
+// Real to complex split of the forward transform, rftfsub() of WebRtc_rdft()
+// from |src| to |dst|. Four pairs of complex values at a time, split into
+// their real and imaginary parts.
+static void Rftfsub(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const size_t m = n >> 1;
+    size_t j1 = 1;
+
+    for (; j1 + 4 <= n / 4; j1 += 4)
+    {
+        const size_t k1 = m - j1;
+        const __m128 wkr = _mm_loadu_ps(&tables->rftWkr[j1]);
+        const __m128 wki = _mm_loadu_ps(&tables->rftWki[j1]);
+        const __m128 j_lo = _mm_loadu_ps(&src[2 * j1]);
+        const __m128 j_hi = _mm_loadu_ps(&src[2 * j1 + 4]);
+        const __m128 k_lo = _mm_loadu_ps(&src[2 * (k1 - 3)]);
+        const __m128 k_hi = _mm_loadu_ps(&src[2 * (k1 - 1)]);
+        // The k values in reverse order, to line up with the j values.
+        const __m128 ajr = _mm_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 aji = _mm_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 akr = _mm_shuffle_ps(k_hi, k_lo, _MM_SHUFFLE(0, 2, 0, 2));
+        const __m128 aki = _mm_shuffle_ps(k_hi, k_lo, _MM_SHUFFLE(1, 3, 1, 3));
+        const __m128 xr = _mm_sub_ps(ajr, akr);
+        const __m128 xi = _mm_add_ps(aji, aki);
+        const __m128 yr = _mm_sub_ps(_mm_mul_ps(wkr, xr), _mm_mul_ps(wki, xi));
+        const __m128 yi = _mm_add_ps(_mm_mul_ps(wkr, xi), _mm_mul_ps(wki, xr));
+        const __m128 cjr = _mm_sub_ps(ajr, yr);
+        const __m128 cji = _mm_sub_ps(aji, yi);
+        const __m128 ckr = _mm_add_ps(akr, yr);
+        const __m128 cki = _mm_sub_ps(aki, yi);
+        const __m128 k0 = _mm_unpacklo_ps(ckr, cki);
+        const __m128 k1v = _mm_unpackhi_ps(ckr, cki);
+
+        _mm_storeu_ps(&dst[2 * j1], _mm_unpacklo_ps(cjr, cji));
+        _mm_storeu_ps(&dst[2 * j1 + 4], _mm_unpackhi_ps(cjr, cji));
+        _mm_storeu_ps(&dst[2 * (k1 - 1)], _mm_shuffle_ps(k0, k0, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(&dst[2 * (k1 - 3)], _mm_shuffle_ps(k1v, k1v, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+    for (; j1 < n / 4; j1++)
+    {
+        const size_t j = 2 * j1;
+        const size_t k = n - j;
+        const float wkr = tables->rftWkr[j1];
+        const float wki = tables->rftWki[j1];
+        const float xr = src[j] - src[k];
+        const float xi = src[j + 1] + src[k + 1];
+        const float yr = wkr * xr - wki * xi;
+        const float yi = wkr * xi + wki * xr;
+        dst[j] = src[j] - yr;
+        dst[j + 1] = src[j + 1] - yi;
+        dst[k] = src[k] + yr;
+        dst[k + 1] = src[k + 1] - yi;
+    }
+    dst[0] = src[0] + src[1];
+    dst[1] = src[0] - src[1];
+    dst[m] = src[m];
+    dst[m + 1] = src[m + 1];
+}
+
+// Complex to real merge of the inverse transform, rftbsub() of WebRtc_rdft()
+// from |src| to |dst|, including the scaling of the first two values.
+static void Rftbsub(const float *src, float *dst, size_t n, const NsFftTables *tables)
+{
+    const size_t m = n >> 1;
+    const float a1 = 0.5f * (src[0] - src[1]);
+    size_t j1 = 1;
+
+    for (; j1 + 4 <= n / 4; j1 += 4)
+    {
+        const size_t k1 = m - j1;
+        const __m128 wkr = _mm_loadu_ps(&tables->rftWkr[j1]);
+        const __m128 wki = _mm_loadu_ps(&tables->rftWki[j1]);
+        const __m128 j_lo = _mm_loadu_ps(&src[2 * j1]);
+        const __m128 j_hi = _mm_loadu_ps(&src[2 * j1 + 4]);
+        const __m128 k_lo = _mm_loadu_ps(&src[2 * (k1 - 3)]);
+        const __m128 k_hi = _mm_loadu_ps(&src[2 * (k1 - 1)]);
+        const __m128 ajr = _mm_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 aji = _mm_shuffle_ps(j_lo, j_hi, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 akr = _mm_shuffle_ps(k_hi, k_lo, _MM_SHUFFLE(0, 2, 0, 2));
+        const __m128 aki = _mm_shuffle_ps(k_hi, k_lo, _MM_SHUFFLE(1, 3, 1, 3));
+        const __m128 xr = _mm_sub_ps(ajr, akr);
+        const __m128 xi = _mm_add_ps(aji, aki);
+        const __m128 yr = _mm_add_ps(_mm_mul_ps(wkr, xr), _mm_mul_ps(wki, xi));
+        const __m128 yi = _mm_sub_ps(_mm_mul_ps(wkr, xi), _mm_mul_ps(wki, xr));
+        const __m128 cjr = _mm_sub_ps(ajr, yr);
+        const __m128 cji = _mm_sub_ps(yi, aji);
+        const __m128 ckr = _mm_add_ps(akr, yr);
+        const __m128 cki = _mm_sub_ps(yi, aki);
+        const __m128 k0 = _mm_unpacklo_ps(ckr, cki);
+        const __m128 k1v = _mm_unpackhi_ps(ckr, cki);
+
+        _mm_storeu_ps(&dst[2 * j1], _mm_unpacklo_ps(cjr, cji));
+        _mm_storeu_ps(&dst[2 * j1 + 4], _mm_unpackhi_ps(cjr, cji));
+        _mm_storeu_ps(&dst[2 * (k1 - 1)], _mm_shuffle_ps(k0, k0, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(&dst[2 * (k1 - 3)], _mm_shuffle_ps(k1v, k1v, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+    for (; j1 < n / 4; j1++)
+    {
+        const size_t j = 2 * j1;
+        const size_t k = n - j;
+        const float wkr = tables->rftWkr[j1];
+        const float wki = tables->rftWki[j1];
+        const float xr = src[j] - src[k];
+        const float xi = src[j + 1] + src[k + 1];
+        const float yr = wkr * xr + wki * xi;
+        const float yi = wkr * xi - wki * xr;
+        dst[j] = src[j] - yr;
+        dst[j + 1] = yi - src[j + 1];
+        dst[k] = src[k] + yr;
+        dst[k + 1] = yi - src[k + 1];
+    }
+    dst[0] = src[0] - a1;
+    dst[1] = -a1;
+    dst[m] = src[m];
+    dst[m + 1] = -src[m + 1];
+}
+
+void WebRtcNs_RdftSSE2(size_t n, int isgn, float *a, size_t *ip, float *w)
+{
+    const NsFftTables *tables;
+    float buffer[ANAL_BLOCKL_MAX];
+
+    if (n == 128)
+    {
+        tables = &WebRtcNs_kFftTables128;
+    }
+    else if (n == 256)
+    {
+        tables = &WebRtcNs_kFftTables256;
+    }
+    else
+    {
+        WebRtc_rdft(n, isgn, a, ip, w);
+        return;
+    }
+    if (isgn >= 0)
+    {
+        Cft1st(a, buffer, n, tables);
+        CftMdl(buffer, n, 8, tables->w);
+        if (n == 256)
+        {
+            CftMdl(buffer, n, 32, tables->w);
+        }
+        CftLast(buffer, n, 0);
+        Rftfsub(buffer, a, n, tables);
+    }
+    else
+    {
+        Rftbsub(a, buffer, n, tables);
+        Cft1st(buffer, a, n, tables);
+        CftMdl(a, n, 8, tables->w);
+        if (n == 256)
+        {
+            CftMdl(a, n, 32, tables->w);
+        }
+        CftLast(a, n, 1);
+    }
+}
+
+// FACTOR / density where the density is above 1, FACTOR elsewhere.
+static __inline __m128 QuantileStep(__m128 density)
+{
+    const __m128 factor = _mm_set1_ps(FACTOR);
+    const __m128 above = _mm_cmpgt_ps(density, _mm_set1_ps(1.f));
+    const __m128 step = _mm_div_ps(factor, density);
+
+    return _mm_or_ps(_mm_and_ps(above, step), _mm_andnot_ps(above, factor));
+}
+
+void WebRtcNs_UpdateQuantilesSSE2(const float *lmagn,
+                                  size_t magnLen,
+                                  const int *counter,
+                                  float *lquantile,
+                                  float *density)
+{
+    const __m128 up = _mm_set1_ps(QUANTILE);
+    const __m128 down = _mm_set1_ps(-(1.f - QUANTILE));
+    const __m128 width = _mm_set1_ps(WIDTH);
+    const __m128 peak = _mm_set1_ps(1.f / (2.f * WIDTH));
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 count[SIMULT], weight[SIMULT];
+    size_t i, s;
+
+    for (s = 0; s < SIMULT; s++)
+    {
+        count[s] = _mm_set1_ps((float) counter[s]);
+        weight[s] = _mm_set1_ps(1.f / (counter[s] + 1));
+    }
+    for (i = 0; i + 4 <= magnLen; i += 4)
+    {
+        const __m128 magn = _mm_loadu_ps(&lmagn[i]);
+
+        for (s = 0; s < SIMULT; s++)
+        {
+            float *lq = &lquantile[s * magnLen + i];
+            float *dens = &density[s * magnLen + i];
+            __m128 q = _mm_loadu_ps(lq);
+            const __m128 d = _mm_loadu_ps(dens);
+            const __m128 above = _mm_cmpgt_ps(magn, q);
+            const __m128 sign = _mm_or_ps(_mm_and_ps(above, up), _mm_andnot_ps(above, down));
+            __m128 inside, updated;
+
+            // Update log quantile estimate.
+            q = _mm_add_ps(q, _mm_mul_ps(_mm_mul_ps(sign, QuantileStep(d)), weight[s]));
+            _mm_storeu_ps(lq, q);
+
+            // Update density estimate.
+            inside = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(magn, q), absMask), width);
+            updated = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(count[s], d), peak), weight[s]);
+            _mm_storeu_ps(dens, _mm_or_ps(_mm_and_ps(inside, updated), _mm_andnot_ps(inside, d)));
+        }
+    }
+    WebRtcNs_UpdateQuantileBins(lmagn, magnLen, counter, i, lquantile, density);
+}
+
+// The vector versions of the fast math approximations in ns_fast_math.h, same
+// operations in the same order as the scalar versions.
+static __inline __m128 LogApprox(__m128 x)
+{
+    const __m128i bits = _mm_castps_si128(x);
+    const __m128i shifted = _mm_add_epi32(bits, _mm_set1_epi32(0x3f800000 - 0x3f3504f3));
+    const __m128i e = _mm_sub_epi32(_mm_srai_epi32(shifted, 23), _mm_set1_epi32(127));
+    const __m128 t = _mm_sub_ps(_mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23))),
+                                _mm_set1_ps(1.f));
+    __m128 p = _mm_set1_ps(NS_LOG_C7);
+
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C6));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(NS_LOG_C0));
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(e), _mm_set1_ps(NS_LOG_LN2)), _mm_mul_ps(t, p));
+}
+
+static __inline __m128 ExpApprox(__m128 x)
+{
+    __m128 y, r, p;
+    __m128i n;
+
+    x = _mm_max_ps(x, _mm_set1_ps(NS_EXP_MIN));
+    x = _mm_min_ps(x, _mm_set1_ps(NS_EXP_MAX));
+    y = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(NS_EXP_LOG2E)), _mm_set1_ps(0.5f));
+    n = _mm_cvttps_epi32(y);
+    n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmplt_ps(y, _mm_cvtepi32_ps(n))));
+    y = _mm_cvtepi32_ps(n);
+    r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(NS_EXP_LN2_HI))),
+                   _mm_mul_ps(y, _mm_set1_ps(NS_EXP_LN2_LO)));
+    p = _mm_set1_ps(NS_EXP_C6);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(NS_EXP_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(NS_EXP_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(NS_EXP_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(NS_EXP_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(NS_EXP_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.f));
+    n = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(n));
+}
+
+static __inline __m128 SqrtApprox(__m128 x)
+{
+    const __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+    const __m128 threeHalves = _mm_set1_ps(1.5f);
+    __m128 y = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(NS_RSQRT_MAGIC),
+                                              _mm_srai_epi32(_mm_castps_si128(x), 1)));
+
+    y = _mm_mul_ps(y, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, y), y)));
+    y = _mm_mul_ps(y, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, y), y)));
+    return _mm_mul_ps(x, y);
+}
+
+void WebRtcNs_LogVectorSSE2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= length; i += 4)
+    {
+        _mm_storeu_ps(&out[i], LogApprox(_mm_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_LogApprox(in[i]);
+    }
+}
+
+void WebRtcNs_ExpVectorSSE2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= length; i += 4)
+    {
+        _mm_storeu_ps(&out[i], ExpApprox(_mm_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_ExpApprox(in[i]);
+    }
+}
+
+void WebRtcNs_SqrtVectorSSE2(const float *in, float *out, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i + 4 <= length; i += 4)
+    {
+        _mm_storeu_ps(&out[i], SqrtApprox(_mm_loadu_ps(&in[i])));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = WebRtcNs_SqrtApprox(in[i]);
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * Approximations of logf(), expf(), sqrtf() and tanhf() for the per-bin loops
+ * of the noise suppression, used instead of libm when fast math is enabled
+ * with WebRtcNs_set_fast_math().
+ *
+ * The array versions are called through function pointers which
+ * WebRtcNs_InitCore() points at the SSE2 or AVX2 versions when the CPU
+ * supports them. They evaluate the same expressions as the scalar versions
+ * below, in the same order and without fused multiply-adds, so every version
+ * returns the same bits and the fast math output does not depend on the CPU.
+ *
+ * Accuracy, measured against the double precision functions:
+ *      - log  : within 2e-7 absolute for arguments in [0.5, 2], 2 ulp relative
+ *               elsewhere. Arguments must be positive and normal.
+ *      - exp  : within 2 ulp relative. Arguments are clamped to [-87, 88].
+ *      - sqrt : within 5e-6 relative. The argument must not be negative.
+ *      - tanh : within 1e-4 absolute.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_FAST_MATH_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_FAST_MATH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ln(x) = e * ln(2) + t * P(t), where x = 2^e * (1 + t) with 1 + t in
+// [sqrt(0.5), sqrt(2)) and P(t) approximates ln(1 + t) / t.
+#define NS_LOG_LN2      0.693147181f
+#define NS_LOG_C0       0.999999968f
+#define NS_LOG_C1       -0.500003751f
+#define NS_LOG_C2       0.333346060f
+#define NS_LOG_C3       -0.249689070f
+#define NS_LOG_C4       0.199133479f
+#define NS_LOG_C5       -0.172782061f
+#define NS_LOG_C6       0.161262479f
+#define NS_LOG_C7       -0.0989535074f
+
+// exp(x) = 2^n * P(r), where x = n * ln(2) + r with |r| <= ln(2) / 2 and
+// P(r) approximates exp(r). ln(2) is split in a high part that n multiplies
+// exactly and a low part.
+#define NS_EXP_LOG2E    1.44269504f
+#define NS_EXP_LN2_HI   0.693359375f
+#define NS_EXP_LN2_LO   -2.12194440e-4f
+#define NS_EXP_MIN      -87.f
+#define NS_EXP_MAX      88.f
+#define NS_EXP_C1       1.00000004f
+#define NS_EXP_C2       0.500000005f
+#define NS_EXP_C3       0.166664155f
+#define NS_EXP_C4       0.0416663529f
+#define NS_EXP_C5       0.00837512640f
+#define NS_EXP_C6       0.00139411084f
+
+// sqrt(x) = x / sqrt(x), with the inverse square root guessed from the bits
+// of x and refined by two Newton-Raphson steps.
+#define NS_RSQRT_MAGIC  0x5f375a86
+
+// Pade approximant of tanh(x), clamped to +-1 from where it crosses 1.
+#define NS_TANH_MAX     4.97f
+
+static __inline float WebRtcNs_BitsToFloat(int32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static __inline int32_t WebRtcNs_FloatToBits(float value)
+{
+    int32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static __inline float WebRtcNs_LogApprox(float x)
+{
+    const int32_t bits = WebRtcNs_FloatToBits(x);
+    // Move the mantissa to [sqrt(0.5), sqrt(2)) by taking the exponent from
+    // the rounded instead of the truncated log2.
+    const int32_t shifted = bits + (0x3f800000 - 0x3f3504f3);
+    const int32_t e = (shifted >> 23) - 127;
+    // |e| is negative below 1, shift it as unsigned.
+    const float t = WebRtcNs_BitsToFloat(bits - (int32_t) ((uint32_t) e << 23)) - 1.f;
+    float p = NS_LOG_C7;
+
+    p = p * t + NS_LOG_C6;
+    p = p * t + NS_LOG_C5;
+    p = p * t + NS_LOG_C4;
+    p = p * t + NS_LOG_C3;
+    p = p * t + NS_LOG_C2;
+    p = p * t + NS_LOG_C1;
+    p = p * t + NS_LOG_C0;
+    return (float) e * NS_LOG_LN2 + t * p;
+}
+
+static __inline float WebRtcNs_ExpApprox(float x)
+{
+    float y, r, p;
+    int32_t n;
+
+    x = x < NS_EXP_MIN ? NS_EXP_MIN : x;
+    x = x > NS_EXP_MAX ? NS_EXP_MAX : x;
+    // n = floor(x * log2(e) + 0.5), the truncation rounds the negative values up.
+    y = x * NS_EXP_LOG2E + 0.5f;
+    n = (int32_t) y;
+    n -= y < (float) n;
+    y = (float) n;
+    r = (x - y * NS_EXP_LN2_HI) - y * NS_EXP_LN2_LO;
+    p = NS_EXP_C6;
+    p = p * r + NS_EXP_C5;
+    p = p * r + NS_EXP_C4;
+    p = p * r + NS_EXP_C3;
+    p = p * r + NS_EXP_C2;
+    p = p * r + NS_EXP_C1;
+    p = p * r + 1.f;
+    return p * WebRtcNs_BitsToFloat((n + 127) << 23);
+}
+
+static __inline float WebRtcNs_SqrtApprox(float x)
+{
+    const float half = 0.5f * x;
+    float y = WebRtcNs_BitsToFloat(NS_RSQRT_MAGIC - (WebRtcNs_FloatToBits(x) >> 1));
+
+    y = y * (1.5f - half * y * y);
+    y = y * (1.5f - half * y * y);
+    return x * y;
+}
+
+static __inline float WebRtcNs_TanhApprox(float x)
+{
+    float x2;
+
+    x = x < -NS_TANH_MAX ? -NS_TANH_MAX : x;
+    x = x > NS_TANH_MAX ? NS_TANH_MAX : x;
+    x2 = x * x;
+    return x * (135135.f + x2 * (17325.f + x2 * (378.f + x2))) /
+           (135135.f + x2 * (62370.f + x2 * (3150.f + x2 * 28.f)));
+}
+
+// Applies the approximation to |length| values of |in|, |out| may be |in|.
+typedef void (*VectorMath)(const float *in, float *out, size_t length);
+
+extern VectorMath WebRtcNs_LogVector;
+extern VectorMath WebRtcNs_ExpVector;
+extern VectorMath WebRtcNs_SqrtVector;
+
+// The x86 versions are defined in noise_suppression_sse2.c and
+// noise_suppression_avx2.c.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+void WebRtcNs_LogVectorSSE2(const float *in, float *out, size_t length);
+
+void WebRtcNs_ExpVectorSSE2(const float *in, float *out, size_t length);
+
+void WebRtcNs_SqrtVectorSSE2(const float *in, float *out, size_t length);
+
+void WebRtcNs_LogVectorAVX2(const float *in, float *out, size_t length);
+
+void WebRtcNs_ExpVectorAVX2(const float *in, float *out, size_t length);
+
+void WebRtcNs_SqrtVectorAVX2(const float *in, float *out, size_t length);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_FAST_MATH_H_
@@ -0,0 +1,835 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ns_lockstep.h"
+#include "noise_suppression.h"
+
+#ifndef SPL_SAT
+#define SPL_SAT(a, b, c)         ((b) > (a) ? (a) : (b) < (c) ? (c) : (b))
+#endif
+
+#define NS_LS_BINS  (HALF_ANAL_BLOCKL * NS_LS_MAX_STREAMS)
+
+// Per-bin state of all streams, bin i of stream l at [i * streams + l], the
+// quantile estimate s of bin i at [(s * magnLen + i) * streams + l].
+typedef struct
+{
+    float lquantile[SIMULT * NS_LS_BINS];
+    float density[SIMULT * NS_LS_BINS];
+    float quantile[NS_LS_BINS];
+    float smooth[NS_LS_BINS];
+    float noise[NS_LS_BINS];
+    float noisePrev[NS_LS_BINS];
+    float magnPrevAnalyze[NS_LS_BINS];
+    float magnPrevProcess[NS_LS_BINS];
+    float logLrtTimeAvg[NS_LS_BINS];
+    float magnAvgPause[NS_LS_BINS];
+    float initMagnEst[NS_LS_BINS];
+    float speechProb[NS_LS_BINS];
+} NsLsBins;
+
+struct NsLockstepT
+{
+    size_t streams;
+    int initFlag;
+    // Frame level state and time signals of each stream, the per-bin arrays
+    // of these instances are not used.
+    NoiseSuppressionC *ns[NS_LS_MAX_STREAMS];
+    NsLsBins bins;
+    // Streams whose analysis block is all zeros in the current frame, and
+    // their per-bin state before the frame (only their lanes are written).
+    int silent[NS_LS_MAX_STREAMS];
+    size_t silentLanes[NS_LS_MAX_STREAMS];
+    size_t numSilent;
+    NsLsBins savedBins;
+    // Spectra and intermediate results of the current frame, same layout as
+    // the bins.
+    float real[NS_LS_BINS];
+    float imag[NS_LS_BINS];
+    float magn[NS_LS_BINS];
+    float lmagn[NS_LS_BINS];
+    float noise[NS_LS_BINS];
+    float snrLocPost[NS_LS_BINS];
+    float snrLocPrior[NS_LS_BINS];
+    float logSnrLocPrior[NS_LS_BINS];
+    float theFilter[NS_LS_BINS];
+    float energy[NS_LS_MAX_STREAMS];
+    float signalEnergy[NS_LS_MAX_STREAMS];
+    float sumMagn[NS_LS_MAX_STREAMS];
+};
+
+// Copies |length| values of stream |l| between the stream's own array and the
+// interleaved layout.
+static void ScatterStream(const float *in, size_t length, size_t streams, size_t l, float *out)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        out[i * streams + l] = in[i];
+    }
+}
+
+static void GatherStream(const float *in, size_t length, size_t streams, size_t l, float *out)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        out[i] = in[i * streams + l];
+    }
+}
+
+// expf() of quantile estimate |s| of stream |l| into the quantile.
+static void ExpQuantile(NsLockstep *self, size_t s, size_t l)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    const float *lquantile = &self->bins.lquantile[s * magnLen * streams];
+    size_t i;
+
+    for (i = 0; i < magnLen; i++)
+    {
+        self->bins.quantile[i * streams + l] = expf(lquantile[i * streams + l]);
+    }
+}
+
+// Copies lanes |lanes| of |rows| rows of |streams| values.
+static void CopyLanes(const float *in, size_t rows, size_t streams,
+                      const size_t *lanes, size_t numLanes, float *out)
+{
+    size_t i, j;
+
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < numLanes; j++)
+        {
+            out[i * streams + lanes[j]] = in[i * streams + lanes[j]];
+        }
+    }
+}
+
+// Copies the per-bin state of the silent streams, over the bins in use.
+static void CopySilentBins(const NsLockstep *self, const NsLsBins *in, NsLsBins *out)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    const size_t *lanes = self->silentLanes;
+    const size_t numLanes = self->numSilent;
+
+    CopyLanes(in->lquantile, SIMULT * magnLen, streams, lanes, numLanes, out->lquantile);
+    CopyLanes(in->density, SIMULT * magnLen, streams, lanes, numLanes, out->density);
+    CopyLanes(in->quantile, magnLen, streams, lanes, numLanes, out->quantile);
+    CopyLanes(in->smooth, magnLen, streams, lanes, numLanes, out->smooth);
+    CopyLanes(in->noise, magnLen, streams, lanes, numLanes, out->noise);
+    CopyLanes(in->noisePrev, magnLen, streams, lanes, numLanes, out->noisePrev);
+    CopyLanes(in->magnPrevAnalyze, magnLen, streams, lanes, numLanes, out->magnPrevAnalyze);
+    CopyLanes(in->magnPrevProcess, magnLen, streams, lanes, numLanes, out->magnPrevProcess);
+    CopyLanes(in->logLrtTimeAvg, magnLen, streams, lanes, numLanes, out->logLrtTimeAvg);
+    CopyLanes(in->magnAvgPause, magnLen, streams, lanes, numLanes, out->magnAvgPause);
+    CopyLanes(in->initMagnEst, magnLen, streams, lanes, numLanes, out->initMagnEst);
+    CopyLanes(in->speechProb, magnLen, streams, lanes, numLanes, out->speechProb);
+}
+
+// Windows and transforms the new analysis block of every stream, the same as
+// the FFT of noise_suppression.c.
+static void ComputeSpectra(NsLockstep *self, const int16_t *const *inFrames)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    float winData[ANAL_BLOCKL_MAX];
+    size_t i, l;
+
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        const size_t history = ns->anaLen - ns->blockLen;
+        float energy = 0.f;
+
+        memmove(ns->analyzeBuf, ns->analyzeBuf + ns->blockLen, sizeof(float) * history);
+        for (i = 0; i < ns->blockLen; i++)
+        {
+            ns->analyzeBuf[history + i] = inFrames[l][i];
+        }
+        for (i = 0; i < ns->anaLen; i++)
+        {
+            winData[i] = ns->window[i] * ns->analyzeBuf[i];
+            energy += winData[i] * winData[i];
+        }
+        self->energy[l] = energy;
+        if (energy == 0.0)
+        {
+            // The stream keeps its state, see WebRtcNsLs_Process().
+            memset(winData, 0, sizeof(float) * ns->anaLen);
+        }
+        else
+        {
+            WebRtcNs_Rdft(ns->anaLen, 1, winData, ns->ip, ns->wfft);
+        }
+        self->real[l] = winData[0];
+        self->imag[l] = 0;
+        self->real[(magnLen - 1) * streams + l] = winData[1];
+        self->imag[(magnLen - 1) * streams + l] = 0;
+        for (i = 1; i < magnLen - 1; i++)
+        {
+            self->real[i * streams + l] = winData[2 * i];
+            self->imag[i * streams + l] = winData[2 * i + 1];
+        }
+    }
+
+    for (l = 0; l < streams; l++)
+    {
+        const size_t last = (magnLen - 1) * streams + l;
+        const float first = self->real[l] * self->real[l] + self->imag[l] * self->imag[l];
+        const float lastEnergy = self->real[last] * self->real[last] +
+                                 self->imag[last] * self->imag[last];
+
+        self->magn[l] = fabsf(self->real[l]) + 1.f;
+        self->magn[last] = fabsf(self->real[last]) + 1.f;
+        self->signalEnergy[l] = first + lastEnergy;
+        self->sumMagn[l] = sqrtf(first) + 2.f + sqrtf(lastEnergy);
+        self->lmagn[l] = logf(self->magn[l]);
+        self->lmagn[last] = logf(self->magn[last]);
+    }
+    for (i = 1; i < magnLen - 1; i++)
+    {
+        const float *real = &self->real[i * streams];
+        const float *imag = &self->imag[i * streams];
+        float *magn = &self->magn[i * streams];
+        float *lmagn = &self->lmagn[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float energy = real[l] * real[l] + imag[l] * imag[l];
+            self->signalEnergy[l] += energy;
+            magn[l] = sqrtf(energy) + 1.f;
+            self->sumMagn[l] += magn[l];
+        }
+        for (l = 0; l < streams; l++)
+        {
+            lmagn[l] = logf(magn[l]);
+        }
+    }
+}
+
+// Quantile noise estimate of every stream into self->noise.
+static void NoiseEstimation(NsLockstep *self)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    float counter[NS_LS_MAX_STREAMS], normCounterWeight[NS_LS_MAX_STREAMS];
+    size_t i, s, l;
+
+    for (l = 0; l < streams; l++)
+    {
+        if (!self->silent[l] && self->ns[l]->updates < END_STARTUP_LONG)
+        {
+            self->ns[l]->updates++;
+        }
+    }
+
+    for (s = 0; s < SIMULT; s++)
+    {
+        for (l = 0; l < streams; l++)
+        {
+            counter[l] = (float) self->ns[l]->counter[s];
+            normCounterWeight[l] = 1.f / (self->ns[l]->counter[s] + 1);
+        }
+        for (i = 0; i < magnLen; i++)
+        {
+            const float *lmagn = &self->lmagn[i * streams];
+            float *lquantile = &self->bins.lquantile[(s * magnLen + i) * streams];
+            float *density = &self->bins.density[(s * magnLen + i) * streams];
+
+            for (l = 0; l < streams; l++)
+            {
+                // Branch free, so the streams of a bin update as one vector.
+                const float delta = FACTOR / (density[l] > 1.f ? density[l] : 1.f);
+                const float step = lmagn[l] > lquantile[l] ? QUANTILE : -(1.f - QUANTILE);
+                const float updated = lquantile[l] + step * delta * normCounterWeight[l];
+                const float updatedDensity = (counter[l] * density[l] + 1.f / (2.f * WIDTH)) *
+                                             normCounterWeight[l];
+
+                lquantile[l] = updated;
+                density[l] = fabsf(lmagn[l] - updated) < WIDTH ? updatedDensity : density[l];
+            }
+        }
+    }
+
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+
+        if (self->silent[l])
+        {
+            continue;
+        }
+        for (s = 0; s < SIMULT; s++)
+        {
+            if (ns->counter[s] >= END_STARTUP_LONG)
+            {
+                ns->counter[s] = 0;
+                if (ns->updates >= END_STARTUP_LONG)
+                {
+                    ExpQuantile(self, s, l);
+                }
+            }
+            ns->counter[s]++;
+        }
+        // Sequentially update the noise during startup, from the last estimate.
+        if (ns->updates < END_STARTUP_LONG)
+        {
+            ExpQuantile(self, SIMULT - 1, l);
+        }
+    }
+    memcpy(self->noise, self->bins.quantile, sizeof(float) * magnLen * streams);
+}
+
+// Spectral flatness and spectral difference features of every stream.
+static void ComputeFeatures(NsLockstep *self)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    const float normMagnLen = self->ns[0]->normMagnLen;
+    float flatnessNum[NS_LS_MAX_STREAMS], flatnessDen[NS_LS_MAX_STREAMS];
+    int zeroBin[NS_LS_MAX_STREAMS];
+    float avgPause[NS_LS_MAX_STREAMS], avgMagn[NS_LS_MAX_STREAMS];
+    float covMagnPause[NS_LS_MAX_STREAMS], varPause[NS_LS_MAX_STREAMS], varMagn[NS_LS_MAX_STREAMS];
+    size_t i, l;
+
+    // Log of the ratio of the geometric to the arithmetic mean, without the
+    // first bin.
+    for (l = 0; l < streams; l++)
+    {
+        flatnessNum[l] = 0.0;
+        flatnessDen[l] = self->ns[l]->sumMagn - self->magn[l];
+        zeroBin[l] = 0;
+        avgPause[l] = 0.0;
+    }
+    for (i = 1; i < magnLen; i++)
+    {
+        const float *magn = &self->magn[i * streams];
+        const float *lmagn = &self->lmagn[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            flatnessNum[l] += magn[l] > 0.f ? lmagn[l] : 0.f;
+            zeroBin[l] |= !(magn[l] > 0.f);
+        }
+    }
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        float spectralTmp;
+
+        if (self->silent[l])
+        {
+            continue;
+        }
+        if (zeroBin[l])
+        {
+            ns->featureData[0] -= SPECT_FL_TAVG * ns->featureData[0];
+            continue;
+        }
+        flatnessDen[l] = flatnessDen[l] * normMagnLen;
+        flatnessNum[l] = flatnessNum[l] * normMagnLen;
+        spectralTmp = expf(flatnessNum[l]);
+        spectralTmp /= flatnessDen[l];
+        ns->featureData[0] += SPECT_FL_TAVG * (spectralTmp - ns->featureData[0]);
+    }
+
+    // Difference of the spectrum to the conservative noise spectrum.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *magnAvgPause = &self->bins.magnAvgPause[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            avgPause[l] += magnAvgPause[l];
+        }
+    }
+    for (l = 0; l < streams; l++)
+    {
+        avgPause[l] *= normMagnLen;
+        avgMagn[l] = self->ns[l]->sumMagn * normMagnLen;
+        covMagnPause[l] = 0.0;
+        varPause[l] = 0.0;
+        varMagn[l] = 0.0;
+    }
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *magnAvgPause = &self->bins.magnAvgPause[i * streams];
+        const float *magn = &self->magn[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float avgPauseDiff = magnAvgPause[l] - avgPause[l];
+            const float avgMagnDiff = magn[l] - avgMagn[l];
+            covMagnPause[l] += avgMagnDiff * avgPauseDiff;
+            varPause[l] += avgPauseDiff * avgPauseDiff;
+            varMagn[l] += avgMagnDiff * avgMagnDiff;
+        }
+    }
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        float avgDiffNormMagn;
+
+        if (self->silent[l])
+        {
+            continue;
+        }
+        covMagnPause[l] *= normMagnLen;
+        varPause[l] *= normMagnLen;
+        varMagn[l] *= normMagnLen;
+        ns->featureData[6] += ns->signalEnergy;
+        avgDiffNormMagn = varMagn[l] - (covMagnPause[l] * covMagnPause[l]) / (varPause[l] + 0.0001f);
+        avgDiffNormMagn = avgDiffNormMagn / (ns->featureData[5] + 0.0001f);
+        ns->featureData[4] += SPECT_DIFF_TAVG * (avgDiffNormMagn - ns->featureData[4]);
+    }
+}
+
+// The analysis of noise_suppression.c for every stream.
+static void Analyze(NsLockstep *self)
+{
+    const size_t streams = self->streams;
+    const size_t magnLen = self->ns[0]->magnLen;
+    int updateParsFlag[NS_LS_MAX_STREAMS];
+    float logLrtTimeAvgKsum[NS_LS_MAX_STREAMS], gainPrior[NS_LS_MAX_STREAMS];
+    float gammaNoise[NS_LS_MAX_STREAMS];
+    float lmagn[HALF_ANAL_BLOCKL], noise[HALF_ANAL_BLOCKL];
+    size_t i, l;
+
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+
+        updateParsFlag[l] = ns->modelUpdatePars[0];
+        if (self->silent[l])
+        {
+            continue;
+        }
+        ns->blockInd++;
+        ns->signalEnergy = self->signalEnergy[l] * ns->normMagnLen;
+        ns->sumMagn = self->sumMagn[l];
+    }
+
+    NoiseEstimation(self);
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        const float norm = 1.0f / (ns->blockInd + 1);
+
+        if (self->silent[l])
+        {
+            continue;
+        }
+        // Simplified noise model during startup.
+        if (ns->blockInd < END_STARTUP_SHORT)
+        {
+            GatherStream(self->lmagn, magnLen, streams, l, lmagn);
+            GatherStream(self->noise, magnLen, streams, l, noise);
+            WebRtcNs_UpdateStartupNoise(ns, lmagn, ns->sumMagn, noise);
+            ScatterStream(noise, magnLen, streams, l, self->noise);
+        }
+        // Average signal energy during END_STARTUP_LONG, used to normalize
+        // the spectral difference.
+        if (ns->blockInd < END_STARTUP_LONG)
+        {
+            ns->featureData[5] *= ns->blockInd;
+            ns->featureData[5] += ns->signalEnergy;
+            ns->featureData[5] *= norm;
+        }
+    }
+
+    // Post and prior SNR.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *magn = &self->magn[i * streams];
+        const float *noiseBin = &self->noise[i * streams];
+        const float *magnPrevAnalyze = &self->bins.magnPrevAnalyze[i * streams];
+        const float *noisePrev = &self->bins.noisePrev[i * streams];
+        const float *smooth = &self->bins.smooth[i * streams];
+        float *snrLocPost = &self->snrLocPost[i * streams];
+        float *snrLocPrior = &self->snrLocPrior[i * streams];
+        float *logSnrLocPrior = &self->logSnrLocPrior[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float previousEstimateStsa = magnPrevAnalyze[l] /
+                                               (noisePrev[l] + 0.0001f) * smooth[l];
+            snrLocPost[l] = magn[l] > noiseBin[l] ? magn[l] / (noiseBin[l] + 0.0001f) - 1.f : 0.f;
+            snrLocPrior[l] = 2.f * (
+                    DD_PR_SNR * previousEstimateStsa + (1.f - DD_PR_SNR) * snrLocPost[l]);
+            logSnrLocPrior[l] = snrLocPrior[l] + 1.0f;
+        }
+        for (l = 0; l < streams; l++)
+        {
+            logSnrLocPrior[l] = logf(logSnrLocPrior[l]);
+        }
+    }
+
+    ComputeFeatures(self);
+    for (l = 0; l < streams; l++)
+    {
+        if (!self->silent[l])
+        {
+            WebRtcNs_UpdateFeatureParameters(self->ns[l], updateParsFlag[l]);
+        }
+        logLrtTimeAvgKsum[l] = 0.0;
+    }
+
+    // Speech probability from the smoothed log LR factor and the prior.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *snrLocPost = &self->snrLocPost[i * streams];
+        const float *snrLocPrior = &self->snrLocPrior[i * streams];
+        const float *logSnrLocPrior = &self->logSnrLocPrior[i * streams];
+        float *logLrtTimeAvg = &self->bins.logLrtTimeAvg[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float besselTmp = (snrLocPost[l] * snrLocPrior[l] + snrLocPrior[l]) /
+                                    (snrLocPrior[l] + 1.0001f);
+            logLrtTimeAvg[l] += LRT_TAVG * (besselTmp - logSnrLocPrior[l] - logLrtTimeAvg[l]);
+            logLrtTimeAvgKsum[l] += logLrtTimeAvg[l];
+        }
+    }
+    for (l = 0; l < streams; l++)
+    {
+        // The bins of a silent stream are put back, its gain is not used.
+        gainPrior[l] = self->silent[l] ? 1.f :
+                       WebRtcNs_UpdatePriorSpeechProb(self->ns[l], logLrtTimeAvgKsum[l]);
+        gammaNoise[l] = NOISE_UPDATE;
+    }
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *logLrtTimeAvg = &self->bins.logLrtTimeAvg[i * streams];
+        float *speechProb = &self->bins.speechProb[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            speechProb[l] = expf(-logLrtTimeAvg[l]);
+        }
+        for (l = 0; l < streams; l++)
+        {
+            speechProb[l] = 1.f / (1.f + gainPrior[l] * speechProb[l]);
+        }
+    }
+
+    // Noise update, the time constant of a bin follows the speech state of
+    // the previous bin.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *magn = &self->magn[i * streams];
+        const float *speechProb = &self->bins.speechProb[i * streams];
+        const float *noisePrev = &self->bins.noisePrev[i * streams];
+        float *magnAvgPause = &self->bins.magnAvgPause[i * streams];
+        float *noiseBin = &self->noise[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float probSpeech = speechProb[l];
+            const float probNonSpeech = 1.f - probSpeech;
+            const float gammaNoiseOld = gammaNoise[l];
+            const float noiseUpdateTmp = gammaNoiseOld * noisePrev[l] +
+                                         (1.f - gammaNoiseOld) * (probNonSpeech * magn[l] +
+                                                                  probSpeech * noisePrev[l]);
+            const float gammaNoiseTmp = probSpeech > PROB_RANGE ? SPEECH_UPDATE : NOISE_UPDATE;
+            float noiseUpdate;
+
+            magnAvgPause[l] = probSpeech < PROB_RANGE ?
+                              magnAvgPause[l] + GAMMA_PAUSE * (magn[l] - magnAvgPause[l]) :
+                              magnAvgPause[l];
+            noiseUpdate = gammaNoiseTmp * noisePrev[l] +
+                          (1.f - gammaNoiseTmp) * (probNonSpeech * magn[l] +
+                                                   probSpeech * noisePrev[l]);
+            noiseUpdate = gammaNoiseTmp == gammaNoiseOld || noiseUpdateTmp < noiseUpdate ?
+                          noiseUpdateTmp : noiseUpdate;
+            noiseBin[l] = noiseUpdate;
+            gammaNoise[l] = gammaNoiseTmp;
+        }
+    }
+
+    memcpy(self->bins.noise, self->noise, sizeof(float) * magnLen * streams);
+    memcpy(self->bins.magnPrevAnalyze, self->magn, sizeof(float) * magnLen * streams);
+}
+
+// The suppression of noise_suppression.c for every stream.
+static void Process(NsLockstep *self, int16_t *const *outFrames)
+{
+    const NoiseSuppressionC *first = self->ns[0];
+    const size_t streams = self->streams;
+    const size_t magnLen = first->magnLen;
+    const float overdrive = first->overdrive;
+    const float denoiseBound = first->denoiseBound;
+    int startup[NS_LS_MAX_STREAMS];
+    float winData[ANAL_BLOCKL_MAX];
+    size_t i, l;
+
+    // Gain of the DD based Wiener filter.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *magn = &self->magn[i * streams];
+        const float *noise = &self->bins.noise[i * streams];
+        const float *noisePrev = &self->bins.noisePrev[i * streams];
+        const float *magnPrevProcess = &self->bins.magnPrevProcess[i * streams];
+        const float *smooth = &self->bins.smooth[i * streams];
+        float *theFilter = &self->theFilter[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            const float previousEstimateStsa = magnPrevProcess[l] /
+                                               (noisePrev[l] + 0.0001f) * smooth[l];
+            const float currentEstimateStsa =
+                    magn[l] > noise[l] ? magn[l] / (noise[l] + 0.0001f) - 1.f : 0.f;
+            const float snrPrior = DD_PR_SNR * previousEstimateStsa +
+                                   (1.f - DD_PR_SNR) * currentEstimateStsa;
+            theFilter[l] = snrPrior / (overdrive + snrPrior);
+        }
+    }
+
+    // During startup the filter is weighted with the one of the initial noise
+    // model, stream by stream.
+    for (l = 0; l < streams; l++)
+    {
+        const NoiseSuppressionC *ns = self->ns[l];
+
+        startup[l] = ns->blockInd < END_STARTUP_SHORT;
+        if (!startup[l] || self->silent[l])
+        {
+            continue;
+        }
+        for (i = 0; i < magnLen; i++)
+        {
+            const size_t k = i * streams + l;
+            float theFilterTmp;
+
+            self->bins.initMagnEst[k] += self->magn[k];
+            theFilterTmp = (self->bins.initMagnEst[k] - overdrive * ns->parametricNoise[i]);
+            theFilterTmp /= (self->bins.initMagnEst[k] + 0.0001f);
+            if (theFilterTmp < denoiseBound)
+            {
+                theFilterTmp = denoiseBound;
+            }
+            if (theFilterTmp > 1.f)
+            {
+                theFilterTmp = 1.f;
+            }
+            self->theFilter[k] *= (ns->blockInd);
+            theFilterTmp *= (END_STARTUP_SHORT - ns->blockInd);
+            self->theFilter[k] += theFilterTmp;
+            self->theFilter[k] /= (END_STARTUP_SHORT);
+        }
+    }
+
+    // Flooring of the filter outside the startup, and application. A gain
+    // floored to 1 leaves the bin as it is.
+    for (i = 0; i < magnLen; i++)
+    {
+        const float *theFilter = &self->theFilter[i * streams];
+        float *smooth = &self->bins.smooth[i * streams];
+        float *real = &self->real[i * streams];
+        float *imag = &self->imag[i * streams];
+
+        for (l = 0; l < streams; l++)
+        {
+            float gain = theFilter[l];
+
+            if (!startup[l])
+            {
+                gain = gain < denoiseBound ? denoiseBound : gain;
+                gain = gain > 1.f ? 1.f : gain;
+            }
+            smooth[l] = gain;
+            real[l] *= gain;
+            imag[l] *= gain;
+        }
+    }
+    memcpy(self->bins.magnPrevProcess, self->magn, sizeof(float) * magnLen * streams);
+    memcpy(self->bins.noisePrev, self->bins.noise, sizeof(float) * magnLen * streams);
+
+    // Back to the time domain and synthesis, stream by stream.
+    for (l = 0; l < streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        const size_t history = ns->anaLen - ns->blockLen;
+        float factor = 1.f;
+
+        if (self->energy[l] != 0.0)
+        {
+            const float norm = 2.f / ns->anaLen;
+
+            winData[0] = self->real[l];
+            winData[1] = self->real[(magnLen - 1) * streams + l];
+            for (i = 1; i < magnLen - 1; i++)
+            {
+                winData[2 * i] = self->real[i * streams + l];
+                winData[2 * i + 1] = self->imag[i * streams + l];
+            }
+            WebRtcNs_Rdft(ns->anaLen, -1, winData, ns->ip, ns->wfft);
+            for (i = 0; i < ns->anaLen; i++)
+            {
+                winData[i] *= norm;
+            }
+
+            // Scale factor: only do it after END_STARTUP_LONG time.
+            if (ns->gainmap == 1 && ns->blockInd > END_STARTUP_LONG)
+            {
+                float factor1 = 1.f;
+                float factor2 = 1.f;
+                float energy2 = 0.f;
+                float gain;
+
+                for (i = 0; i < ns->anaLen; i++)
+                {
+                    energy2 += winData[i] * winData[i];
+                }
+                gain = sqrtf(energy2 / (self->energy[l] + 1.f));
+                if (gain > B_LIM)
+                {
+                    factor1 = 1.f + 1.3f * (gain - B_LIM);
+                    if (gain * factor1 > 1.f)
+                    {
+                        factor1 = 1.f / gain;
+                    }
+                }
+                if (gain < B_LIM)
+                {
+                    if (gain <= ns->denoiseBound)
+                    {
+                        gain = ns->denoiseBound;
+                    }
+                    factor2 = 1.f - 0.3f * (B_LIM - gain);
+                }
+                factor = ns->priorSpeechProb * factor1 +
+                         (1.f - ns->priorSpeechProb) * factor2;
+            }
+            for (i = 0; i < ns->anaLen; i++)
+            {
+                ns->syntBuf[i] += factor * winData[i] * ns->window[i];
+            }
+        }
+
+        // Read out the processed segment and update the synthesis buffer.
+        for (i = 0; i < ns->blockLen; i++)
+        {
+            outFrames[l][i] = SPL_SAT(32767, ns->syntBuf[ns->windShift + i], (-32768));
+        }
+        memmove(ns->syntBuf, ns->syntBuf + ns->blockLen, sizeof(float) * history);
+        memset(ns->syntBuf + history, 0, sizeof(float) * ns->blockLen);
+    }
+}
+
+NsLockstep *WebRtcNsLs_Create(size_t streams)
+{
+    size_t l;
+
+    if (streams == 0 || streams > NS_LS_MAX_STREAMS || streams % 4 != 0)
+        return NULL;
+    NsLockstep *self = (NsLockstep *) calloc(1, sizeof(NsLockstep));
+    if (self == NULL)
+        return NULL;
+    self->streams = streams;
+    for (l = 0; l < streams; l++)
+    {
+        self->ns[l] = (NoiseSuppressionC *) WebRtcNs_Create();
+        if (self->ns[l] == NULL)
+        {
+            WebRtcNsLs_Free(self);
+            return NULL;
+        }
+    }
+    return self;
+}
+
+void WebRtcNsLs_Free(NsLockstep *self)
+{
+    size_t l;
+
+    if (self == NULL)
+        return;
+    for (l = 0; l < self->streams; l++)
+    {
+        WebRtcNs_Free((NsHandle *) self->ns[l]);
+    }
+    free(self);
+}
+
+int WebRtcNsLs_Init(NsLockstep *self, uint32_t fs, int mode)
+{
+    size_t l, s;
+
+    // The engine has no upper bands.
+    if (self == NULL || fs > 16000)
+        return -1;
+    self->initFlag = 0;
+    for (l = 0; l < self->streams; l++)
+    {
+        NoiseSuppressionC *ns = self->ns[l];
+        size_t magnLen;
+
+        if (WebRtcNs_InitCore(ns, fs) != 0 || WebRtcNs_set_policy_core(ns, mode) != 0)
+            return -1;
+        magnLen = ns->magnLen;
+        // Start from the per-bin state of the instance.
+        for (s = 0; s < SIMULT; s++)
+        {
+            ScatterStream(&ns->lquantile[s * magnLen], magnLen, self->streams, l,
+                          &self->bins.lquantile[s * magnLen * self->streams]);
+            ScatterStream(&ns->density[s * magnLen], magnLen, self->streams, l,
+                          &self->bins.density[s * magnLen * self->streams]);
+        }
+        ScatterStream(ns->quantile, magnLen, self->streams, l, self->bins.quantile);
+        ScatterStream(ns->smooth, magnLen, self->streams, l, self->bins.smooth);
+        ScatterStream(ns->noise, magnLen, self->streams, l, self->bins.noise);
+        ScatterStream(ns->noisePrev, magnLen, self->streams, l, self->bins.noisePrev);
+        ScatterStream(ns->magnPrevAnalyze, magnLen, self->streams, l, self->bins.magnPrevAnalyze);
+        ScatterStream(ns->magnPrevProcess, magnLen, self->streams, l, self->bins.magnPrevProcess);
+        ScatterStream(ns->logLrtTimeAvg, magnLen, self->streams, l, self->bins.logLrtTimeAvg);
+        ScatterStream(ns->magnAvgPause, magnLen, self->streams, l, self->bins.magnAvgPause);
+        ScatterStream(ns->initMagnEst, magnLen, self->streams, l, self->bins.initMagnEst);
+        ScatterStream(ns->speechProb, magnLen, self->streams, l, self->bins.speechProb);
+    }
+    self->initFlag = 1;
+    return 0;
+}
+
+int WebRtcNsLs_Process(NsLockstep *self,
+                       const int16_t *const *inFrames,
+                       int16_t *const *outFrames)
+{
+    size_t l;
+
+    if (self == NULL || inFrames == NULL || outFrames == NULL || !self->initFlag)
+        return -1;
+
+    ComputeSpectra(self, inFrames);
+    // A stream whose analysis block is all zeros keeps its noise estimate and
+    // filter. All streams run the vector loops of the frame, the frame level
+    // updates of the silent ones are skipped and their bins are put back
+    // afterwards.
+    self->numSilent = 0;
+    for (l = 0; l < self->streams; l++)
+    {
+        self->silent[l] = self->energy[l] == 0.0;
+        if (self->silent[l])
+        {
+            self->silentLanes[self->numSilent++] = l;
+        }
+    }
+    if (self->numSilent > 0)
+    {
+        CopySilentBins(self, &self->bins, &self->savedBins);
+    }
+
+    Analyze(self);
+    Process(self, outFrames);
+
+    if (self->numSilent > 0)
+    {
+        CopySilentBins(self, &self->savedBins, &self->bins);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Stream-parallel noise suppression engine.
+ *
+ * Runs the noise suppression of several mono streams at the same sampling
+ * frequency in lockstep. The per-bin state of all streams is stored bin by
+ * bin with the streams side by side, so every per-bin loop of the analysis and
+ * the suppression runs across the streams, one vector lane per stream, and
+ * the branches of the per-bin code become per-lane selects. The frame level
+ * state of each stream stays in its own NoiseSuppressionC.
+ *
+ * The output of every stream is bit exact with WebRtcNs_AnalyzeProcess() on a
+ * separate instance, also when some streams are digital silence. The fast
+ * math mode of WebRtcNs_set_fast_math() is not supported.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_LOCKSTEP_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_LOCKSTEP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NS_LS_MAX_STREAMS   16
+
+typedef struct NsLockstepT NsLockstep;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * This function creates a lockstep engine.
+ *
+ * Input:
+ *      - streams       : Number of streams, 4, 8, 12 or 16
+ *
+ * Return value         : Pointer to the new engine
+ *                        NULL - Error
+ */
+NsLockstep *WebRtcNsLs_Create(size_t streams);
+
+/*
+ * This function frees the engine.
+ *
+ * Input:
+ *      - self          : Pointer to the engine that should be freed
+ */
+void WebRtcNsLs_Free(NsLockstep *self);
+
+/*
+ * This function initializes all streams. It has to be called before any
+ * processing is made.
+ *
+ * Input:
+ *      - self          : Engine that should be initialized
+ *      - fs            : Sampling frequency, 8000 or 16000
+ *      - mode          : 0: Mild, 1: Medium , 2: Aggressive, 3: Very aggressive
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNsLs_Init(NsLockstep *self, uint32_t fs, int mode);
+
+/*
+ * This function suppresses noise in one 10 ms frame of every stream.
+ *
+ * Input:
+ *      - self          : Initialized engine
+ *      - inFrames      : Input frame of each stream
+ *
+ * Output:
+ *      - outFrames     : Output frame of each stream, may be the input frame
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNsLs_Process(NsLockstep *self,
+                       const int16_t *const *inFrames,
+                       int16_t *const *outFrames);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_LOCKSTEP_H_
@@ -0,0 +1,389 @@
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+
+# include <windows.h>
+# include <process.h>
+
+// The Interlocked functions are full barriers, they stand in for every memory
+// order of the C11 atomics.
+typedef volatile LONG NsMcCounter;
+typedef CRITICAL_SECTION NsMcMutex;
+typedef CONDITION_VARIABLE NsMcCond;
+typedef HANDLE NsMcThread;
+
+# define McLoad(p, order)        ((unsigned) InterlockedCompareExchange((p), 0, 0))
+# define McStore(p, v, order)    InterlockedExchange((p), (LONG) (v))
+
+#else
+
+# include <stdatomic.h>
+# include <pthread.h>
+
+typedef atomic_uint NsMcCounter;
+typedef pthread_mutex_t NsMcMutex;
+typedef pthread_cond_t NsMcCond;
+typedef pthread_t NsMcThread;
+
+# define McLoad(p, order)        atomic_load_explicit((p), (order))
+# define McStore(p, v, order)    atomic_store_explicit((p), (v), (order))
+
+#endif
+
+#include "ns_multichannel.h"
+#include "noise_suppression.h"
+
+#define NS_MC_QUEUE_LEN     4   // blocks in flight per channel, power of 2
+#define NS_MC_CACHE_LINE    64
+#define NS_MC_SPIN_COUNT    4096    // polls of an empty queue before parking
+
+// One block of interleaved frames, input == NULL stops the worker.
+typedef struct
+{
+    const int16_t *input;
+    size_t frames;
+} NsMcJob;
+
+// Lock-free single-producer/single-consumer ring, the slots are handed over
+// by head and tail, which count modulo UINT_MAX + 1. A consumer that finds
+// the ring empty spins for a while and then parks on the condition variable;
+// the producer only takes the mutex when a consumer is parked.
+typedef struct
+{
+    _Alignas(NS_MC_CACHE_LINE) NsMcCounter head;    // written by the consumer
+    _Alignas(NS_MC_CACHE_LINE) NsMcCounter tail;    // written by the producer
+    NsMcCounter parked;                             // consumer is waiting
+    NsMcJob slots[NS_MC_QUEUE_LEN];
+    NsMcMutex lock;
+    NsMcCond wake;
+    int initialized;
+} NsMcQueue;
+
+typedef struct
+{
+    NsHandle *ns;
+    size_t channel;
+    size_t channels;
+    size_t frameLen;
+    int16_t *output;        // planar output of this channel
+    NsMcQueue jobs;         // engine -> worker
+    NsMcQueue done;         // worker -> engine
+    NsMcThread thread;
+    int started;
+} NsMcWorker;
+
+struct NsMultiChannelT
+{
+    size_t channels;
+    size_t blockFrames;
+    size_t frameLen;
+    int initFlag;
+    NsMcWorker *workers;
+};
+
+static int MutexInit(NsMcMutex *lock)
+{
+#if defined(_WIN32)
+    InitializeCriticalSection(lock);
+    return 0;
+#else
+    return pthread_mutex_init(lock, NULL) != 0 ? -1 : 0;
+#endif
+}
+
+static void MutexDestroy(NsMcMutex *lock)
+{
+#if defined(_WIN32)
+    DeleteCriticalSection(lock);
+#else
+    pthread_mutex_destroy(lock);
+#endif
+}
+
+static void MutexLock(NsMcMutex *lock)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(lock);
+#else
+    pthread_mutex_lock(lock);
+#endif
+}
+
+static void MutexUnlock(NsMcMutex *lock)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(lock);
+#else
+    pthread_mutex_unlock(lock);
+#endif
+}
+
+static int CondInit(NsMcCond *cond)
+{
+#if defined(_WIN32)
+    InitializeConditionVariable(cond);
+    return 0;
+#else
+    return pthread_cond_init(cond, NULL) != 0 ? -1 : 0;
+#endif
+}
+
+static void CondDestroy(NsMcCond *cond)
+{
+#if defined(_WIN32)
+    // Win32 condition variables hold no resources.
+    (void) cond;
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+static void CondWait(NsMcCond *cond, NsMcMutex *lock)
+{
+#if defined(_WIN32)
+    SleepConditionVariableCS(cond, lock, INFINITE);
+#else
+    pthread_cond_wait(cond, lock);
+#endif
+}
+
+static void CondSignal(NsMcCond *cond)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(cond);
+#else
+    pthread_cond_signal(cond);
+#endif
+}
+
+static int QueueInit(NsMcQueue *queue)
+{
+    McStore(&queue->head, 0, memory_order_relaxed);
+    McStore(&queue->tail, 0, memory_order_relaxed);
+    McStore(&queue->parked, 0, memory_order_relaxed);
+    if (MutexInit(&queue->lock) != 0)
+        return -1;
+    if (CondInit(&queue->wake) != 0)
+    {
+        MutexDestroy(&queue->lock);
+        return -1;
+    }
+    queue->initialized = 1;
+    return 0;
+}
+
+static void QueueDestroy(NsMcQueue *queue)
+{
+    if (!queue->initialized)
+        return;
+    CondDestroy(&queue->wake);
+    MutexDestroy(&queue->lock);
+    queue->initialized = 0;
+}
+
+static int QueuePush(NsMcQueue *queue, NsMcJob job)
+{
+    unsigned tail = McLoad(&queue->tail, memory_order_relaxed);
+    unsigned head = McLoad(&queue->head, memory_order_acquire);
+    if (tail - head == NS_MC_QUEUE_LEN)
+        return -1;
+    queue->slots[tail & (NS_MC_QUEUE_LEN - 1)] = job;
+    // Sequentially consistent with the parked flag, either the consumer sees
+    // the new tail or this sees it parked.
+    McStore(&queue->tail, tail + 1, memory_order_seq_cst);
+    if (McLoad(&queue->parked, memory_order_seq_cst))
+    {
+        MutexLock(&queue->lock);
+        CondSignal(&queue->wake);
+        MutexUnlock(&queue->lock);
+    }
+    return 0;
+}
+
+static NsMcJob QueuePop(NsMcQueue *queue)
+{
+    unsigned head = McLoad(&queue->head, memory_order_relaxed);
+    int spins = 0;
+    // Pairs with the release of the producer's tail store.
+    while (McLoad(&queue->tail, memory_order_acquire) == head)
+    {
+        if (++spins < NS_MC_SPIN_COUNT)
+            continue;
+        MutexLock(&queue->lock);
+        McStore(&queue->parked, 1, memory_order_seq_cst);
+        while (McLoad(&queue->tail, memory_order_seq_cst) == head)
+            CondWait(&queue->wake, &queue->lock);
+        McStore(&queue->parked, 0, memory_order_seq_cst);
+        MutexUnlock(&queue->lock);
+    }
+    NsMcJob job = queue->slots[head & (NS_MC_QUEUE_LEN - 1)];
+    McStore(&queue->head, head + 1, memory_order_release);
+    return job;
+}
+
+static void WorkerLoop(NsMcWorker *worker)
+{
+    for (;;)
+    {
+        NsMcJob job = QueuePop(&worker->jobs);
+        if (job.input == NULL)
+            break;
+        const size_t frameLen = worker->frameLen;
+        const size_t stride = worker->channels;
+        const int16_t *input = job.input + worker->channel;
+        int16_t *output = worker->output;
+        for (size_t k = 0; k < job.frames * frameLen; k++)
+            output[k] = input[k * stride];
+
+        const int16_t *nsIn[1] = {output};
+        int16_t *nsOut[1] = {output};
+        WebRtcNs_ProcessBatch(worker->ns, nsIn, 1, job.frames, nsOut);
+        QueuePush(&worker->done, job);
+    }
+}
+
+#if defined(_WIN32)
+static unsigned __stdcall WorkerMain(void *arg)
+{
+    WorkerLoop((NsMcWorker *) arg);
+    return 0;
+}
+#else
+static void *WorkerMain(void *arg)
+{
+    WorkerLoop((NsMcWorker *) arg);
+    return NULL;
+}
+#endif
+
+static int ThreadStart(NsMcWorker *worker)
+{
+#if defined(_WIN32)
+    uintptr_t handle = _beginthreadex(NULL, 0, WorkerMain, worker, 0, NULL);
+    if (handle == 0)
+        return -1;
+    worker->thread = (HANDLE) handle;
+    return 0;
+#else
+    return pthread_create(&worker->thread, NULL, WorkerMain, worker) != 0 ? -1 : 0;
+#endif
+}
+
+static void ThreadJoin(NsMcThread thread)
+{
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+NsMultiChannel *WebRtcNsMc_Create(size_t channels, size_t blockFrames)
+{
+    if (channels == 0 || blockFrames == 0)
+        return NULL;
+    NsMultiChannel *self = (NsMultiChannel *) calloc(1, sizeof(NsMultiChannel));
+    if (self == NULL)
+        return NULL;
+    self->channels = channels;
+    self->blockFrames = blockFrames;
+    self->workers = (NsMcWorker *) calloc(channels, sizeof(NsMcWorker));
+    if (self->workers == NULL)
+    {
+        free(self);
+        return NULL;
+    }
+    for (size_t c = 0; c < channels; c++)
+    {
+        NsMcWorker *worker = &self->workers[c];
+        worker->channel = c;
+        worker->channels = channels;
+        worker->ns = WebRtcNs_Create();
+        worker->output = (int16_t *) malloc(sizeof(int16_t) * BLOCKL_MAX * blockFrames);
+        if (worker->ns == NULL || worker->output == NULL ||
+            QueueInit(&worker->jobs) != 0 || QueueInit(&worker->done) != 0 ||
+            ThreadStart(worker) != 0)
+        {
+            WebRtcNsMc_Free(self);
+            return NULL;
+        }
+        worker->started = 1;
+    }
+    return self;
+}
+
+void WebRtcNsMc_Free(NsMultiChannel *self)
+{
+    if (self == NULL)
+        return;
+    for (size_t c = 0; c < self->channels; c++)
+    {
+        NsMcWorker *worker = &self->workers[c];
+        if (worker->started)
+        {
+            NsMcJob quit = {NULL, 0};
+            QueuePush(&worker->jobs, quit);
+            ThreadJoin(worker->thread);
+        }
+        // Also the queues of a worker whose creation failed partway.
+        QueueDestroy(&worker->jobs);
+        QueueDestroy(&worker->done);
+        if (worker->ns)
+            WebRtcNs_Free(worker->ns);
+        free(worker->output);
+    }
+    free(self->workers);
+    free(self);
+}
+
+int WebRtcNsMc_Init(NsMultiChannel *self, uint32_t fs, int mode)
+{
+    // The workers process the L band only.
+    if (self == NULL || fs > 16000)
+        return -1;
+    self->initFlag = 0;
+    self->frameLen = fs / 100;
+    // The workers are parked, the next job hand-off publishes the new state.
+    for (size_t c = 0; c < self->channels; c++)
+    {
+        NsMcWorker *worker = &self->workers[c];
+        if (WebRtcNs_Init(worker->ns, fs) != 0)
+            return -1;
+        if (WebRtcNs_set_policy(worker->ns, mode) != 0)
+            return -1;
+        worker->frameLen = self->frameLen;
+    }
+    self->initFlag = 1;
+    return 0;
+}
+
+int WebRtcNsMc_Process(NsMultiChannel *self, int16_t *buffer, size_t frames)
+{
+    if (self == NULL || buffer == NULL || !self->initFlag)
+        return -1;
+    if (frames > self->blockFrames)
+        return -1;
+    if (frames == 0)
+        return 0;
+
+    NsMcJob job = {buffer, frames};
+    for (size_t c = 0; c < self->channels; c++)
+        QueuePush(&self->workers[c].jobs, job);
+    // Rejoin at the block boundary, every channel has consumed the input
+    // before it is overwritten.
+    for (size_t c = 0; c < self->channels; c++)
+        QueuePop(&self->workers[c].done);
+
+    const size_t channels = self->channels;
+    const size_t samples = frames * self->frameLen;
+    for (size_t c = 0; c < channels; c++)
+    {
+        const int16_t *output = self->workers[c].output;
+        for (size_t k = 0; k < samples; k++)
+            buffer[k * channels + c] = output[k];
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Multichannel noise suppression engine.
+ *
+ * Every channel owns one NsHandle which lives on its own worker thread. The
+ * caller hands interleaved blocks of whole 10 ms frames to the engine; each
+ * block is published to the workers through lock-free single-producer /
+ * single-consumer queues and all workers rejoin before the call returns, so
+ * the output order is the same as with a single thread.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_MULTICHANNEL_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_MULTICHANNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct NsMultiChannelT NsMultiChannel;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * This function creates a multichannel engine with one noise suppression
+ * instance and one worker thread per channel.
+ *
+ * Input:
+ *      - channels      : Number of interleaved channels
+ *      - blockFrames   : Maximum number of 10 ms frames per call to
+ *                        WebRtcNsMc_Process()
+ *
+ * Return value         : Pointer to the new engine
+ *                        NULL - Error
+ */
+NsMultiChannel *WebRtcNsMc_Create(size_t channels, size_t blockFrames);
+
+/*
+ * This function stops the worker threads and frees the engine.
+ *
+ * Input:
+ *      - self          : Pointer to the engine that should be freed
+ */
+void WebRtcNsMc_Free(NsMultiChannel *self);
+
+/*
+ * This function initializes the instances of all channels. It has to be
+ * called before any processing is made.
+ *
+ * Input:
+ *      - self          : Engine that should be initialized
+ *      - fs            : Sampling frequency, 8000 or 16000
+ *      - mode          : 0: Mild, 1: Medium , 2: Aggressive, 3: Very aggressive
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNsMc_Init(NsMultiChannel *self, uint32_t fs, int mode);
+
+/*
+ * This function runs noise suppression on a block of interleaved 10 ms
+ * frames, all channels in parallel.
+ *
+ * Input:
+ *      - self          : Initialized engine
+ *      - buffer        : Interleaved samples, frames * channels * 10 ms
+ *      - frames        : Number of 10 ms frames, at most blockFrames
+ *
+ * Output:
+ *      - buffer        : Noise suppressed samples, same layout
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNsMc_Process(NsMultiChannel *self, int16_t *buffer, size_t frames);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_MULTICHANNEL_H_
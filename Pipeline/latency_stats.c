@@ -0,0 +1,159 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "latency_stats.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+
+# include <windows.h>
+
+#elif defined(__APPLE__)
+
+# include <mach/mach_time.h>
+
+#else
+
+# include <time.h>
+
+#endif
+
+#define LATENCY_SUB_BITS    4                           // 16 buckets per octave
+#define LATENCY_SUB_COUNT   (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_EXP     40                          // 2^40 ns, about 18 minutes
+#define LATENCY_BUCKETS     ((LATENCY_MAX_EXP - LATENCY_SUB_BITS + 2) * LATENCY_SUB_COUNT)
+
+struct LatencyHistogramT
+{
+    atomic_uint_least64_t buckets[LATENCY_BUCKETS];
+    atomic_uint_least64_t totalNs;
+    atomic_uint_least64_t maxNs;
+};
+
+uint64_t WebRtcLatency_Now(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER t;
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&t);
+    return (uint64_t) ((double) t.QuadPart * 1e9 / (double) frequency.QuadPart);
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t frequency;
+    if (frequency.denom == 0)
+        mach_timebase_info(&frequency);
+    return mach_absolute_time() * frequency.numer / frequency.denom;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+#endif
+}
+
+static int HighestBit(uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int n = 0;
+    while (v >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+// Values below 16 ns get one bucket each, above that every octave is split
+// into LATENCY_SUB_COUNT equal buckets.
+static size_t BucketIndex(uint64_t ns)
+{
+    if (ns < LATENCY_SUB_COUNT)
+        return (size_t) ns;
+    int exp = HighestBit(ns);
+    if (exp > LATENCY_MAX_EXP)
+        return LATENCY_BUCKETS - 1;
+    size_t sub = (size_t) (ns >> (exp - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1);
+    return (size_t) (exp - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT + sub;
+}
+
+// Largest value that falls into bucket |index|.
+static uint64_t BucketUpperEdge(size_t index)
+{
+    if (index < LATENCY_SUB_COUNT)
+        return index;
+    int shift = (int) (index / LATENCY_SUB_COUNT) - 1;
+    uint64_t sub = index % LATENCY_SUB_COUNT;
+    return ((LATENCY_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+LatencyHistogram *WebRtcLatency_Create(void)
+{
+    LatencyHistogram *hist = (LatencyHistogram *) malloc(sizeof(LatencyHistogram));
+    if (hist == NULL)
+        return NULL;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++)
+        atomic_init(&hist->buckets[i], 0);
+    atomic_init(&hist->totalNs, 0);
+    atomic_init(&hist->maxNs, 0);
+    return hist;
+}
+
+void WebRtcLatency_Free(LatencyHistogram *hist)
+{
+    free(hist);
+}
+
+void WebRtcLatency_Reset(LatencyHistogram *hist)
+{
+    if (hist == NULL)
+        return;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++)
+        atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->totalNs, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->maxNs, 0, memory_order_relaxed);
+}
+
+void WebRtcLatency_Record(LatencyHistogram *hist, uint64_t ns)
+{
+    atomic_fetch_add_explicit(&hist->buckets[BucketIndex(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->totalNs, ns, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&hist->maxNs, memory_order_relaxed);
+    while (ns > max &&
+           !atomic_compare_exchange_weak_explicit(&hist->maxNs, &max, ns,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+        // |max| was reloaded, try again.
+    }
+}
+
+void WebRtcLatency_Summary(const LatencyHistogram *hist, LatencySummary *summary)
+{
+    static const double kQuantiles[4] = {0.5, 0.9, 0.99, 0.999};
+    uint64_t *targets[4] = {&summary->p50Ns, &summary->p90Ns, &summary->p99Ns, &summary->p999Ns};
+    // Work on a snapshot, the owner thread may keep recording meanwhile.
+    uint64_t counts[LATENCY_BUCKETS];
+    uint64_t count = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        counts[i] = atomic_load_explicit((atomic_uint_least64_t *) &hist->buckets[i], memory_order_relaxed);
+        count += counts[i];
+    }
+    summary->count = count;
+    summary->totalNs = atomic_load_explicit((atomic_uint_least64_t *) &hist->totalNs, memory_order_relaxed);
+    summary->maxNs = atomic_load_explicit((atomic_uint_least64_t *) &hist->maxNs, memory_order_relaxed);
+    summary->meanNs = count ? summary->totalNs / count : 0;
+
+    uint64_t seen = 0;
+    size_t q = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS && q < 4; i++)
+    {
+        seen += counts[i];
+        while (q < 4 && count > 0 && (double) seen >= kQuantiles[q] * (double) count)
+        {
+            uint64_t edge = BucketUpperEdge(i);
+            *targets[q++] = edge < summary->maxNs ? edge : summary->maxNs;
+        }
+    }
+    while (q < 4)
+        *targets[q++] = 0;
+}
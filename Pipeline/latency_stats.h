@@ -0,0 +1,94 @@
+/*
+ * Per-frame latency histograms.
+ *
+ * A histogram counts processing times in log-linear buckets: 16 buckets per
+ * power of two, so every recorded value is known within 1/16 (about 6 %) of
+ * its true value from 1 ns up to about 18 minutes. Recording is a handful of
+ * relaxed atomic increments and never blocks, so the histograms can stay
+ * enabled in production and be read from any thread while the audio thread
+ * keeps writing to them.
+ */
+
+#ifndef WEBRTC_3A_LATENCY_STATS_H_
+#define WEBRTC_3A_LATENCY_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct LatencyHistogramT LatencyHistogram;
+
+typedef struct
+{
+    uint64_t count;         // number of recorded values
+    uint64_t totalNs;       // sum of all recorded values
+    uint64_t meanNs;
+    uint64_t p50Ns;         // percentiles, rounded up to the bucket edge
+    uint64_t p90Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+    uint64_t maxNs;         // exact
+} LatencySummary;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * This function returns a monotonic timestamp in nanoseconds, used to time
+ * the values handed to WebRtcLatency_Record().
+ */
+uint64_t WebRtcLatency_Now(void);
+
+/*
+ * This function creates an empty histogram.
+ *
+ * Return value         : Pointer to the new histogram
+ *                        NULL - Error
+ */
+LatencyHistogram *WebRtcLatency_Create(void);
+
+/*
+ * This function frees a histogram.
+ *
+ * Input:
+ *      - hist          : Pointer to the histogram that should be freed
+ */
+void WebRtcLatency_Free(LatencyHistogram *hist);
+
+/*
+ * This function clears all counters of a histogram. It is not atomic with
+ * respect to a concurrent WebRtcLatency_Record(), values recorded meanwhile
+ * may be partly kept.
+ *
+ * Input:
+ *      - hist          : Histogram that should be cleared
+ */
+void WebRtcLatency_Reset(LatencyHistogram *hist);
+
+/*
+ * This function adds one value to a histogram. It is lock-free and meant to
+ * be called by the single thread that owns the timed stage.
+ *
+ * Input:
+ *      - hist          : Histogram
+ *      - ns            : Duration in nanoseconds
+ */
+void WebRtcLatency_Record(LatencyHistogram *hist, uint64_t ns);
+
+/*
+ * This function computes the summary of a histogram. It may be called from
+ * any thread, while values are being recorded.
+ *
+ * Input:
+ *      - hist          : Histogram
+ *
+ * Output:
+ *      - summary       : Count, mean, percentiles and maximum
+ */
+void WebRtcLatency_Summary(const LatencyHistogram *hist, LatencySummary *summary);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_3A_LATENCY_STATS_H_
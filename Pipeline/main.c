@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DR_WAV_IMPLEMENTATION
+
+#include "dr_wav.h"
+
+#include "pipeline.h"
+
+#ifndef nullptr
+#define nullptr 0
+#endif
+
+// 每次读写的 10ms 帧数, 内存占用与文件长度无关
+#define BLOCK_FRAMES 50
+
+//打开wav文件用于流式写入
+int wavOpenWrite(drwav *pWav, const char *filename, uint32_t sampleRate)
+{
+    drwav_data_format format;
+    format.container = drwav_container_riff;
+    format.format = DR_WAVE_FORMAT_PCM;
+    format.channels = 1;
+    format.sampleRate = (drwav_uint32) sampleRate;
+    format.bitsPerSample = 16;
+
+    if (!drwav_init_file_write(pWav, filename, &format))
+    {
+        fprintf(stderr, "write file [%s] error.\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+//打开wav文件用于流式读取,仅仅处理单通道音频
+int wavOpenRead(drwav *pWav, const char *filename)
+{
+    if (!drwav_init_file(pWav, filename))
+    {
+        fprintf(stderr, "read file [%s] error.\n", filename);
+        return -1;
+    }
+    if (pWav->channels != 1)
+    {
+        fprintf(stderr, "file [%s] is not mono.\n", filename);
+        drwav_uninit(pWav);
+        return -1;
+    }
+    return 0;
+}
+
+//分割路径函数
+void splitpath(const char *path, char *drv, char *dir, char *name, char *ext)
+{
+    const char *end;
+    const char *p;
+    const char *s;
+    if (path[0] && path[1] == ':')
+    {
+        if (drv)
+        {
+            *drv++ = *path++;
+            *drv++ = *path++;
+            *drv = '\0';
+        }
+    }
+    else if (drv)
+        *drv = '\0';
+    for (end = path; *end && *end != ':';)
+        end++;
+    for (p = end; p > path && *--p != '\\' && *p != '/';)
+        if (*p == '.')
+        {
+            end = p;
+            break;
+        }
+    if (ext)
+        for (s = end; (*ext = *s++);)
+            ext++;
+    for (p = end; p > path;)
+        if (*--p == '\\' || *p == '/')
+        {
+            p++;
+            break;
+        }
+    if (name)
+    {
+        for (s = p; s < end;)
+            *name++ = *s++;
+        *name = '\0';
+    }
+    if (dir)
+    {
+        for (s = path; s < p;)
+            *dir++ = *s++;
+        *dir = '\0';
+    }
+}
+
+//打印各模块每帧耗时分布 (us)
+void printStats(const PipelineHandle *pipeline)
+{
+    PipelineStats stats;
+    if (WebRtcPipeline_GetStats(pipeline, &stats) != 0)
+        return;
+    printf("%-12s %8s %9s %9s %9s %9s %9s %9s\n", "stage", "frames", "mean", "p50", "p90", "p99",
+           "p99.9", "max");
+    for (int i = 0; i < kPipelineNumStages; i++)
+    {
+        const LatencySummary *s = &stats.stage[i];
+        if (s->count == 0)
+            continue;
+        printf("%-12s %8llu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n", WebRtcPipeline_StageName(i),
+               (unsigned long long) s->count, s->meanNs / 1e3, s->p50Ns / 1e3, s->p90Ns / 1e3,
+               s->p99Ns / 1e3, s->p999Ns / 1e3, s->maxNs / 1e3);
+    }
+    printf("time interval: %d ms, real time factor: %.4f\n",
+           (int) (stats.stage[kPipelineStageFrame].totalNs / 1000000), stats.realTimeFactor);
+}
+
+int pipelineProcess(drwav *far_reader, drwav *near_reader, drwav *writer)
+{
+    if (near_reader == nullptr || writer == nullptr) return -1;
+    uint32_t sampleRate = near_reader->sampleRate;
+    PipelineConfig config;
+    WebRtcPipeline_DefaultConfig(&config);
+    // 没有远端参考信号时关闭回声消除
+    if (far_reader == nullptr)
+        config.aecmEnable = kPipelineFalse;
+    config.aecmConfig.echoMode = 1;// 0, 1, 2, 3 (default), 4
+
+    PipelineHandle *pipeline = WebRtcPipeline_Create();
+    if (pipeline == NULL) return -1;
+    if (WebRtcPipeline_Init(pipeline, sampleRate, &config) != 0)
+    {
+        printf("WebRtcPipeline_Init fail\n");
+        WebRtcPipeline_Free(pipeline);
+        return -1;
+    }
+    size_t samples = WebRtcPipeline_frame_length(pipeline);
+    size_t blockSamples = samples * BLOCK_FRAMES;
+    int16_t *near_block = (int16_t *) malloc(blockSamples * sizeof(int16_t));
+    int16_t *far_block = (int16_t *) malloc(blockSamples * sizeof(int16_t));
+    if (near_block == NULL || far_block == NULL)
+    {
+        if (near_block) free(near_block);
+        if (far_block) free(far_block);
+        WebRtcPipeline_Free(pipeline);
+        return -1;
+    }
+    int ret = 1;
+    uint64_t nTotal = 0;
+    uint64_t activeFrames = 0;
+    uint64_t samplesRead;
+    while (ret > 0 && (samplesRead = drwav_read_pcm_frames_s16(near_reader, blockSamples, near_block)) > 0)
+    {
+        int16_t *far_input = nullptr;
+        if (far_reader)
+        {
+            // 远端信号较短时以静音补齐
+            uint64_t farRead = drwav_read_pcm_frames_s16(far_reader, samplesRead, far_block);
+            if (farRead < samplesRead)
+                memset(far_block + farRead, 0, (samplesRead - farRead) * sizeof(int16_t));
+            far_input = far_block;
+        }
+        // 不足 10ms 的尾部数据原样输出
+        size_t nFrames = samplesRead / samples;
+        int16_t *near_input = near_block;
+        for (size_t i = 0; i < nFrames; i++)
+        {
+            int vadFlag = 0;
+            if (WebRtcPipeline_Process(pipeline, far_input, near_input, near_input, &vadFlag) != 0)
+            {
+                printf("failed in WebRtcPipeline_Process\n");
+                ret = -1;
+                break;
+            }
+            if (vadFlag == 1)
+                activeFrames++;
+            near_input += samples;
+            if (far_input)
+                far_input += samples;
+        }
+        nTotal += nFrames;
+        if (ret > 0 && drwav_write_pcm_frames(writer, samplesRead, near_block) != samplesRead)
+        {
+            fprintf(stderr, "write error.\n");
+            ret = -1;
+        }
+    }
+    if (nTotal > 0)
+    {
+        printf("frames: %llu, voice frames: %llu\n", (unsigned long long) nTotal,
+               (unsigned long long) activeFrames);
+        printStats(pipeline);
+    }
+    WebRtcPipeline_Free(pipeline);
+    free(near_block);
+    free(far_block);
+    return ret;
+}
+
+void pipeline(char *near_file, char *far_file, char *out_file)
+{
+    drwav near_reader;
+    drwav far_reader;
+    drwav writer;
+    //按块读取, 避免整个文件载入内存
+    if (wavOpenRead(&near_reader, near_file) != 0)
+        return;
+    if (far_file)
+    {
+        if (wavOpenRead(&far_reader, far_file) != 0)
+        {
+            drwav_uninit(&near_reader);
+            return;
+        }
+        if (far_reader.sampleRate != near_reader.sampleRate)
+        {
+            fprintf(stderr, "sample rate of [%s] and [%s] differs.\n", near_file, far_file);
+            drwav_uninit(&near_reader);
+            drwav_uninit(&far_reader);
+            return;
+        }
+    }
+    if (wavOpenWrite(&writer, out_file, near_reader.sampleRate) == 0)
+    {
+        pipelineProcess(far_file ? &far_reader : nullptr, &near_reader, &writer);
+        drwav_uninit(&writer);
+    }
+    drwav_uninit(&near_reader);
+    if (far_file)
+        drwav_uninit(&far_reader);
+}
+
+int main(int argc, char *argv[])
+{
+    printf("WebRTC 3A Pipeline (AECM + NS + VAD + AGC)\n");
+    printf("usage : pipeline near_file.wav [far_file.wav]\n");
+    if (argc < 2)
+        return -1;
+    // mixed file
+    char *near_file = argv[1];
+    // echo file
+    char *far_file = argc > 2 ? argv[2] : nullptr;
+    char drive[3];
+    char dir[256];
+    char fname[256];
+    char ext[256];
+    char out_file[1024];
+    splitpath(near_file, drive, dir, fname, ext);
+    sprintf(out_file, "%s%s%s_out%s", drive, dir, fname, ext);
+    pipeline(near_file, far_file, out_file);
+
+    printf("press any key to exit. \n");
+    getchar();
+    return 0;
+}
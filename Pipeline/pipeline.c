@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+#include "../NS/noise_suppression.h"
+#include "../VAD/vad.h"
+
+#define kPipelineInitCheck 42
+
+struct PipelineHandleT
+{
+    uint32_t fs;
+    size_t frameLen;
+    PipelineConfig config;
+    int initFlag;
+
+    void *aecm;
+    NsHandle *ns;
+    VadInst *vad;
+    void *agc;
+
+    LatencyHistogram *latency[kPipelineNumStages];
+
+    // Shared frame buffers, reused for every 10 ms frame.
+    int16_t nearFrame[PIPELINE_FRAME_LEN_MAX];
+    int16_t cleanFrame[PIPELINE_FRAME_LEN_MAX];
+    int16_t outFrame[PIPELINE_FRAME_LEN_MAX];
+};
+
+void WebRtcPipeline_DefaultConfig(PipelineConfig *config)
+{
+    config->aecmEnable = kPipelineTrue;
+    config->aecmConfig.cngMode = AecmTrue;
+    config->aecmConfig.echoMode = 3;
+    config->msInSndCardBuf = 40;
+
+    config->nsEnable = kPipelineTrue;
+    config->nsPolicy = 1;
+
+    config->vadEnable = kPipelineTrue;
+    config->vadMode = 1;
+
+    config->agcEnable = kPipelineTrue;
+    config->agcMode = kAgcModeAdaptiveDigital;
+    config->agcConfig.targetLevelDbfs = 3;
+    config->agcConfig.compressionGaindB = 9;
+    config->agcConfig.limiterEnable = kAgcTrue;
+
+    config->statsEnable = kPipelineTrue;
+}
+
+const char *WebRtcPipeline_StageName(int stage)
+{
+    static const char *const kNames[kPipelineNumStages] = {
+            "AECM", "NS analyze", "NS process", "AGC digital", "AGC analog", "VAD", "frame"};
+    if (stage < 0 || stage >= kPipelineNumStages)
+        return "unknown";
+    return kNames[stage];
+}
+
+// Records the time since |start| into |stage| and returns the current time,
+// which is the start of the next stage.
+static uint64_t StatsMark(PipelineHandle *inst, int stage, uint64_t start)
+{
+    if (!inst->config.statsEnable)
+        return 0;
+    uint64_t now = WebRtcLatency_Now();
+    WebRtcLatency_Record(inst->latency[stage], now - start);
+    return now;
+}
+
+PipelineHandle *WebRtcPipeline_Create(void)
+{
+    PipelineHandle *self = (PipelineHandle *) calloc(1, sizeof(PipelineHandle));
+    if (self == NULL)
+        return NULL;
+
+    self->aecm = WebRtcAecm_Create();
+    self->ns = WebRtcNs_Create();
+    self->vad = WebRtcVad_Create();
+    self->agc = WebRtcAgc_Create();
+    if (self->aecm == NULL || self->ns == NULL || self->vad == NULL || self->agc == NULL)
+    {
+        WebRtcPipeline_Free(self);
+        return NULL;
+    }
+    for (int i = 0; i < kPipelineNumStages; i++)
+    {
+        self->latency[i] = WebRtcLatency_Create();
+        if (self->latency[i] == NULL)
+        {
+            WebRtcPipeline_Free(self);
+            return NULL;
+        }
+    }
+    self->initFlag = 0;
+    return self;
+}
+
+void WebRtcPipeline_Free(PipelineHandle *inst)
+{
+    if (inst == NULL)
+        return;
+    if (inst->aecm)
+        WebRtcAecm_Free(inst->aecm);
+    if (inst->ns)
+        WebRtcNs_Free(inst->ns);
+    if (inst->vad)
+        WebRtcVad_Free(inst->vad);
+    if (inst->agc)
+        WebRtcAgc_Free(inst->agc);
+    for (int i = 0; i < kPipelineNumStages; i++)
+        WebRtcLatency_Free(inst->latency[i]);
+    free(inst);
+}
+
+int WebRtcPipeline_Init(PipelineHandle *inst, uint32_t fs,
+                        const PipelineConfig *config)
+{
+    if (inst == NULL)
+        return -1;
+    // AECM is the most restrictive stage and only handles 8 and 16 kHz.
+    if (fs != 8000 && fs != 16000)
+        return -1;
+
+    inst->initFlag = 0;
+    inst->fs = fs;
+    inst->frameLen = fs / 100;
+    if (config)
+        inst->config = *config;
+    else
+        WebRtcPipeline_DefaultConfig(&inst->config);
+
+    if (inst->config.aecmEnable)
+    {
+        if (WebRtcAecm_Init(inst->aecm, (int32_t) fs) != 0)
+            return -1;
+        if (WebRtcAecm_set_config(inst->aecm, inst->config.aecmConfig) != 0)
+            return -1;
+    }
+    if (inst->config.nsEnable)
+    {
+        if (WebRtcNs_Init(inst->ns, fs) != 0)
+            return -1;
+        if (WebRtcNs_set_policy(inst->ns, inst->config.nsPolicy) != 0)
+            return -1;
+    }
+    if (inst->config.vadEnable)
+    {
+        if (WebRtcVad_Init(inst->vad) != 0)
+            return -1;
+        if (WebRtcVad_set_mode(inst->vad, inst->config.vadMode) != 0)
+            return -1;
+    }
+    if (inst->config.agcEnable)
+    {
+        if (WebRtcAgc_Init(inst->agc, 0, 255, inst->config.agcMode, fs) != 0)
+            return -1;
+        if (WebRtcAgc_set_config(inst->agc, inst->config.agcConfig) != 0)
+            return -1;
+    }
+
+    memset(inst->nearFrame, 0, sizeof(inst->nearFrame));
+    memset(inst->cleanFrame, 0, sizeof(inst->cleanFrame));
+    memset(inst->outFrame, 0, sizeof(inst->outFrame));
+    WebRtcPipeline_ResetStats(inst);
+    inst->initFlag = kPipelineInitCheck;
+    return 0;
+}
+
+size_t WebRtcPipeline_frame_length(const PipelineHandle *inst)
+{
+    if (inst == NULL || inst->initFlag != kPipelineInitCheck)
+        return 0;
+    return inst->frameLen;
+}
+
+int WebRtcPipeline_Process(PipelineHandle *inst,
+                           const int16_t *farend,
+                           const int16_t *nearend,
+                           int16_t *out,
+                           int *vadFlag)
+{
+    if (inst == NULL || nearend == NULL || out == NULL)
+        return -1;
+    if (inst->initFlag != kPipelineInitCheck)
+        return -1;
+    if (inst->config.aecmEnable && farend == NULL)
+        return -1;
+
+    const uint64_t frameStart = inst->config.statsEnable ? WebRtcLatency_Now() : 0;
+    uint64_t stageStart = frameStart;
+    const size_t frameLen = inst->frameLen;
+    // Keep a private copy of the near-end, the caller may process in place.
+    memcpy(inst->nearFrame, nearend, frameLen * sizeof(int16_t));
+    const int16_t *stageIn = inst->nearFrame;
+
+    if (inst->config.nsEnable)
+    {
+        const int16_t *nsIn[1] = {inst->nearFrame};
+        int16_t *nsOut[1] = {inst->cleanFrame};
+        WebRtcNs_Analyze(inst->ns, nsIn[0]);
+        stageStart = StatsMark(inst, kPipelineStageNsAnalyze, stageStart);
+        WebRtcNs_Process(inst->ns, nsIn, 1, nsOut);
+        stageStart = StatsMark(inst, kPipelineStageNsProcess, stageStart);
+        stageIn = inst->cleanFrame;
+    }
+
+    if (inst->config.aecmEnable)
+    {
+        if (WebRtcAecm_BufferFarend(inst->aecm, farend, frameLen) != 0)
+            return -1;
+        // The unprocessed near-end drives the echo path estimate, the noise
+        // suppressed one is what the echo is removed from.
+        if (WebRtcAecm_Process(inst->aecm, inst->nearFrame,
+                               inst->config.nsEnable ? inst->cleanFrame : NULL,
+                               inst->outFrame, frameLen,
+                               inst->config.msInSndCardBuf) != 0)
+            return -1;
+        stageStart = StatsMark(inst, kPipelineStageAecm, stageStart);
+        stageIn = inst->outFrame;
+    }
+
+    int vad = -1;
+    if (inst->config.vadEnable)
+    {
+        vad = WebRtcVad_Process(inst->vad, (int) inst->fs, stageIn, frameLen, 0);
+        if (vad < 0)
+            return -1;
+        stageStart = StatsMark(inst, kPipelineStageVad, stageStart);
+    }
+
+    if (inst->config.agcEnable)
+    {
+        int32_t outMicLevel = 0;
+        uint8_t saturationWarning = 0;
+        if (WebRtcAgc_ProcessDigitalStage(inst->agc, &stageIn, 1, frameLen, &out, 0,
+                                          &outMicLevel, &saturationWarning) != 0)
+            return -1;
+        stageStart = StatsMark(inst, kPipelineStageAgcDigital, stageStart);
+        if (WebRtcAgc_ProcessAnalogStage(inst->agc, 0, &outMicLevel, 0,
+                                         &saturationWarning) != 0)
+            return -1;
+        StatsMark(inst, kPipelineStageAgcAnalog, stageStart);
+    }
+    else if (out != stageIn)
+    {
+        memcpy(out, stageIn, frameLen * sizeof(int16_t));
+    }
+
+    if (vadFlag)
+        *vadFlag = vad;
+    StatsMark(inst, kPipelineStageFrame, frameStart);
+    return 0;
+}
+
+int WebRtcPipeline_GetStats(const PipelineHandle *inst, PipelineStats *stats)
+{
+    if (inst == NULL || stats == NULL)
+        return -1;
+    for (int i = 0; i < kPipelineNumStages; i++)
+        WebRtcLatency_Summary(inst->latency[i], &stats->stage[i]);
+    const LatencySummary *frame = &stats->stage[kPipelineStageFrame];
+    stats->frames = frame->count;
+    stats->audioSeconds = inst->fs ? (double) (frame->count * inst->frameLen) / inst->fs : 0;
+    stats->realTimeFactor = stats->audioSeconds > 0 ? frame->totalNs / 1e9 / stats->audioSeconds : 0;
+    return 0;
+}
+
+void WebRtcPipeline_ResetStats(PipelineHandle *inst)
+{
+    if (inst == NULL)
+        return;
+    for (int i = 0; i < kPipelineNumStages; i++)
+        WebRtcLatency_Reset(inst->latency[i]);
+}
@@ -0,0 +1,199 @@
+/*
+ * Streaming 3A pipeline: chains the mobile echo canceller (AECM), the noise
+ * suppressor (NS), the voice activity detector (VAD) and the automatic gain
+ * control (AGC) on one 10 ms frame at a time.
+ *
+ * The stages run in the same order as the WebRTC audio processing module:
+ *
+ *      near-end -> NS analyze/process -> AECM -> VAD -> AGC -> out
+ *
+ * NS runs ahead of AECM and its output is handed to AECM as the "clean"
+ * near-end signal, while the unprocessed near-end is used as the "noisy"
+ * signal for the echo path estimation. The VAD decision is taken on the echo
+ * cancelled signal, before any gain is applied.
+ */
+
+#ifndef WEBRTC_3A_PIPELINE_H_
+#define WEBRTC_3A_PIPELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../AECM/aecm.h"
+#include "../AGC/agc.h"
+#include "latency_stats.h"
+
+#define PIPELINE_FRAME_LEN_MAX  160 // 10 ms at 16 kHz
+
+enum
+{
+    kPipelineFalse = 0,
+    kPipelineTrue
+};
+
+// Timed stages, kPipelineStageFrame covers a whole WebRtcPipeline_Process().
+enum
+{
+    kPipelineStageAecm = 0,
+    kPipelineStageNsAnalyze,
+    kPipelineStageNsProcess,
+    kPipelineStageAgcDigital,
+    kPipelineStageAgcAnalog,
+    kPipelineStageVad,
+    kPipelineStageFrame,
+    kPipelineNumStages
+};
+
+typedef struct
+{
+    int16_t aecmEnable;             // kPipelineFalse, kPipelineTrue (default)
+    AecmConfig aecmConfig;          // cngMode AecmTrue, echoMode 3 (default)
+    int16_t msInSndCardBuf;         // default 40 ms
+
+    int16_t nsEnable;               // kPipelineFalse, kPipelineTrue (default)
+    int nsPolicy;                   // 0: Mild, 1: Medium (default), 2: Aggressive
+
+    int16_t vadEnable;              // kPipelineFalse, kPipelineTrue (default)
+    int vadMode;                    // 0, 1 (default), 2, 3
+
+    int16_t agcEnable;              // kPipelineFalse, kPipelineTrue (default)
+    int16_t agcMode;                // kAgcModeAdaptiveDigital (default)
+    WebRtcAgcConfig agcConfig;      // -3 dBOv, 9 dB, limiter on (default)
+
+    int16_t statsEnable;            // kPipelineFalse, kPipelineTrue (default)
+} PipelineConfig;
+
+typedef struct
+{
+    LatencySummary stage[kPipelineNumStages];   // per frame processing time
+    uint64_t frames;                // frames processed since the last reset
+    double audioSeconds;            // duration of these frames
+    double realTimeFactor;          // processing time / audioSeconds
+} PipelineStats;
+
+typedef struct PipelineHandleT PipelineHandle;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * This function fills a configuration struct with the default settings, which
+ * enables all four stages.
+ *
+ * Output:
+ *      - config        : Default configuration
+ */
+void WebRtcPipeline_DefaultConfig(PipelineConfig *config);
+
+/*
+ * This function creates an instance of the 3A pipeline together with the
+ * instances of all its stages.
+ *
+ * Return value         : Pointer to the new instance
+ *                        NULL - Error
+ */
+PipelineHandle *WebRtcPipeline_Create(void);
+
+/*
+ * This function frees the pipeline instance and all its stages.
+ *
+ * Input:
+ *      - inst          : Pointer to the instance that should be freed
+ */
+void WebRtcPipeline_Free(PipelineHandle *inst);
+
+/*
+ * This function initializes the pipeline and every enabled stage. It has to
+ * be called before any processing is made.
+ *
+ * Input:
+ *      - inst          : Instance that should be initialized
+ *      - fs            : Sampling frequency, 8000 or 16000 Hz
+ *      - config        : Pipeline configuration, NULL for the defaults
+ *
+ * Output:
+ *      - inst          : Initialized instance
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcPipeline_Init(PipelineHandle *inst, uint32_t fs,
+                        const PipelineConfig *config);
+
+/*
+ * This function returns the number of samples in one 10 ms frame, which is
+ * the length the pipeline expects for every call to WebRtcPipeline_Process().
+ *
+ * Input:
+ *      - inst          : Initialized pipeline instance
+ *
+ * Return value         : Frame length in samples, 0 if not initialized
+ */
+size_t WebRtcPipeline_frame_length(const PipelineHandle *inst);
+
+/*
+ * This function runs one 10 ms frame through all enabled stages. All signal
+ * buffers are owned by the pipeline, so no allocation takes place here.
+ *
+ * Input:
+ *      - inst          : Pipeline instance
+ *      - farend        : Far-end (loudspeaker) frame, may be NULL when the
+ *                        AECM is disabled
+ *      - nearend       : Near-end (microphone) frame
+ *
+ * Output:
+ *      - out           : Processed frame, may be the same vector as nearend
+ *      - vadFlag       : VAD decision of the frame (1 - active voice,
+ *                        0 - non-active voice, -1 - VAD disabled),
+ *                        may be NULL
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcPipeline_Process(PipelineHandle *inst,
+                           const int16_t *farend,
+                           const int16_t *nearend,
+                           int16_t *out,
+                           int *vadFlag);
+
+/*
+ * This function returns the latency statistics of every stage since the last
+ * call to WebRtcPipeline_Init() or WebRtcPipeline_ResetStats(). It does not
+ * lock and may be called from any thread while frames are being processed.
+ * Stages which are disabled, or when statsEnable is off, report a count of 0.
+ *
+ * Input:
+ *      - inst          : Pipeline instance
+ *
+ * Output:
+ *      - stats         : Percentiles per stage and real time factor
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcPipeline_GetStats(const PipelineHandle *inst, PipelineStats *stats);
+
+/*
+ * This function clears the latency statistics of all stages.
+ *
+ * Input:
+ *      - inst          : Pipeline instance
+ */
+void WebRtcPipeline_ResetStats(PipelineHandle *inst);
+
+/*
+ * This function returns a printable name of a timed stage.
+ *
+ * Input:
+ *      - stage         : kPipelineStageAecm ... kPipelineStageFrame
+ *
+ * Return value         : Name of the stage, "unknown" if out of range
+ */
+const char *WebRtcPipeline_StageName(int stage);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // WEBRTC_3A_PIPELINE_H_
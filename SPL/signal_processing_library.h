@@ -0,0 +1,451 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This header file includes the fixed point helpers shared by AECM, AGC, VAD
+ * and CNG. The scalar helpers are inlined; the vector kernels are called
+ * through function pointers which WebRtcSpl_Init() points at the fastest
+ * version the CPU supports (SSE2, SSE4.1 or AVX2 on x86). Before
+ * WebRtcSpl_Init() has run, and on other CPUs, the portable C versions are
+ * used. All versions return bit exact results.
+ */
+
+#ifndef COMMON_AUDIO_SIGNAL_PROCESSING_INCLUDE_SIGNAL_PROCESSING_LIBRARY_H_
+#define COMMON_AUDIO_SIGNAL_PROCESSING_INCLUDE_SIGNAL_PROCESSING_LIBRARY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define WEBRTC_SPL_WORD16_MAX       32767
+#define WEBRTC_SPL_WORD16_MIN       -32768
+#define WEBRTC_SPL_WORD32_MAX       (int32_t)0x7fffffff
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU features, as returned by WebRtcSpl_CpuFeatures().
+enum
+{
+    kSplCpuSSE2 = 1 << 0,
+    kSplCpuSSE41 = 1 << 1,
+    kSplCpuAVX2 = 1 << 2,
+    kSplCpuPOPCNT = 1 << 3
+};
+
+// Returns the number of leading zero bits in the argument, 32 for 0.
+static __inline int WebRtcSpl_CountLeadingZeros32(uint32_t n)
+{
+    if (n == 0)
+        return 32;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(n);
+#elif defined(_MSC_VER)
+    {
+        unsigned long idx;
+        _BitScanReverse(&idx, n);
+        return (int) (idx ^ 31U);
+    }
+#else
+    {
+        int zeros = 0;
+        while (!(n & 0x80000000U))
+        {
+            n <<= 1;
+            zeros++;
+        }
+        return zeros;
+    }
+#endif
+}
+
+static __inline int16_t WebRtcSpl_GetSizeInBits(uint32_t n)
+{
+    return (int16_t) (32 - WebRtcSpl_CountLeadingZeros32(n));
+}
+
+// Return the number of steps a can be left-shifted without overflow,
+// or 0 if a == 0.
+static __inline int16_t WebRtcSpl_NormW32(int32_t a)
+{
+    return a == 0 ? 0 : (int16_t) (WebRtcSpl_CountLeadingZeros32(a < 0 ? ~a : a) - 1);
+}
+
+// Return the number of steps a can be left-shifted without overflow,
+// or 0 if a == 0.
+static __inline int16_t WebRtcSpl_NormU32(uint32_t a)
+{
+    return a == 0 ? 0 : (int16_t) WebRtcSpl_CountLeadingZeros32(a);
+}
+
+// Return the number of steps a can be left-shifted without overflow,
+// or 0 if a == 0.
+static __inline int16_t WebRtcSpl_NormW16(int16_t a)
+{
+    const int32_t a32 = a;
+    return a == 0 ? 0 : (int16_t) (WebRtcSpl_CountLeadingZeros32(a < 0 ? ~a32 : a32) - 17);
+}
+
+static __inline int16_t WebRtcSpl_SatW32ToW16(int32_t value32)
+{
+    int16_t out16 = (int16_t) value32;
+
+    if (value32 > 32767)
+        out16 = 32767;
+    else if (value32 < -32768)
+        out16 = -32768;
+
+    return out16;
+}
+
+static __inline int16_t WebRtcSpl_AddSatW16(int16_t a, int16_t b)
+{
+    return WebRtcSpl_SatW32ToW16((int32_t) a + (int32_t) b);
+}
+
+static __inline int32_t WebRtcSpl_AddSatW32(int32_t a, int32_t b)
+{
+    // Do the addition in unsigned numbers, since signed overflow is undefined
+    // behavior.
+    const int32_t sum = (int32_t) ((uint32_t) a + (uint32_t) b);
+
+    // a + b can't overflow if a and b have different signs. If they have the
+    // same sign, a + b also has the same sign iff it didn't overflow.
+    if ((a < 0) == (b < 0) && (a < 0) != (sum < 0))
+    {
+        // The direction of the overflow is obvious from the sign of a + b.
+        return sum < 0 ? INT32_MAX : INT32_MIN;
+    }
+    return sum;
+}
+
+static __inline int32_t WebRtcSpl_SubSatW32(int32_t a, int32_t b)
+{
+    // Do the subtraction in unsigned numbers, since signed overflow is
+    // undefined behavior.
+    const int32_t diff = (int32_t) ((uint32_t) a - (uint32_t) b);
+
+    // a - b can't overflow if a and b have the same sign. If they have
+    // different signs, a - b has the same sign as a iff it didn't overflow.
+    if ((a < 0) != (b < 0) && (a < 0) != (diff < 0))
+    {
+        // The direction of the overflow is obvious from the sign of a - b.
+        return diff < 0 ? INT32_MAX : INT32_MIN;
+    }
+    return diff;
+}
+
+// Divides a 32-bit value by a 16-bit value, 0x7FFFFFFF on division by 0.
+static __inline int32_t WebRtcSpl_DivW32W16(int32_t num, int16_t den)
+{
+    // Guard against division with 0
+    return (den != 0) ? (int32_t) (num / den) : (int32_t) 0x7FFFFFFF;
+}
+
+// Same as WebRtcSpl_DivW32W16() but with a 16-bit result, 0x7FFF on
+// division by 0.
+static __inline int16_t WebRtcSpl_DivW32W16ResW16(int32_t num, int16_t den)
+{
+    // Guard against division with 0
+    return (den != 0) ? (int16_t) (num / den) : (int16_t) 0x7FFF;
+}
+
+// Returns the CPU features, a combination of kSplCpuSSE2, kSplCpuSSE41,
+// kSplCpuAVX2 and kSplCpuPOPCNT. The result is computed once and cached.
+int WebRtcSpl_CpuFeatures(void);
+
+// Initialize the function pointers of the vector kernels to the fastest
+// version the CPU supports. Thread safe, and cheap after the first call.
+void WebRtcSpl_Init(void);
+
+// Returns the largest absolute value in a signed 16-bit vector, abs(-32768)
+// is saturated to 32767.
+//
+// Input:
+//      - vector : 16-bit input vector.
+//      - length : Number of samples in vector.
+//
+// Return value  : Maximum absolute value in vector.
+typedef int16_t (*MaxAbsValueW16)(const int16_t *vector, size_t length);
+extern MaxAbsValueW16 WebRtcSpl_MaxAbsValueW16;
+int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t *vector, size_t length);
+
+// Returns the number of right shifts needed to avoid overflow when summing
+// |times| squares of samples of |in_vector|.
+//
+// Input:
+//      - in_vector        : Input vector to check scaling on
+//      - in_vector_length : Samples in |in_vector|
+//      - times            : Number of additions to be performed
+//
+// Return value            : Number of right bit shifts needed
+typedef int16_t (*GetScalingSquare)(int16_t *in_vector,
+                                    size_t in_vector_length,
+                                    size_t times);
+extern GetScalingSquare WebRtcSpl_GetScalingSquare;
+int16_t WebRtcSpl_GetScalingSquareC(int16_t *in_vector,
+                                    size_t in_vector_length,
+                                    size_t times);
+
+// Calculates the energy of a vector, scaled down so that the sum of squares
+// does not overflow.
+//
+// Input:
+//      - vector        : Vector which the energy should be calculated on
+//      - vector_length : Number of samples in vector
+//
+// Output:
+//      - scale_factor  : Number of left bit shifts needed to get the physical
+//                        energy value, i.e, to get the Q0 value
+//
+// Return value         : Energy value in Q(-|scale_factor|)
+typedef int32_t (*EnergyW16)(int16_t *vector,
+                             size_t vector_length,
+                             int *scale_factor);
+extern EnergyW16 WebRtcSpl_Energy;
+int32_t WebRtcSpl_EnergyC(int16_t *vector,
+                          size_t vector_length,
+                          int *scale_factor);
+
+// Calculates the dot product of two vectors, every product right shifted by
+// |scaling| before it is added.
+//
+// Input:
+//      - vector1 : Vector 1
+//      - vector2 : Vector 2
+//      - length  : Number of samples used in the dot product
+//      - scaling : The number of right bit shifts to apply on each term
+//
+// Return value   : The dot product, truncated to 32 bits
+typedef int32_t (*DotProductWithScale)(const int16_t *vector1,
+                                       const int16_t *vector2,
+                                       size_t length,
+                                       int scaling);
+extern DotProductWithScale WebRtcSpl_DotProductWithScale;
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t *vector1,
+                                       const int16_t *vector2,
+                                       size_t length,
+                                       int scaling);
+
+// Saturating element-wise addition, out[i] = sat(in1[i] + in2[i]). |out| may
+// be the same vector as |in1| or |in2|.
+//
+// Input:
+//      - in1    : Vector 1
+//      - in2    : Vector 2
+//      - length : Number of samples
+//
+// Output:
+//      - out    : Sum of the two vectors
+typedef void (*AddSatVectorW16)(const int16_t *in1,
+                                const int16_t *in2,
+                                int16_t *out,
+                                size_t length);
+extern AddSatVectorW16 WebRtcSpl_AddSatVectorW16;
+void WebRtcSpl_AddSatVectorW16C(const int16_t *in1,
+                                const int16_t *in2,
+                                int16_t *out,
+                                size_t length);
+
+// Largest square of the samples of each block of a vector of consecutive
+// blocks, maxSquares[k] = max(vector[k * block_length + n]^2). -32768 gives
+// 2^30.
+//
+// Input:
+//      - vector       : 16-bit input vector of |blocks| * |block_length|
+//                       samples
+//      - block_length : Number of samples per block
+//      - blocks       : Number of blocks
+//
+// Output:
+//      - maxSquares   : Largest square of each block
+typedef void (*MaxSquareBlocksW16)(const int16_t *vector,
+                                   size_t block_length,
+                                   size_t blocks,
+                                   int32_t *maxSquares);
+extern MaxSquareBlocksW16 WebRtcSpl_MaxSquareBlocksW16;
+void WebRtcSpl_MaxSquareBlocksW16C(const int16_t *vector,
+                                   size_t block_length,
+                                   size_t blocks,
+                                   int32_t *maxSquares);
+
+// Multiplies every sample with its own gain in Q16 and saturates,
+// vector[i] = sat((vector[i] * gains[i]) >> 16) with a 64-bit product.
+//
+// Input:
+//      - vector : 16-bit vector
+//      - gains  : Gain of every sample in Q16
+//      - length : Number of samples
+//
+// Output:
+//      - vector : Scaled vector
+typedef void (*ApplyGainsW16)(int16_t *vector,
+                              const int32_t *gains,
+                              size_t length);
+extern ApplyGainsW16 WebRtcSpl_ApplyGainsW16;
+void WebRtcSpl_ApplyGainsW16C(int16_t *vector,
+                              const int32_t *gains,
+                              size_t length);
+
+// Same as WebRtcSpl_ApplyGainsW16() on |channels| interleaved channels, all
+// channels of a frame share the gain of the frame.
+//
+// Input:
+//      - vector   : Interleaved 16-bit vector, sample k of channel c at
+//                   vector[k * channels + c]
+//      - channels : Number of channels
+//      - gains    : Gain of every frame in Q16
+//      - frames   : Number of frames
+//
+// Output:
+//      - vector   : Scaled vector
+typedef void (*ApplyGainsStridedW16)(int16_t *vector,
+                                     size_t channels,
+                                     const int32_t *gains,
+                                     size_t frames);
+extern ApplyGainsStridedW16 WebRtcSpl_ApplyGainsStridedW16;
+void WebRtcSpl_ApplyGainsStridedW16C(int16_t *vector,
+                                     size_t channels,
+                                     const int32_t *gains,
+                                     size_t frames);
+
+// Mean of |channels| interleaved channels per frame,
+// mean[k] = (sum * (32768 / channels)) >> 15, exact for a power of two
+// number of channels.
+//
+// Input:
+//      - vector   : Interleaved 16-bit vector, sample k of channel c at
+//                   vector[k * channels + c]
+//      - channels : Number of channels, 1 to 32768
+//      - frames   : Number of frames
+//
+// Output:
+//      - mean     : Mean of every frame
+typedef void (*MeanChannelsW16)(const int16_t *vector,
+                                size_t channels,
+                                size_t frames,
+                                int16_t *mean);
+extern MeanChannelsW16 WebRtcSpl_MeanChannelsW16;
+void WebRtcSpl_MeanChannelsW16C(const int16_t *vector,
+                                size_t channels,
+                                size_t frames,
+                                int16_t *mean);
+
+// Band splitting, see splitting_filter.c.
+#define SPL_BAND_LENGTH_MAX         320     // samples of a band per call
+#define SPL_THREE_BAND_FILTERS      12
+#define SPL_THREE_BAND_TAPS         4
+#define SPL_THREE_BAND_STATE        15      // history of a sparse filter
+
+typedef struct
+{
+    size_t bandLength;
+    float analysisModulation[SPL_THREE_BAND_FILTERS][3];
+    float synthesisModulation[SPL_THREE_BAND_FILTERS][3];
+    float analysis[SPL_THREE_BAND_FILTERS][SPL_THREE_BAND_STATE];
+    float synthesis[SPL_THREE_BAND_FILTERS][SPL_THREE_BAND_STATE];
+} WebRtcSpl_ThreeBandState;
+
+// Filter bank of a 10 ms frame at 8, 16, 32 or 48 kHz into bands of 8 kHz
+// width, at most SPL_MAX_BANDS.
+#define SPL_MAX_BANDS               3
+
+typedef struct
+{
+    size_t numBands;
+    size_t frameLength;
+    size_t bandLength;
+    int32_t analysisState1[6];
+    int32_t analysisState2[6];
+    int32_t synthesisState1[6];
+    int32_t synthesisState2[6];
+    WebRtcSpl_ThreeBandState threeBand;
+} WebRtcSpl_BandSplitState;
+
+// Splits |in_data| into a low and a high band of half the sampling frequency
+// with the QMF. |in_data_length| is even and at most 2 * SPL_BAND_LENGTH_MAX.
+//
+// Input:
+//      - in_data       : Input signal
+//      - in_data_length: Length of the input signal
+//      - filter_state1 : All-pass state of the odd samples, 6 values
+//      - filter_state2 : All-pass state of the even samples, 6 values
+//
+// Output:
+//      - low_band      : Lower band, in_data_length / 2 samples
+//      - high_band     : Upper band, in_data_length / 2 samples
+void WebRtcSpl_AnalysisQMF(const int16_t *in_data,
+                           size_t in_data_length,
+                           int16_t *low_band,
+                           int16_t *high_band,
+                           int32_t *filter_state1,
+                           int32_t *filter_state2);
+
+// Merges the bands of WebRtcSpl_AnalysisQMF() back into one signal.
+//
+// Input:
+//      - low_band      : Lower band
+//      - high_band     : Upper band
+//      - band_length   : Length of each band, at most SPL_BAND_LENGTH_MAX
+//      - filter_state1 : All-pass state of the sum channel, 6 values
+//      - filter_state2 : All-pass state of the difference channel, 6 values
+//
+// Output:
+//      - out_data      : Output signal, 2 * band_length samples
+void WebRtcSpl_SynthesisQMF(const int16_t *low_band,
+                            const int16_t *high_band,
+                            size_t band_length,
+                            int16_t *out_data,
+                            int32_t *filter_state1,
+                            int32_t *filter_state2);
+
+// Initializes the three band filter bank for bands of |band_length| samples,
+// at most SPL_BAND_LENGTH_MAX.
+void WebRtcSpl_ThreeBandInit(WebRtcSpl_ThreeBandState *state, size_t band_length);
+
+// Splits 3 * band_length samples of |in_data| into three bands.
+void WebRtcSpl_ThreeBandAnalysis(WebRtcSpl_ThreeBandState *state,
+                                 const int16_t *in_data,
+                                 int16_t *const *bands);
+
+// Merges three bands of band_length samples into |out_data|.
+void WebRtcSpl_ThreeBandSynthesis(WebRtcSpl_ThreeBandState *state,
+                                  const int16_t *const *bands,
+                                  int16_t *out_data);
+
+// Initializes a band splitter for 10 ms frames at |fs|: one band at 8 and
+// 16 kHz, two QMF bands at 32 kHz and three bands at 48 kHz, every band of
+// 16 kHz or less.
+//
+// Return value         :  0 - Ok
+//                        -1 - Unsupported sampling frequency
+int WebRtcSpl_BandSplitInit(WebRtcSpl_BandSplitState *state, uint32_t fs);
+
+// Splits a 10 ms frame into state->numBands bands of state->bandLength
+// samples, the lowest band first.
+void WebRtcSpl_BandSplitAnalysis(WebRtcSpl_BandSplitState *state,
+                                 const int16_t *in_data,
+                                 int16_t *const *bands);
+
+// Merges the bands of a 10 ms frame, |out_data| may be the input frame.
+void WebRtcSpl_BandSplitSynthesis(WebRtcSpl_BandSplitState *state,
+                                  const int16_t *const *bands,
+                                  int16_t *out_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // COMMON_AUDIO_SIGNAL_PROCESSING_INCLUDE_SIGNAL_PROCESSING_LIBRARY_H_
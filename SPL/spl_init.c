@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * CPU feature detection and run time selection of the vector kernels.
+ */
+
+#include "spl_simd.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+
+# include <windows.h>
+
+#else
+
+# include <pthread.h>
+
+#endif
+
+#if defined(WEBRTC_SPL_X86) && !defined(_MSC_VER)
+
+# include <cpuid.h>
+
+#endif
+
+// Declare function pointers, the C versions are used until WebRtcSpl_Init().
+MaxAbsValueW16 WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16C;
+GetScalingSquare WebRtcSpl_GetScalingSquare = WebRtcSpl_GetScalingSquareC;
+EnergyW16 WebRtcSpl_Energy = WebRtcSpl_EnergyC;
+DotProductWithScale WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+AddSatVectorW16 WebRtcSpl_AddSatVectorW16 = WebRtcSpl_AddSatVectorW16C;
+MaxSquareBlocksW16 WebRtcSpl_MaxSquareBlocksW16 = WebRtcSpl_MaxSquareBlocksW16C;
+ApplyGainsW16 WebRtcSpl_ApplyGainsW16 = WebRtcSpl_ApplyGainsW16C;
+ApplyGainsStridedW16 WebRtcSpl_ApplyGainsStridedW16 = WebRtcSpl_ApplyGainsStridedW16C;
+MeanChannelsW16 WebRtcSpl_MeanChannelsW16 = WebRtcSpl_MeanChannelsW16C;
+
+#if defined(WEBRTC_SPL_X86)
+static void CpuId(int info[4], int leaf)
+{
+#if defined(_MSC_VER)
+    __cpuidex(info, leaf, 0);
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    __cpuid_count(leaf, 0, a, b, c, d);
+    info[0] = (int) a;
+    info[1] = (int) b;
+    info[2] = (int) c;
+    info[3] = (int) d;
+#endif
+}
+
+// Reads the extended control register, tells which register states the OS
+// saves on a context switch.
+static uint64_t Xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t) edx << 32) | eax;
+#endif
+}
+
+static int DetectCpuFeatures(void)
+{
+    int info[4];
+    int features = 0;
+
+    CpuId(info, 0);
+    const int maxLeaf = info[0];
+    CpuId(info, 1);
+    if (info[3] & (1 << 26))
+        features |= kSplCpuSSE2;
+    if (info[2] & (1 << 19))
+        features |= kSplCpuSSE41;
+    if (info[2] & (1 << 23))
+        features |= kSplCpuPOPCNT;
+    // AVX2 also needs the OS to save the YMM registers (OSXSAVE and XCR0).
+    if (maxLeaf >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+        (Xgetbv() & 0x6) == 0x6)
+    {
+        CpuId(info, 7);
+        if (info[1] & (1 << 5))
+            features |= kSplCpuAVX2;
+    }
+    return features;
+}
+#endif
+
+static int cpuFeatures = 0;
+
+static void InitFunctionPointers(void)
+{
+#if defined(WEBRTC_SPL_X86)
+    cpuFeatures = DetectCpuFeatures();
+    if (cpuFeatures & kSplCpuAVX2)
+    {
+        WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+        WebRtcSpl_GetScalingSquare = WebRtcSpl_GetScalingSquareAVX2;
+        WebRtcSpl_Energy = WebRtcSpl_EnergyAVX2;
+        WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleAVX2;
+        WebRtcSpl_AddSatVectorW16 = WebRtcSpl_AddSatVectorW16AVX2;
+        WebRtcSpl_MaxSquareBlocksW16 = WebRtcSpl_MaxSquareBlocksW16AVX2;
+        WebRtcSpl_ApplyGainsW16 = WebRtcSpl_ApplyGainsW16AVX2;
+        WebRtcSpl_ApplyGainsStridedW16 = WebRtcSpl_ApplyGainsStridedW16AVX2;
+        WebRtcSpl_MeanChannelsW16 = WebRtcSpl_MeanChannelsW16SSE2;
+    }
+    else if (cpuFeatures & kSplCpuSSE41)
+    {
+        WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE41;
+        WebRtcSpl_GetScalingSquare = WebRtcSpl_GetScalingSquareSSE41;
+        WebRtcSpl_Energy = WebRtcSpl_EnergySSE41;
+        WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleSSE41;
+        WebRtcSpl_AddSatVectorW16 = WebRtcSpl_AddSatVectorW16SSE2;
+        WebRtcSpl_MaxSquareBlocksW16 = WebRtcSpl_MaxSquareBlocksW16SSE41;
+        WebRtcSpl_ApplyGainsW16 = WebRtcSpl_ApplyGainsW16SSE2;
+        WebRtcSpl_ApplyGainsStridedW16 = WebRtcSpl_ApplyGainsStridedW16SSE2;
+        WebRtcSpl_MeanChannelsW16 = WebRtcSpl_MeanChannelsW16SSE2;
+    }
+    else if (cpuFeatures & kSplCpuSSE2)
+    {
+        WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+        WebRtcSpl_GetScalingSquare = WebRtcSpl_GetScalingSquareSSE2;
+        WebRtcSpl_Energy = WebRtcSpl_EnergySSE2;
+        WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleSSE2;
+        WebRtcSpl_AddSatVectorW16 = WebRtcSpl_AddSatVectorW16SSE2;
+        WebRtcSpl_MaxSquareBlocksW16 = WebRtcSpl_MaxSquareBlocksW16SSE2;
+        WebRtcSpl_ApplyGainsW16 = WebRtcSpl_ApplyGainsW16SSE2;
+        WebRtcSpl_ApplyGainsStridedW16 = WebRtcSpl_ApplyGainsStridedW16SSE2;
+        WebRtcSpl_MeanChannelsW16 = WebRtcSpl_MeanChannelsW16SSE2;
+    }
+#endif
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK InitOnce(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+    (void) once;
+    (void) param;
+    (void) context;
+    InitFunctionPointers();
+    return TRUE;
+}
+
+static void once(void)
+{
+    static INIT_ONCE lock = INIT_ONCE_STATIC_INIT;
+    InitOnceExecuteOnce(&lock, InitOnce, NULL, NULL);
+}
+#else
+static void once(void)
+{
+    static pthread_once_t lock = PTHREAD_ONCE_INIT;
+    pthread_once(&lock, InitFunctionPointers);
+}
+#endif
+
+int WebRtcSpl_CpuFeatures(void)
+{
+    once();
+    return cpuFeatures;
+}
+
+void WebRtcSpl_Init(void)
+{
+    once();
+}
@@ -0,0 +1,97 @@
+/*
+ * Internal declarations of the SPL vector kernels, shared by the C and the
+ * x86 SIMD implementations. Not to be included by the modules.
+ */
+
+#ifndef COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
+#define COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
+
+#include "signal_processing_library.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Turns the largest absolute sample value found by a GetScalingSquare
+// version into its number of right shifts.
+int16_t WebRtcSpl_ScalingFromMaxAbs(int16_t smax, size_t times);
+
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t *vector, size_t length);
+int16_t WebRtcSpl_GetScalingSquareSSE2(int16_t *in_vector,
+                                       size_t in_vector_length,
+                                       size_t times);
+int32_t WebRtcSpl_EnergySSE2(int16_t *vector,
+                             size_t vector_length,
+                             int *scale_factor);
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t *vector1,
+                                          const int16_t *vector2,
+                                          size_t length,
+                                          int scaling);
+void WebRtcSpl_AddSatVectorW16SSE2(const int16_t *in1,
+                                   const int16_t *in2,
+                                   int16_t *out,
+                                   size_t length);
+void WebRtcSpl_MaxSquareBlocksW16SSE2(const int16_t *vector,
+                                      size_t block_length,
+                                      size_t blocks,
+                                      int32_t *maxSquares);
+void WebRtcSpl_ApplyGainsW16SSE2(int16_t *vector,
+                                 const int32_t *gains,
+                                 size_t length);
+void WebRtcSpl_ApplyGainsStridedW16SSE2(int16_t *vector,
+                                        size_t channels,
+                                        const int32_t *gains,
+                                        size_t frames);
+void WebRtcSpl_MeanChannelsW16SSE2(const int16_t *vector,
+                                   size_t channels,
+                                   size_t frames,
+                                   int16_t *mean);
+
+int16_t WebRtcSpl_MaxAbsValueW16SSE41(const int16_t *vector, size_t length);
+int16_t WebRtcSpl_GetScalingSquareSSE41(int16_t *in_vector,
+                                        size_t in_vector_length,
+                                        size_t times);
+int32_t WebRtcSpl_EnergySSE41(int16_t *vector,
+                              size_t vector_length,
+                              int *scale_factor);
+int32_t WebRtcSpl_DotProductWithScaleSSE41(const int16_t *vector1,
+                                           const int16_t *vector2,
+                                           size_t length,
+                                           int scaling);
+void WebRtcSpl_MaxSquareBlocksW16SSE41(const int16_t *vector,
+                                       size_t block_length,
+                                       size_t blocks,
+                                       int32_t *maxSquares);
+
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t *vector, size_t length);
+int16_t WebRtcSpl_GetScalingSquareAVX2(int16_t *in_vector,
+                                       size_t in_vector_length,
+                                       size_t times);
+int32_t WebRtcSpl_EnergyAVX2(int16_t *vector,
+                             size_t vector_length,
+                             int *scale_factor);
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t *vector1,
+                                          const int16_t *vector2,
+                                          size_t length,
+                                          int scaling);
+void WebRtcSpl_AddSatVectorW16AVX2(const int16_t *in1,
+                                   const int16_t *in2,
+                                   int16_t *out,
+                                   size_t length);
+void WebRtcSpl_MaxSquareBlocksW16AVX2(const int16_t *vector,
+                                      size_t block_length,
+                                      size_t blocks,
+                                      int32_t *maxSquares);
+void WebRtcSpl_ApplyGainsW16AVX2(int16_t *vector,
+                                 const int32_t *gains,
+                                 size_t length);
+void WebRtcSpl_ApplyGainsStridedW16AVX2(int16_t *vector,
+                                        size_t channels,
+                                        const int32_t *gains,
+                                        size_t frames);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
@@ -0,0 +1,372 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * Band splitting filter banks. Two bands use the fixed point QMF of WebRTC,
+ * built from polyphase all-pass filters, which keeps the magnitude of the
+ * input and changes its phase. Three bands use a float pseudo QMF bank, cosine
+ * modulated from one linear phase prototype whose polyphase components run at
+ * the band rate, which reconstructs the input delayed by 45 samples.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "signal_processing_library.h"
+
+// QMF filter coefficients in Q16.
+static const uint16_t kAllPassFilter1[3] = {6418, 36982, 57261};
+static const uint16_t kAllPassFilter2[3] = {21333, 49062, 63010};
+
+// C + (B * A >> 16), with A unsigned Q16 and B in 32 bits.
+#define SPL_SCALEDIFF32(A, B, C) \
+    ((C) + ((B) >> 16) * (A) + (int32_t) (((uint32_t) ((B) & 0x0000FFFF) * (A)) >> 16))
+
+// Three cascaded first order all-pass filters
+//
+//         a_3 + q^-1    a_2 + q^-1    a_1 + q^-1
+// y[n] =  -----------   -----------   -----------   x[n]
+//         1 + a_3q^-1   1 + a_2q^-1   1 + a_1q^-1
+//
+// |filter_state| holds x[-1] and y[-1] of each cascade. The second cascade
+// writes back into |in_data|, so the input is changed.
+static void AllPassQMF(int32_t *in_data,
+                       size_t data_length,
+                       int32_t *out_data,
+                       const uint16_t *filter_coefficients,
+                       int32_t *filter_state)
+{
+    size_t k;
+    int32_t diff;
+
+    // First cascade, from |in_data| to |out_data|.
+    diff = WebRtcSpl_SubSatW32(in_data[0], filter_state[1]);
+    out_data[0] = SPL_SCALEDIFF32(filter_coefficients[0], diff, filter_state[0]);
+    for (k = 1; k < data_length; k++)
+    {
+        diff = WebRtcSpl_SubSatW32(in_data[k], out_data[k - 1]);
+        out_data[k] = SPL_SCALEDIFF32(filter_coefficients[0], diff, in_data[k - 1]);
+    }
+    filter_state[0] = in_data[data_length - 1];
+    filter_state[1] = out_data[data_length - 1];
+
+    // Second cascade, from |out_data| to |in_data|.
+    diff = WebRtcSpl_SubSatW32(out_data[0], filter_state[3]);
+    in_data[0] = SPL_SCALEDIFF32(filter_coefficients[1], diff, filter_state[2]);
+    for (k = 1; k < data_length; k++)
+    {
+        diff = WebRtcSpl_SubSatW32(out_data[k], in_data[k - 1]);
+        in_data[k] = SPL_SCALEDIFF32(filter_coefficients[1], diff, out_data[k - 1]);
+    }
+    filter_state[2] = out_data[data_length - 1];
+    filter_state[3] = in_data[data_length - 1];
+
+    // Third cascade, from |in_data| to |out_data|.
+    diff = WebRtcSpl_SubSatW32(in_data[0], filter_state[5]);
+    out_data[0] = SPL_SCALEDIFF32(filter_coefficients[2], diff, filter_state[4]);
+    for (k = 1; k < data_length; k++)
+    {
+        diff = WebRtcSpl_SubSatW32(in_data[k], out_data[k - 1]);
+        out_data[k] = SPL_SCALEDIFF32(filter_coefficients[2], diff, in_data[k - 1]);
+    }
+    filter_state[4] = in_data[data_length - 1];
+    filter_state[5] = out_data[data_length - 1];
+}
+
+void WebRtcSpl_AnalysisQMF(const int16_t *in_data,
+                           size_t in_data_length,
+                           int16_t *low_band,
+                           int16_t *high_band,
+                           int32_t *filter_state1,
+                           int32_t *filter_state2)
+{
+    int32_t half_in1[SPL_BAND_LENGTH_MAX];
+    int32_t half_in2[SPL_BAND_LENGTH_MAX];
+    int32_t filter1[SPL_BAND_LENGTH_MAX];
+    int32_t filter2[SPL_BAND_LENGTH_MAX];
+    const size_t band_length = in_data_length / 2;
+    size_t i;
+    int32_t tmp;
+
+    // Split even and odd samples, in Q10.
+    for (i = 0; i < band_length; i++)
+    {
+        half_in2[i] = ((int32_t) in_data[2 * i]) * (1 << 10);
+        half_in1[i] = ((int32_t) in_data[2 * i + 1]) * (1 << 10);
+    }
+
+    // All-pass filter the even and odd samples independently.
+    AllPassQMF(half_in1, band_length, filter1, kAllPassFilter1, filter_state1);
+    AllPassQMF(half_in2, band_length, filter2, kAllPassFilter2, filter_state2);
+
+    // The sum and the difference of the branches are the lower and the upper
+    // band.
+    for (i = 0; i < band_length; i++)
+    {
+        tmp = (filter1[i] + filter2[i] + 1024) >> 11;
+        low_band[i] = WebRtcSpl_SatW32ToW16(tmp);
+
+        tmp = (filter1[i] - filter2[i] + 1024) >> 11;
+        high_band[i] = WebRtcSpl_SatW32ToW16(tmp);
+    }
+}
+
+void WebRtcSpl_SynthesisQMF(const int16_t *low_band,
+                            const int16_t *high_band,
+                            size_t band_length,
+                            int16_t *out_data,
+                            int32_t *filter_state1,
+                            int32_t *filter_state2)
+{
+    int32_t half_in1[SPL_BAND_LENGTH_MAX];
+    int32_t half_in2[SPL_BAND_LENGTH_MAX];
+    int32_t filter1[SPL_BAND_LENGTH_MAX];
+    int32_t filter2[SPL_BAND_LENGTH_MAX];
+    size_t i;
+    int32_t tmp;
+
+    // Sum and difference of the bands, in Q10.
+    for (i = 0; i < band_length; i++)
+    {
+        tmp = (int32_t) low_band[i] + (int32_t) high_band[i];
+        half_in1[i] = tmp * (1 << 10);
+        tmp = (int32_t) low_band[i] - (int32_t) high_band[i];
+        half_in2[i] = tmp * (1 << 10);
+    }
+
+    AllPassQMF(half_in1, band_length, filter1, kAllPassFilter2, filter_state1);
+    AllPassQMF(half_in2, band_length, filter2, kAllPassFilter1, filter_state2);
+
+    // The filtered branches are the even and odd output samples.
+    for (i = 0; i < band_length; i++)
+    {
+        tmp = (filter2[i] + 512) >> 10;
+        out_data[2 * i] = WebRtcSpl_SatW32ToW16(tmp);
+
+        tmp = (filter1[i] + 512) >> 10;
+        out_data[2 * i + 1] = WebRtcSpl_SatW32ToW16(tmp);
+    }
+}
+
+// Prototype low pass filter of the three band filter bank, a Kaiser windowed
+// sinc (beta 8) of 48 taps that is 3 dB down at the band edge, so the bands
+// are power complementary. Row f holds taps f, f + 12, f + 24 and f + 36: the
+// taps for the samples of phase f % 3, delayed by f / 3 band samples, of which
+// only every 4th is non zero.
+static const float kLowpassCoeffs[SPL_THREE_BAND_FILTERS][SPL_THREE_BAND_TAPS] = {
+        {+0.00003051f, +0.00513583f, +0.18477299f, +0.00723307f},
+        {+0.00006131f, -0.00122017f, +0.16174062f, +0.00608991f},
+        {+0.00002406f, -0.01112536f, +0.12147277f, +0.00345753f},
+        {-0.00017277f, -0.02156852f, +0.07365908f, +0.00090334f},
+        {-0.00056492f, -0.02754188f, +0.02880746f, -0.00070191f},
+        {-0.00102939f, -0.02338322f, -0.00484963f, -0.00123071f},
+        {-0.00123071f, -0.00484963f, -0.02338322f, -0.00102939f},
+        {-0.00070191f, +0.02880746f, -0.02754188f, -0.00056492f},
+        {+0.00090334f, +0.07365908f, -0.02156852f, -0.00017277f},
+        {+0.00345753f, +0.12147277f, -0.01112536f, +0.00002406f},
+        {+0.00608991f, +0.16174062f, -0.00122017f, +0.00006131f},
+        {+0.00723307f, +0.18477299f, +0.00513583f, +0.00003051f}};
+
+#define SPL_THREE_BANDS     3
+#define SPL_SPARSITY        4
+
+// Filters |length| samples of |in| with the sparse filter |filter|, whose
+// taps are delayed by |filter| / 3 samples. |state| holds the last
+// SPL_THREE_BAND_STATE samples of the previous call.
+static void SparseFir(size_t filter, const float *in, size_t length, float *state, float *out)
+{
+    const size_t delay = filter / SPL_THREE_BANDS;
+    const float *coeffs = kLowpassCoeffs[filter];
+    float history[SPL_THREE_BAND_STATE + SPL_BAND_LENGTH_MAX];
+    size_t i, j;
+
+    memcpy(history, state, sizeof(float) * SPL_THREE_BAND_STATE);
+    memcpy(&history[SPL_THREE_BAND_STATE], in, sizeof(float) * length);
+    for (i = 0; i < length; i++)
+    {
+        float sum = 0.f;
+        for (j = 0; j < SPL_THREE_BAND_TAPS; j++)
+        {
+            sum += history[SPL_THREE_BAND_STATE - delay + i - j * SPL_SPARSITY] * coeffs[j];
+        }
+        out[i] = sum;
+    }
+    memcpy(state, &history[length], sizeof(float) * SPL_THREE_BAND_STATE);
+}
+
+void WebRtcSpl_ThreeBandInit(WebRtcSpl_ThreeBandState *state, size_t band_length)
+{
+    const double pi = 3.14159265358979323846;
+    const double center = (SPL_THREE_BAND_FILTERS * SPL_THREE_BAND_TAPS - 1) / 2.0;
+    size_t f, b;
+
+    memset(state, 0, sizeof(*state));
+    state->bandLength = band_length;
+    // Cosine modulation to the center of band b, periodic in 12 taps. The
+    // phases of +-pi/4, opposite in the synthesis, cancel the aliasing between
+    // adjacent bands.
+    for (f = 0; f < SPL_THREE_BAND_FILTERS; f++)
+    {
+        for (b = 0; b < SPL_THREE_BANDS; b++)
+        {
+            const double phase = (b % 2 == 0 ? pi : -pi) / 4;
+            const double angle = pi * (2 * b + 1) * (f - center) / (2 * SPL_THREE_BANDS);
+            state->analysisModulation[f][b] = (float) (2 * cos(angle + phase));
+            state->synthesisModulation[f][b] = (float) (2 * cos(angle - phase));
+        }
+    }
+}
+
+void WebRtcSpl_ThreeBandAnalysis(WebRtcSpl_ThreeBandState *state,
+                                 const int16_t *in_data,
+                                 int16_t *const *bands)
+{
+    const size_t band_length = state->bandLength;
+    float phase[SPL_BAND_LENGTH_MAX], filtered[SPL_BAND_LENGTH_MAX];
+    float out[SPL_THREE_BANDS][SPL_BAND_LENGTH_MAX];
+    size_t i, j, k, b;
+
+    memset(out, 0, sizeof(out));
+    for (i = 0; i < SPL_THREE_BANDS; i++)
+    {
+        // Every third sample, the last of the band sample period first.
+        for (k = 0; k < band_length; k++)
+        {
+            phase[k] = in_data[SPL_THREE_BANDS * (k + 1) - i - 1];
+        }
+        for (j = 0; j < SPL_SPARSITY; j++)
+        {
+            const size_t filter = i + j * SPL_THREE_BANDS;
+            SparseFir(filter, phase, band_length, state->analysis[filter], filtered);
+            // Modulate down to every band.
+            for (b = 0; b < SPL_THREE_BANDS; b++)
+            {
+                const float gain = state->analysisModulation[filter][b];
+                for (k = 0; k < band_length; k++)
+                {
+                    out[b][k] += gain * filtered[k];
+                }
+            }
+        }
+    }
+    for (b = 0; b < SPL_THREE_BANDS; b++)
+    {
+        for (k = 0; k < band_length; k++)
+        {
+            bands[b][k] = WebRtcSpl_SatW32ToW16((int32_t) lrintf(out[b][k]));
+        }
+    }
+}
+
+void WebRtcSpl_ThreeBandSynthesis(WebRtcSpl_ThreeBandState *state,
+                                  const int16_t *const *bands,
+                                  int16_t *out_data)
+{
+    const size_t band_length = state->bandLength;
+    float modulated[SPL_BAND_LENGTH_MAX], filtered[SPL_BAND_LENGTH_MAX];
+    float out[SPL_THREE_BANDS * SPL_BAND_LENGTH_MAX];
+    size_t i, j, k, b;
+
+    memset(out, 0, sizeof(float) * SPL_THREE_BANDS * band_length);
+    for (i = 0; i < SPL_THREE_BANDS; i++)
+    {
+        for (j = 0; j < SPL_SPARSITY; j++)
+        {
+            const size_t filter = i + j * SPL_THREE_BANDS;
+            // Modulate every band up and sum.
+            memset(modulated, 0, sizeof(float) * band_length);
+            for (b = 0; b < SPL_THREE_BANDS; b++)
+            {
+                const float gain = state->synthesisModulation[filter][b];
+                for (k = 0; k < band_length; k++)
+                {
+                    modulated[k] += gain * bands[b][k];
+                }
+            }
+            SparseFir(filter, modulated, band_length, state->synthesis[filter], filtered);
+            // Upsample into phase i, the reverse order of the analysis.
+            for (k = 0; k < band_length; k++)
+            {
+                out[SPL_THREE_BANDS * k + i] += SPL_THREE_BANDS * filtered[k];
+            }
+        }
+    }
+    for (k = 0; k < SPL_THREE_BANDS * band_length; k++)
+    {
+        out_data[k] = WebRtcSpl_SatW32ToW16((int32_t) lrintf(out[k]));
+    }
+}
+
+int WebRtcSpl_BandSplitInit(WebRtcSpl_BandSplitState *state, uint32_t fs)
+{
+    memset(state, 0, sizeof(*state));
+    state->frameLength = fs / 100;
+    if (fs == 8000 || fs == 16000)
+    {
+        state->numBands = 1;
+    }
+    else if (fs == 32000)
+    {
+        state->numBands = 2;
+    }
+    else if (fs == 48000)
+    {
+        state->numBands = 3;
+    }
+    else
+    {
+        return -1;
+    }
+    state->bandLength = state->frameLength / state->numBands;
+    if (state->numBands == 3)
+    {
+        WebRtcSpl_ThreeBandInit(&state->threeBand, state->bandLength);
+    }
+    return 0;
+}
+
+void WebRtcSpl_BandSplitAnalysis(WebRtcSpl_BandSplitState *state,
+                                 const int16_t *in_data,
+                                 int16_t *const *bands)
+{
+    if (state->numBands == 1)
+    {
+        memcpy(bands[0], in_data, sizeof(int16_t) * state->frameLength);
+    }
+    else if (state->numBands == 2)
+    {
+        WebRtcSpl_AnalysisQMF(in_data, state->frameLength, bands[0], bands[1],
+                              state->analysisState1, state->analysisState2);
+    }
+    else
+    {
+        WebRtcSpl_ThreeBandAnalysis(&state->threeBand, in_data, bands);
+    }
+}
+
+void WebRtcSpl_BandSplitSynthesis(WebRtcSpl_BandSplitState *state,
+                                  const int16_t *const *bands,
+                                  int16_t *out_data)
+{
+    if (state->numBands == 1)
+    {
+        memcpy(out_data, bands[0], sizeof(int16_t) * state->frameLength);
+    }
+    else if (state->numBands == 2)
+    {
+        WebRtcSpl_SynthesisQMF(bands[0], bands[1], state->bandLength, out_data,
+                               state->synthesisState1, state->synthesisState2);
+    }
+    else
+    {
+        WebRtcSpl_ThreeBandSynthesis(&state->threeBand, bands, out_data);
+    }
+}
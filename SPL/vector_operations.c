@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * Portable C versions of the vector kernels. They are the reference for the
+ * SIMD versions and the fallback on every other CPU.
+ */
+
+#include <stdlib.h>
+
+#include "spl_simd.h"
+
+int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t *vector, size_t length)
+{
+    size_t i = 0;
+    int absolute = 0, maximum = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        absolute = abs((int) vector[i]);
+
+        if (absolute > maximum)
+        {
+            maximum = absolute;
+        }
+    }
+
+    // Guard the case for abs(-32768).
+    if (maximum > WEBRTC_SPL_WORD16_MAX)
+    {
+        maximum = WEBRTC_SPL_WORD16_MAX;
+    }
+
+    return (int16_t) maximum;
+}
+
+int16_t WebRtcSpl_ScalingFromMaxAbs(int16_t smax, size_t times)
+{
+    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) times);
+    int16_t t = WebRtcSpl_NormW32((int32_t) smax * (int32_t) smax);
+
+    if (smax == 0)
+    {
+        return 0; // Since norm(0) returns 0
+    }
+    else
+    {
+        return (t > nbits) ? 0 : nbits - t;
+    }
+}
+
+int16_t WebRtcSpl_GetScalingSquareC(int16_t *in_vector,
+                                    size_t in_vector_length,
+                                    size_t times)
+{
+    size_t i;
+    int16_t smax = -1;
+    int16_t sabs;
+    int16_t *sptr = in_vector;
+    size_t looptimes = in_vector_length;
+
+    // Note that -(-32768) wraps to -32768 here, so such samples never become
+    // the maximum. The SIMD versions keep this behavior.
+    for (i = looptimes; i > 0; i--)
+    {
+        sabs = (int16_t) (*sptr > 0 ? *sptr++ : -*sptr++);
+        smax = (sabs > smax ? sabs : smax);
+    }
+    return WebRtcSpl_ScalingFromMaxAbs(smax, times);
+}
+
+int32_t WebRtcSpl_EnergyC(int16_t *vector,
+                          size_t vector_length,
+                          int *scale_factor)
+{
+    int32_t en = 0;
+    size_t i;
+    int scaling =
+            WebRtcSpl_GetScalingSquareC(vector, vector_length, vector_length);
+    size_t looptimes = vector_length;
+    int16_t *vectorptr = vector;
+
+    for (i = 0; i < looptimes; i++)
+    {
+        en += (*vectorptr * *vectorptr) >> scaling;
+        vectorptr++;
+    }
+    *scale_factor = scaling;
+
+    return en;
+}
+
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t *vector1,
+                                       const int16_t *vector2,
+                                       size_t length,
+                                       int scaling)
+{
+    int64_t sum = 0;
+    size_t i = 0;
+
+    /* Unroll the loop to improve performance. */
+    for (i = 0; i + 3 < length; i += 4)
+    {
+        sum += (vector1[i + 0] * vector2[i + 0]) >> scaling;
+        sum += (vector1[i + 1] * vector2[i + 1]) >> scaling;
+        sum += (vector1[i + 2] * vector2[i + 2]) >> scaling;
+        sum += (vector1[i + 3] * vector2[i + 3]) >> scaling;
+    }
+    for (; i < length; i++)
+    {
+        sum += (vector1[i] * vector2[i]) >> scaling;
+    }
+
+    return (int32_t) (sum);
+}
+
+void WebRtcSpl_AddSatVectorW16C(const int16_t *in1,
+                                const int16_t *in2,
+                                int16_t *out,
+                                size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        out[i] = WebRtcSpl_AddSatW16(in1[i], in2[i]);
+    }
+}
+
+void WebRtcSpl_MaxSquareBlocksW16C(const int16_t *vector,
+                                   size_t block_length,
+                                   size_t blocks,
+                                   int32_t *maxSquares)
+{
+    size_t k, n;
+
+    for (k = 0; k < blocks; k++)
+    {
+        int32_t maximum = 0;
+        for (n = 0; n < block_length; n++)
+        {
+            int32_t square = vector[k * block_length + n] * vector[k * block_length + n];
+            if (square > maximum)
+            {
+                maximum = square;
+            }
+        }
+        maxSquares[k] = maximum;
+    }
+}
+
+void WebRtcSpl_ApplyGainsW16C(int16_t *vector,
+                              const int32_t *gains,
+                              size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        int64_t scaled = ((int64_t) vector[i] * gains[i]) >> 16;
+        if (scaled > WEBRTC_SPL_WORD16_MAX)
+        {
+            vector[i] = WEBRTC_SPL_WORD16_MAX;
+        }
+        else if (scaled < WEBRTC_SPL_WORD16_MIN)
+        {
+            vector[i] = WEBRTC_SPL_WORD16_MIN;
+        }
+        else
+        {
+            vector[i] = (int16_t) scaled;
+        }
+    }
+}
+
+void WebRtcSpl_ApplyGainsStridedW16C(int16_t *vector,
+                                     size_t channels,
+                                     const int32_t *gains,
+                                     size_t frames)
+{
+    size_t n;
+
+    for (n = 0; n < frames; n++)
+    {
+        int32_t gain = gains[n];
+        size_t c;
+
+        for (c = 0; c < channels; c++)
+        {
+            WebRtcSpl_ApplyGainsW16C(&vector[n * channels + c], &gain, 1);
+        }
+    }
+}
+
+void WebRtcSpl_MeanChannelsW16C(const int16_t *vector,
+                                size_t channels,
+                                size_t frames,
+                                int16_t *mean)
+{
+    // 1 / channels in Q15, the sum times it stays within 31 bits
+    const int32_t recip = (int32_t) (32768 / channels);
+    size_t n, c;
+
+    for (n = 0; n < frames; n++)
+    {
+        int32_t sum = 0;
+        for (c = 0; c < channels; c++)
+        {
+            sum += vector[n * channels + c];
+        }
+        mean[n] = (int16_t) ((sum * recip) >> 15);
+    }
+}
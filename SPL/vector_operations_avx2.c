@@ -0,0 +1,260 @@
+/*
+ * AVX2 versions of the SPL vector kernels, bit exact with the C versions.
+ */
+
+#include <immintrin.h>
+
+#include "spl_simd.h"
+
+static int32_t HorizontalSumW32(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_srli_si128(s, 8));
+    s = _mm_add_epi32(s, _mm_srli_si128(s, 4));
+    return _mm_cvtsi128_si32(s);
+}
+
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t *vector, size_t length)
+{
+    __m256i vmax = _mm256_setzero_si256();
+    size_t i = 0;
+
+    // abs(-32768) is 0x8000, which is 32768 in the unsigned maximum.
+    for (; i + 16 <= length; i += 16)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *) &vector[i]);
+        vmax = _mm256_max_epu16(vmax, _mm256_abs_epi16(x));
+    }
+    __m128i m = _mm_max_epu16(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+    m = _mm_minpos_epu16(_mm_xor_si128(m, _mm_set1_epi16(-1)));
+    int maximum = (uint16_t) ~_mm_extract_epi16(m, 0);
+    for (; i < length; i++)
+    {
+        int absolute = vector[i] < 0 ? -vector[i] : vector[i];
+        if (absolute > maximum)
+            maximum = absolute;
+    }
+    return (int16_t) (maximum > WEBRTC_SPL_WORD16_MAX ? WEBRTC_SPL_WORD16_MAX : maximum);
+}
+
+int16_t WebRtcSpl_GetScalingSquareAVX2(int16_t *in_vector,
+                                       size_t in_vector_length,
+                                       size_t times)
+{
+    __m256i vmax = _mm256_set1_epi16(-1);
+    size_t i = 0;
+
+    // abs(-32768) stays -32768 in the signed maximum, as in the C version.
+    for (; i + 16 <= in_vector_length; i += 16)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *) &in_vector[i]);
+        vmax = _mm256_max_epi16(vmax, _mm256_abs_epi16(x));
+    }
+    __m128i m = _mm_max_epi16(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+    int16_t smax = (int16_t) _mm_extract_epi16(m, 0);
+    for (; i < in_vector_length; i++)
+    {
+        int16_t sabs = (int16_t) (in_vector[i] > 0 ? in_vector[i] : -in_vector[i]);
+        smax = sabs > smax ? sabs : smax;
+    }
+    return WebRtcSpl_ScalingFromMaxAbs(smax, times);
+}
+
+int32_t WebRtcSpl_EnergyAVX2(int16_t *vector,
+                             size_t vector_length,
+                             int *scale_factor)
+{
+    const int scaling = WebRtcSpl_GetScalingSquareAVX2(vector, vector_length, vector_length);
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    // |x| zero extended to 32 bits, madd then gives x * x + 0 * 0 per lane.
+    for (; i + 16 <= vector_length; i += 16)
+    {
+        __m256i a = _mm256_abs_epi16(_mm256_loadu_si256((const __m256i *) &vector[i]));
+        __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(a));
+        __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(a, 1));
+        acc = _mm256_add_epi32(acc, _mm256_sra_epi32(_mm256_madd_epi16(lo, lo), shift));
+        acc = _mm256_add_epi32(acc, _mm256_sra_epi32(_mm256_madd_epi16(hi, hi), shift));
+    }
+    uint32_t en = (uint32_t) HorizontalSumW32(acc);
+    for (; i < vector_length; i++)
+        en += (uint32_t) ((vector[i] * vector[i]) >> scaling);
+    *scale_factor = scaling;
+    return (int32_t) en;
+}
+
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t *vector1,
+                                          const int16_t *vector2,
+                                          size_t length,
+                                          int scaling)
+{
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) &vector1[i]));
+        __m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) &vector2[i]));
+        acc = _mm256_add_epi32(acc, _mm256_sra_epi32(_mm256_mullo_epi32(a, b), shift));
+    }
+    uint32_t sum = (uint32_t) HorizontalSumW32(acc);
+    for (; i < length; i++)
+        sum += (uint32_t) ((vector1[i] * vector2[i]) >> scaling);
+    return (int32_t) sum;
+}
+
+void WebRtcSpl_AddSatVectorW16AVX2(const int16_t *in1,
+                                   const int16_t *in2,
+                                   int16_t *out,
+                                   size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *) &in1[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *) &in2[i]);
+        _mm256_storeu_si256((__m256i *) &out[i], _mm256_adds_epi16(a, b));
+    }
+    for (; i < length; i++)
+        out[i] = WebRtcSpl_AddSatW16(in1[i], in2[i]);
+}
+
+void WebRtcSpl_MaxSquareBlocksW16AVX2(const int16_t *vector,
+                                      size_t block_length,
+                                      size_t blocks,
+                                      int32_t *maxSquares)
+{
+    size_t k;
+
+    // Blocks shorter than a vector, 8 samples at 8 kHz, go to SSE4.1.
+    if (block_length < 16)
+    {
+        WebRtcSpl_MaxSquareBlocksW16SSE41(vector, block_length, blocks, maxSquares);
+        return;
+    }
+    for (k = 0; k < blocks; k++)
+    {
+        const int16_t *block = &vector[k * block_length];
+        __m256i vmax = _mm256_setzero_si256();
+        size_t n = 0;
+        // abs(-32768) is 0x8000, which is 32768 in the unsigned maximum.
+        for (; n + 16 <= block_length; n += 16)
+        {
+            __m256i x = _mm256_loadu_si256((const __m256i *) &block[n]);
+            vmax = _mm256_max_epu16(vmax, _mm256_abs_epi16(x));
+        }
+        __m128i m = _mm_max_epu16(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+        m = _mm_minpos_epu16(_mm_xor_si128(m, _mm_set1_epi16(-1)));
+        int32_t maximum = (uint16_t) ~_mm_extract_epi16(m, 0);
+        maximum *= maximum;
+        for (; n < block_length; n++)
+        {
+            int32_t square = block[n] * block[n];
+            if (square > maximum)
+                maximum = square;
+        }
+        maxSquares[k] = maximum;
+    }
+}
+
+// Scales 16 samples with the Q16 gains |g0| (samples 0 to 7) and |g1|
+// (samples 8 to 15), the same split of the gains as the SSE2 version. The
+// packs work per 128-bit lane, the gains are put back in sample order after
+// them.
+static __m256i ApplyGains16(__m256i x, __m256i g0, __m256i g1)
+{
+    const __m256i one = _mm256_set1_epi16(1);
+    __m256i upper = _mm256_packs_epi32(_mm256_srai_epi32(g0, 16), _mm256_srai_epi32(g1, 16));
+    __m256i lower = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(g0, 16), 16),
+                                       _mm256_srai_epi32(_mm256_slli_epi32(g1, 16), 16));
+    upper = _mm256_permute4x64_epi64(upper, 0xD8);
+    lower = _mm256_permute4x64_epi64(lower, 0xD8);
+    __m256i high = _mm256_sub_epi16(_mm256_mulhi_epu16(x, lower),
+                                    _mm256_and_si256(_mm256_srai_epi16(x, 15), lower));
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(x, high),
+                                   _mm256_unpacklo_epi16(upper, one));
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(x, high),
+                                   _mm256_unpackhi_epi16(upper, one));
+    return _mm256_packs_epi32(lo, hi);
+}
+
+void WebRtcSpl_ApplyGainsW16AVX2(int16_t *vector,
+                                 const int32_t *gains,
+                                 size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *) &vector[i]);
+        __m256i g0 = _mm256_loadu_si256((const __m256i *) &gains[i]);
+        __m256i g1 = _mm256_loadu_si256((const __m256i *) &gains[i + 8]);
+        _mm256_storeu_si256((__m256i *) &vector[i], ApplyGains16(x, g0, g1));
+    }
+    WebRtcSpl_ApplyGainsW16SSE2(&vector[i], &gains[i], length - i);
+}
+
+void WebRtcSpl_ApplyGainsStridedW16AVX2(int16_t *vector,
+                                        size_t channels,
+                                        const int32_t *gains,
+                                        size_t frames)
+{
+    size_t n = 0, c;
+
+    if (channels == 2)
+    {
+        // 8 frames per vector, every gain twice
+        const __m256i first = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const __m256i second = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+        for (; n + 8 <= frames; n += 8)
+        {
+            __m256i x = _mm256_loadu_si256((const __m256i *) &vector[2 * n]);
+            __m256i g = _mm256_loadu_si256((const __m256i *) &gains[n]);
+            _mm256_storeu_si256((__m256i *) &vector[2 * n],
+                                ApplyGains16(x, _mm256_permutevar8x32_epi32(g, first),
+                                             _mm256_permutevar8x32_epi32(g, second)));
+        }
+    }
+    else if (channels == 4)
+    {
+        const __m256i first = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        const __m256i second = _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3);
+        for (; n + 4 <= frames; n += 4)
+        {
+            __m256i x = _mm256_loadu_si256((const __m256i *) &vector[4 * n]);
+            __m256i g = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) &gains[n]));
+            _mm256_storeu_si256((__m256i *) &vector[4 * n],
+                                ApplyGains16(x, _mm256_permutevar8x32_epi32(g, first),
+                                             _mm256_permutevar8x32_epi32(g, second)));
+        }
+    }
+    else if (channels == 8)
+    {
+        for (; n + 2 <= frames; n += 2)
+        {
+            __m256i x = _mm256_loadu_si256((const __m256i *) &vector[8 * n]);
+            _mm256_storeu_si256((__m256i *) &vector[8 * n],
+                                ApplyGains16(x, _mm256_set1_epi32(gains[n]), _mm256_set1_epi32(gains[n + 1])));
+        }
+    }
+    else if (channels % 16 == 0)
+    {
+        for (; n < frames; n++)
+        {
+            __m256i g = _mm256_set1_epi32(gains[n]);
+            for (c = 0; c < channels; c += 16)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *) &vector[n * channels + c]);
+                _mm256_storeu_si256((__m256i *) &vector[n * channels + c], ApplyGains16(x, g, g));
+            }
+        }
+    }
+    WebRtcSpl_ApplyGainsStridedW16SSE2(&vector[n * channels], channels, &gains[n], frames - n);
+}
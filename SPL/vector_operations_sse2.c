@@ -0,0 +1,376 @@
+/*
+ * SSE2 versions of the SPL vector kernels, bit exact with the C versions.
+ */
+
+#include <emmintrin.h>
+
+#include "spl_simd.h"
+
+static int16_t HorizontalMaxW16(__m128i v)
+{
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+    v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+    return (int16_t) _mm_cvtsi128_si32(v);
+}
+
+static int32_t HorizontalSumW32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+
+// Sum of (a[i] * b[i]) >> scaling over 8 lanes, wrapping in 32 bits.
+static __m128i ScaledProducts(__m128i a, __m128i b, __m128i shift)
+{
+    __m128i lo = _mm_mullo_epi16(a, b);
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    __m128i p0 = _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), shift);
+    __m128i p1 = _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), shift);
+    return _mm_add_epi32(p0, p1);
+}
+
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t *vector, size_t length)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmax = zero;
+    size_t i = 0;
+
+    // The saturating negation turns -32768 into 32767, as the C version.
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &vector[i]);
+        vmax = _mm_max_epi16(vmax, _mm_max_epi16(x, _mm_subs_epi16(zero, x)));
+    }
+    int maximum = HorizontalMaxW16(vmax);
+    for (; i < length; i++)
+    {
+        int absolute = vector[i] < 0 ? -vector[i] : vector[i];
+        if (absolute > maximum)
+            maximum = absolute;
+    }
+    return (int16_t) (maximum > WEBRTC_SPL_WORD16_MAX ? WEBRTC_SPL_WORD16_MAX : maximum);
+}
+
+int16_t WebRtcSpl_GetScalingSquareSSE2(int16_t *in_vector,
+                                       size_t in_vector_length,
+                                       size_t times)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmax = _mm_set1_epi16(-1);
+    size_t i = 0;
+
+    // The wrapping negation keeps -32768 out of the maximum, as the C version.
+    for (; i + 8 <= in_vector_length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &in_vector[i]);
+        vmax = _mm_max_epi16(vmax, _mm_max_epi16(x, _mm_sub_epi16(zero, x)));
+    }
+    int16_t smax = HorizontalMaxW16(vmax);
+    for (; i < in_vector_length; i++)
+    {
+        int16_t sabs = (int16_t) (in_vector[i] > 0 ? in_vector[i] : -in_vector[i]);
+        smax = sabs > smax ? sabs : smax;
+    }
+    return WebRtcSpl_ScalingFromMaxAbs(smax, times);
+}
+
+int32_t WebRtcSpl_EnergySSE2(int16_t *vector,
+                             size_t vector_length,
+                             int *scale_factor)
+{
+    const int scaling = WebRtcSpl_GetScalingSquareSSE2(vector, vector_length, vector_length);
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= vector_length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &vector[i]);
+        acc = _mm_add_epi32(acc, ScaledProducts(x, x, shift));
+    }
+    uint32_t en = (uint32_t) HorizontalSumW32(acc);
+    for (; i < vector_length; i++)
+        en += (uint32_t) ((vector[i] * vector[i]) >> scaling);
+    *scale_factor = scaling;
+    return (int32_t) en;
+}
+
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t *vector1,
+                                          const int16_t *vector2,
+                                          size_t length,
+                                          int scaling)
+{
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    // The C version sums in 64 bits and truncates, which is the same as
+    // wrapping 32-bit sums.
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *) &vector1[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *) &vector2[i]);
+        acc = _mm_add_epi32(acc, ScaledProducts(a, b, shift));
+    }
+    uint32_t sum = (uint32_t) HorizontalSumW32(acc);
+    for (; i < length; i++)
+        sum += (uint32_t) ((vector1[i] * vector2[i]) >> scaling);
+    return (int32_t) sum;
+}
+
+void WebRtcSpl_AddSatVectorW16SSE2(const int16_t *in1,
+                                   const int16_t *in2,
+                                   int16_t *out,
+                                   size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *) &in1[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *) &in2[i]);
+        _mm_storeu_si128((__m128i *) &out[i], _mm_adds_epi16(a, b));
+    }
+    for (; i < length; i++)
+        out[i] = WebRtcSpl_AddSatW16(in1[i], in2[i]);
+}
+
+void WebRtcSpl_MaxSquareBlocksW16SSE2(const int16_t *vector,
+                                      size_t block_length,
+                                      size_t blocks,
+                                      int32_t *maxSquares)
+{
+    // SSE2 has no unsigned 16-bit maximum, the absolute values are compared
+    // with the sign bit flipped. abs(-32768) is 0x8000, which is 32768.
+    const __m128i bias = _mm_set1_epi16((int16_t) 0x8000);
+    size_t k;
+
+    for (k = 0; k < blocks; k++)
+    {
+        const int16_t *block = &vector[k * block_length];
+        __m128i vmax = bias;
+        size_t n = 0;
+        for (; n + 8 <= block_length; n += 8)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *) &block[n]);
+            __m128i sign = _mm_srai_epi16(x, 15);
+            __m128i absolute = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+            vmax = _mm_max_epi16(vmax, _mm_xor_si128(absolute, bias));
+        }
+        int32_t maximum = (uint16_t) (HorizontalMaxW16(vmax) ^ 0x8000);
+        maximum *= maximum;
+        for (; n < block_length; n++)
+        {
+            int32_t square = block[n] * block[n];
+            if (square > maximum)
+                maximum = square;
+        }
+        maxSquares[k] = maximum;
+    }
+}
+
+// (vector[i] * gains[i]) >> 16 of 8 samples, without 64-bit products. With
+// the gain split into its signed upper and unsigned lower 16 bits, the result
+// is x * upper + ((x * lower) >> 16), which fits in 32 bits.
+static __m128i ApplyGains8(__m128i x, __m128i g0, __m128i g1)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i upper = _mm_packs_epi32(_mm_srai_epi32(g0, 16), _mm_srai_epi32(g1, 16));
+    __m128i lower = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(g0, 16), 16),
+                                    _mm_srai_epi32(_mm_slli_epi32(g1, 16), 16));
+    // Upper half of the signed times unsigned product.
+    __m128i high = _mm_sub_epi16(_mm_mulhi_epu16(x, lower),
+                                 _mm_and_si128(_mm_srai_epi16(x, 15), lower));
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(x, high), _mm_unpacklo_epi16(upper, one));
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(x, high), _mm_unpackhi_epi16(upper, one));
+    return _mm_packs_epi32(lo, hi);
+}
+
+void WebRtcSpl_ApplyGainsW16SSE2(int16_t *vector,
+                                 const int32_t *gains,
+                                 size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &vector[i]);
+        __m128i g0 = _mm_loadu_si128((const __m128i *) &gains[i]);
+        __m128i g1 = _mm_loadu_si128((const __m128i *) &gains[i + 4]);
+        _mm_storeu_si128((__m128i *) &vector[i], ApplyGains8(x, g0, g1));
+    }
+    WebRtcSpl_ApplyGainsW16C(&vector[i], &gains[i], length - i);
+}
+
+// Gains repeated per channel in blocks for the channel counts without a lane
+// pattern, scaled by the dispatched WebRtcSpl_ApplyGainsW16().
+static void ApplyRepeatedGains(int16_t *vector,
+                               size_t channels,
+                               const int32_t *gains,
+                               size_t frames)
+{
+    int32_t block[256];
+    const size_t blockFrames = sizeof(block) / sizeof(block[0]) / channels;
+    size_t n, c, k;
+
+    while (frames > 0 && blockFrames > 0)
+    {
+        const size_t m = frames < blockFrames ? frames : blockFrames;
+        for (n = 0, k = 0; n < m; n++)
+        {
+            for (c = 0; c < channels; c++)
+            {
+                block[k++] = gains[n];
+            }
+        }
+        WebRtcSpl_ApplyGainsW16(vector, block, k);
+        vector += k;
+        gains += m;
+        frames -= m;
+    }
+    WebRtcSpl_ApplyGainsStridedW16C(vector, channels, gains, frames);
+}
+
+void WebRtcSpl_ApplyGainsStridedW16SSE2(int16_t *vector,
+                                        size_t channels,
+                                        const int32_t *gains,
+                                        size_t frames)
+{
+    size_t n = 0, c;
+
+    if (channels == 1)
+    {
+        WebRtcSpl_ApplyGainsW16(vector, gains, frames);
+        return;
+    }
+    if (channels == 2)
+    {
+        // 4 frames per vector, every gain twice
+        for (; n + 4 <= frames; n += 4)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *) &vector[2 * n]);
+            __m128i g = _mm_loadu_si128((const __m128i *) &gains[n]);
+            _mm_storeu_si128((__m128i *) &vector[2 * n],
+                             ApplyGains8(x, _mm_unpacklo_epi32(g, g), _mm_unpackhi_epi32(g, g)));
+        }
+    }
+    else if (channels == 4)
+    {
+        for (; n + 2 <= frames; n += 2)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *) &vector[4 * n]);
+            _mm_storeu_si128((__m128i *) &vector[4 * n],
+                             ApplyGains8(x, _mm_set1_epi32(gains[n]), _mm_set1_epi32(gains[n + 1])));
+        }
+    }
+    else if (channels % 8 == 0)
+    {
+        for (; n < frames; n++)
+        {
+            __m128i g = _mm_set1_epi32(gains[n]);
+            for (c = 0; c < channels; c += 8)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *) &vector[n * channels + c]);
+                _mm_storeu_si128((__m128i *) &vector[n * channels + c], ApplyGains8(x, g, g));
+            }
+        }
+    }
+    else
+    {
+        ApplyRepeatedGains(vector, channels, gains, frames);
+        return;
+    }
+    WebRtcSpl_ApplyGainsStridedW16C(&vector[n * channels], channels, &gains[n], frames - n);
+}
+
+void WebRtcSpl_MeanChannelsW16SSE2(const int16_t *vector,
+                                   size_t channels,
+                                   size_t frames,
+                                   int16_t *mean)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const int32_t recip = (int32_t) (32768 / channels);
+    size_t n = 0, c;
+
+    // The pairwise sums of _mm_madd_epi16() add up the channels, the mean of
+    // a power of two number of channels is a shift.
+    if (channels == 2)
+    {
+        for (; n + 8 <= frames; n += 8)
+        {
+            __m128i s0 = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &vector[2 * n]), one);
+            __m128i s1 = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &vector[2 * n + 8]), one);
+            _mm_storeu_si128((__m128i *) &mean[n],
+                             _mm_packs_epi32(_mm_srai_epi32(s0, 1), _mm_srai_epi32(s1, 1)));
+        }
+    }
+    else if (channels == 4)
+    {
+        for (; n + 4 <= frames; n += 4)
+        {
+            __m128 s0 = _mm_castsi128_ps(
+                    _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &vector[4 * n]), one));
+            __m128 s1 = _mm_castsi128_ps(
+                    _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &vector[4 * n + 8]), one));
+            __m128i sum = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0))),
+                                        _mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1))));
+            sum = _mm_srai_epi32(sum, 2);
+            _mm_storel_epi64((__m128i *) &mean[n], _mm_packs_epi32(sum, sum));
+        }
+    }
+    else if (channels % 8 == 0)
+    {
+        // log2(channels), or -1 when the mean needs a multiplication
+        int shift = -1;
+        if ((channels & (channels - 1)) == 0)
+        {
+            for (shift = 3; ((size_t) 1 << shift) < channels; shift++)
+            {
+            }
+        }
+        // 4 frames at a time, their partial sums are transposed and added
+        for (; n + 4 <= frames; n += 4)
+        {
+            const int16_t *frame = &vector[n * channels];
+            __m128i acc0 = _mm_setzero_si128();
+            __m128i acc1 = _mm_setzero_si128();
+            __m128i acc2 = _mm_setzero_si128();
+            __m128i acc3 = _mm_setzero_si128();
+            __m128i t0, t1, sum;
+
+            for (c = 0; c < channels; c += 8)
+            {
+                acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(
+                        _mm_loadu_si128((const __m128i *) &frame[c]), one));
+                acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(
+                        _mm_loadu_si128((const __m128i *) &frame[channels + c]), one));
+                acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(
+                        _mm_loadu_si128((const __m128i *) &frame[2 * channels + c]), one));
+                acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(
+                        _mm_loadu_si128((const __m128i *) &frame[3 * channels + c]), one));
+            }
+            t0 = _mm_add_epi32(_mm_unpacklo_epi32(acc0, acc1), _mm_unpackhi_epi32(acc0, acc1));
+            t1 = _mm_add_epi32(_mm_unpacklo_epi32(acc2, acc3), _mm_unpackhi_epi32(acc2, acc3));
+            sum = _mm_add_epi32(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1));
+            if (shift >= 0)
+            {
+                sum = _mm_srai_epi32(sum, shift);
+                _mm_storel_epi64((__m128i *) &mean[n], _mm_packs_epi32(sum, sum));
+            }
+            else
+            {
+                int32_t sums[4];
+                size_t k;
+
+                _mm_storeu_si128((__m128i *) sums, sum);
+                for (k = 0; k < 4; k++)
+                {
+                    mean[n + k] = (int16_t) ((sums[k] * recip) >> 15);
+                }
+            }
+        }
+    }
+    WebRtcSpl_MeanChannelsW16C(&vector[n * channels], channels, frames - n, &mean[n]);
+}
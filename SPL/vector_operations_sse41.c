@@ -0,0 +1,141 @@
+/*
+ * SSE4.1 versions of the SPL vector kernels, bit exact with the C versions.
+ * The saturating vector add and the gain application have nothing to gain
+ * over SSE2 and are not here.
+ */
+
+#include <smmintrin.h>
+
+#include "spl_simd.h"
+
+static int32_t HorizontalSumW32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+
+int16_t WebRtcSpl_MaxAbsValueW16SSE41(const int16_t *vector, size_t length)
+{
+    __m128i vmax = _mm_setzero_si128();
+    size_t i = 0;
+
+    // abs(-32768) is 0x8000, which is 32768 in the unsigned maximum.
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &vector[i]);
+        vmax = _mm_max_epu16(vmax, _mm_abs_epi16(x));
+    }
+    // The unsigned minimum moves the largest lane to the front.
+    vmax = _mm_minpos_epu16(_mm_xor_si128(vmax, _mm_set1_epi16(-1)));
+    int maximum = (uint16_t) ~_mm_extract_epi16(vmax, 0);
+    for (; i < length; i++)
+    {
+        int absolute = vector[i] < 0 ? -vector[i] : vector[i];
+        if (absolute > maximum)
+            maximum = absolute;
+    }
+    return (int16_t) (maximum > WEBRTC_SPL_WORD16_MAX ? WEBRTC_SPL_WORD16_MAX : maximum);
+}
+
+int16_t WebRtcSpl_GetScalingSquareSSE41(int16_t *in_vector,
+                                        size_t in_vector_length,
+                                        size_t times)
+{
+    __m128i vmax = _mm_set1_epi16(-1);
+    size_t i = 0;
+
+    // abs(-32768) stays -32768 in the signed maximum, as in the C version.
+    for (; i + 8 <= in_vector_length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *) &in_vector[i]);
+        vmax = _mm_max_epi16(vmax, _mm_abs_epi16(x));
+    }
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 8));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 4));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 2));
+    int16_t smax = (int16_t) _mm_extract_epi16(vmax, 0);
+    for (; i < in_vector_length; i++)
+    {
+        int16_t sabs = (int16_t) (in_vector[i] > 0 ? in_vector[i] : -in_vector[i]);
+        smax = sabs > smax ? sabs : smax;
+    }
+    return WebRtcSpl_ScalingFromMaxAbs(smax, times);
+}
+
+int32_t WebRtcSpl_EnergySSE41(int16_t *vector,
+                              size_t vector_length,
+                              int *scale_factor)
+{
+    const int scaling = WebRtcSpl_GetScalingSquareSSE41(vector, vector_length, vector_length);
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    // |x| zero extended to 32 bits, madd then gives x * x + 0 * 0 per lane.
+    for (; i + 8 <= vector_length; i += 8)
+    {
+        __m128i a = _mm_abs_epi16(_mm_loadu_si128((const __m128i *) &vector[i]));
+        __m128i lo = _mm_cvtepu16_epi32(a);
+        __m128i hi = _mm_cvtepu16_epi32(_mm_srli_si128(a, 8));
+        acc = _mm_add_epi32(acc, _mm_sra_epi32(_mm_madd_epi16(lo, lo), shift));
+        acc = _mm_add_epi32(acc, _mm_sra_epi32(_mm_madd_epi16(hi, hi), shift));
+    }
+    uint32_t en = (uint32_t) HorizontalSumW32(acc);
+    for (; i < vector_length; i++)
+        en += (uint32_t) ((vector[i] * vector[i]) >> scaling);
+    *scale_factor = scaling;
+    return (int32_t) en;
+}
+
+int32_t WebRtcSpl_DotProductWithScaleSSE41(const int16_t *vector1,
+                                           const int16_t *vector2,
+                                           size_t length,
+                                           int scaling)
+{
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        __m128i a = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) &vector1[i]));
+        __m128i b = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) &vector2[i]));
+        acc = _mm_add_epi32(acc, _mm_sra_epi32(_mm_mullo_epi32(a, b), shift));
+    }
+    uint32_t sum = (uint32_t) HorizontalSumW32(acc);
+    for (; i < length; i++)
+        sum += (uint32_t) ((vector1[i] * vector2[i]) >> scaling);
+    return (int32_t) sum;
+}
+
+void WebRtcSpl_MaxSquareBlocksW16SSE41(const int16_t *vector,
+                                       size_t block_length,
+                                       size_t blocks,
+                                       int32_t *maxSquares)
+{
+    size_t k;
+
+    for (k = 0; k < blocks; k++)
+    {
+        const int16_t *block = &vector[k * block_length];
+        __m128i vmax = _mm_setzero_si128();
+        size_t n = 0;
+        // abs(-32768) is 0x8000, which is 32768 in the unsigned maximum.
+        for (; n + 8 <= block_length; n += 8)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *) &block[n]);
+            vmax = _mm_max_epu16(vmax, _mm_abs_epi16(x));
+        }
+        vmax = _mm_minpos_epu16(_mm_xor_si128(vmax, _mm_set1_epi16(-1)));
+        int32_t maximum = (uint16_t) ~_mm_extract_epi16(vmax, 0);
+        maximum *= maximum;
+        for (; n < block_length; n++)
+        {
+            int32_t square = block[n] * block[n];
+            if (square > maximum)
+                maximum = square;
+        }
+        maxSquares[k] = maximum;
+    }
+}
@@ -0,0 +1,372 @@
+// 批处理: 处理一个目录或清单文件中的所有音频, 每个文件一个独立实例,
+// 在固定大小的线程池上并行执行 (POSIX 线程或 Win32 线程).
+// NS, AGC, AECM 和 VAD 工具共用.
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+
+# include <windows.h>
+# include <process.h>
+
+typedef CRITICAL_SECTION BatchMutex;
+typedef HANDLE BatchThread;
+
+#else
+
+# include <pthread.h>
+# include <dirent.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
+typedef pthread_mutex_t BatchMutex;
+typedef pthread_t BatchThread;
+
+#endif
+
+typedef struct
+{
+    char **items;
+    size_t count;
+    size_t capacity;
+} BatchList;
+
+typedef struct
+{
+    size_t done;
+    size_t failed;
+    double audioSeconds;        // total duration of the processed audio
+    double processSeconds;      // sum of the per file processing time
+    double wallSeconds;         // elapsed time of the whole batch, set by the caller
+} BatchStats;
+
+// Processes one item of the list. Returns 0 on success and fills in the
+// duration of the processed audio and the time spent on processing it.
+typedef int (*BatchJob)(const char *item, void *user, double *audioSeconds, double *processSeconds);
+
+typedef struct
+{
+    const BatchList *list;
+    BatchJob job;
+    void *user;
+    size_t next;
+    BatchStats *stats;
+    BatchMutex lock;
+} BatchQueue;
+
+static int batchNumCores(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+#endif
+}
+
+static void batchMutexInit(BatchMutex *lock)
+{
+#if defined(_WIN32)
+    InitializeCriticalSection(lock);
+#else
+    pthread_mutex_init(lock, NULL);
+#endif
+}
+
+static void batchMutexDestroy(BatchMutex *lock)
+{
+#if defined(_WIN32)
+    DeleteCriticalSection(lock);
+#else
+    pthread_mutex_destroy(lock);
+#endif
+}
+
+static void batchMutexLock(BatchMutex *lock)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(lock);
+#else
+    pthread_mutex_lock(lock);
+#endif
+}
+
+static void batchMutexUnlock(BatchMutex *lock)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(lock);
+#else
+    pthread_mutex_unlock(lock);
+#endif
+}
+
+static int batchListAdd(BatchList *list, const char *item)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        char **items = (char **) realloc(list->items, capacity * sizeof(char *));
+        if (items == NULL)
+            return -1;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    size_t length = strlen(item) + 1;
+    list->items[list->count] = (char *) malloc(length);
+    if (list->items[list->count] == NULL)
+        return -1;
+    memcpy(list->items[list->count], item, length);
+    list->count++;
+    return 0;
+}
+
+static void batchListFree(BatchList *list)
+{
+    for (size_t i = 0; i < list->count; i++)
+        free(list->items[i]);
+    free(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+static int batchHasSuffix(const char *name, const char *suffix)
+{
+    size_t n = strlen(name);
+    size_t m = strlen(suffix);
+    return n >= m && strcmp(name + n - m, suffix) == 0;
+}
+
+static int batchCompare(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+static int batchListDirectoryEntry(BatchList *list, const char *path, const char *name, const char *suffix)
+{
+    char file[1024];
+    if (!batchHasSuffix(name, suffix) || batchHasSuffix(name, "_out.wav"))
+        return 0;
+    snprintf(file, sizeof(file), "%s/%s", path, name);
+    return batchListAdd(list, file);
+}
+
+// Adds the files of directory |path| ending with |suffix| to |list|.
+static int batchListDirectory(BatchList *list, const char *path, const char *suffix)
+{
+    int ret = 0;
+#if defined(_WIN32)
+    char pattern[1024];
+    WIN32_FIND_DATAA entry;
+    snprintf(pattern, sizeof(pattern), "%s\\*", path);
+    HANDLE dir = FindFirstFileA(pattern, &entry);
+    if (dir == INVALID_HANDLE_VALUE)
+    {
+        fprintf(stderr, "can not open [%s].\n", path);
+        return -1;
+    }
+    do
+    {
+        ret = batchListDirectoryEntry(list, path, entry.cFileName, suffix);
+    } while (ret == 0 && FindNextFileA(dir, &entry));
+    FindClose(dir);
+#else
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+    {
+        fprintf(stderr, "can not open [%s].\n", path);
+        return -1;
+    }
+    struct dirent *entry;
+    while (ret == 0 && (entry = readdir(dir)) != NULL)
+        ret = batchListDirectoryEntry(list, path, entry->d_name, suffix);
+    closedir(dir);
+#endif
+    return ret;
+}
+
+// Loads the work items from a directory or from a manifest file.
+// Directory : every file ending with |suffix|, outputs (*_out.wav) are skipped.
+// Manifest  : one item per line, empty lines and lines starting with '#' are
+//             skipped.
+static int batchListLoad(BatchList *list, const char *path, const char *suffix)
+{
+    memset(list, 0, sizeof(*list));
+#if defined(_WIN32)
+    DWORD attributes = GetFileAttributesA(path);
+    if (attributes == INVALID_FILE_ATTRIBUTES)
+    {
+        fprintf(stderr, "can not open [%s].\n", path);
+        return -1;
+    }
+    int isDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        fprintf(stderr, "can not open [%s].\n", path);
+        return -1;
+    }
+    int isDirectory = S_ISDIR(st.st_mode);
+#endif
+    if (isDirectory)
+    {
+        if (batchListDirectory(list, path, suffix) != 0)
+        {
+            batchListFree(list);
+            return -1;
+        }
+        qsort(list->items, list->count, sizeof(char *), batchCompare);
+        return 0;
+    }
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "can not open [%s].\n", path);
+        return -1;
+    }
+    char line[2048];
+    while (fgets(line, sizeof(line), fp))
+    {
+        char *s = line;
+        while (isspace((unsigned char) *s))
+            s++;
+        size_t n = strlen(s);
+        while (n > 0 && isspace((unsigned char) s[n - 1]))
+            s[--n] = '\0';
+        if (n == 0 || s[0] == '#')
+            continue;
+        if (batchListAdd(list, s) != 0)
+        {
+            fclose(fp);
+            batchListFree(list);
+            return -1;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static void batchWorkerLoop(BatchQueue *queue)
+{
+    for (;;)
+    {
+        batchMutexLock(&queue->lock);
+        size_t i = queue->next++;
+        batchMutexUnlock(&queue->lock);
+        if (i >= queue->list->count)
+            break;
+
+        double audioSeconds = 0;
+        double processSeconds = 0;
+        int ret = queue->job(queue->list->items[i], queue->user, &audioSeconds, &processSeconds);
+
+        batchMutexLock(&queue->lock);
+        if (ret == 0)
+        {
+            queue->stats->done++;
+            queue->stats->audioSeconds += audioSeconds;
+            queue->stats->processSeconds += processSeconds;
+        }
+        else
+        {
+            queue->stats->failed++;
+            fprintf(stderr, "failed: %s\n", queue->list->items[i]);
+        }
+        batchMutexUnlock(&queue->lock);
+    }
+}
+
+#if defined(_WIN32)
+static unsigned __stdcall batchWorker(void *arg)
+{
+    batchWorkerLoop((BatchQueue *) arg);
+    return 0;
+}
+
+static int batchThreadStart(BatchThread *thread, BatchQueue *queue)
+{
+    *thread = (HANDLE) _beginthreadex(NULL, 0, batchWorker, queue, 0, NULL);
+    return *thread != NULL ? 0 : -1;
+}
+
+static void batchThreadJoin(BatchThread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static void *batchWorker(void *arg)
+{
+    batchWorkerLoop((BatchQueue *) arg);
+    return NULL;
+}
+
+static int batchThreadStart(BatchThread *thread, BatchQueue *queue)
+{
+    return pthread_create(thread, NULL, batchWorker, queue) == 0 ? 0 : -1;
+}
+
+static void batchThreadJoin(BatchThread thread)
+{
+    pthread_join(thread, NULL);
+}
+#endif
+
+// Runs |job| on every item of |list| on |numThreads| workers, numThreads <= 0
+// uses one worker per core.
+static int batchRun(const BatchList *list, int numThreads, BatchJob job, void *user, BatchStats *stats)
+{
+    BatchQueue queue;
+    memset(stats, 0, sizeof(*stats));
+    if (numThreads <= 0)
+        numThreads = batchNumCores();
+    if ((size_t) numThreads > list->count)
+        numThreads = list->count > 0 ? (int) list->count : 1;
+    BatchThread *threads = (BatchThread *) malloc(numThreads * sizeof(BatchThread));
+    if (threads == NULL)
+        return -1;
+    queue.list = list;
+    queue.job = job;
+    queue.user = user;
+    queue.next = 0;
+    queue.stats = stats;
+    batchMutexInit(&queue.lock);
+
+    int started = 0;
+    for (; started < numThreads; started++)
+    {
+        if (batchThreadStart(&threads[started], &queue) != 0)
+            break;
+    }
+    if (started == 0)
+        batchWorkerLoop(&queue);
+    for (int i = 0; i < started; i++)
+        batchThreadJoin(threads[i]);
+
+    batchMutexDestroy(&queue.lock);
+    free(threads);
+    return started > 0 ? started : 1;
+}
+
+static void batchReport(const BatchStats *stats, int numThreads)
+{
+    printf("files: %zu done, %zu failed, %d threads\n", stats->done, stats->failed, numThreads);
+    printf("audio: %.2f s, wall time: %.2f s, process time: %.2f s\n", stats->audioSeconds, stats->wallSeconds,
+           stats->processSeconds);
+    if (stats->audioSeconds > 0 && stats->wallSeconds > 0)
+    {
+        printf("real time factor: %.5f (%.1fx real time)\n", stats->wallSeconds / stats->audioSeconds,
+               stats->audioSeconds / stats->wallSeconds);
+    }
+}
+
+#endif  // BATCH_H_
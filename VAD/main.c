@@ -7,6 +7,7 @@
 
 #include "dr_wav.h"
 #include "vad.h"
+#include "../Tools/batch.h"
 
 #ifndef nullptr
 #define nullptr 0
@@ -21,46 +22,49 @@
 #endif
 
 
-//读取wav文件
-int16_t *wavRead_int16(char *filename, uint32_t *sampleRate, uint64_t *totalSampleCount)
+//打开wav文件用于流式读取
+int wavOpenRead(drwav *pWav, const char *filename)
 {
-    unsigned int channels;
-    int16_t *buffer = drwav_open_and_read_file_s16(filename, &channels, sampleRate, totalSampleCount);
-    if (buffer == nullptr)
+    if (!drwav_init_file(pWav, filename))
     {
         printf("读取wav文件失败.");
+        return -1;
     }
     //仅仅处理单通道音频
-    if (channels != 1)
+    if (pWav->channels != 1)
     {
-        drwav_free(buffer);
-        buffer = nullptr;
-        *sampleRate = 0;
-        *totalSampleCount = 0;
+        drwav_uninit(pWav);
+        return -1;
     }
-    return buffer;
+    return 0;
 }
 
 
-int vadProcess(int16_t *buffer, uint32_t sampleRate, size_t samplesCount, int16_t vad_mode, int per_ms_frames)
+int vadProcess(drwav *reader, FILE *out, int16_t vad_mode, int per_ms_frames, double *processSeconds)
 {
-    if (buffer == nullptr) return -1;
-    if (samplesCount == 0) return -1;
+    if (reader == nullptr) return -1;
+    uint32_t sampleRate = reader->sampleRate;
     // kValidRates : 8000, 16000, 32000, 48000
     // 10, 20 or 30 ms frames
     per_ms_frames = MAX(MIN(30, per_ms_frames), 10);
     size_t samples = sampleRate * per_ms_frames / 1000;
     if (samples == 0) return -1;
-    int16_t *input = buffer;
-    size_t nTotal = (samplesCount / samples);
+    // 每次只读取一帧, 内存占用与文件长度无关
+    int16_t *input = (int16_t *) malloc(samples * sizeof(int16_t));
+    if (input == NULL) return -1;
 
     void *vadInst = WebRtcVad_Create();
-    if (vadInst == NULL) return -1;
+    if (vadInst == NULL)
+    {
+        free(input);
+        return -1;
+    }
     int status = WebRtcVad_Init(vadInst);
     if (status != 0)
     {
         printf("WebRtcVad_Init fail\n");
         WebRtcVad_Free(vadInst);
+        free(input);
         return -1;
     }
     status = WebRtcVad_set_mode(vadInst, vad_mode);
@@ -68,50 +72,68 @@ int vadProcess(int16_t *buffer, uint32_t sampleRate, size_t samplesCount, int16_
     {
         printf("WebRtcVad_set_mode fail\n");
         WebRtcVad_Free(vadInst);
+        free(input);
         return -1;
     }
-    printf("Activity ： \n");
-    for (int i = 0; i < nTotal; i++)
+    fprintf(out, "Activity ： \n");
+    while (drwav_read_s16(reader, samples, input) == samples)
     {
+        double startTime = now();
         int keep_weight = 0;
         int nVadRet = WebRtcVad_Process(vadInst, sampleRate, input, samples, keep_weight);
         if (nVadRet == -1)
         {
             printf("failed in WebRtcVad_Process\n");
             WebRtcVad_Free(vadInst);
+            free(input);
             return -1;
         }
         else
         {
             // output result
-            printf(" %d \t", nVadRet);
+            fprintf(out, " %d \t", nVadRet);
         }
-        input += samples;
+        *processSeconds += calcElapsed(startTime, now());
     }
-    printf("\n");
+    fprintf(out, "\n");
     WebRtcVad_Free(vadInst);
+    free(input);
     return 1;
 }
 
-void vad(char *in_file)
+int vad(const char *in_file, FILE *out, double *audioSeconds, double *processSeconds)
 {
-    //音频采样率
-    uint32_t sampleRate = 0;
-    //总音频采样数
-    uint64_t inSampleCount = 0;
-    int16_t *inBuffer = wavRead_int16(in_file, &sampleRate, &inSampleCount);
+    drwav reader;
     //如果加载成功
-    if (inBuffer != nullptr)
-    {
-        //    Aggressiveness mode (0, 1, 2, or 3)
-        int16_t mode = 1;
-        int per_ms = 30;
-        double startTime = now();
-        vadProcess(inBuffer, sampleRate, inSampleCount, mode, per_ms);
-        double time_interval = calcElapsed(startTime, now());
-        printf("time interval: %d ms\n ", (int) (time_interval * 1000));
-        free(inBuffer);
-    }
+    if (wavOpenRead(&reader, in_file) != 0)
+        return -1;
+    //    Aggressiveness mode (0, 1, 2, or 3)
+    int16_t mode = 1;
+    int per_ms = 30;
+    *processSeconds = 0;
+    int ret = vadProcess(&reader, out, mode, per_ms, processSeconds);
+    *audioSeconds = (double) reader.totalSampleCount / reader.sampleRate;
+    drwav_uninit(&reader);
+    return ret > 0 ? 0 : -1;
+}
+
+// 批处理时每个文件的检测结果写入 xxx_vad.txt
+int vadBatchJob(const char *in_file, void *user, double *audioSeconds, double *processSeconds)
+{
+    char out_file[1024];
+    (void) user;
+    size_t n = strlen(in_file);
+    if (n < strlen(".wav") || n + strlen("_vad.txt") >= sizeof(out_file))
+        return -1;
+    n -= strlen(".wav");
+    memcpy(out_file, in_file, n);
+    strcpy(out_file + n, "_vad.txt");
+    FILE *out = fopen(out_file, "w");
+    if (out == NULL)
+        return -1;
+    int ret = vad(in_file, out, audioSeconds, processSeconds);
+    fclose(out);
+    return ret;
 }
 
 int main(int argc, char *argv[])
@@ -119,10 +141,33 @@ int main(int argc, char *argv[])
     printf("WebRTC Voice Activity Detector\n");
     printf("静音检测\n");
     if (argc < 2)
+    {
+        printf("usage : vad in_file.wav\n");
+        printf("        vad -b dir_or_manifest [threads]\n");
         return -1;
+    }
+    if (strcmp(argv[1], "-b") == 0)
+    {
+        //批处理模式: 每个文件一个独立实例, 线程数默认为 CPU 核数
+        if (argc < 3)
+            return -1;
+        BatchList list;
+        BatchStats stats;
+        if (batchListLoad(&list, argv[2], ".wav") != 0)
+            return -1;
+        double startTime = now();
+        int threads = batchRun(&list, argc > 3 ? atoi(argv[3]) : 0, vadBatchJob, NULL, &stats);
+        stats.wallSeconds = calcElapsed(startTime, now());
+        batchReport(&stats, threads);
+        batchListFree(&list);
+        return stats.failed == 0 && threads > 0 ? 0 : 1;
+    }
     char *in_file = argv[1];
-    vad(in_file);
+    double audioSeconds = 0;
+    double time_interval = 0;
+    if (vad(in_file, stdout, &audioSeconds, &time_interval) == 0)
+        printf("time interval: %d ms\n ", (int) (time_interval * 1000));
     printf("按任意键退出程序 \n");
     getchar();
     return 0;
-}
\ No newline at end of file
+}
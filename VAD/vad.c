@@ -9,82 +9,10 @@
  */
 
 #include "vad.h"
+#include "../SPL/signal_processing_library.h"
 #include <stdlib.h>
 
 
-static __inline int32_t DivW32W16(int32_t num, int16_t den)
-{
-    // Guard against division with 0
-    return (den != 0) ? (int32_t) (num / den) : (int32_t) 0x7FFFFFFF;
-}
-
-
-static __inline uint32_t __clz_uint32(uint32_t v)
-{
-// Never used with input 0
-    assert(v > 0);
-#if defined(__INTEL_COMPILER)
-    return _bit_scan_reverse(v) ^ 31U;
-#elif defined(__GNUC__) && (__GNUC__ >= 4 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
-// This will translate either to (bsr ^ 31U), clz , ctlz, cntlz, lzcnt depending on
-// -march= setting or to a software routine in exotic machines.
-    return __builtin_clz(v);
-#elif defined(_MSC_VER)
-    // for _BitScanReverse
-#include <intrin.h>
-    {
-        uint32_t idx;
-        _BitScanReverse(&idx, v);
-        return idx ^ 31U;
-    }
-#else
-// Will never be emitted for MSVC, GCC, Intel compilers
-    static const uint8_t byte_to_unary_table[] = {
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    };
-    return word > 0xffffff ? byte_to_unary_table[v >> 24] :
-        word > 0xffff ? byte_to_unary_table[v >> 16] + 8 :
-        word > 0xff ? byte_to_unary_table[v >> 8] + 16 :
-        byte_to_unary_table[v] + 24;
-#endif
-}
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormU32(uint32_t a)
-{
-
-    if (a == 0) return 0;
-    return (int16_t) __clz_uint32(a);
-}
-
-
-// Return the number of steps a can be left-shifted without overflow,
-// or 0 if a == 0.
-static __inline int16_t NormW32(int32_t a)
-{
-
-    if (a == 0) return 0;
-    uint32_t v = (uint32_t) (a < 0 ? ~a : a);
-    // Returns the number of leading zero bits in the argument.
-    return (int16_t) (__clz_uint32(v) - 1);
-}
-
 void resampleData(const int16_t *sourceData, int32_t sampleRate, uint32_t srcSize, int16_t *destinationData,
                   int32_t newSampleRate)
 {
@@ -315,8 +243,8 @@ static int16_t GmmProbability(VadInstT *self, int16_t *features,
             // Note that b0 and b1 are values less than 1, hence, 0 <= log2(1+b0) < 1.
             // Further, b0 and b1 are independent and on the average the two terms
             // cancel.
-            shifts_h0 = NormW32(h0_test);
-            shifts_h1 = NormW32(h1_test);
+            shifts_h0 = WebRtcSpl_NormW32(h0_test);
+            shifts_h1 = WebRtcSpl_NormW32(h1_test);
             if (h0_test == 0)
             {
                 shifts_h0 = 31;
@@ -347,7 +275,7 @@ static int16_t GmmProbability(VadInstT *self, int16_t *features,
                 // High probability of noise. Assign conditional probabilities for each
                 // Gaussian in the GMM.
                 tmp1_s32 = (noise_probability[0] & 0xFFFFF000) << 2;  // Q29
-                ngprvec[channel] = (int16_t) DivW32W16(tmp1_s32, h0);  // Q14
+                ngprvec[channel] = (int16_t) WebRtcSpl_DivW32W16(tmp1_s32, h0);  // Q14
                 ngprvec[channel + kNumChannels] = 16384 - ngprvec[channel];
             }
             else
@@ -364,7 +292,7 @@ static int16_t GmmProbability(VadInstT *self, int16_t *features,
                 // High probability of speech. Assign conditional probabilities for each
                 // Gaussian in the GMM. Otherwise use the initialized values, i.e., 0.
                 tmp1_s32 = (speech_probability[0] & 0xFFFFF000) << 2;  // Q29
-                sgprvec[channel] = (int16_t) DivW32W16(tmp1_s32, h1);  // Q14
+                sgprvec[channel] = (int16_t) WebRtcSpl_DivW32W16(tmp1_s32, h1);  // Q14
                 sgprvec[channel + kNumChannels] = 16384 - sgprvec[channel];
             }
         }
@@ -469,11 +397,11 @@ static int16_t GmmProbability(VadInstT *self, int16_t *features,
                     // 0.1 * Q20 / Q7 = Q13.
                     if (tmp2_s32 > 0)
                     {
-                        tmp_s16 = (int16_t) DivW32W16(tmp2_s32, ssk * 10);
+                        tmp_s16 = (int16_t) WebRtcSpl_DivW32W16(tmp2_s32, ssk * 10);
                     }
                     else
                     {
-                        tmp_s16 = (int16_t) DivW32W16(-tmp2_s32, ssk * 10);
+                        tmp_s16 = (int16_t) WebRtcSpl_DivW32W16(-tmp2_s32, ssk * 10);
                         tmp_s16 = -tmp_s16;
                     }
                     // Divide by 4 giving an update factor of 0.025 (= 0.1 / 4).
@@ -508,11 +436,11 @@ static int16_t GmmProbability(VadInstT *self, int16_t *features,
                     // Q20 / Q7 = Q13.
                     if (tmp1_s32 > 0)
                     {
-                        tmp_s16 = (int16_t) DivW32W16(tmp1_s32, nsk);
+                        tmp_s16 = (int16_t) WebRtcSpl_DivW32W16(tmp1_s32, nsk);
                     }
                     else
                     {
-                        tmp_s16 = (int16_t) DivW32W16(-tmp1_s32, nsk);
+                        tmp_s16 = (int16_t) WebRtcSpl_DivW32W16(-tmp1_s32, nsk);
                         tmp_s16 = -tmp_s16;
                     }
                     tmp_s16 += 32;  // Rounding
@@ -626,6 +554,8 @@ int WebRtcVad_InitCore(VadInstT *self)
         return -1;
     }
 
+    WebRtcSpl_Init();
+
     // Initialization of general struct variables.
     self->vad = 1;  // Speech active (=1).
     self->frame_counter = 0;
@@ -754,62 +684,6 @@ int WebRtcVad_CalcVad8khz(VadInstT *inst, const int16_t *speech_frame,
     return inst->vad;
 }
 
-static __inline int16_t WebRtcSpl_GetSizeInBits(uint32_t n)
-{
-    return (int16_t) 32 - (n == 0 ? (int16_t) 32 : (int16_t) __clz_uint32(n));
-}
-
-int16_t WebRtcSpl_GetScalingSquare(int16_t *in_vector,
-                                   size_t in_vector_length,
-                                   size_t times)
-{
-    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) times);
-    size_t i;
-    int16_t smax = -1;
-    int16_t sabs;
-    int16_t *sptr = in_vector;
-    int16_t t;
-    size_t looptimes = in_vector_length;
-
-    for (i = looptimes; i > 0; i--)
-    {
-        sabs = (*sptr > 0 ? *sptr++ : -*sptr++);
-        smax = (sabs > smax ? sabs : smax);
-    }
-    t = NormW32(((int32_t) ((int32_t) (smax) * (int32_t) (smax))));
-
-    if (smax == 0)
-    {
-        return 0; // Since norm(0) returns 0
-    }
-    else
-    {
-        return (t > nbits) ? 0 : nbits - t;
-    }
-}
-
-int32_t WebRtcSpl_Energy(int16_t *vector,
-                         size_t vector_length,
-                         int *scale_factor)
-{
-    int32_t en = 0;
-    size_t i;
-    int scaling =
-            WebRtcSpl_GetScalingSquare(vector, vector_length, vector_length);
-    size_t looptimes = vector_length;
-    int16_t *vectorptr = vector;
-
-    for (i = 0; i < looptimes; i++)
-    {
-        en += (*vectorptr * *vectorptr) >> scaling;
-        vectorptr++;
-    }
-    *scale_factor = scaling;
-
-    return en;
-}
-
-
 // Allpass filter coefficients, upper and lower, in Q13.
 // Upper: 0.64, Lower: 0.17.
 static const int16_t kSmoothingDown = 6553;  // 0.2 in Q15.
@@ -1019,7 +893,7 @@ int32_t WebRtcVad_GaussianProbability(int16_t input,
     // 131072 = 1 in Q17, and (|std| >> 1) is for rounding instead of truncation.
     // Q-domain: Q17 / Q7 = Q10.
     tmp32 = (int32_t) 131072 + (int32_t) (std >> 1);
-    inv_std = (int16_t) DivW32W16(tmp32, std);
+    inv_std = (int16_t) WebRtcSpl_DivW32W16(tmp32, std);
 
     // Calculate |inv_std2| = 1 / s^2, in Q14.
     tmp16 = (inv_std >> 2);  // Q10 -> Q8.
@@ -1226,7 +1100,7 @@ static void LogOfEnergy(const int16_t *data_in, size_t data_length,
     {
         // By construction, normalizing to 15 bits is equivalent with 17 leading
         // zeros of an unsigned 32 bit value.
-        int normalizing_rshifts = 17 - NormU32(energy);
+        int normalizing_rshifts = 17 - WebRtcSpl_NormU32(energy);
         // In a 15 bit representation the leading bit is 2^14. log2(2^14) in Q10 is
         // (14 << 10), which is what we initialize |log2_energy| with. For a more
         // detailed derivations, see below.
@@ -1466,7 +1340,7 @@ int WebRtcVad_Process(VadInst *handle, int fs, const int16_t *audio_frame,
         const size_t kFrameLen10ms = (size_t) (fs / 100);
         const size_t kFrameLen10ms8khz = 80;
         size_t num_10ms_frames = frame_length / kFrameLen10ms;
-        int i = 0;
+        size_t i = 0;
         for (i = 0; i < num_10ms_frames; i++)
         {
             resampleData(audio_frame, fs, kFrameLen10ms, &speech_nb[i * kFrameLen10ms8khz],
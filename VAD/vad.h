@@ -37,10 +37,6 @@
 #define RTC_DCHECK_LT(a, b) RTC_DCHECK((a) < (b))
 #define RTC_DCHECK_GT(a, b) RTC_DCHECK((a) > (b))
 
-int32_t WebRtcSpl_Energy(int16_t *vector,
-                         size_t vector_length,
-                         int *scale_factor);
-
 enum
 {
     kNumChannels = 6